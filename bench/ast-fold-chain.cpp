@@ -0,0 +1,36 @@
+/** @file ast-fold-chain.cpp
+ * @brief ExprChecker::fold_tree() 在常量链上的耗时. 第 i 个常量引用第 i-1 个三次,
+ *        没有记忆化时求值是指数级的, 记忆化以后是线性的.
+ *
+ * 用法: ast-fold-chain [链长=400] */
+#include "myglc-lang/ast-code-context.hxx"
+#include "myglc-lang/ast-parser.hxx"
+#include "myglc-lang/code-visitors/expr-checker.hxx"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+int main(int argc, char *argv[])
+{
+    int length = argc > 1 ? std::atoi(argv[1]) : 400;
+
+    std::ostringstream os;
+    os << "const int c0 = 1;\n";
+    for (int i = 1; i < length; i++)
+        os << "const int c" << i << " = c" << i - 1 << " + c" << i - 1 << " - c" << i - 1 << ";\n";
+    os << "int main() { return c" << length - 1 << "; }\n";
+
+    MYGL::Ast::CodeContext::PtrT ctx = MYGL::Ast::CodeContext::fromString(os.str());
+    MYGL::Ast::Parser parser{*ctx};
+    if (int ret = parser.try_parse(); ret != 0)
+        return ret;
+
+    auto begin = std::chrono::steady_clock::now();
+    MYGL::GenUtil::ExprChecker checker;
+    checker.fold_tree(ctx->root());
+    auto end = std::chrono::steady_clock::now();
+    std::fprintf(stderr, "chain of %d constants: fold_tree %.3f ms\n", length,
+                 std::chrono::duration<double, std::milli>(end - begin).count());
+    return 0;
+}
@@ -0,0 +1,35 @@
+/** @file ast-nested-scope.cpp
+ * @brief 深层嵌套语句块里的名字解析耗时. 第 i 层语句块定义 v_i, 初始值引用上一层的
+ *        v_{i-1} 和最外层的 v_0. 沿父作用域链逐层查找时解析 v_0 要走 i 层, 总耗时
+ *        是深度的平方; 用扁平符号表时每次解析只查一次, 总耗时和深度成正比.
+ *
+ * 用法: ast-nested-scope [嵌套深度=2000] */
+#include "myglc-lang/ast-code-context.hxx"
+#include "myglc-lang/ast-parser.hxx"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+int main(int argc, char *argv[])
+{
+    int depth = argc > 1 ? std::atoi(argv[1]) : 2000;
+
+    std::ostringstream os;
+    os << "int main() {\n  int v_0 = 1;\n";
+    for (int i = 1; i < depth; i++)
+        os << "{ int v_" << i << " = v_" << i - 1 << " + v_0;\n";
+    os << "  v_0 = v_" << depth - 1 << ";\n";
+    for (int i = 1; i < depth; i++)
+        os << "}";
+    os << "\n  return v_0;\n}\n";
+
+    MYGL::Ast::CodeContext::PtrT ctx = MYGL::Ast::CodeContext::fromString(os.str());
+    auto begin = std::chrono::steady_clock::now();
+    MYGL::Ast::Parser parser{*ctx};
+    int ret = parser.try_parse();
+    auto end = std::chrono::steady_clock::now();
+    std::fprintf(stderr, "depth %d: rc=%d, parse and register %.3f ms\n", depth, ret,
+                 std::chrono::duration<double, std::milli>(end - begin).count());
+    return ret;
+}
@@ -0,0 +1,80 @@
+/** @file irbase-operand-read.cpp
+ * @brief 读操作数的开销. 函数里有 n 条 `add a, i`, 每一轮把所有指令的操作数读一遍:
+ *        - use:    经过 User 的操作数表, 每个操作数是 Use* -> 槽位 -> Value* 两次访存;
+ *        - direct: 直接读指令里的操作数成员(get_lhs/get_rhs), 相当于 Use 嵌在 User
+ *                  里面时的下限.
+ *        只用到 list_as_user/get_usee/get_lhs 这几个老接口, 同一份源码也能对着
+ *        改动之前的树编译, 比较两种 Use 表示.
+ *
+ * 用法: irbase-operand-read [指令条数=200000] [轮数=50] */
+#include "mygl-ir/ir-basicblock.hxx"
+#include "mygl-ir/ir-constant-function.hxx"
+#include "mygl-ir/ir-constant.hxx"
+#include "mygl-ir/ir-instruction.hxx"
+#include "mygl-ir/ir-module.hxx"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace MYGL::IR;
+using namespace MYGL::IRBase;
+using namespace MTB;
+
+namespace {
+    /* 操作数表的元素可能是 Use* 也可能是 Use&, 两种都接受 */
+    Use *use_of(Use *use) { return use; }
+    Use *use_of(Use &use) { return &use; }
+
+    template<typename FnT>
+    double time_ns(size_t nrounds, FnT &&fn)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < nrounds; i++)
+            fn();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - begin).count();
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    size_t ninsts  = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    size_t nrounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 50;
+
+    owned<Module> module = Module::Create("operand-read", 8);
+    TypeContext &ctx = module->type_ctx();
+    IntType *i32 = ctx.getIntType(32);
+    auto fty = ctx.getFunctionType(i32, TypeContext::FTypeListT{i32});
+    owned<Function> fn = Function::Create(ctx.getPointerType(fty), "f", module, false);
+    (void)module->setFunction("f", fn);
+
+    Value *a = fn->argumentAt(0);
+    BasicBlock *entry = fn->get_entry();
+    std::vector<BinarySSA*> insts;
+    insts.reserve(ninsts);
+    for (size_t i = 0; i < ninsts; i++) {
+        owned<BinarySSA> inst = BinarySSA::Create(
+            Instruction::OpCode::ADD, a, own<IntConst>(i32, int64_t(i % 64)), true);
+        entry->append(inst);
+        insts.push_back(inst.get());
+    }
+
+    uintptr_t sum_use = 0, sum_direct = 0;
+    double use_ns = time_ns(nrounds, [&insts, &sum_use]() {
+        for (BinarySSA *inst: insts) {
+            for (auto &&use: inst->get_list_as_user())
+                sum_use += uintptr_t(use_of(use)->get_usee());
+        }
+    });
+    double direct_ns = time_ns(nrounds, [&insts, &sum_direct]() {
+        for (BinarySSA *inst: insts)
+            sum_direct += uintptr_t(inst->get_lhs()) + uintptr_t(inst->get_rhs());
+    });
+
+    double noperands = double(ninsts) * 2 * double(nrounds);
+    std::fprintf(stderr, "%zu insts x %zu rounds: use %.2f ns/operand, direct %.2f ns/operand\n",
+                 ninsts, nrounds, use_ns / noperands, direct_ns / noperands);
+    return sum_use == sum_direct ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+/** @file irutil-dominator-tree.cpp
+ * @brief DominatorTree::Build() 在大 CFG 上的耗时, 以及第一次查询时计算全部支配边界的耗时.
+ *
+ * 两种形状:
+ *  - 梯子: b_i 分支到 b_{i+1} 和 b_{i+2}, 倒数第二块跳回 b_1. 每个块都能被跳过,
+ *    所以直接支配者都是入口, 每个块的支配边界是后面两块.
+ *  - 长链: b_i 只跳到 b_{i+1}, 支配树是一条深度为 n 的链, 用来检查没有递归爆栈.
+ *
+ * 用法: irutil-dominator-tree [基本块个数=100000] */
+#include "mygl-ir/ir-basicblock.hxx"
+#include "mygl-ir/ir-constant-function.hxx"
+#include "mygl-ir/ir-constant.hxx"
+#include "mygl-ir/ir-instruction.hxx"
+#include "mygl-ir/ir-module.hxx"
+#include "mygl-ir/utils/irutil-dominance.hxx"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace MYGL::IR;
+using namespace MTB;
+using MYGL::IRUtil::DominatorTree;
+
+namespace {
+    struct CFG {
+        owned<Function>          fn;
+        std::vector<BasicBlock*> blocks;
+
+        CFG(Module *module, char const *name, size_t nblocks)
+        {
+            TypeContext &ctx = module->type_ctx();
+            auto fty = ctx.getFunctionType(ctx.getIntType(32), TypeContext::FTypeListT{});
+            fn = Function::Create(ctx.getPointerType(fty), name, module, false);
+            (void)module->setFunction(name, fn);
+            blocks.reserve(nblocks);
+            blocks.push_back(fn->get_entry());
+            for (size_t i = 1; i < nblocks; i++) {
+                owned<BasicBlock> block = BasicBlock::Create(fn);
+                fn->body().append(block);
+                blocks.push_back(block.get());
+            }
+        }
+
+        void jump(size_t from, size_t to) {
+            blocks[from]->set_terminator(JumpSSA::Create(blocks[from], blocks[to]));
+        }
+        void branch(size_t from, size_t if_true, size_t if_false) {
+            blocks[from]->set_terminator(BranchSSA::Create(
+                IntConst::BooleanTrue(), blocks[if_true], blocks[if_false]));
+        }
+    }; // struct CFG
+
+    void measure(char const *shape, CFG const &cfg)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        DominatorTree::PtrT tree = DominatorTree::Build(cfg.fn);
+        auto middle = std::chrono::steady_clock::now();
+        size_t nfrontier = 0;
+        for (BasicBlock *block: cfg.blocks)
+            nfrontier += tree->get_frontier(block).size();
+        auto end = std::chrono::steady_clock::now();
+        std::fprintf(stderr, "%-6s %zu blocks: build %.3f ms, frontiers %.3f ms "
+                             "(%zu frontier entries, entry dominates last: %d)\n",
+                     shape, tree->get_nblocks(),
+                     std::chrono::duration<double, std::milli>(middle - begin).count(),
+                     std::chrono::duration<double, std::milli>(end - middle).count(),
+                     nfrontier, int(tree->dominates(cfg.blocks.front(), cfg.blocks.back())));
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    size_t nblocks = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    if (nblocks < 4)
+        nblocks = 4;
+    owned<Module> module = Module::Create("dominator-tree", 8);
+
+    {
+        CFG cfg(module.get(), "ladder", nblocks);
+        for (size_t i = 0; i + 2 < nblocks; i++)
+            cfg.branch(i, i + 1, i + 2);
+        cfg.jump(nblocks - 2, 1);
+        cfg.jump(nblocks - 1, nblocks - 1);
+        measure("ladder", cfg);
+    }
+    {
+        CFG cfg(module.get(), "chain", nblocks);
+        for (size_t i = 0; i + 1 < nblocks; i++)
+            cfg.jump(i, i + 1);
+        cfg.jump(nblocks - 1, nblocks - 1);
+        measure("chain", cfg);
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+/** @file irutil-replace-uses.cpp
+ * @brief IRUtil::usee_replace_this_with() 在有大量使用者的值上的耗时. 函数参数 a 被
+ *        n 条 `add a, 1` 使用, 把 a 的所有使用换成参数 b, 再换回来.
+ *
+ * 用法: irutil-replace-uses [使用者个数=100000] */
+#include "mygl-ir/ir-basicblock.hxx"
+#include "mygl-ir/ir-constant-function.hxx"
+#include "mygl-ir/ir-constant.hxx"
+#include "mygl-ir/ir-instruction.hxx"
+#include "mygl-ir/ir-module.hxx"
+#include "mygl-ir/utils/irutil-value-replace.hxx"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace MYGL::IR;
+using namespace MYGL::IRBase;
+using namespace MTB;
+
+namespace {
+    size_t count_uses(Value *value)
+    {
+        size_t n = 0;
+        for (Use *use = value->get_list_as_usee().front();
+             use != nullptr; use = use->get_next_usee())
+            n++;
+        return n;
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    size_t nusers = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+
+    owned<Module> module = Module::Create("replace-uses", 8);
+    TypeContext &ctx = module->type_ctx();
+    IntType *i32 = ctx.getIntType(32);
+    auto fty = ctx.getFunctionType(i32, TypeContext::FTypeListT{i32, i32});
+    owned<Function> fn = Function::Create(ctx.getPointerType(fty), "f", module, false);
+    (void)module->setFunction("f", fn);
+
+    Value *a = fn->argumentAt(0);
+    Value *b = fn->argumentAt(1);
+    BasicBlock *entry = fn->get_entry();
+    owned<IntConst> one = own<IntConst>(i32, int64_t(1));
+    for (size_t i = 0; i < nusers; i++)
+        entry->append(BinarySSA::Create(Instruction::OpCode::ADD, a, one, true));
+
+    auto begin = std::chrono::steady_clock::now();
+    MYGL::IRUtil::usee_replace_this_with(a, b);
+    auto middle = std::chrono::steady_clock::now();
+    MYGL::IRUtil::usee_replace_this_with(b, a);
+    auto end = std::chrono::steady_clock::now();
+
+    std::fprintf(stderr, "%zu users: a -> b %.3f ms, b -> a %.3f ms (a has %zu uses, b has %zu)\n",
+                 nusers,
+                 std::chrono::duration<double, std::milli>(middle - begin).count(),
+                 std::chrono::duration<double, std::milli>(end - middle).count(),
+                 count_uses(a), count_uses(b));
+    return count_uses(a) == nusers && count_uses(b) == 0 ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+/** @file lexer-throughput.cpp
+ * @brief 词法分析吞吐量, 单位 MB/s. 分别量 tokenize() 一次扫完整份源码和语法分析器
+ *        那样逐个 yylex() 取词法单元两种用法, 每一轮都新建 Lexer.
+ *
+ * 用法: lexer-throughput [源码大小 MB=16] [轮数=5] */
+#include "myglc-lang/ast-lexer.hxx"
+#include "myglc-lang/ast-parser.tab.hxx"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+using namespace MYGL::Ast;
+
+namespace {
+    /** 声明、注释、浮点和整数字面量、各种运算符都有一些, 平均不到 3 字节一个词法单元 */
+    std::string make_source(size_t nbytes)
+    {
+        std::ostringstream os;
+        for (int f = 0; os.tellp() < std::streamoff(nbytes); f++) {
+            os << "/* function " << f << " */\n"
+                  "float f" << f << "(int a, float b[]) {\n"
+                  "  int x = a + 0x" << std::hex << f << std::dec << " * 2; // scaled\n"
+                  "  while (x <= 100 && a != " << f << ") {\n"
+                  "    b[x] = b[x - 1] * 1.5e-3 + " << f << ".25;\n"
+                  "    if (!(x % 3)) { x = x + 1; } else { x = x << 1; }\n"
+                  "  }\n"
+                  "  return b[0] / (x >= 0 || a < 2);\n"
+                  "}\n";
+        }
+        return os.str();
+    }
+
+    template<typename FnT>
+    double best_ms(int rounds, FnT &&fn)
+    {
+        double best = 1e300;
+        for (int r = 0; r < rounds; r++) {
+            auto begin = std::chrono::steady_clock::now();
+            fn();
+            best = std::min(best, std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - begin).count());
+        }
+        return best;
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16;
+    int    rounds    = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    std::string source = make_source(megabytes << 20);
+    double mb = double(source.size()) / (1 << 20);
+
+    size_t ntokens = 0, nerrors = 0;
+    double tokenize_ms = best_ms(rounds, [&] {
+        Lexer lexer{"<bench>", source};
+        Lexer::RawTokenListT const &tokens = lexer.tokenize();
+        ntokens = tokens.size();
+        nerrors = std::count_if(tokens.begin(), tokens.end(), [](Lexer::RawToken const &t) {
+            return t.kind == parser::token::YYerror;
+        });
+    });
+    size_t nlexed = 0;
+    double yylex_ms = best_ms(rounds, [&] {
+        Lexer lexer{"<bench>", source};
+        nlexed = 0;
+        while (lexer.yylex() != parser::token::YYEOF)
+            nlexed++;
+    });
+
+    std::fprintf(stderr, "%.1f MB, %zu tokens, %zu error tokens\n", mb, ntokens, nerrors);
+    std::fprintf(stderr, "tokenize(): %.1f ms, %.0f MB/s\n", tokenize_ms, mb / tokenize_ms * 1000);
+    std::fprintf(stderr, "yylex():    %.1f ms, %.0f MB/s (%zu tokens)\n",
+                 yylex_ms, mb / yylex_ms * 1000, nlexed);
+    return 0;
+}
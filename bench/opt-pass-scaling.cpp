@@ -0,0 +1,135 @@
+/** @file opt-pass-scaling.cpp
+ * @brief FunctionPassManager 在不同线程数下跑 mem2reg + sccp + gvn 的耗时.
+ *        每个线程数都重新生成一遍模块, 只计 `run()` 的时间.
+ *
+ * 每个函数长得像前端给局部变量生成的代码: 参数先存进 alloca, 经过一个菱形分支
+ * 写入另一个 alloca, 汇合后再做一串依赖于它的运算, 里面夹着重复的表达式.
+ *
+ * 用法: opt-pass-scaling [函数个数=10000] [每个函数的运算条数=40] [线程数...=1 2 4 N]
+ *       N 是硬件线程数. */
+#include "mygl-ir/ir-basicblock.hxx"
+#include "mygl-ir/ir-constant-function.hxx"
+#include "mygl-ir/ir-constant.hxx"
+#include "mygl-ir/ir-instruction.hxx"
+#include "mygl-ir/ir-module.hxx"
+#include "base/mtb-thread-pool.hxx"
+#include "optimizers/FunctionPassManager.hxx"
+#include "optimizers/GVNPass.hxx"
+#include "optimizers/Mem2RegPass.hxx"
+#include "optimizers/SCCPPass.hxx"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace MYGL::IR;
+using namespace MYGL::IRBase;
+using namespace MTB;
+using OpCode = Instruction::OpCode;
+using MYGL::Optimizers::FunctionPassManager;
+
+namespace {
+    owned<IntConst> iconst(IntType *ity, int64_t value) {
+        return IntConst::Create(ity, value);
+    }
+
+    void make_function(Module *module, FunctionType *fty, std::string const &name, int nops)
+    {
+        TypeContext &ctx = module->type_ctx();
+        IntType *i32 = ctx.getIntType(32);
+        owned<Function> fn = Function::Create(ctx.getPointerType(fty), name, module, false);
+        (void)module->setFunction(name, fn);
+
+        BasicBlock *entry = fn->get_entry();
+        owned<BasicBlock> then_block = BasicBlock::Create(fn);
+        owned<BasicBlock> else_block = BasicBlock::Create(fn);
+        owned<BasicBlock> join       = BasicBlock::Create(fn);
+        fn->body().append(then_block);
+        fn->body().append(else_block);
+        fn->body().append(join);
+
+        owned<Value> arg = fn->argumentAt(0);
+        owned<AllocaSSA> x = AllocaSSA::CreateAutoAligned(i32);
+        owned<AllocaSSA> y = AllocaSSA::CreateAutoAligned(i32);
+        entry->append(x);
+        entry->append(y);
+        entry->append(StoreSSA::Create(arg, x));
+        entry->append(StoreSSA::Create(iconst(i32, 0), y));
+        owned<CompareSSA> cond = CompareSSA::CreateICmp(CompareResult::LT, true, arg, iconst(i32, 10));
+        entry->append(cond);
+        entry->set_terminator(BranchSSA::Create(cond, then_block, else_block));
+
+        owned<LoadSSA> tx = own<LoadSSA>(x);
+        then_block->append(tx);
+        owned<BinarySSA> tv = BinarySSA::Create(OpCode::ADD, tx, iconst(i32, 1), true);
+        then_block->append(tv);
+        then_block->append(StoreSSA::Create(tv, y));
+        then_block->set_terminator(JumpSSA::Create(then_block, join));
+
+        owned<LoadSSA> ex = own<LoadSSA>(x);
+        else_block->append(ex);
+        owned<BinarySSA> ev = BinarySSA::Create(OpCode::MUL, ex, iconst(i32, 3), true);
+        else_block->append(ev);
+        else_block->append(StoreSSA::Create(ev, y));
+        else_block->set_terminator(JumpSSA::Create(else_block, join));
+
+        /* 每一步都把 (last op arg) 算两遍, 第二遍留给 gvn 消除 */
+        static constexpr OpCode ops[] = { OpCode::ADD, OpCode::MUL, OpCode::SUB, OpCode::XOR };
+        owned<LoadSSA> yv = own<LoadSSA>(y);
+        join->append(yv);
+        owned<Value> last = yv;
+        for (int i = 0; i < nops; i++) {
+            owned<BinarySSA> a = BinarySSA::Create(ops[i % 4], last, arg, true);
+            owned<BinarySSA> b = BinarySSA::Create(ops[i % 4], last, arg, true);
+            join->append(a);
+            join->append(b);
+            owned<BinarySSA> sum = BinarySSA::Create(OpCode::ADD, a, b, true);
+            join->append(sum);
+            last = sum;
+        }
+        join->set_terminator(ReturnSSA::Create(fn, last));
+    }
+
+    owned<Module> make_module(int nfunctions, int nops)
+    {
+        owned<Module> module = Module::Create("pass-scaling", 8);
+        TypeContext &ctx = module->type_ctx();
+        IntType *i32 = ctx.getIntType(32);
+        FunctionType *fty = ctx.getFunctionType(i32, TypeContext::FTypeListT{i32});
+        for (int f = 0; f < nfunctions; f++)
+            make_function(module, fty, "f" + std::to_string(f), nops);
+        return module;
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    int nfunctions = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int nops       = argc > 2 ? std::atoi(argv[2]) : 40;
+    std::vector<size_t> thread_counts;
+    for (int i = 3; i < argc; i++)
+        thread_counts.push_back(std::strtoul(argv[i], nullptr, 10));
+    if (thread_counts.empty())
+        thread_counts = { 1, 2, 4, ThreadPool::DefaultConcurrency() };
+
+    double base_ms = 0;
+    for (size_t nthreads: thread_counts) {
+        owned<Module> module = make_module(nfunctions, nops);
+        FunctionPassManager manager{nthreads};
+        manager.addPass(own<MYGL::Optimizers::Mem2RegPass>())
+               .addPass(own<MYGL::Optimizers::SCCPPass>())
+               .addPass(own<MYGL::Optimizers::GVNPass>());
+
+        auto begin = std::chrono::steady_clock::now();
+        size_t nchanged = manager.run(module);
+        double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - begin).count();
+        if (base_ms == 0)
+            base_ms = ms;
+        std::fprintf(stderr, "%2zu threads: %d functions x %d ops, %.1f ms, "
+                             "speedup %.2fx (%zu changed)\n",
+                     nthreads, nfunctions, nops, ms, base_ms / ms, nchanged);
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include "base/mtb-arena.hxx"
+#include <cstdlib>
+#include <new>
+
+namespace MTB {
+
+inline namespace arena_impl {
+    thread_local BumpArena *current_arena = nullptr;
+
+    constexpr size_t align_up(size_t value, size_t align) {
+        return (value + align - 1) & ~(align - 1);
+    }
+} // inline namespace arena_impl
+
+/* @class BumpArena 分块指针碰撞分配器 */
+
+BumpArena::BumpArena(size_t chunk_size)
+    : _chunks(nullptr), _cursor(nullptr), _end(nullptr),
+      _chunk_size(chunk_size), _nchunks(0),
+      _allocated_bytes(0), _released(false), _nlive(1) {}
+
+BumpArena::~BumpArena()
+{
+    Chunk *chunk = _chunks;
+    while (chunk != nullptr) {
+        Chunk *next = chunk->next;
+        ::operator delete(chunk);
+        chunk = next;
+    }
+}
+
+void BumpArena::_grow(size_t min_size)
+{
+    constexpr size_t head_size = align_up(sizeof(Chunk), alignof(std::max_align_t));
+    size_t size = _chunk_size;
+    if (min_size > size / 2)
+        size = min_size;
+    size += head_size;
+
+    Chunk *chunk = static_cast<Chunk*>(::operator new(size));
+    chunk->next  = _chunks;
+    chunk->size  = size;
+    _chunks = chunk;
+    _cursor = reinterpret_cast<char*>(chunk) + head_size;
+    _end    = reinterpret_cast<char*>(chunk) + size;
+    _nchunks++;
+}
+
+void *BumpArena::allocate(size_t size, size_t align)
+{
+    uintptr_t cur = align_up(uintptr_t(_cursor), align);
+    MTB_UNLIKELY_IF (_cursor == nullptr || cur + size > uintptr_t(_end)) {
+        _grow(size + align);
+        cur = align_up(uintptr_t(_cursor), align);
+    }
+    _cursor = reinterpret_cast<char*>(cur + size);
+    _nlive.fetch_add(1, std::memory_order_relaxed);
+    _allocated_bytes += size;
+    return reinterpret_cast<void*>(cur);
+}
+
+void BumpArena::_unref() noexcept
+{
+    /* 计数里包含所有者的那一个, 所以归零只可能发生在 release 之后 */
+    if (_nlive.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        delete this;
+}
+
+void BumpArena::deallocate(void *ptr) noexcept
+{
+    (void)ptr;
+    _unref();
+}
+
+void BumpArena::release() noexcept
+{
+    if (current_arena == this)
+        current_arena = nullptr;
+    _released = true;
+    _unref();
+}
+
+BumpArena *BumpArena::get_current() noexcept {
+    return current_arena;
+}
+
+void *BumpArena::_allocate_object(size_t size)
+{
+    /* 对象放在模 OBJECT_ALIGN 余 ARENA_TAG 的第一个地址上, 并且前面至少留出头部的位置.
+     * 这样对象地址总是带着 ARENA_TAG, 也满足 max_align_t 的对齐. */
+    constexpr size_t skew = OBJECT_ALIGN - ARENA_TAG;
+    auto place = [](char *cursor) {
+        return align_up(uintptr_t(cursor) + HEADER_SIZE + skew, OBJECT_ALIGN) - skew;
+    };
+    uintptr_t obj = place(_cursor);
+    MTB_UNLIKELY_IF (_cursor == nullptr || obj + size > uintptr_t(_end)) {
+        _grow(size + HEADER_SIZE + OBJECT_ALIGN);
+        obj = place(_cursor);
+    }
+    *(reinterpret_cast<BumpArena**>(obj) - 1) = this;
+    _allocated_bytes += obj + size - uintptr_t(_cursor);
+    _cursor = reinterpret_cast<char*>(obj + size);
+    _nlive.fetch_add(1, std::memory_order_relaxed);
+    return reinterpret_cast<void*>(obj);
+}
+
+void *BumpArena::AllocateObject(size_t size)
+{
+    BumpArena *arena = current_arena;
+    if (arena == nullptr || arena->_released)
+        return ::operator new(size, std::align_val_t(OBJECT_ALIGN));
+    return arena->_allocate_object(size);
+}
+
+void BumpArena::FreeObject(void *ptr) noexcept
+{
+    if (ptr == nullptr)
+        return;
+    if ((uintptr_t(ptr) & ARENA_TAG) == 0) {
+        ::operator delete(ptr, std::align_val_t(OBJECT_ALIGN));
+        return;
+    }
+    BumpArena *arena = *(reinterpret_cast<BumpArena**>(ptr) - 1);
+    arena->deallocate(ptr);
+}
+
+/* end class BumpArena */
+
+/* @class ArenaScope */
+
+ArenaScope::ArenaScope(BumpArena *arena) noexcept
+    : _saved(current_arena) {
+    current_arena = arena;
+}
+ArenaScope::~ArenaScope() {
+    current_arena = _saved;
+}
+
+/* end class ArenaScope */
+
+} // namespace MTB
@@ -6,28 +6,18 @@ namespace MTB::Compatibility {
 
 std::string vrt_fmt(char const* fmt, va_list ap)
 {
-    constexpr const unsigned INLINE_BUFLEN = 256;
-    size_t size = vsnprintf(nullptr, 0, fmt, ap);
+    /* 算长度那一遍会把 ap 用掉, 要在副本上算 */
+    va_list ap_size;
+    va_copy(ap_size, ap);
+    int size = vsnprintf(nullptr, 0, fmt, ap_size);
+    va_end(ap_size);
 
-    if (size == 0) {
+    if (size <= 0)
         return {};
-    } else if (size + 8 <= INLINE_BUFLEN) {
-#ifdef __GNUC__
-        auto buffer = (char*)alloca(size);
-#else
-        char buffer[INLINE_BUFLEN];
-#endif
-        (size_t&)(*buffer) = 0;
-        vsnprintf(buffer, size, fmt, ap);
-        return std::string{buffer, size};
-    } else {
-        char *buffer = new char[size + 8];
-        (size_t&)(*buffer) = 0;
-        vsnprintf(buffer, size, fmt, ap);
-        std::string ret{buffer, size};
-        delete[] buffer;
-        return ret;
-    }
+    /* vsnprintf 总要写一个结尾的 '\0', 直接写进 string 多留的那个字节里 */
+    std::string ret(size_t(size), '\0');
+    vsnprintf(ret.data(), ret.size() + 1, fmt, ap);
+    return ret;
 }
 
 }
\ No newline at end of file
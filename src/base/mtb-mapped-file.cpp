@@ -0,0 +1,66 @@
+#include "base/mtb-mapped-file.hxx"
+#include <cerrno>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace MTB {
+
+/** @class MappedFile */
+
+MappedFile &MappedFile::operator=(MappedFile &&that) noexcept
+{
+    if (this == &that)
+        return *this;
+    close();
+    _data    = std::exchange(that._data, nullptr);
+    _size    = std::exchange(that._size, 0);
+    _is_open = std::exchange(that._is_open, false);
+    return *this;
+}
+
+bool MappedFile::open(std::string const &path)
+{
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        int err = errno;
+        ::close(fd);
+        errno = err;
+        return false;
+    }
+    size_t size = size_t(st.st_size);
+    if (size != 0) {
+        void *data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            int err = errno;
+            ::close(fd);
+            errno = err;
+            return false;
+        }
+        _data = data;
+    }
+    /* 映射建立以后文件描述符就不需要了 */
+    ::close(fd);
+    _size    = size;
+    _is_open = true;
+    return true;
+}
+
+void MappedFile::close() noexcept
+{
+    if (_data != nullptr)
+        ::munmap(_data, _size);
+    _data    = nullptr;
+    _size    = 0;
+    _is_open = false;
+}
+
+/** end class MappedFile */
+
+} // namespace MTB
@@ -0,0 +1,78 @@
+#include "base/mtb-symbol.hxx"
+#include "base/mtb-exception.hxx"
+#include <cstring>
+
+
+namespace MTB {
+/* @class Symbol */
+    Symbol::Symbol(std::string_view str)
+        : _id(str.empty() ? 0 : SymbolTable::Global().intern(str)) {}
+
+    size_t Symbol::CountInterned() noexcept {
+        return SymbolTable::Global().size();
+    }
+/* end class Symbol */
+
+inline namespace symbol_impl {
+/* @class SymbolTable */
+    SymbolTable &SymbolTable::Global()
+    {
+        /* 故意不析构: 静态对象析构时可能还有别的静态对象在用符号 */
+        static SymbolTable *instance = new SymbolTable();
+        return *instance;
+    }
+
+    SymbolTable::SymbolTable()
+        : _pages(new std::atomic<std::string_view*>[MAX_PAGES])
+    {
+        for (size_t i = 0; i < MAX_PAGES; i++)
+            _pages[i].store(nullptr, std::memory_order_relaxed);
+        /* 0 号是空串 */
+        _pages[0].store(new std::string_view[PAGE_SIZE], std::memory_order_release);
+        _ids.emplace(std::string_view{}, 0);
+        _count.store(1, std::memory_order_release);
+    }
+
+    uint32_t SymbolTable::intern(std::string_view str)
+    {
+        std::lock_guard guard{_lock};
+        if (auto it = _ids.find(str); it != _ids.end())
+            return it->second;
+
+        size_t id = _count.load(std::memory_order_relaxed);
+        MTB_UNLIKELY_IF (id >= MAX_PAGES * PAGE_SIZE) {
+            throw Exception(ErrorLevel::FATAL, std::string_view{"symbol table is full"});
+        }
+        std::string_view *page = _pages[id >> PAGE_BITS].load(std::memory_order_relaxed);
+        if (page == nullptr) {
+            page = new std::string_view[PAGE_SIZE];
+            _pages[id >> PAGE_BITS].store(page, std::memory_order_release);
+        }
+        std::string_view stored = _store(str);
+        page[id & (PAGE_SIZE - 1)] = stored;
+        _ids.emplace(stored, uint32_t(id));
+        _count.store(id + 1, std::memory_order_release);
+        return uint32_t(id);
+    }
+
+    std::string_view SymbolTable::_store(std::string_view str)
+    {
+        /* 长字符串单独占一块, 免得浪费当前块剩下的空间 */
+        if (str.size() > CHUNK_SIZE / 4) {
+            _chunks.emplace_back(new char[str.size()]);
+            std::memcpy(_chunks.back().get(), str.data(), str.size());
+            return {_chunks.back().get(), str.size()};
+        }
+        if (size_t(_chunk_end - _chunk_cur) < str.size()) {
+            _chunks.emplace_back(new char[CHUNK_SIZE]);
+            _chunk_cur = _chunks.back().get();
+            _chunk_end = _chunk_cur + CHUNK_SIZE;
+        }
+        char *ret = _chunk_cur;
+        std::memcpy(ret, str.data(), str.size());
+        _chunk_cur += str.size();
+        return {ret, str.size()};
+    }
+/* end class SymbolTable */
+} // inline namespace symbol_impl
+} // namespace MTB
@@ -0,0 +1,109 @@
+#include "base/mtb-text-buffer.hxx"
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <unistd.h>
+
+namespace MTB {
+
+inline namespace text_buffer_impl {
+    /* "00" "01" ... "99", 一次查表转换两位数字 */
+    static constexpr char digit_pairs[201] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+    /** 从 end 往前写入 value 的十进制表示, 返回第一个字符的位置 */
+    static char *format_uint_backward(char *end, uint64_t value)
+    {
+        char *p = end;
+        while (value >= 100) {
+            unsigned pair = unsigned(value % 100) * 2;
+            value /= 100;
+            *--p = digit_pairs[pair + 1];
+            *--p = digit_pairs[pair];
+        }
+        if (value >= 10) {
+            unsigned pair = unsigned(value) * 2;
+            *--p = digit_pairs[pair + 1];
+            *--p = digit_pairs[pair];
+        } else {
+            *--p = char('0' + value);
+        }
+        return p;
+    }
+} // inline namespace text_buffer_impl
+
+/** @class TextBuffer */
+
+TextBuffer &TextBuffer::appendRepeat(std::string_view str, size_t count)
+{
+    _grow(str.size() * count);
+    for (size_t i = 0; i < count; i++)
+        _data.append(str);
+    return *this;
+}
+
+TextBuffer &TextBuffer::appendUInt(uint64_t value)
+{
+    char buf[24];
+    char *end   = buf + sizeof(buf);
+    char *begin = format_uint_backward(end, value);
+    return append(std::string_view(begin, end - begin));
+}
+
+TextBuffer &TextBuffer::appendInt(int64_t value)
+{
+    char buf[24];
+    char *end = buf + sizeof(buf);
+    /* 先转成无符号再取反, 避免 -INT64_MIN 溢出 */
+    uint64_t magnitude = value < 0 ? 0 - uint64_t(value) : uint64_t(value);
+    char *begin = format_uint_backward(end, magnitude);
+    if (value < 0)
+        *--begin = '-';
+    return append(std::string_view(begin, end - begin));
+}
+
+TextBuffer &TextBuffer::appendDouble(double value)
+{
+    char buf[32];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+    (void)ec; /* 32 字节足够放下任何 double 的最短表示 */
+    return append(std::string_view(buf, end - buf));
+}
+
+bool TextBuffer::writeTo(int fd) const
+{
+    char const *p    = _data.data();
+    size_t      rest = _data.size();
+    while (rest > 0) {
+        ssize_t n = ::write(fd, p, rest);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        p    += n;
+        rest -= size_t(n);
+    }
+    return true;
+}
+
+size_t TextBuffer::_next_capacity(size_t required) const
+{
+    size_t capacity = _data.capacity() < DEFAULT_CAPACITY
+                    ? DEFAULT_CAPACITY
+                    : _data.capacity() * 2;
+    return capacity < required ? required : capacity;
+}
+
+/** end class TextBuffer */
+
+} // namespace MTB
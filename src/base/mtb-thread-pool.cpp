@@ -0,0 +1,126 @@
+#include "base/mtb-thread-pool.hxx"
+#include <utility>
+
+namespace MTB {
+
+/* @class ThreadPool 工作窃取线程池 */
+
+ThreadPool::ThreadPool(size_t nworkers)
+    : _nqueued(0), _npending(0), _next_worker(0), _stopping(false)
+{
+    if (nworkers == 0)
+        nworkers = DefaultConcurrency();
+    _workers.reserve(nworkers);
+    for (size_t i = 0; i < nworkers; i++)
+        _workers.push_back(std::make_unique<Worker>());
+    _threads.reserve(nworkers);
+    for (size_t i = 0; i < nworkers; i++)
+        _threads.emplace_back(&ThreadPool::_workerMain, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock{_state_lock};
+        _stopping = true;
+    }
+    _task_cv.notify_all();
+    for (std::thread &t: _threads)
+        t.join();
+}
+
+size_t ThreadPool::DefaultConcurrency() noexcept
+{
+    size_t n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+void ThreadPool::submit(TaskT task)
+{
+    size_t target = _next_worker.fetch_add(1, std::memory_order_relaxed)
+                  % _workers.size();
+    {
+        /* 计数在状态锁里改, 和工作线程的等待条件配对, 不会丢唤醒.
+         * 必须先记账再放任务: 否则别的线程可能在记账之前就把任务偷走执行完,
+         * 先做 `_nqueued` 的减法, 无符号计数回绕后工作线程会一直空转. */
+        std::lock_guard lock{_state_lock};
+        _nqueued.fetch_add(1, std::memory_order_relaxed);
+        _npending++;
+    }
+    {
+        Worker &w = *_workers[target];
+        std::lock_guard lock{w.lock};
+        w.tasks.push_back(std::move(task));
+    }
+    _task_cv.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock lock{_state_lock};
+    _done_cv.wait(lock, [this]{ return _npending == 0; });
+    if (_first_error != nullptr)
+        std::rethrow_exception(std::exchange(_first_error, nullptr));
+}
+
+bool ThreadPool::_tryPop(size_t self, TaskT &out)
+{
+    /* 先取自己队尾: 刚放进去的任务最可能还在缓存里 */
+    {
+        Worker &w = *_workers[self];
+        std::lock_guard lock{w.lock};
+        if (!w.tasks.empty()) {
+            out = std::move(w.tasks.back());
+            w.tasks.pop_back();
+            _nqueued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    /* 再从别人队首偷 */
+    size_t n = _workers.size();
+    for (size_t i = 1; i < n; i++) {
+        Worker &victim = *_workers[(self + i) % n];
+        std::lock_guard lock{victim.lock};
+        if (!victim.tasks.empty()) {
+            out = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            _nqueued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::_finishTask(std::exception_ptr error)
+{
+    std::lock_guard lock{_state_lock};
+    if (error != nullptr && _first_error == nullptr)
+        _first_error = std::move(error);
+    if (--_npending == 0)
+        _done_cv.notify_all();
+}
+
+void ThreadPool::_workerMain(size_t self)
+{
+    while (true) {
+        TaskT task;
+        if (_tryPop(self, task)) {
+            std::exception_ptr error = nullptr;
+            try {
+                task();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            _finishTask(std::move(error));
+            continue;
+        }
+        std::unique_lock lock{_state_lock};
+        _task_cv.wait(lock, [this]{
+            return _stopping || _nqueued.load(std::memory_order_relaxed) != 0;
+        });
+        if (_stopping && _nqueued.load(std::memory_order_relaxed) == 0)
+            return;
+    }
+}
+
+} // namespace MTB
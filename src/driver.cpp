@@ -1,10 +1,83 @@
+#include "mygl-ir/utils/ir-util-writer.hxx"
+#include "mygl-ir/utils/irutil-bitcode.hxx"
+#include "myglc-lang/frontend-batch.hxx"
+#include <cstdlib>
+#include <exception>
+#include <fstream>
 #include <iostream>
+#include <string>
 #include <string_view>
+#include <vector>
 
-std::string_view preclude_syi = 
+std::string_view preclude_syi =
 R"(
 extern void putint(int number);
 extern void putfloat(float number);
 extern int getint();
 extern float getfloat();
-)";
\ No newline at end of file
+)";
+
+/* 用法: driver [-j <nthreads>] <source>...
+ *       driver [-j <nthreads>] -l [-o <output>] <bitcode>...
+ * 第一种在线程池上并行地解析并检查每个源文件(编译单元), 报告出错的单元.
+ * 第二种把 write_bitcode_file() 写出的模块链接成一个, 输出文本 IR.
+ * 前端还不能生成 IR (见 BatchFrontend 的说明), 所以两步之间还接不起来. */
+int main(int argc, char *argv[])
+{
+    using namespace MYGL;
+    size_t      nworkers = 0;
+    bool        link     = false;
+    std::string output;
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (arg == "-j" && i + 1 < argc)
+            nworkers = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "-o" && i + 1 < argc)
+            output = argv[++i];
+        else if (arg == "-l")
+            link = true;
+        else
+            inputs.emplace_back(arg);
+    }
+    if (inputs.empty()) {
+        std::cerr << "usage: " << argv[0] << " [-j <nthreads>] <source>...\n"
+                  << "       " << argv[0] << " [-j <nthreads>] -l [-o <output>] <bitcode>...\n";
+        return 2;
+    }
+
+    Driver::BatchFrontend frontend{preclude_syi, nworkers};
+    if (!link) {
+        int nfailed = 0;
+        for (auto &unit: frontend.check(inputs)) {
+            if (unit.is_ok())
+                continue;
+            std::cerr << unit.filename << ": " << unit.error << '\n';
+            nfailed++;
+        }
+        return nfailed == 0 ? 0 : 1;
+    }
+
+    MTB::owned<IR::Module> module;
+    try {
+        std::vector<MTB::owned<IR::Module>> modules;
+        std::vector<IR::Module*> module_ptrs;
+        for (std::string const &input: inputs) {
+            modules.push_back(IRUtil::read_bitcode_file(input));
+            module_ptrs.push_back(modules.back().get());
+        }
+        module = frontend.link(module_ptrs, "a.out");
+    } catch (std::exception &e) {
+        std::cerr << "link: " << e.what() << '\n';
+        return 1;
+    }
+    IRUtil::Writer writer{module};
+    writer.set_nthreads(nworkers);
+    if (output.empty()) {
+        writer.write(std::cout);
+    } else {
+        std::ofstream out{output};
+        writer.write(out);
+    }
+    return 0;
+}
@@ -59,7 +59,11 @@ class Object {
 public:
     Object() : __ref_count__(0) {}
     virtual ~Object() = default;
+#if __MTB_OBJECT_ATOMIC_REFCOUNT__ != 0
     alignas(uint64_t) mutable volatile std::atomic_int __ref_count__;
+#else
+    alignas(uint64_t) mutable int __ref_count__;
+#endif
 
     inline void setInlineInit()   const { __ref_count__++; }
     inline void unsetInlineInit() const { __ref_count__--; }
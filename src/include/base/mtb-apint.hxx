@@ -32,7 +32,7 @@ public:
 
     uint8_t  get_binary_bits()  const { return _binary_bits; }
     int64_t  get_signed_value() const {
-        uint64_t ret = (sign_neg()? 0xFFFF'FFFF'FFFF'FFFF: 0) | _instance; 
+        uint64_t ret = (sign_neg()? _get_binary_nmask(): 0) | _instance;
         return reinterpret_cast<int64_t&>(ret);
     }
     uint64_t get_unsigned_value() const { return _instance; }
@@ -137,6 +137,9 @@ private:
     uint8_t  _binary_bits;
 
     uint64_t _get_binary_pmask() const {
+        /* 移位数等于位宽是未定义行为, 64 位要单独处理 */
+        if (_binary_bits >= 64)
+            return 0xFFFF'FFFF'FFFF'FFFF;
         return (uint64_t(0x1) << _binary_bits) - 1;
     }
     uint64_t _get_binary_nmask() const {
@@ -0,0 +1,139 @@
+#ifndef __MTB_ARENA_H__
+#define __MTB_ARENA_H__
+
+#include "mtb-base.hxx"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+/* 竞技场分配开关. 为 0 时所有 `MTB_ARENA_OPERATORS` 类都退回普通堆分配,
+ * 方便和原来的 malloc/free 模式做对比. 可以用 `-D__MTB_ARENA_ENABLED__=0` 覆盖. */
+#ifndef __MTB_ARENA_ENABLED__
+#define __MTB_ARENA_ENABLED__ 1
+#endif
+
+namespace MTB {
+    /** @class BumpArena
+     * @brief 分块的指针碰撞分配器. 分配只移动游标, 单个对象的释放只减少存活计数,
+     *        内存在整块竞技场退休时一次性归还.
+     *
+     * 竞技场的所有者不直接 delete 它, 而是调用 `release()` 表示"我不再往里放东西了".
+     * 所有者本身也算一个存活引用, 通常所有者先析构完里面的对象再 release, 这时所有块
+     * 立即一起归还. 倘若还有对象没被析构(比如一条指令被别人的 owned 指针持有), 竞技场
+     * 会等到最后一个对象释放时再自行销毁, 所以不会出现悬垂内存.
+     *
+     * @warning 分配只能在一个线程上进行(持有 `ArenaScope` 的那个线程). 存活计数是原子的,
+     *          对象可以在任何线程上释放, 比如并行 pass 里被别的函数的指令持有的 Use. */
+    class BumpArena {
+    public:
+        /** 每个块的默认大小. 大于一半块大小的对象会单独占一个块. */
+        static constexpr size_t DEFAULT_CHUNK_SIZE = 16 * 1024;
+
+        /** 经由 `MTB_ARENA_OPERATORS` 放进竞技场的对象前面紧贴着一个指向竞技场的指针,
+         *  对象地址模 OBJECT_ALIGN 余 ARENA_TAG; 走堆分配的对象没有这个头部, 地址按
+         *  OBJECT_ALIGN 对齐. 两种对象都满足 `alignof(std::max_align_t)`,
+         *  `FreeObject()` 只看地址的 ARENA_TAG 这一位就知道对象从哪里来. */
+        static constexpr size_t    OBJECT_ALIGN = 2 * alignof(std::max_align_t);
+        static constexpr uintptr_t ARENA_TAG    = alignof(std::max_align_t);
+        static constexpr size_t    HEADER_SIZE  = sizeof(BumpArena*);
+        static_assert(HEADER_SIZE <= ARENA_TAG);
+    public:
+        explicit BumpArena(size_t chunk_size = DEFAULT_CHUNK_SIZE);
+        BumpArena(BumpArena const &) = delete;
+        BumpArena &operator=(BumpArena const &) = delete;
+
+        /** @fn allocate(size, align)
+         * @brief 在竞技场里分配 size 字节, 按 align 对齐. 存活计数加一. */
+        void *allocate(size_t size, size_t align = alignof(std::max_align_t));
+        /** @fn deallocate(ptr)
+         * @brief 存活计数减一. 竞技场已退休且存活计数归零时销毁自己. */
+        void  deallocate(void *ptr) noexcept;
+        /** @fn release()
+         * @brief 所有者放弃竞技场. 没有存活对象时立即销毁, 否则推迟到最后一个对象释放.
+         *        只能调用一次, 调用之后不能再访问竞技场. */
+        void  release() noexcept;
+
+        /** @property nlive{get;} 尚未析构的对象个数 */
+        size_t get_nlive() const {
+            return _nlive.load(std::memory_order_relaxed) - (_released ? 0 : 1);
+        }
+        /** @property allocated_bytes{get;} 累计分配的字节数(含头部和对齐填充) */
+        size_t get_allocated_bytes() const { return _allocated_bytes; }
+        /** @property nchunks{get;} 已申请的块数 */
+        size_t get_nchunks()         const { return _nchunks; }
+        /** @property is_released{get;} */
+        bool   is_released()         const { return _released; }
+
+        /** @property current{get;} static
+         * @brief 当前线程正在使用的竞技场, 由 `ArenaScope` 设置. 为 null 时走堆分配. */
+        static BumpArena *get_current() noexcept;
+
+        /** @fn AllocateObject(size) static
+         * @brief `MTB_ARENA_OPERATORS` 使用的 operator new 实现. 没有活跃的竞技场时
+         *        直接从堆上按 OBJECT_ALIGN 对齐分配, 不带头部. */
+        static void *AllocateObject(size_t size);
+        /** @fn FreeObject(ptr) static
+         * @brief `MTB_ARENA_OPERATORS` 使用的 operator delete 实现. */
+        static void  FreeObject(void *ptr) noexcept;
+    private:
+        struct Chunk {
+            Chunk *next;
+            size_t size;
+        }; // struct Chunk
+        friend class ArenaScope;
+
+        Chunk  *_chunks;
+        char   *_cursor, *_end;
+        size_t  _chunk_size;
+        size_t  _nchunks;
+        size_t  _allocated_bytes;
+        bool    _released;
+        /* 存活对象个数, 所有者未 release 之前额外多算一个 */
+        std::atomic<size_t> _nlive;
+
+        ~BumpArena();
+        void  _grow(size_t min_size);
+        void *_allocate_object(size_t size);
+        void  _unref() noexcept;
+    }; // class BumpArena
+
+    /** @class ArenaScope
+     * @brief RAII 地把当前线程的竞技场切换到 arena, 析构时切回原来的竞技场.
+     *        arena 为 null 表示在该作用域内使用堆分配. */
+    class ArenaScope {
+    public:
+        explicit ArenaScope(BumpArena *arena) noexcept;
+        ~ArenaScope();
+        ArenaScope(ArenaScope const &) = delete;
+        ArenaScope &operator=(ArenaScope const &) = delete;
+    private:
+        BumpArena *_saved;
+    }; // class ArenaScope
+} // namespace MTB
+
+/** @def MTB_ARENA_OPERATORS
+ * @brief 放在类定义里, 让该类(以及子类)的 new/delete 走当前线程的竞技场.
+ *        由于带虚析构函数的类在 delete 时使用最终派生类的 operator delete,
+ *        所以放在继承链的根部即可.
+ *        对象按 `alignof(std::max_align_t)` 对齐. 对齐要求更高的类(alignas 超过它)
+ *        会选中带对齐参数的那一对 new/delete, 直接走堆分配, 不进竞技场. */
+#if __MTB_ARENA_ENABLED__ != 0
+#define MTB_ARENA_OPERATORS \
+    static void *operator new(size_t size) {\
+        return MTB::BumpArena::AllocateObject(size);\
+    }\
+    static void operator delete(void *ptr) noexcept {\
+        MTB::BumpArena::FreeObject(ptr);\
+    }\
+    static void *operator new(size_t size, std::align_val_t align) {\
+        return ::operator new(size, align);\
+    }\
+    static void operator delete(void *ptr, std::align_val_t align) noexcept {\
+        ::operator delete(ptr, align);\
+    }
+#else
+#define MTB_ARENA_OPERATORS
+#endif
+
+#endif
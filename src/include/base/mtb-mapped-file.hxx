@@ -0,0 +1,56 @@
+#ifndef __MTB_MAPPED_FILE_H__
+#define __MTB_MAPPED_FILE_H__
+
+#include "mtb-base.hxx"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace MTB {
+    /** @class MappedFile
+     * @brief 只读映射整个文件, 析构时解除映射. 读文件的代码直接在映射上解析,
+     *        不把文件内容拷贝进自己的缓冲区.
+     *
+     * 打开失败不抛异常: `open()` 返回 false 并保留 errno, 由调用者抛出自己模块的
+     * 异常类型. 空文件映射成功, 但 `get_data()` 为 null. */
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { close(); }
+        MappedFile(MappedFile const &) = delete;
+        MappedFile &operator=(MappedFile const &) = delete;
+        MappedFile(MappedFile &&that) noexcept
+            : _data(that._data), _size(that._size), _is_open(that._is_open) {
+            that._data    = nullptr;
+            that._size    = 0;
+            that._is_open = false;
+        }
+        MappedFile &operator=(MappedFile &&that) noexcept;
+
+        /** @fn open(path)
+         * @brief 关闭已有的映射, 然后映射文件 path.
+         * @return 成功返回 true. 失败时返回 false, errno 保留失败原因. */
+        bool open(std::string const &path);
+        void close() noexcept;
+
+        /** @property is_open{get;} */
+        bool is_open() const { return _is_open; }
+        /** @property data{get;} */
+        char const *get_data() const { return static_cast<char const*>(_data); }
+        /** @property size{get;} */
+        size_t get_size() const { return _size; }
+
+        std::string_view view() const { return {get_data(), _size}; }
+        std::span<uint8_t const> bytes() const {
+            return {static_cast<uint8_t const*>(_data), _size};
+        }
+    private:
+        void  *_data    = nullptr;
+        size_t _size    = 0;
+        bool   _is_open = false;
+    }; // class MappedFile
+} // namespace MTB
+
+#endif
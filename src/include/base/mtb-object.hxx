@@ -3,6 +3,13 @@
 
 #include "mtb-base.hxx"
 
+/* 引用计数是否使用原子操作. 一个模块只在一个线程里编译时可以用
+ * `-D__MTB_OBJECT_ATOMIC_REFCOUNT__=0` 关掉, 这样每次拷贝 owned 都只是一次
+ * 普通的加减, 不再是带锁的读-改-写. 多线程跑 Pass 时必须保持为 1. */
+#ifndef __MTB_OBJECT_ATOMIC_REFCOUNT__
+#define __MTB_OBJECT_ATOMIC_REFCOUNT__ 1
+#endif
+
 #if __cplusplus >= 202002L
 
 #include <atomic>
@@ -12,6 +19,15 @@
 #include <utility>
 
 namespace MTB {
+    /** @typedef RefCountT
+     * @brief Object 引用计数的类型, 由 `__MTB_OBJECT_ATOMIC_REFCOUNT__` 决定.
+     *        两种类型都支持 `++`/`--`/隐式转换为 int, owned 的代码不用区分. */
+#if __MTB_OBJECT_ATOMIC_REFCOUNT__ != 0
+    using RefCountT = std::atomic_int;
+#else
+    using RefCountT = int;
+#endif
+
     /** @class Object
      * @brief Medi ToolBox的基础类, 有基于引用计数自动内存管理功能. 不使用`std::shared_ptr`
      *        的理由是, `shared_ptr`很容易出现重复析构的问题.
@@ -20,11 +36,11 @@ namespace MTB {
     public:
         Object() : __ref_count__(0) {}
         virtual ~Object() = default;
-        alignas(uint64_t) mutable volatile std::atomic_int __ref_count__;
+        alignas(uint64_t) mutable RefCountT __ref_count__;
 
         inline void setInlineInit()   const { __ref_count__++; }
         inline void unsetInlineInit() const { __ref_count__--; }
-        void __inc_refcnt() const { __ref_count__.fetch_add(1); }
+        void __inc_refcnt() const { ++__ref_count__; }
         bool __dec_refcnt_and_test() const {
             int ret = --__ref_count__;
             return (ret == 0);
@@ -104,12 +120,12 @@ namespace MTB {
             __ptr = rrinst.__ptr;
             rrinst.__ptr = nullptr;
         }
-        /** 析构时解引用 */
+        /** 析构时解引用. 减一和判零必须是同一次操作, 否则原子模式下两个线程
+         *  可能同时看到 0. */
         ~owned() {
             if (__ptr == nullptr)
                 return;
-            __ptr->__ref_count__--;
-            if (__ptr->__ref_count__ == 0)
+            if (__ptr->__dec_refcnt_and_test())
                 delete __ptr;
         }
 
@@ -183,7 +199,10 @@ namespace MTB {
         template<typename ObjET>
         requires (!(std::is_base_of_v<ObjET, ObjT>))
         operator owned<ObjET>() const {
-            return owned(dynamic_cast<ObjET*>(__ptr));
+            ObjET *ret = dynamic_cast<ObjET*>(__ptr);
+            if (ret == nullptr)
+                return nullptr;
+            return owned<ObjET>(ret);
         }
 
         ObjT *get() const { return __ptr; }
@@ -326,18 +345,15 @@ namespace MTB {
     template<PublicExtendsObject ObjT, typename... ArgT>
     inline owned<ObjT> own(ArgT&&... args)
     {
+        /* 使用 new 表达式而不是 std::allocator, 这样类自己的 operator new
+         * (比如 MTB_ARENA_OPERATORS) 才能生效. 构造失败时 new 表达式会自动归还内存. */
         ObjT *ret;
         try {
-            std::allocator<ObjT> allocator;
-            ret = allocator.allocate(1);
-            new(ret) ObjT(std::forward<ArgT>(args)...);
+            ret = new ObjT(std::forward<ArgT>(args)...);
         } catch (std::bad_alloc &ae) {
             fputs(ae.what(), stderr);
             fputc('\n', stderr);
             std::terminate();
-        } catch (std::exception &e) {
-            delete ret;
-            throw;
         }
         return owned{ret};
     }
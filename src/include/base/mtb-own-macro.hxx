@@ -6,17 +6,12 @@
 
 #define MTB_OWN(ret, ObjType, ...) \
     do {\
-        ObjType             *__mtb_ret_rawp__;\
-        std::allocator<ObjType> __allocator__;\
+        ObjType *__mtb_ret_rawp__;\
         try {\
-            __mtb_ret_rawp__ = __allocator__.allocate(1);\
-            new(__mtb_ret_rawp__) ObjType(__VA_ARGS__);\
+            __mtb_ret_rawp__ = new ObjType(__VA_ARGS__);\
         } catch (std::bad_alloc &ba) {\
             fputs(ba.what(), stderr), fputc('\n', stderr);\
             std::terminate();\
-        } catch (std::exception &e) {\
-            __allocator__.deallocate(__mtb_ret_rawp__, 1);\
-            throw;\
         }\
         ret = MTB::owned(__mtb_ret_rawp__);\
     } while (false)
@@ -26,17 +21,12 @@
     MTB_OWN(object_name, ObjType, __VA_ARGS__);
 
 #define RETURN_MTB_OWN(ObjType, ...) do {\
-        ObjType             *__mtb_ret_rawp__;\
-        std::allocator<ObjType> __allocator__;\
+        ObjType *__mtb_ret_rawp__;\
         try {\
-            __mtb_ret_rawp__ = __allocator__.allocate(1);\
-            new(__mtb_ret_rawp__) ObjType(__VA_ARGS__);\
+            __mtb_ret_rawp__ = new ObjType(__VA_ARGS__);\
         } catch (std::bad_alloc &ba) {\
             fputs(ba.what(), stderr), fputc('\n', stderr);\
             std::terminate();\
-        } catch (std::exception &e) {\
-            __allocator__.deallocate(__mtb_ret_rawp__, 1);\
-            throw;\
         }\
         return MTB::owned(__mtb_ret_rawp__);\
     } while (false)
@@ -0,0 +1,102 @@
+#ifndef __MTB_SYMBOL_H__
+#define __MTB_SYMBOL_H__
+
+#include "mtb-base.hxx"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace MTB {
+    /** @class Symbol
+     * @brief 驻留字符串的 32 位编号. 内容相同的字符串在整个进程里只存一份, 编号也
+     *        只有一个, 所以比较两个符号就是比较两个整数, 拿符号做哈希表的键也不必
+     *        再对字符串求哈希.
+     *
+     * 0 号符号是空串, 默认构造的符号就是它. 符号的字符串一直存活到进程结束,
+     * `str()` 返回的 string_view 可以放心长期保存.
+     *
+     * 驻留和取字符串都是线程安全的. 取字符串不加锁. */
+    class Symbol {
+    public:
+        constexpr Symbol() noexcept = default;
+        /** @fn Symbol(str)
+         * @brief 驻留 str, 得到它的符号. 已经驻留过的字符串直接返回原来的编号. */
+        explicit Symbol(std::string_view str);
+        explicit Symbol(char const *str): Symbol(std::string_view{str}) {}
+        explicit Symbol(std::string const &str): Symbol(std::string_view{str}) {}
+
+        /** @property id{get;} */
+        uint32_t get_id() const noexcept { return _id; }
+        /** @property str{get;} 符号的字符串, 生命期到进程结束 */
+        std::string_view str() const noexcept;
+        bool empty() const noexcept { return _id == 0; }
+
+        operator std::string_view() const noexcept { return str(); }
+
+        bool operator==(Symbol const &) const noexcept = default;
+        /** 按编号排序, 不是按字典序. 需要字典序时比较 `str()`. */
+        bool operator<(Symbol const &that) const noexcept { return _id < that._id; }
+
+        /** @fn CountInterned() static
+         * @brief 已经驻留的字符串个数, 包括空串. */
+        static size_t CountInterned() noexcept;
+    private:
+        uint32_t _id = 0;
+    }; // class Symbol
+
+    inline namespace symbol_impl {
+        /** @class SymbolTable
+         * @brief Symbol 背后的全局驻留表. 字符串按块存放, 编号到字符串的映射是分页的
+         *        数组, 页一旦分配就不再移动, 所以读者不需要加锁. */
+        class SymbolTable {
+        public:
+            static constexpr size_t PAGE_BITS  = 13;
+            static constexpr size_t PAGE_SIZE  = size_t(1) << PAGE_BITS;
+            static constexpr size_t MAX_PAGES  = size_t(1) << 14;
+            static constexpr size_t CHUNK_SIZE = 64 * 1024;
+        public:
+            static SymbolTable &Global();
+
+            uint32_t intern(std::string_view str);
+            std::string_view get(uint32_t id) const noexcept {
+                std::string_view const *page =
+                    _pages[id >> PAGE_BITS].load(std::memory_order_acquire);
+                return page[id & (PAGE_SIZE - 1)];
+            }
+            size_t size() const noexcept { return _count.load(std::memory_order_acquire); }
+        private:
+            SymbolTable();
+
+            std::mutex _lock;
+            std::unordered_map<std::string_view, uint32_t> _ids;
+            std::unique_ptr<std::atomic<std::string_view*>[]> _pages;
+            std::vector<std::unique_ptr<char[]>> _chunks;
+            char  *_chunk_cur = nullptr;
+            char  *_chunk_end = nullptr;
+            std::atomic<size_t> _count{0};
+
+            std::string_view _store(std::string_view str);
+        }; // class SymbolTable
+    } // inline namespace symbol_impl
+
+    inline std::string_view Symbol::str() const noexcept {
+        return SymbolTable::Global().get(_id);
+    }
+} // namespace MTB
+
+template<>
+struct std::hash<MTB::Symbol> {
+    size_t operator()(MTB::Symbol sym) const noexcept {
+        /* 编号是连续的小整数, 乘一个奇数打散到高位, 免得哈希表的桶挤在一起 */
+        return size_t(sym.get_id()) * 0x9E3779B97F4A7C15ull;
+    }
+}; // struct std::hash<MTB::Symbol>
+
+#endif
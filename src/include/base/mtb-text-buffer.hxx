@@ -0,0 +1,89 @@
+#ifndef __MTB_TEXT_BUFFER_H__
+#define __MTB_TEXT_BUFFER_H__
+
+#include "mtb-base.hxx"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace MTB {
+    /** @class TextBuffer
+     * @brief 只追加的文本缓冲区. 用来代替 `std::ostream` + `std::format` 拼接大段文本:
+     *        整数由手写的逐两位转换写入, 不经过 locale 和格式串解析; 内容全部拼好
+     *        以后再用一次 `write(2)` 交给操作系统.
+     *
+     * 多个缓冲区可以在不同线程上分别填充, 最后按固定顺序 `appendBuffer()` 拼接,
+     * 这样并行生成的文本和串行生成的完全一样.
+     *
+     * @warning 线程不安全. 一个缓冲区同一时刻只应该被一个线程写入. */
+    class TextBuffer {
+    public:
+        /** 第一次追加时预留的容量 */
+        static constexpr size_t DEFAULT_CAPACITY = 4096;
+    public:
+        TextBuffer() = default;
+        explicit TextBuffer(size_t capacity) { _data.reserve(capacity); }
+
+        /** @property data{get;} 不以 0 结尾 */
+        char const *get_data() const { return _data.data(); }
+        /** @property size{get;} */
+        size_t get_size() const { return _data.size(); }
+        bool   empty()    const { return _data.empty(); }
+        std::string_view view() const { return _data; }
+
+        void reserve(size_t capacity) { _data.reserve(capacity); }
+        void clear() { _data.clear(); }
+        /** @fn release()
+         * @brief 交出内部字符串, 缓冲区变为空. */
+        std::string release() { return std::move(_data); }
+
+        TextBuffer &append(std::string_view str) {
+            _grow(str.size());
+            _data.append(str);
+            return *this;
+        }
+        TextBuffer &append(char c) {
+            _grow(1);
+            _data.push_back(c);
+            return *this;
+        }
+        /** @fn appendRepeat(str, count)
+         * @brief 追加 count 份 str, 用于缩进. */
+        TextBuffer &appendRepeat(std::string_view str, size_t count);
+        TextBuffer &appendBuffer(TextBuffer const &that) {
+            return append(that.view());
+        }
+
+        /** @fn appendUInt(value)
+         * @brief 以十进制追加无符号整数. */
+        TextBuffer &appendUInt(uint64_t value);
+        /** @fn appendInt(value)
+         * @brief 以十进制追加有符号整数. `INT64_MIN` 也能正确处理. */
+        TextBuffer &appendInt(int64_t value);
+        /** @fn appendDouble(value)
+         * @brief 追加能原样读回的最短十进制表示, 和 `std::format("{}", value)` 结果相同. */
+        TextBuffer &appendDouble(double value);
+
+        TextBuffer &operator<<(std::string_view str) { return append(str); }
+        TextBuffer &operator<<(char c)               { return append(c); }
+
+        /** @fn writeTo(fd)
+         * @brief 把全部内容写进文件描述符 fd. 通常只需要一次 `write(2)`,
+         *        被信号打断或者只写了一部分时继续写剩下的.
+         * @return 成功返回 true, 失败时返回 false, errno 保留失败原因. */
+        bool writeTo(int fd) const;
+    private:
+        std::string _data;
+
+        void _grow(size_t extra) {
+            size_t required = _data.size() + extra;
+            MTB_UNLIKELY_IF (required > _data.capacity())
+                _data.reserve(_next_capacity(required));
+        }
+        size_t _next_capacity(size_t required) const;
+    }; // class TextBuffer
+} // namespace MTB
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef __MTB_THREAD_POOL_H__
+#define __MTB_THREAD_POOL_H__
+
+#include "mtb-base.hxx"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MTB {
+    /** @class ThreadPool
+     * @brief 工作窃取线程池. 每个工作线程有一个自己的任务双端队列, 提交的任务
+     *        轮流放进各个队列. 工作线程从自己队列的尾部取任务, 自己的队列空了就
+     *        从别的线程队列的头部偷任务, 这样耗时不均的任务(比如大小差别很大的
+     *        函数)也能把所有线程喂饱.
+     *
+     * 任务抛出的异常不会让工作线程退出: 线程池记下第一个异常, 由 `wait()` 重新抛出. */
+    class ThreadPool {
+    public:
+        using TaskT = std::function<void()>;
+    public:
+        /** @fn ThreadPool(nworkers)
+         * @param nworkers 工作线程数. 为 0 时取 `std::thread::hardware_concurrency()`. */
+        explicit ThreadPool(size_t nworkers = 0);
+        ~ThreadPool();
+        ThreadPool(ThreadPool const &) = delete;
+        ThreadPool &operator=(ThreadPool const &) = delete;
+
+        /** @property nworkers{get;} */
+        size_t get_nworkers() const { return _workers.size(); }
+
+        /** @fn submit(task)
+         * @brief 提交一个任务. 可以在任务里继续提交任务. */
+        void submit(TaskT task);
+        /** @fn wait()
+         * @brief 阻塞到所有已提交的任务都执行完毕. 有任务抛出过异常时重新抛出
+         *        第一个异常. 不要在任务里调用, 否则会死锁. */
+        void wait();
+
+        /** @fn DefaultConcurrency() static
+         * @brief 硬件线程数, 拿不到时返回 1. */
+        static size_t DefaultConcurrency() noexcept;
+    private:
+        struct Worker {
+            std::mutex        lock;
+            std::deque<TaskT> tasks;
+        }; // struct Worker
+
+        std::vector<std::unique_ptr<Worker>> _workers;
+        std::vector<std::thread>             _threads;
+        std::mutex              _state_lock;
+        std::condition_variable _task_cv, _done_cv;
+        std::atomic_size_t      _nqueued;     // 在队列里还没被取走的任务数
+        size_t                  _npending;    // 已提交但没执行完的任务数
+        std::atomic_size_t      _next_worker; // 下一个任务放进哪个队列
+        std::exception_ptr      _first_error;
+        bool                    _stopping;
+
+        bool _tryPop(size_t self, TaskT &out);
+        void _finishTask(std::exception_ptr error);
+        void _workerMain(size_t self);
+    }; // class ThreadPool
+} // namespace MTB
+
+#endif
@@ -43,6 +43,9 @@ public:
     friend struct TargetInfo;
     friend class  Function;
     friend RefT;
+
+    /* 基本块放在所属函数的竞技场里, 见 Function::get_arena() */
+    MTB_ARENA_OPERATORS
 public:
     struct TargetInfo {
         BasicBlock *target_block;
@@ -355,6 +358,9 @@ private:
     Function *_parent;
     ProxyT    _reflist_item_proxy;
     ConnectStatus _connect_status;
+
+    /* 跳转关系多了或者少了一条边, 通知所属函数控制流图变了 */
+    void _markCfgChanged();
 }; // class BasicBlock final
 
 /** @struct ActionPred
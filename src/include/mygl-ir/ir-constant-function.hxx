@@ -2,6 +2,7 @@
 #define __MYGL_IR_FUNCTION_H__
 
 #include "base/mtb-object.hxx"
+#include "base/mtb-arena.hxx"
 #include "ir-constant.hxx"
 #include "ir-basic-value.hxx"
 #include "ir-basicblock.hxx"
@@ -10,6 +11,10 @@
 #include <functional>
 #include <memory>
 
+namespace MYGL::IRUtil {
+    class DominatorTree;
+} // namespace MYGL::IRUtil
+
 namespace MYGL::IR {
 
 /** @class Function
@@ -114,6 +119,7 @@ public: /* 函数体代理 -- 操作最快的一集 */
         Function          *get_function()        const;
         BasicBlock::ListT *get_basicblock_list() const;
         BasicBlock        *get_entry()           const;
+        MTB::BumpArena    *get_arena()           const;
         bool is_ssa() const;
     }; // struct BodyImplProxy
 
@@ -248,6 +254,13 @@ public:  /* ================ [函数体] ================ */
      * @throws BasicBlock::ListT::WrongItemException 当 entry 不是 Function 的子结点时 */
     void set_entry(BasicBlock *entry);
 
+    /** @property arena{get;}
+     * @brief 函数体的竞技场. 在 `MTB::ArenaScope scope{fn->get_arena()}` 的作用域里
+     *        创建的指令、Use 和基本块都会分配在这里, 最后一个对象析构后整块归还.
+     *        链表结点不进竞技场, 免得模块级的结点把函数的竞技场拖住.
+     *        函数声明没有竞技场, 返回 null(此时会退回堆分配). */
+    MTB::BumpArena *get_arena() const;
+
     /** @warning 请注意, 该属性可能会被废弃. */
     [[deprecated("该属性会被替换为 get_entry(), 请及时更换.")]]
     BasicBlock *get_first_basicblock() const { return get_entry(); }
@@ -257,6 +270,24 @@ public:  /* ================ [函数体] ================ */
      * @return {size_t} 已清除的基本块数量 */
     size_t collectGarbage();
 
+public:  /* ================ [函数体: 控制流分析缓存] ================ */
+    using DomTreePtrT = std::shared_ptr<IRUtil::DominatorTree const>;
+
+    /** @property cfg_version{get;}
+     * @brief 控制流图的版本号. 基本块之间新增或者断开一条边、入口改变时加一.
+     *        依赖控制流图的分析结果记下构建时的版本号, 对不上就说明过期了.
+     *        函数声明恒为 0. */
+    uint64_t get_cfg_version() const;
+    /** @fn markCfgChanged()
+     * @brief 让依赖控制流图的分析结果全部过期. 基本块的跳转关系变化时会自动调用. */
+    void markCfgChanged();
+
+    /** @property dominator_cache{get;set;}
+     * @brief 函数体上缓存的支配树, 可能已经过期. 一般不直接用它, 而是调用
+     *        `IRUtil::DominatorTree::Get(fn)`. 函数声明上设置会被忽略. */
+    DomTreePtrT get_dominator_cache() const;
+    void        set_dominator_cache(DomTreePtrT tree);
+
 public:  /* ================ [函数体: 二阶段, 可变变量存储区] ================ */
     /** @property is_ssa{get;} bool
      * @brief 函数是不是 SSA 的. 倘若一个函数存在可变寄存器, 那么它就不是 SSA 的。
@@ -9,8 +9,10 @@
 #include "irbase-use-def.hxx"
 #include "ir-basic-value.hxx"
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace MYGL::IR {
 using namespace IRBase;
@@ -147,10 +149,25 @@ protected:
 }; // imcomplete class ConstantData
 
 /** @class IntConst
- * @brief 整数常量 */
+ * @brief 整数常量.
+ *
+ * 用 `Create` 得到的常量是驻留的: 类型和位模式都相同的常量同一时刻只有一个实例,
+ * 判断两个驻留常量相等只要比较指针. 驻留表不持有常量, 最后一个引用消失时常量照常
+ * 析构并从表里摘掉. 直接调用构造函数得到的是不驻留的独立实例.
+ *
+ * @warning 驻留常量被所有引用它的指令共用, 不能用 setter 修改. 要修改请先 `copy()`. */
 class IntConst final: public ConstantData {
 public:
-    static owned<IntConst> BooleanTrue, BooleanFalse;
+    /** @fn BooleanTrue() / BooleanFalse() static
+     * @brief i1 类型的 true/false. 第一次调用时构造, 不受静态对象初始化顺序影响. */
+    static owned<IntConst> const &BooleanTrue();
+    static owned<IntConst> const &BooleanFalse();
+
+    /** @fn Create(value_type, value) static
+     * @brief 取类型为 value_type、值为 value 的驻留常量, 没有就新建一个. 线程安全.
+     *        i1 类型直接返回 BooleanTrue()/BooleanFalse(). */
+    static owned<IntConst> Create(IntType *value_type, int64_t value);
+    static owned<IntConst> Create(IntType *value_type, APInt value, bool as_signed = true);
 public:
     explicit IntConst(IntType *value_type, int64_t value);
     explicit IntConst(IntType *value_type, APInt value, bool as_signed = true);
@@ -160,19 +177,32 @@ public:
     OVERRIDE_GET_FALSE(is_float)
     bool is_zero() const override { return _value == 0; }
 
+    /** @fn get_name_or_id() 没有设置过名称时现场格式化值的十进制串.
+     *  常量一般不起名, 所以构造时不预先格式化; 写文本 IR 时由 Writer 直接写进缓冲区. */
+    std::string get_name_or_id() const final;
+
     APInt get_apint_value() const final { return _value; }
     void set_apint_value(APInt v) final { set_value(v); }
 
     uint64_t get_uint_value() const final { return _value.get_unsigned_value(); }
-    void set_uint_value(uint64_t value) final { _value.set_value(value); }
+    void set_uint_value(uint64_t value) final {
+        APInt v = _value; v.set_value(value); set_value(v);
+    }
 
     int64_t  get_int_value() const final { return _value.get_signed_value(); }
-    void set_int_value(int64_t value)   final { _value.set_value(value); }
+    void set_int_value(int64_t value) final {
+        APInt v = _value; v.set_value(value); set_value(v);
+    }
 
     double get_float_value() const final { return _value.get_signed_value(); }
-    void set_float_value(double value)  final { _value = value; }
+    void set_float_value(double value) final {
+        APInt v = _value; v = int64_t(value); set_value(v);
+    }
 
-    DEFINE_GETSET(APInt, value)
+    /** @property value{get;set;}
+     * @warning 所有 setter 最后都走 set_value. 对驻留常量调用会直接崩溃. */
+    APInt get_value() const { return _value; }
+    void  set_value(APInt value);
 
     owned<ConstantData> castToClosest(Type *target_type) const final;
     owned<ConstantData> add(const owned<ConstantData> rhs) const final;
@@ -183,10 +213,9 @@ public:
     owned<ConstantData> smod(const owned<ConstantData> rhs) const final;
     owned<ConstantData> umod(const owned<ConstantData> rhs) const final;
     owned<ConstantData> neg() const final {
-        return new IntConst(
-            static_cast<IntType*>(_value_type), -_value
-        );
+        return Create(static_cast<IntType*>(_value_type), -_value);
     }
+    /** @fn copy() 得到一个不驻留的副本, 可以随意修改 */
     owned<ConstantData> copy() const final {
         return new IntConst(static_cast<IntType*>(get_value_type()), _value);
     }
@@ -194,11 +223,17 @@ public:
     void accept(IValueVisitor &visitor) final;
     CompareResult compare(const owned<ConstantData> rhs) const final;
 private:
-    APInt _value;
+    APInt       _value;
+    bool        _interned = false; // 在驻留表里, 析构时要摘掉
 }; // class IntConst final
 
+/** @class FloatConst
+ * @brief 浮点常量. 和 IntConst 一样, `Create` 得到的常量按 (类型, 位模式) 驻留,
+ *        所以 0.0 和 -0.0 是两个常量. */
 class FloatConst final: public ConstantData {
 public:
+    /** @fn Create(value_type, value) static
+     * @brief 取驻留的浮点常量, 没有就新建一个. 线程安全. */
     static owned<FloatConst> Create(FloatType *value_type, double value = 0);
 public:
     explicit FloatConst(FloatType *value_type, double value) noexcept;
@@ -208,8 +243,8 @@ public:
     OVERRIDE_GET_TRUE (is_float)
     bool is_zero() const override { return _value == 0.0; }
 
-    string_view get_name()    const final { return _name; }
-    void set_name(string_view name) final { _name = name; }
+    string_view get_name()    const final { return _name.str(); }
+    void set_name(string_view name) final { _name = MTB::Symbol{name}; }
 
     APInt get_apint_value() const final {
         return APInt{
@@ -228,8 +263,10 @@ public:
     double get_float_value()  const final { return _value; }
     void set_float_value(double value)  final { set_value(value); }
 
-    /** @property value{get;set;} 浮点类存储的真值 */
-    DEFINE_GETSET(double, value)
+    /** @property value{get;set;} 浮点类存储的真值
+     * @warning 所有 setter 最后都走 set_value. 对驻留常量调用会直接崩溃. */
+    double get_value() const { return _value; }
+    void   set_value(double value);
 
     owned<ConstantData> castToClosest(Type *target_type) const final;
     owned<ConstantData> add(const owned<ConstantData> rhs) const final;
@@ -238,8 +275,9 @@ public:
     owned<ConstantData> sdiv(const owned<ConstantData> rhs) const final;
     owned<ConstantData> smod(const owned<ConstantData> rhs) const final;
     owned<ConstantData> neg() const final {
-        return new FloatConst(static_cast<FloatType*>(_value_type), -_value);
+        return Create(static_cast<FloatType*>(_value_type), -_value);
     }
+    /** @fn copy() 得到一个不驻留的副本, 可以随意修改 */
     owned<ConstantData> copy() const final {
         return new FloatConst(static_cast<FloatType*>(get_value_type()), _value);
     }
@@ -249,6 +287,7 @@ public:
     bool equals(const Constant *another) const override;
 private:
     double _value;
+    bool   _interned = false; // 在驻留表里, 析构时要摘掉
 }; // class FloatConst final
 
 /** @class ZeroDataConst
@@ -395,8 +434,24 @@ protected:
 
 /** @class ArrarExpr
  * @brief 聚合数组表达式, 用于表示一系列数组. 该表达式具有CoW(Copy on Write)
- *        特性, 对于空数组来说，只有访问元素时才会为数组分配空间. */
+ *        特性, 对于空数组来说，只有访问元素时才会为数组分配空间.
+ *
+ * 元素有三种存放方式:
+ * - 全零: 元素表和稀疏表都为空;
+ * - 稀疏: 只在稀疏表里按下标升序存放非零元素, 其余元素都是 0. 大而稀疏的数组
+ *   占用的内存只和非零元素的个数有关;
+ * - 稠密: 元素表里存放全部元素.
+ * 通过 element_list 访问元素时前两种都会被展开成稠密的. */
 class ArrayExpr final: public ConstantExpr {
+public:
+    /** @struct SparseElem
+     * @brief 稀疏数组里的一个元素. */
+    struct SparseElem {
+        size_t       index;
+        owned<Value> value;
+    }; // struct SparseElem
+    using SparseListT       = std::vector<SparseElem>;
+    using SparseReadClosure = std::function<bool(size_t, Value*)>;
 public:
     static owned<ArrayExpr> CreateEmpty(ArrayType *array_type) {
         return new ArrayExpr(array_type);
@@ -413,6 +468,10 @@ public:
         return new ArrayExpr(static_cast<ArrayType*>(prob_array_type));
     }
     static owned<ArrayExpr> CreateFromValueArray(ValueArrayT const& value_list, Type *content_type = nullptr);
+    /** @fn CreateSparse(array_type, elements)
+     *  @brief 创建稀疏数组. elements 要按下标严格升序排列, 没有列出的元素都是 0.
+     *  @throws MTB::Exception 下标越界或者没有严格升序时 */
+    static owned<ArrayExpr> CreateSparse(ArrayType *array_type, SparseListT &&elements);
 
     explicit ArrayExpr(ArrayType *array_type);
     explicit ArrayExpr(ValueArrayT &&value_list);
@@ -439,6 +498,21 @@ public:
         return _element_list;
     }
 
+    /** @property is_sparse{get;} 元素是否存放在稀疏表里 */
+    bool is_sparse() const {
+        return _element_list.empty() && !_sparse_list.empty();
+    }
+    /** @property sparse_list{unsafe raw get;}
+     *  @brief 稀疏表. 数组被展开以后为空. */
+    SparseListT const &unsafe_get_sparse_list() const {
+        return _sparse_list;
+    }
+
+    /** @fn traverseNonZero(fn)
+     *  @brief 按下标升序遍历可能非零的元素, 不展开数组: 稀疏数组只遍历稀疏表,
+     *         稠密数组跳过空元素, 全零数组什么都不遍历. fn 返回 true 时停止. */
+    void traverseNonZero(SparseReadClosure fn) const;
+
     /** @fn contentAt(size_t index)
      *  @brief 数组取索引. 倘若遇到被0填充的子数组/子结构体，就展开。 */
     owned<Value> getContent(size_t index) final;
@@ -456,6 +530,9 @@ public:
     void reset() final;
 private:
     ValueArrayT _element_list;
+    SparseListT _sparse_list; // 只在稀疏状态下非空
+
+    void _expandSparse();
 }; // class ArrayExpr final
 using Array = ArrayExpr;
 
@@ -4,6 +4,7 @@
 #define __MYGL_IR_INSTRUCTION_H__
 
 #include "base/mtb-object.hxx"
+#include "base/mtb-arena.hxx"
 #include "base/mtb-getter-setter.hxx"
 #include "base/mtb-classed-enum.hxx"
 #include "base/mtb-exception.hxx"
@@ -75,6 +76,9 @@ public: /* TypeDefs and Metadata */
     TryCastToTerminator(Instruction const* self) {
         return TryCastToTerminator(const_cast<Instruction*>(self));
     }
+
+    /* 指令放在所属函数的竞技场里, 见 Function::get_arena() */
+    MTB_ARENA_OPERATORS
 public:
     /** @enum OpCode
      * @brief 指令的操作码。实际使用中你不需要管OpCode这个结构体的运算符重载是怎么样
@@ -108,6 +112,9 @@ public:
 
         MTB_MAKE_CLASSED_ENUM(OpCode)
         std::string_view getString() const;
+        /** @fn FromString(name) static
+         * @brief getString() 的逆运算. 名称不存在时返回 NONE. */
+        static OpCode FromString(std::string_view name);
 
         /** @brief 属性区: 表示该OpCode应该有哪些特征
          *
@@ -3,6 +3,7 @@
 
 #include "base/mtb-getter-setter.hxx"
 #include "base/mtb-object.hxx"
+#include "base/mtb-symbol.hxx"
 #include "ir-constant.hxx"
 #include "ir-constant-function.hxx"
 #include "irbase-type-context.hxx"
@@ -15,11 +16,12 @@ using namespace IRBase;
 using namespace MTB;
 
 /** @class Module
- * @brief MYGL-IR模块, 用于存放符号表、全局信息、IR结点树. */
+ * @brief MYGL-IR模块, 用于存放符号表、全局信息、IR结点树.
+ *        符号表以驻留后的 `MTB::Symbol` 为键, 接口仍然接受字符串. */
 class Module: public MTB::Object {
 public:
-    using GlobalVariableMapT = std::unordered_map<std::string, owned<GlobalVariable>>;
-    using FunctionMapT       = std::unordered_map<std::string, owned<Function>>;
+    using GlobalVariableMapT = std::unordered_map<Symbol, owned<GlobalVariable>>;
+    using FunctionMapT       = std::unordered_map<Symbol, owned<Function>>;
     using RefT               = MTB::owned<Module>;
 
     friend class     Value;
@@ -6,13 +6,19 @@
 #include "irbase-type.hxx"
 #include <cstddef>
 #include <deque>
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace MYGL::IRBase {
 
 /** @class TypeContext
- * @brief 一个简单的类型管理器，可以内嵌在Module里做类型管理，也可以全局使用。 */
+ * @brief 一个简单的类型管理器，可以内嵌在Module里做类型管理，也可以全局使用。
+ *
+ * 函数级并行优化时多个线程会同时向同一个 Module 的类型管理器要类型, 所以
+ * `getXXX`/`getOrRegisterType`/`hasType` 都在内部加锁. `type_set` 访问器直接
+ * 暴露内部表, 不受锁保护, 只能在单线程阶段使用. */
 class TypeContext {
 public:
     using TypePtrT = owned<Type>;
@@ -96,9 +102,63 @@ public:
 
     PointerType  *getPointerType(Type *target_type, bool is_constant = false);
 private:
+    /* 复合类型的驻留表. 键里的成员类型都是已经注册过的类型, 所以按指针比较就是
+     * 结构比较. 先查表再构造, 类型已经存在时不会分配临时对象. */
+    struct ArrayKey {
+        Type  *element;
+        size_t length;
+        bool operator==(ArrayKey const &) const = default;
+    }; // struct ArrayKey
+    struct PointerKey {
+        Type *target;
+        bool  is_constant;
+        bool operator==(PointerKey const &) const = default;
+    }; // struct PointerKey
+    /** 函数类型的键. 查表时用 FunctionKeyView 引用调用者的参数表, 不拷贝. */
+    struct FunctionKey {
+        Type              *return_type;
+        std::vector<Type*> param_list;
+        size_t             hash;
+    }; // struct FunctionKey
+    struct FunctionKeyView {
+        Type             *return_type;
+        FTypeListT const &param_list;
+        size_t            hash;
+    }; // struct FunctionKeyView
+    struct KeyHasher {
+        using is_transparent = void;
+        size_t operator()(ArrayKey const &key) const noexcept;
+        size_t operator()(PointerKey const &key) const noexcept;
+        size_t operator()(FunctionKey const &key) const noexcept { return key.hash; }
+        size_t operator()(FunctionKeyView const &key) const noexcept { return key.hash; }
+    }; // struct KeyHasher
+    struct FunctionKeyEqual {
+        using is_transparent = void;
+        bool operator()(FunctionKey const &lhs, FunctionKey const &rhs) const;
+        bool operator()(FunctionKeyView const &lhs, FunctionKey const &rhs) const;
+        bool operator()(FunctionKey const &lhs, FunctionKeyView const &rhs) const {
+            return (*this)(rhs, lhs);
+        }
+    }; // struct FunctionKeyEqual
+
+    using ArrayTypeMapT    = std::unordered_map<ArrayKey,   ArrayType*,   KeyHasher>;
+    using PointerTypeMapT  = std::unordered_map<PointerKey, PointerType*, KeyHasher>;
+    using FunctionTypeMapT = std::unordered_map<FunctionKey, FunctionType*,
+                                                KeyHasher, FunctionKeyEqual>;
+
+    static size_t hashFunctionKey(Type *return_type, FTypeListT const &param_list);
+    FunctionType *findFunctionType(Type *return_type, FTypeListT const &param_list,
+                                   size_t hash) const;
+    FunctionType *internFunctionType(owned<FunctionType> fty, size_t hash);
+
     TypeSet     _type_set;
     IntTypeMapT _optimized_int_type_map;
+    ArrayTypeMapT    _array_type_map;
+    PointerTypeMapT  _pointer_type_map;
+    FunctionTypeMapT _function_type_map;
     size_t  _machine_word_size;
+    /* 公有方法之间会互相调用(比如 getFunctionPointer -> getPointerType), 所以用递归锁 */
+    mutable std::recursive_mutex _lock;
 }; // class TypeContext
 
 } // namespace MYGL::IRBase
@@ -106,6 +106,17 @@ public:
     DEFINE_DEFAULT_FALSE_GETTER(is_pointer_type)
     DECLARE_ABSTRACT_GETTER(size_t, hash)
 
+    /** @property cached_hash{get;}
+     * @brief 第一次读取时计算 `hash` 并缓存. 类型注册进 TypeContext 以后就不应该再修改,
+     *        所以缓存不会过期; 复合类型的 hash 也由元素类型的缓存值组合而成. */
+    size_t get_cached_hash() const {
+        MTB_UNLIKELY_IF (!_hash_cached) {
+            _cached_hash = get_hash();
+            _hash_cached = true;
+        }
+        return _cached_hash;
+    }
+
     /* 类型实例的内存布局 */
     DEFINE_VIRTUAL_GETSET(size_t, instance_size)
     DEFINE_VIRTUAL_GETSET(size_t, instance_align)
@@ -131,11 +142,14 @@ protected:
     bool     _is_constant,   _is_callable;
     bool     _is_indexable,  _is_readable;
     uint8_t  _machine_word_size;
+    mutable bool   _hash_cached;
+    mutable size_t _cached_hash;
 
     explicit Type(TypeTID type_id, Type *base_type = nullptr) noexcept
         : _type_id(type_id), _base_type(base_type),
           _machine_word_size(global_machine_word_size),
-          _type_context(nullptr) {}
+          _type_context(nullptr),
+          _hash_cached(false), _cached_hash(0) {}
     explicit Type(TypeTID type_id, Type *base_type, TypeContext *ctx) noexcept;
 }; // class Type
 
@@ -465,10 +479,10 @@ public:
 
 struct TypeHasher {
     size_t operator()(owned<Type> const &type) const {
-        return type->get_hash();
+        return type->get_cached_hash();
     }
     size_t operator()(const Type *type) const {
-        return type->get_hash();
+        return type->get_cached_hash();
     }
 }; // struct TypeHasher
 struct TypeFullEqual {
@@ -4,15 +4,20 @@
 #include "base/mtb-exception.hxx"
 #include "base/mtb-getter-setter.hxx"
 #include "base/mtb-object.hxx"
+#include "base/mtb-arena.hxx"
 #include "base/mtb-reflist.hxx"
+#include "base/mtb-symbol.hxx"
 #include "irbase-type.hxx"
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <iterator>
 #include <list>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <variant>
 #include <vector>
 namespace MYGL::IRBase {
@@ -22,8 +27,69 @@ using namespace MTB;
 class Value;
 class User;
 class Use;
+class UseList;
 interface IValueVisitor;
 
+/** @class UseeList
+ * @brief Value 的使用者链表. 链表结点就嵌在 Use 里, 不需要额外分配.
+ *
+ * 每个 Use 记住"指向自己的那个指针"的地址, 所以从链表里摘除一个 Use 不需要知道它
+ * 挂在哪个 Value 上, 也不需要遍历链表. 新的 Use 插在链表头部, 遍历顺序与登记顺序
+ * 相反. */
+class UseeList {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = Use*;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = Use *const*;
+        using reference         = Use *const&;
+
+        iterator() noexcept: _cur(nullptr) {}
+        explicit iterator(Use *cur) noexcept: _cur(cur) {}
+
+        Use *const &operator*() const { return _cur; }
+        iterator &operator++();
+        iterator  operator++(int) { iterator ret = *this; ++*this; return ret; }
+        bool operator==(iterator const &rhs) const { return _cur == rhs._cur; }
+        bool operator!=(iterator const &rhs) const { return _cur != rhs._cur; }
+    private:
+        Use *_cur;
+    }; // class iterator
+    using const_iterator = iterator;
+public:
+    UseeList() noexcept: _head(nullptr) {}
+    UseeList(UseeList const &) = delete;
+    UseeList &operator=(UseeList const &) = delete;
+    /* Value 先于它的使用者析构时, 剩下的 Use 要和这个链表断开 */
+    ~UseeList() { clear(); }
+
+    iterator begin() const { return iterator{_head}; }
+    iterator end()   const { return iterator{}; }
+    iterator cbegin() const { return begin(); }
+    iterator cend()   const { return end(); }
+
+    bool empty() const { return _head == nullptr; }
+    Use *front() const { return _head; }
+    /** @fn size()
+     * @brief 统计使用者数量. 要遍历整个链表, 时间复杂度 O(n). */
+    size_t size() const;
+
+    /** @fn push_front(use)
+     * @brief 把 use 挂在链表头部. use 原先挂在别的链表上时会先被摘下来. */
+    void push_front(Use *use);
+    /** @fn remove(use)
+     * @brief 把 use 从链表里摘下来, O(1). use 没有挂在任何链表上时什么也不做. */
+    static void remove(Use *use);
+    /** @fn clear()
+     * @brief 把链表里的 Use 全部摘下来. Use 自己的链接也会清空, 它们之后析构时
+     *        不会再碰这个链表. */
+    void clear();
+private:
+    Use *_head;
+}; // class UseeList
+
 /** @enum ValueTID
  * @brief Value的RTTI枚举标识, 你可以叫它"运行时类型".
  *
@@ -75,7 +141,7 @@ enum class ValueTID: uint64_t {
 imcomplete class Value: public Object {
 public:
     using string_view = std::string_view;
-    using UseListT    = std::list<Use*>;
+    using UseListT    = UseeList;
     using UValueListT = std::list<Value*>;
     using ValueListT  = std::list<owned<Value>>;
     using ValueArrayT = std::vector<owned<Value>>;
@@ -137,17 +203,19 @@ public:
      * @brief 实例可复用性, uniquely_referenced的反义属性. */
     bool shares_representation() const { return !uniquely_referenced(); }
 
-    /** @property name{get;set;access;} virtual
+    /** @property name{get;set;} virtual
+     * @brief 名称驻留成 `MTB::Symbol` 存放, 同名的值共用一份字符串.
      * @warning MYGL不会验证两个Value的name是不是唯一的, 但是要保证任意两个Value
      *          的ID是唯一的。 */
-    virtual string_view get_name() const { return _name; }
-    virtual void set_name(string_view value) { _name = value; }
-    virtual std::string &name() { return _name; }
+    virtual string_view get_name() const { return _name.str(); }
+    virtual void set_name(string_view value) { _name = MTB::Symbol{value}; }
+    /** @property name_symbol{get;} 名称对应的符号, 比较名称时直接比较它 */
+    MTB::Symbol get_name_symbol() const { return _name; }
 
     /** @property name_or_id{get;} virtual
      * @brief 名称不为空时返回名称, 否则返回id. */
     virtual std::string get_name_or_id() const;
-    virtual std::string &initNameAsId();
+    virtual string_view initNameAsId();
 
     /** @property list_as_usee{get;access;}
      * @brief 作为操作数的链表, 记录有哪些 `Use` 关系使用了自己 */
@@ -159,23 +227,32 @@ public:
     /* Value不能自己动, 需要一个访问器来帮它完成成员访问操作 */
     virtual void accept(IValueVisitor &visitor) = 0;
 
-    void addUseAsUsee(Use *use) {
-        _list_as_usee.push_back(use);
-    }
+    /** @property is_use_list_shared{get;}
+     * @brief 使用链表是否会被多个函数同时修改. 常量、全局变量、函数这些模块级
+     *        的值可以同时被好几个函数的指令使用, 在函数级并行优化时需要加锁;
+     *        指令、基本块、参数只属于一个函数, 不需要. */
+    bool is_use_list_shared() const { return _use_list_shared; }
+
+    class ConcurrentUseScope;
+
+    void addUseAsUsee(Use *use);
     /** @fn removeUseAsUsee(Use)
      * @brief 移除一个使用自己当操作数的 `Use`. 由于每个 `Use`
      *        都是互斥的, 当一条指令有不止一个操作数为自己时, 因
-     *        为所处的 `Use` 不同, 自己只会被删除一次. */
-    void removeUseAsUsee(Use *use) {
-        _list_as_usee.remove(use);
-    }
+     *        为所处的 `Use` 不同, 自己只会被删除一次.
+     *        `Use` 自己记得链表位置, 所以这是常数时间操作. */
+    void removeUseAsUsee(Use *use);
 protected:
     ValueTID _type_id;      // 与RTTI类似，表示Value实例的类的ID
     Type    *_value_type;   // 每个Value都有一个类型, 这个类型被注册在TypeContext里
     UseListT _list_as_usee; // 被其他值使用的use列表
-    std::string _name;      // 名称, 可以不写
+    MTB::Symbol _name;      // 名称, 可以不写
     uint32_t    _id;        // 每个Value都有唯一ID.
     bool     _is_writable;  // 是否为可写,这个是用来标注全部变量这样在变量表里的
+    bool     _use_list_shared = false; // 使用链表是否跨函数共享, 见 is_use_list_shared
+
+    void _addSharedUseAsUsee(Use *use);
+    void _removeSharedUseAsUsee(Use *use);
 
     explicit Value(ValueTID type_id, Type *value_type)
         : Value(type_id, value_type, 0){}
@@ -183,102 +260,295 @@ protected:
 }; // imcomplete class Value
 
 /** @class Use
- * @brief 使用关系
- * TODO: 重构use-def关系，使得Use以结构体的形式存储在集合里。 */
-class Use: public Object {
+ * @brief 使用关系, 描述 User 里的一个操作数槽位.
+ *
+ * Use 不再持有闭包, 而是直接记住操作数在 User 里的存储位置(槽位), 读操作数就是一次
+ * 访存. 槽位可以是 `Value*` 这样的普通指针, 也可以是 `owned<Value>` 这样的引用计数
+ * 指针 -- 二者的内存布局都只有一个指针, 区别只在写入时要不要维护引用计数.
+ *
+ * 有些操作数在写入时还要顺带维护别的东西(比如基本块的 CFG 关系、Phi 的入口表),
+ * 这时 Use 会带一个设置钩子, 写操作交给钩子完成. 钩子只是普通函数指针, 不会再产生
+ * 堆上的闭包对象.
+ *
+ * Use 是单独分配(跟随 User 放在竞技场里)的对象, 没有嵌在 User 里:
+ * - usee 的使用者链表是侵入式的, 链表里的邻居直接指着 Use, 地址必须稳定;
+ * - `CallSSA::ArgUseTuple`、`SwitchSSA::BlockUsePair`、`Function::ArgUsePair`
+ *   这些地方长期持有 `Use*`, 而它们的槽位放在会扩容的 vector 里;
+ * - Phi、Switch、Call 的操作数个数可变, 嵌进 User 就得跟着槽位一起搬家.
+ * 代价是按操作数表读操作数要多一次访存. `bench/irbase-operand-read.cpp` 测的是
+ * 这一次访存和直接读成员的差距. */
+class Use {
 public:
     struct SetResult;
     using self_t = Use;
     using OperandRefT = owned<Value>;
+    using ListT = UseList;
 
-    /** @fn UseeSetHandle
-     * @brief  Usee setter 或清除工具.
+    /** @fn SetHook(user, use, value)
+     * @brief 槽位的设置钩子. 钩子负责写入槽位, 并维护 value 的 `list_as_usee`.
      * @return 当value == nullptr时, 表示是否应该移除Use. */
-    using UseeSetHandle = std::function<SetResult(Value *value)>;
-    using UseeGetHandle = std::function<Value*()>;
-    using ListT  = RefList<Use>;
-    using ProxyT = RefListProxy<Use>;
+    using SetHook = SetResult(*)(User *user, Use *use, Value *value);
+
+    /* 槽位可能是 `BasicBlock*`, `owned<Function>` 之类的派生类指针, 统一按
+     * `Value*` 读写. MYGL 的 Value 类都是单继承链, 基类子对象偏移恒为 0. */
+#if defined(__GNUC__) || defined(__clang__)
+    using SlotT [[gnu::may_alias]] = Value*;
+#else
+    using SlotT = Value*;
+#endif
+
+    /** @enum SlotKind
+     * @brief 槽位的指针种类. */
+    enum class SlotKind: uint8_t {
+        RAW_PTR,    // Value*, 不持有所有权
+        OWNED_PTR,  // owned<Value>, 写入时维护引用计数
+    }; // enum class SlotKind
 
     struct SetResult {
         bool use_dies;
     }; // struct SetResult
+
+    /* Use 跟随 User 放在当前竞技场里 */
+    MTB_ARENA_OPERATORS
 public:
-    Use(User *user, UseeGetHandle get_usee, UseeSetHandle set_usee);
-    /** @warning unsafe: 没有额外检查 */
-    Use(User *user, Value *&usee);
-    /** @warning unsafe: 没有额外检查 */
-    Use(User *user, owned<Value> &usee);
+    /** 没有挂在共享值上时的锁编号 */
+    static constexpr uint8_t NOT_SHARED = 0xff;
 
-    ~Use() override;
+    /** @warning unsafe: 没有额外检查 */
+    Use(User *user, SlotT *slot, SlotKind kind, SetHook set_hook = nullptr)
+        : _slot(slot), _user(user), _set_hook(set_hook),
+          _next_usee(nullptr), _prev_usee_next(nullptr), _kind(kind),
+          _usee_stripe(NOT_SHARED) {}
+    Use(Use const &) = delete;
+    Use &operator=(Use const &) = delete;
 
     /** @property usee{get;set;}
-     * @brief 被使用的值/操作数，由两个handle组成。
-     * 该属性调用的大部分set函数都会自动维护use-def关系，所以swapUseeOut好像没有存在的必要。
-     *
-     * @section 属性声明
+     * @brief 被使用的值/操作数. 读取是对槽位的直接访存.
      *
-     * 原版本的usee直接存储指针，后来改为存储`std::variant<Value**, owned<Value>*>`.
-     * 由于指针方案无法联动修改User子类的元素, Variant方案不能在修改时检查，所以该属性改成了
-     * 两个函数闭包 -- 一个getter一个setter.
+     * 写入时, 没有钩子的槽位由 Use 自己维护新旧 usee 的 `list_as_usee`;
+     * 有钩子的槽位交给钩子(通常是 User 的 set_xxx 方法)完成, 以便做类型检查
+     * 和 CFG 维护.
      *
-     * @note User.addValue{()=>Value, (value)=>void}
-     * @note User.addUncheckedValue(Value *&value)
-     * @note User.addUncheckedValue(owned<Value> &value) */
-    Value *get_usee() const { return _get_handle(); }
+     * @note User.addValue(Value *&slot, hook = null)
+     * @note User.addValue(owned<Value> &slot, hook = null) */
+    Value *get_usee() const { return *_slot; }
     /** @note 属性usee */
-    void set_usee(Value *usee) { _set_handle(usee); }
+    void set_usee(Value *usee);
     /** @note 属性usee
      * @fn remove_usee
      * @brief 清除该Usee.
-     * @ */
+     * @return 钩子要求移除该 Use 时, Use 会从 User 的操作数表中删除并返回 true.
+     *         此后不能再访问这个 Use. */
     bool remove_usee();
 
-    /** @property user{get;set;}
+    /** @property user{get;}
      * @brief 使用Usee的值. */
     User *get_user() const { return _user; }
 
+    /** @property slot{get;} */
+    SlotT   *get_slot()     const { return _slot; }
+    /** @property slot_kind{get;} */
+    SlotKind get_slot_kind() const { return _kind; }
+    /** @property set_hook{get;} */
+    SetHook  get_set_hook() const { return _set_hook; }
+    /** @fn owned_slot()
+     * @brief 把 `OWNED_PTR` 槽位当作 owned<Value> 访问, 供设置钩子写入槽位. */
+    owned<Value> &owned_slot() const {
+        return *reinterpret_cast<owned<Value>*>(_slot);
+    }
+
     /** @fn swapUseeOut
      * @brief 把usee属性换成new_usee。该方法会自动维护usee的use关系. */
     owned<Value> swapUseeOut(Value *new_usee);
 
-/** Use as RefList<Use>.Node */
-    ListT::Iterator get_iterator() {
-        return _proxy.get_iterator();
-    }
-    ListT::Modifier get_modifier() {
-        return ListT::Modifier{get_iterator()};
-    }
-    ProxyT &reflist_item_proxy() { return _proxy; }
+    /** @property next_usee{get;}
+     * @brief 同一个 usee 的使用者链表里的下一个 Use. */
+    Use *get_next_usee() const { return _next_usee; }
+    /** @property linked_as_usee{get;}
+     * @brief 是否挂在某个 usee 的使用者链表上. */
+    bool is_linked_as_usee() const { return _prev_usee_next != nullptr; }
 protected:
+    friend class Value;
     friend class User;
+    friend class UseList;
+    friend class UseeList;
+    /** 还挂在 usee 的使用者链表上时先摘下来, 链表里的邻居才不会指向已释放的内存.
+     *  摘除只用 Use 自己记下的链表位置, 不读槽位 -- 这时槽位可能已经随 User 析构了.
+     *  挂在共享值上时也不能问 usee 要锁, 所以挂上去的时候记下锁的编号. */
+    ~Use();
     void set_user(User *user) { _user = user; }
 
-    User           *_user;
-    UseeGetHandle   _get_handle;
-    UseeSetHandle   _set_handle;
-    ProxyT          _proxy;
+    SlotT   *_slot;
+    User    *_user;
+    SetHook  _set_hook;
+    Use     *_next_usee;      // 使用者链表的后继
+    Use    **_prev_usee_next; // 指向自己的那个指针(前驱的 _next_usee 或链表头)
+    SlotKind _kind;
+    uint8_t  _usee_stripe;    // 挂在共享值上时是那个值的锁编号, 否则是 NOT_SHARED
 }; // class Use
 
+/** @class Value::ConcurrentUseScope
+ * @brief 函数级并行区间. 作用域存活期间, 共享值(见 `is_use_list_shared`)的使用
+ *        链表增删会经过按地址分段的互斥锁. 可以嵌套, 不在任何作用域内时不加锁.
+ *
+ * 销毁一个还挂在共享值上的 Use(比如 SCCP 换掉以 true/false 为条件的跳转)
+ * 也会拿同一把锁.
+ *
+ * @warning 只保护链表的增删. 在并行区间里遍历共享值的使用链表(比如对常量做
+ *          `usee_replace_this_with`)仍然是不安全的. */
+class Value::ConcurrentUseScope {
+public:
+    ConcurrentUseScope() noexcept {
+        _nactive.fetch_add(1, std::memory_order_relaxed);
+    }
+    ~ConcurrentUseScope() {
+        _nactive.fetch_sub(1, std::memory_order_relaxed);
+    }
+    ConcurrentUseScope(ConcurrentUseScope const &) = delete;
+    ConcurrentUseScope &operator=(ConcurrentUseScope const &) = delete;
+
+    /** @property is_active{get;} static */
+    static bool is_active() noexcept {
+        return _nactive.load(std::memory_order_relaxed) != 0;
+    }
+private:
+    static std::atomic_int _nactive;
+}; // class Value::ConcurrentUseScope
+
+/* ========== [UseeList inline methods] ========== */
+inline UseeList::iterator &UseeList::iterator::operator++() {
+    _cur = _cur->_next_usee;
+    return *this;
+}
+inline void UseeList::push_front(Use *use)
+{
+    if (use->_prev_usee_next != nullptr)
+        remove(use);
+    use->_next_usee = _head;
+    if (_head != nullptr)
+        _head->_prev_usee_next = &use->_next_usee;
+    use->_prev_usee_next = &_head;
+    _head = use;
+}
+inline void UseeList::remove(Use *use)
+{
+    Use **pprev = use->_prev_usee_next;
+    if (pprev == nullptr)
+        return;
+    Use *next = use->_next_usee;
+    *pprev = next;
+    if (next != nullptr)
+        next->_prev_usee_next = pprev;
+    use->_next_usee      = nullptr;
+    use->_prev_usee_next = nullptr;
+    use->_usee_stripe    = Use::NOT_SHARED;
+}
+
+/* ========== [Value inline methods] ========== */
+inline void Value::addUseAsUsee(Use *use)
+{
+    MTB_UNLIKELY_IF (_use_list_shared)
+        return _addSharedUseAsUsee(use);
+    _list_as_usee.push_front(use);
+}
+inline void Value::removeUseAsUsee(Use *use)
+{
+    MTB_UNLIKELY_IF (_use_list_shared && ConcurrentUseScope::is_active())
+        return _removeSharedUseAsUsee(use);
+    UseeList::remove(use);
+}
+
+/** @class UseList
+ * @brief User 的操作数表, 按操作数顺序存放 Use 指针, 拥有这些 Use.
+ *
+ * 操作数不多于 `INLINE_CAPACITY` 个时指针直接存放在 User 对象内部, 不需要额外的
+ * 堆分配; 只有 Phi、Switch、Call 这类操作数可变长的 User 才会溢出到堆上. */
+class UseList {
+public:
+    static constexpr uint32_t INLINE_CAPACITY = 3;
+    using iterator       = Use *const *;
+    using const_iterator = Use *const *;
+public:
+    UseList() noexcept
+        : _data(_inline), _size(0), _capacity(INLINE_CAPACITY) {}
+    UseList(UseList const &) = delete;
+    UseList &operator=(UseList const &) = delete;
+    ~UseList();
+
+    size_t size()  const { return _size; }
+    bool   empty() const { return _size == 0; }
+
+    /** @fn at(index) const
+     * @throw std::out_of_range 当 index 超出界限时丢出该异常. */
+    Use *at(size_t index) const;
+    Use *operator[](size_t index) const { return _data[index]; }
+    Use *front() const { return _data[0]; }
+    Use *back()  const { return _data[_size - 1]; }
+
+    iterator begin() const { return _data; }
+    iterator end()   const { return _data + _size; }
+
+    /** @fn append(use)
+     * @brief 把 use 追加到操作数表末尾, 之后由操作数表负责销毁它. */
+    void append(Use *use);
+    /** @fn remove(use)
+     * @brief 从操作数表中移除并销毁 use. 后面的操作数下标会前移.
+     * @return use 不在表里时返回 false. */
+    bool remove(Use *use);
+    /** @fn clear()
+     * @brief 销毁所有 Use. 不维护它们的 usee 的 `list_as_usee`. */
+    void clear();
+private:
+    Use    **_data;
+    uint32_t _size, _capacity;
+    Use     *_inline[INLINE_CAPACITY];
+}; // class UseList
+
 imcomplete class User: public Value {
 public:
     using OwnedUseListT = Use::ListT;
+    using SetHook       = Use::SetHook;
 
     ~User() override;
 public:
     /** @property list_as_user{get;access;}
-     *  @brief 操作数链表, 存储使用关系. */
+     *  @brief 操作数表, 存储使用关系. */
     Use::ListT const &get_list_as_user() const { return _list_as_user; }
     /** @fn list_as_user()
      * @see property:list_as_user */
     Use::ListT &      list_as_user()           { return _list_as_user; }
 
-    bool addUseAsUser(owned<Use> use);
+    /** @fn addUseAsUser(use)
+     * @brief 把一个已经构造好的 Use 挂到操作数表末尾. 不会登记到 usee 的
+     *        `list_as_usee` 里. */
+    bool addUseAsUser(Use *use);
+    /** @fn removeUseAsUser(use)
+     * @brief 从操作数表中移除并销毁 use. 调用者要先把它从 usee 的
+     *        `list_as_usee` 里摘掉. */
     bool removeUseAsUser(Use *use);
 
-    Use *addValue(Use::UseeGetHandle get_usee, Use::UseeSetHandle set_usee);
+    /** @fn addValue(slot, set_hook = null)
+     * @brief 以 slot 为槽位创建一个 Use, 追加到操作数表末尾. 倘若槽位当前
+     *        已经有值, 同时把该 Use 登记到这个值的 `list_as_usee` 里. */
+    Use *addValue(Value *&slot, SetHook set_hook = nullptr);
+    /** @see addValue(Value *&slot, set_hook) */
+    Use *addValue(owned<Value> &slot, SetHook set_hook = nullptr);
+
+    template<typename ValueT>
+    requires (std::is_base_of_v<Value, ValueT> && !std::is_same_v<Value, ValueT>)
+    Use *addValue(ValueT *&slot, SetHook set_hook = nullptr) {
+        return _addSlot(reinterpret_cast<Use::SlotT*>(&slot),
+                        Use::SlotKind::RAW_PTR, set_hook);
+    }
+    template<typename ValueT>
+    requires (std::is_base_of_v<Value, ValueT> && !std::is_same_v<Value, ValueT>)
+    Use *addValue(owned<ValueT> &slot, SetHook set_hook = nullptr) {
+        return _addSlot(reinterpret_cast<Use::SlotT*>(&slot.__ptr),
+                        Use::SlotKind::OWNED_PTR, set_hook);
+    }
 
-    Use *addUncheckedValue(Value *&value);
-    Use *addUncheckedValue(owned<Value> &value);
+    Use *addUncheckedValue(Value *&value)       { return addValue(value); }
+    Use *addUncheckedValue(owned<Value> &value) { return addValue(value); }
 
     void clearUseAsUser();
     virtual size_t replaceAllUsee(Value *pattern, Value *new_usee);
@@ -286,8 +556,16 @@ protected:
     OwnedUseListT _list_as_user;
 
     explicit User(ValueTID type_id, Type *value_type);
-}; // imcomplete class User
 
+    /** @fn rebindSlot(use, slot)
+     * @brief 操作数存放在会搬家的容器(比如 vector)里时, 容器搬家以后用它把 Use
+     *        重新指向新的槽位. 槽位里的值不变, 所以不用动 `list_as_usee`. */
+    static void rebindSlot(Use *use, owned<Value> &slot) {
+        use->_slot = &slot.__ptr;
+    }
+private:
+    Use *_addSlot(Use::SlotT *slot, Use::SlotKind kind, SetHook set_hook);
+}; // imcomplete class User
 struct ValueUsePair {
     owned<Value> value;
     Use         *use;
@@ -320,39 +598,33 @@ public:
 
 } // namespace MYGL::IRBase
 
-#if __cplusplus >= 202002L || defined(_USE_ISOC23)
-#define MYGL_ADD_USEE_PROPERTY(property, ...) \
-    addValue([this __VA_OPT__(,) __VA_ARGS__](){ return get_##property(); },\
-             [this __VA_OPT__(,) __VA_ARGS__](Value *usee){\
-                set_##property(usee);\
-                return Use::SetResult{false};\
-             })
-#else
+/** @def MYGL_ADD_USEE_PROPERTY(property)
+ * @brief 把成员 `_property` 登记为一个操作数槽位. 读写都直接作用在成员上. */
 #define MYGL_ADD_USEE_PROPERTY(property) \
-    addValue([this](){ return get_##property(); },\
-             [this](Value *usee){\
-                set_##property(usee);\
-                return Use::SetResult{false};\
-             })
-#endif
+    addValue(_##property)
 
+/** @def MYGL_ADD_TYPED_USEE_PROPERTY(Type, property)
+ * @brief 把成员 `_property` 登记为操作数槽位, 写入时经由 `set_property()` 完成,
+ *        类型不是 Type 的值会被忽略. */
 #define MYGL_ADD_TYPED_USEE_PROPERTY(Type, property) \
-    addValue([this](){ return get_##property(); },\
-             [this](Value *usee)-> Use::SetResult { \
+    addValue(_##property,\
+             [](User *user, Use *, Value *usee)-> Use::SetResult {\
+                using SelfT = std::remove_pointer_t<decltype(this)>;\
                 Type* tusee = dynamic_cast<Type*>(usee);\
                 if ((tusee == nullptr) != (usee == nullptr))\
                     return Use::SetResult{false};\
-                set_##property(tusee);\
+                static_cast<SelfT*>(user)->set_##property(tusee);\
                 return Use::SetResult{false};\
              })
 #define MYGL_ADD_TYPED_USEE_PROPERTY_FINAL(Type, VALUE_TID, property)\
-    addValue([this](){ return get_##property(); },\
-            [this](Value *usee)-> Use::SetResult { \
+    addValue(_##property,\
+             [](User *user, Use *, Value *usee)-> Use::SetResult {\
+                using SelfT = std::remove_pointer_t<decltype(this)>;\
                 if (usee != nullptr &&\
                     usee->get_type_id() != ValueTID::VALUE_TID)\
                     return Use::SetResult{false};\
                 Type* tusee = static_cast<Type*>(usee);\
-                set_##property(tusee);\
+                static_cast<SelfT*>(user)->set_##property(tusee);\
                 return Use::SetResult{false};\
-            })
+             })
 #endif
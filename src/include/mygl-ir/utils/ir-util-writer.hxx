@@ -4,17 +4,30 @@
 #include "base/mtb-getter-setter.hxx"
 #include "base/mtb-object.hxx"
 #include "base/mtb-exception.hxx"
+#include "base/mtb-text-buffer.hxx"
 #include "mygl-ir/ir-instruction.hxx"
 #include "mygl-ir/ir-basic-value.hxx"
 #include "mygl-ir/ir-constant.hxx"
 #include "mygl-ir/ir-module.hxx"
 #include "mygl-ir/irbase-value-visitor.hxx"
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 namespace MYGL::IRUtil {
 using namespace IR;
 using namespace IRBase;
 using namespace MTB;
 
+/** @class Writer
+ * @brief 把模块写成 MYGL-IR 文本. 所有文本先追加进一块 `TextBuffer`, 写完整个
+ *        模块以后再一次性交给输出流或者文件描述符.
+ *
+ * 全局变量和函数都按名称排序输出, 所以同一个模块的输出是确定的. 函数体可以在
+ * 多个线程上分别生成, 最后按顺序拼接, 结果和串行生成完全一样. 当
+ * `__MTB_OBJECT_ATOMIC_REFCOUNT__` 为 0 时总是串行生成. */
 class Writer: public MTB::Object,
               public IRBase::IValueVisitor {
 public:
@@ -27,10 +40,10 @@ public:
         _module = std::move(module);
     }
 
-    /** @property stream{get;set;} */
-    std ::ostream &get_stream() const { return *_stream; }
-    void set_stream(std ::ostream &stream) { _stream = &stream; }
-    std::ostream &stream() { return *_stream; }
+    /** @property buffer{get;access;}
+     *  @brief 输出缓冲区. `write` 系列方法会先清空它. */
+    TextBuffer const &get_buffer() const { return _buffer; }
+    TextBuffer &      buffer()           { return _buffer; }
 
     /** @property indent{get;set;}
      *  @brief 缩进系数, 表示要缩进多少个tab. */
@@ -49,30 +62,45 @@ public:
         _shows_alias_target = shows_alias_target;
     }
 
+    /** @property nthreads{get;set;}
+     *  @brief 生成函数体的线程数. 0 表示取硬件线程数, 1 表示在调用线程上串行生成.
+     *         默认为 1, 要并行生成的调用者自己设置. */
+    size_t get_nthreads() const       { return _nthreads; }
+    void   set_nthreads(size_t value) { _nthreads = value; }
+
     void add_indent() { _indent++; }
     void dec_indent() { _indent--; }
     void indent() {
-        for (int i = 0; i < get_indent(); i++)
-            stream() << _indent_space;
+        _buffer.appendRepeat(_indent_space, _indent);
     }
     void wrap_indent() {
-        stream() << std::endl; indent();
+        _buffer.append('\n');
+        indent();
     }
 
-    void write(std::ostream &stream)
-    {
-        set_stream(stream);
-        if (_module == nullptr)
-            throw NullException("module");
-        visit(get_module());
-        /* 同步缓冲区 */
-        stream.flush();
-    }
+    /** @fn render()
+     * @brief 把整个模块生成到 buffer 里.
+     * @return buffer 的内容, 下一次写入前有效.
+     * @throws NullException 当 module 为 null 时 */
+    std::string_view render();
+
+    /** @fn write(stream)
+     * @brief 生成整个模块, 然后一次性写入 stream. */
+    void write(std::ostream &stream);
+    /** @fn writeTo(fd)
+     * @brief 生成整个模块, 然后写入文件描述符 fd, 通常只有一次 `write(2)`.
+     * @return 写入失败时返回 false, errno 保留失败原因. */
+    bool writeTo(int fd);
+    /** @fn writeToFile(path)
+     * @brief 生成整个模块, 然后覆盖写入文件 path.
+     * @return 打开或写入失败时返回 false, errno 保留失败原因. */
+    bool writeToFile(std::string const &path);
 
     void visit(IntConst   *value) override;
     void visit(FloatConst *value) override;
     void visit(ZeroConst  *value) override;
     void visit(UndefinedConst *value) override;
+    void visit(PoisonConst *value) override;
     void visit(Array      *value) override;
     void visit(Function   *value) override;
     void visit(GlobalVariable *value) override;
@@ -90,27 +118,53 @@ public:
     void visit(JumpSSA    *value) override;
     void visit(BranchSSA  *value) override;
     void visit(SwitchSSA  *value) override;
+    void visit(BinarySelectSSA   *value) override;
     void visit(CallSSA    *value) override;
     void visit(ReturnSSA  *value) override;
-    void visit(GetElemPtrSSA *value) override;
+    void visit(GetElemPtrSSA  *value) override;
+    void visit(ExtractElemSSA *value) override;
+    void visit(InsertElemSSA  *value) override;
     void visit(StoreSSA   *value) override;
     void visit(CompareSSA *value) override;
     /* Module */
     void visit(Module    *module) override;
 private:
+    using TypeNameMapT = std::unordered_map<Type*, std::string>;
+    using SlotMapT     = std::unordered_map<Value*, uint32_t>;
+    using DefNameMapT  = std::unordered_map<Value*, std::string_view>;
+
     owned<Module>  _module;
-    std::ostream  *_stream;
+    TextBuffer     _buffer;
     size_t         _indent;
     std::string    _indent_space;
     bool           _llvm_compatible;
     bool           _shows_alias_target;
+    size_t         _nthreads;
+    TypeNameMapT   _type_names;
+    SlotMapT       _slots;      // 当前函数里没有名字的局部值的编号
+    DefNameMapT    _def_names;  // 没有名字的全局定义在模块里登记的名称
 
     /** @fn _write_operand(value)
      * @brief 根据引用唯一性等性质把 User 的操作数格式化为字符串. */
     void _write_operand(Value *operand);
-
+    /** @fn _write_typed_operand(value)
+     * @brief 写入 `<type> <operand>` */
+    void _write_typed_operand(Value *operand);
+    /** @fn _write_name(prefix, value)
+     * @brief 写入 `<prefix><name>`, 不构造临时字符串. 没有名字时依次使用函数内
+     *        编号、模块里登记的名称和 id. prefix 为 '\0' 时不写前缀. */
+    void _write_name(char prefix, Value *value);
+    /** @fn _number_slots(fn)
+     * @brief 给 fn 里没有名字的参数、基本块和指令按出现顺序编号. */
+    void _number_slots(Function *fn);
+    /** @fn _write_type(type)
+     * @brief 写入类型名. 类型名在第一次用到时生成, 之后从缓存里取. */
+    void _write_type(Type *type);
+    /** @fn _write_functions(fn_list)
+     * @brief 依次写入 fn_list 里的函数, 可能在多个线程上分别生成. */
+    void _write_functions(std::vector<Function*> const &fn_list);
 }; // class Writer
 
 }; // namespace MYGL::IRUtil
 
-#endif
\ No newline at end of file
+#endif
@@ -27,4 +27,11 @@ namespace MYGL::IRUtil::BasicBlock {
     [[nodiscard("请不要忽略可能返回的 RecomposeError 错误.")]]
     RecomposeError recompose(IR::BasicBlock *current);
 
+    /** @fn replace_terminator(block, terminator)
+     * @brief 把 block 的终止指令换成 terminator. 和 `BasicBlock::set_terminator` 不同,
+     *        旧的终止指令对条件、跳转目标等操作数的使用关系会一并解除, 不会留在
+     *        这些值的 `list_as_usee` 里.
+     *        调用者要自己处理 block 不再跳转的后继里 PhiSSA 的入口. */
+    void replace_terminator(IR::BasicBlock *block, MTB::owned<IR::Instruction> terminator);
+
 } // namespace MYGL::IRUtil::BasicBlock
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+#ifndef __MYGL_IRUTIL_BITCODE_H__
+#define __MYGL_IRUTIL_BITCODE_H__
+
+#include "base/mtb-exception.hxx"
+#include "base/mtb-object.hxx"
+#include "mygl-ir/ir-module.hxx"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+/** @file irutil-bitcode.hxx
+ * @brief MYGL-IR 模块的二进制格式. 用于在编译的不同阶段之间缓存 IR, 读入时
+ *        直接重建 Module / Function / BasicBlock, 不经过文本解析器.
+ *
+ * 格式(整数都是 LEB128 变长编码, 字符串是 "长度 + 字节"):
+ * - 文件头: 魔数 `MYBC`, 版本号, 机器字长, 模块名.
+ * - 类型表: 模块用到的所有类型, 被依赖的类型排在前面, 之后都用下标引用类型.
+ * - 定义表: 按名称排序的全局变量头与函数头.
+ * - 常量池: 指令和全局变量初始值用到的常量. 数组常量引用池里排在它前面的元素,
+ *   函数与全局变量引用定义表.
+ * - 全局变量初始值: 常量池下标.
+ * - 函数体: 每个函数定义一段, 段首是段长. 入口基本块排在第一个, 参数和指令按
+ *   出现顺序编号, 指令操作数用"当前编号 - 操作数编号"的相对编号表示, 所以大多数
+ *   操作数只占一个字节. 引用后面才定义的值(比如 phi 的回边)时额外记录值类型.
+ *
+ * 不支持非 SSA 的 `MoveInst` 以及 `memmove`/`memset` 内部指令, 遇到时抛出
+ * `BitcodeException`. */
+namespace MYGL::IRUtil {
+
+    /** @class BitcodeException
+     * @brief 写入了不支持的 IR, 或者读到了损坏/版本不符的二进制数据. */
+    class BitcodeException: public MTB::Exception {
+    public:
+        BitcodeException(std::string_view msg,
+                         MTB::SourceLocation location = CURRENT_SRCLOC)
+            : MTB::Exception(MTB::ErrorLevel::CRITICAL, msg, location) {}
+    }; // class BitcodeException
+
+    /** @class LinkException
+     * @brief 链接的模块之间有冲突: 同名定义重复, 或者同名符号的类型对不上. */
+    class LinkException: public MTB::Exception {
+    public:
+        LinkException(std::string_view msg,
+                      MTB::SourceLocation location = CURRENT_SRCLOC)
+            : MTB::Exception(MTB::ErrorLevel::CRITICAL, msg, location) {}
+    }; // class LinkException
+
+    /** @fn write_bitcode(module)
+     * @brief 把 module 序列化成二进制格式. 同一个模块的输出是确定的.
+     * @throws NullException    当 module 为 null 时
+     * @throws BitcodeException 当 module 含有不支持的指令或者类型时 */
+    extern std::vector<uint8_t> write_bitcode(IR::Module *module);
+
+    /** @fn write_bitcode_file(module, path)
+     * @brief 序列化 module 并一次性写入文件 path.
+     * @throws BitcodeException 写文件失败时也会抛出该异常 */
+    extern void write_bitcode_file(IR::Module *module, std::string const &path);
+
+    /** @fn read_bitcode(bytes)
+     * @brief 从 write_bitcode() 的输出重建模块. bytes 只在调用期间被读取.
+     * @throws BitcodeException 当 bytes 不是合法的二进制模块时 */
+    extern MTB::owned<IR::Module> read_bitcode(std::span<uint8_t const> bytes);
+
+    /** @fn read_bitcode_file(path)
+     * @brief 把文件 path 映射进内存(mmap)后调用 read_bitcode(), 不做额外拷贝.
+     * @throws BitcodeException 打开或映射文件失败时也会抛出该异常 */
+    extern MTB::owned<IR::Module> read_bitcode_file(std::string const &path);
+
+    /** @fn link_bitcode(target, bytes)
+     * @brief 把 write_bitcode() 输出的模块合并进已有的模块 target. 同名的函数和
+     *        全局变量合并成一个: 声明遇到定义时变成定义, 两个定义则是冲突.
+     *        类型全部重新登记到 target 的类型管理器里.
+     * @throws BitcodeException 当 bytes 不是合法的二进制模块时
+     * @throws LinkException    当 bytes 里的定义和 target 里的冲突时. 此时 target
+     *                          可能已经合并了一部分定义, 不应该再使用 */
+    extern void link_bitcode(IR::Module *target, std::span<uint8_t const> bytes);
+    /** @fn link_modules(name, modules)
+     * @brief 把若干模块链接成一个名为 name 的新模块. 原来的模块保持不变.
+     *        模块之间的类型和值互不共享, 所以合并时先序列化成二进制格式再读进新模块.
+     * @throws LinkException 见 link_bitcode() */
+    extern MTB::owned<IR::Module> link_modules(std::string_view name,
+                                               std::span<IR::Module* const> modules);
+
+} // namespace MYGL::IRUtil
+
+#endif
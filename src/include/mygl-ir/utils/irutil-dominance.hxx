@@ -0,0 +1,126 @@
+#pragma once
+#ifndef __MYGL_IRUTIL_DOMINANCE_H__
+#define __MYGL_IRUTIL_DOMINANCE_H__
+
+#include "mygl-ir/ir-basicblock.hxx"
+#include "mygl-ir/ir-constant-function.hxx"
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace MYGL::IRUtil {
+
+    /** @class DominatorTree
+     * @brief 函数的支配树与支配边界.
+     *
+     * 构建时从入口开始深度优先遍历, 给每个可达基本块一个稠密编号(先序号, 入口是 0),
+     * 之后所有数据都是按编号下标的数组. 直接支配者用 Semi-NCA 算法求出, 复杂度
+     * O(E log V), 遍历和路径压缩都不递归, 十万级别深度的控制流图也不会爆栈.
+     * 支配关系查询借助支配树上的先序区间, 是 O(1) 的. 支配边界第一次查询时才计算.
+     *
+     * 不可达的基本块不在树里: 它们的编号是 `NPOS`, 直接支配者是 null, 谁也不支配它们.
+     *
+     * 支配树构建好以后就是只读的. 控制流图变了以后它不会更新自己, 而是过期
+     * (见 `is_valid`), 通过 `Get(fn)` 获取时会自动重建.
+     *
+     * @warning 支配边界是惰性计算的, 和函数本身一样, 同一棵树不要在多个线程上
+     *          同时查询支配边界. */
+    class DominatorTree {
+    public:
+        using PtrT       = std::shared_ptr<DominatorTree const>;
+        using BlockListT = std::vector<IR::BasicBlock*>;
+        using BlockSpanT = std::span<IR::BasicBlock* const>;
+
+        /** 不可达基本块的编号 */
+        static constexpr uint32_t NPOS = UINT32_MAX;
+    public:
+        /** @fn Get(fn) static
+         * @brief 取函数定义 fn 上缓存的支配树. 没有缓存或者缓存已经过期时重新构建,
+         *        并把新的树缓存到 fn 上.
+         * @throws NullException 当 fn 为 null 或者是函数声明时 */
+        static PtrT Get(IR::Function *fn);
+
+        /** @fn Build(fn) static
+         * @brief 构建函数定义 fn 的支配树, 不读也不写 fn 上的缓存.
+         * @throws NullException 当 fn 为 null 或者是函数声明时 */
+        static PtrT Build(IR::Function *fn);
+    public:
+        explicit DominatorTree(IR::Function *fn);
+
+        /** @property function{get;} */
+        IR::Function *get_function() const { return _function; }
+        /** @property cfg_version{get;} 构建时函数控制流图的版本号 */
+        uint64_t get_cfg_version() const { return _cfg_version; }
+        /** @property is_valid{get;} 函数的控制流图在构建以后有没有变过 */
+        bool is_valid() const { return _function->get_cfg_version() == _cfg_version; }
+
+        /** @property nblocks{get;} 可达基本块的个数 */
+        size_t get_nblocks() const { return _blocks.size(); }
+        /** @property entry{get;} */
+        IR::BasicBlock *get_entry() const { return _blocks.front(); }
+
+        /** @property preorder{get;} 按编号排列的可达基本块, 即深度优先遍历的先序 */
+        BlockListT const &get_preorder() const { return _blocks; }
+        /** @property reverse_postorder{get;} 可达基本块的逆后序, 入口排在第一个.
+         *        除了回边, 每条边都从前面的块指向后面的块. */
+        BlockListT const &get_reverse_postorder() const { return _rpo; }
+
+        /** @fn indexOf(block) 基本块的稠密编号, 不可达时是 NPOS */
+        uint32_t indexOf(IR::BasicBlock const *block) const;
+        /** @fn blockAt(index) 编号为 index 的基本块 */
+        IR::BasicBlock *blockAt(uint32_t index) const { return _blocks[index]; }
+        bool is_reachable(IR::BasicBlock const *block) const { return indexOf(block) != NPOS; }
+
+        /** @fn get_idom(block)
+         * @brief block 的直接支配者. 入口和不可达的基本块没有直接支配者, 返回 null. */
+        IR::BasicBlock *get_idom(IR::BasicBlock const *block) const;
+        /** @fn get_idom_index(index) 编号版本, 入口的直接支配者是 NPOS */
+        uint32_t get_idom_index(uint32_t index) const { return _idom[index]; }
+
+        /** @fn get_children(block) 支配树上 block 的子结点, 也就是以 block 为直接支配者的块 */
+        BlockSpanT get_children(IR::BasicBlock const *block) const;
+
+        /** @fn dominates(a, b)
+         * @brief a 是否支配 b. 每个可达的块都支配它自己; 不可达的块谁也不支配. */
+        bool dominates(IR::BasicBlock const *a, IR::BasicBlock const *b) const;
+        /** @fn dominates(a, inst) a 是否支配指令 inst 所在的基本块 */
+        bool dominates(IR::BasicBlock const *a, IR::Instruction const *inst) const;
+        /** @fn strictlyDominates(a, b) a 支配 b 并且 a != b */
+        bool strictlyDominates(IR::BasicBlock const *a, IR::BasicBlock const *b) const {
+            return a != b && dominates(a, b);
+        }
+
+        /** @fn get_frontier(block)
+         * @brief block 的支配边界: block 支配它的某个前驱、但是不严格支配它自己的块.
+         *        结果按编号从小到大排列. 第一次调用时计算整个函数的支配边界. */
+        BlockSpanT get_frontier(IR::BasicBlock const *block) const;
+    private:
+        IR::Function *_function;
+        uint64_t      _cfg_version;
+
+        BlockListT _blocks;     // 编号 -> 基本块
+        BlockListT _rpo;
+        std::unordered_map<IR::BasicBlock const*, uint32_t> _index;
+        std::vector<uint32_t> _idom;
+
+        /* 支配树的子结点表, 压缩成一维: 结点 i 的子结点是
+         * _children[_child_begin[i] .. _child_begin[i + 1]) */
+        std::vector<uint32_t>   _child_begin;
+        BlockListT              _children;
+        /* 支配树先序区间. a 支配 b 当且仅当 b 的先序号落在 [_tree_in[a], _tree_in[a] + _tree_size[a]) */
+        std::vector<uint32_t>   _tree_in, _tree_size;
+
+        /* 支配边界, 布局同子结点表. 惰性计算 */
+        mutable bool                  _has_frontier = false;
+        mutable std::vector<uint32_t> _frontier_begin;
+        mutable BlockListT            _frontier;
+
+        void _build();
+        void _computeFrontier() const;
+    }; // class DominatorTree
+
+} // namespace MYGL::IRUtil
+
+#endif
@@ -1,7 +1,7 @@
 #ifndef __MYGL_IR_UTIL_FUNCTION_H__
 #define __MYGL_IR_UTIL_FUNCTION_H__
 
-#include "ir-constant-function.hxx"
+#include "mygl-ir/ir-constant-function.hxx"
 
 namespace MYGL::IRUtil::Function {
 
@@ -27,9 +27,13 @@ public:
 DirectCopyResult direct_copy(IR::Function* func, std::string_view new_name);
 
 /** @fn gc_mark_sweep(function)
- * @brief 从入口基本块开始扫描函数的 CFG 和数据流关系, 遇到不可达
- *        且没有数据流关系的基本块时, 就删除这些基本块. */
-void gc_mark_sweep(IR::Function *function);
+ * @brief 从入口基本块开始扫描函数的 CFG, 删除所有不可达的基本块.
+ *
+ * 不可达块里定义的值只可能经由 PhiSSA 流进可达的块, 所以删除前先摘掉可达块里
+ * PhiSSA 来自不可达块的入口, 再把这些值剩下的使用者换成 undef.
+ * @return 删除的基本块个数. 函数声明返回 0.
+ * @throws NullException 当 function 为 null 时 */
+size_t gc_mark_sweep(IR::Function *function);
 
 } // namespace MYGL::IRUtil::Function
 
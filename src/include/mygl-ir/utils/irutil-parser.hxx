@@ -0,0 +1,54 @@
+#pragma once
+#ifndef __MYGL_IRUTIL_PARSER_H__
+#define __MYGL_IRUTIL_PARSER_H__
+
+#include "base/mtb-exception.hxx"
+#include "base/mtb-object.hxx"
+#include "mygl-ir/ir-module.hxx"
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/** @file irutil-parser.hxx
+ * @brief MYGL-IR 文本格式的读入器, 是 `Writer` 的逆操作. 可以跳过前端, 直接从
+ *        IR 文本构造模块.
+ *
+ * 解析器手写, 直接在输入文本(通常是映射进内存的文件)上移动游标, 名称和数字都是
+ * 输入上的 string_view, 只有真正存进 IR 的名称才会被拷贝.
+ *
+ * 文本格式约定:
+ * - 可选的首行 `; module <name>` 给出模块名. 其余 `;` 开头到行尾都是注释.
+ * - 顶层定义 `@gvar = ...`、`define ...`、`declare ...` 都从行首开始, 函数体以
+ *   行首的 `}` 结束. 读入时先扫一遍顶层定义的头部, 建好所有全局变量和函数,
+ *   所以初始值和函数体里可以引用后面才定义的全局量.
+ * - 基本块标签 `<name>:` 从行首开始, 函数体里的第一个标签是入口基本块.
+ * - 纯数字的局部名称(`%0`、`%1`...)是 Writer 生成的编号, 读入后不会成为值的名称,
+ *   重新写出时会得到相同的编号.
+ *
+ * 不支持非 SSA 的 `move` 以及 `memmove`/`memset` 内部指令, 遇到时抛出
+ * `ParseException`. */
+namespace MYGL::IRUtil {
+
+    /** @class ParseException
+     * @brief IR 文本不合法. 消息以 `<line>:<column>: ` 开头, 行号和列号从 1 开始. */
+    class ParseException: public MTB::Exception {
+    public:
+        ParseException(size_t line, size_t column, std::string_view msg,
+                       MTB::SourceLocation location = CURRENT_SRCLOC);
+    public:
+        size_t line, column;
+    }; // class ParseException
+
+    /** @fn parse_ir(text)
+     * @brief 从 Writer 输出的文本重建模块. text 只在调用期间被读取.
+     * @throws ParseException 当 text 不是合法的 IR 文本时 */
+    extern MTB::owned<IR::Module> parse_ir(std::string_view text);
+
+    /** @fn parse_ir_file(path)
+     * @brief 把文件 path 映射进内存(mmap)后调用 parse_ir(), 不做额外拷贝.
+     * @throws ParseException 打开或映射文件失败时也会抛出该异常, 此时行号为 0 */
+    extern MTB::owned<IR::Module> parse_ir_file(std::string const &path);
+
+} // namespace MYGL::IRUtil
+
+#endif
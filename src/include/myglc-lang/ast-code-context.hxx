@@ -1,14 +1,41 @@
 #pragma once
 
 #include "ast-node.hxx"
+#include "ast-node-arena.hxx"
 #include "ast-lexer.hxx"
+#include "ast-source-registry.hxx"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace MYGL::Ast {
     class CodeContext final/*: std::enable_shared_from_this<CodeContext>*/ {
+    public:
+        /** @interface TopLevelSink
+         * @brief 流式语法分析的接收者. 设置了接收者以后, 语法分析器每归约完一个顶层
+         *        声明或函数定义, 就立即登记它并交给接收者, 函数定义处理完以后马上释放
+         *        函数体. 这样语法树常驻内存的只有全局声明和函数签名, 峰值内存约等于
+         *        最大的那个函数体.
+         *
+         *        IR 生成的接收者还没有接上: IRGen::Generator 的语句、表达式生成器和
+         *        IR::Builder 在树里没有定义, 链接不起来.
+         *
+         * @fn on_declaration(decl) 已经登记好的全局声明. decl 一直有效.
+         * @fn on_function(func)    已经登记好的函数定义, 函数体此时还在.
+         * @fn on_release(func, nodes) func 的函数体即将释放, nodes 是函数体里的
+         *     所有结点. 接收者要丢掉所有以这些结点为键或者指向它们的数据. */
+        interface TopLevelSink {
+        public:
+            virtual ~TopLevelSink() = default;
+            abstract void on_declaration(Declaration *decl) = 0;
+            abstract void on_function(Function *func) = 0;
+            abstract void on_release(Function *func, std::vector<Node*> const &nodes) {
+                (void)func; (void)nodes;
+            }
+        }; // interface TopLevelSink
     public:
         using InputHandle  = std::istream*;
         using OutputHandle = std::ostream*;
@@ -30,6 +57,14 @@ namespace MYGL::Ast {
             ret->_filename = filename;
             return ret;
         }
+        /** @fn fromMappedFile(filename, registry)
+         * @brief 把源文件只读地映射进内存, 词法分析器和所有 SourceRange 直接指向映射,
+         *        不再复制源码. 同一个 registry 里的 CodeContext 共享同一个文件的映射.
+         * @throws NullException 文件打不开或者映射失败时 */
+        static PtrT fromMappedFile(std::string const &filename,
+                                   SourceRegistry &registry = SourceRegistry::Global()) {
+            return std::make_shared<CodeContext>(registry.open(filename), filename);
+        }
         static PtrT fromInputFile(std::istream &stream = std::cin) {
             return std::make_shared<CodeContext>(&stream);
         }
@@ -43,27 +78,119 @@ namespace MYGL::Ast {
             return _filename;
         }
         std::string &filename() { return _filename; }
+        /** @property source{get;} 整份源码. 映射模式下直接指向文件映射. */
+        std::string_view get_source() const { return _lexer->src_buffer; }
         void sync_lexer() {
             // _source_code = std::string_view{_lexer->YYText(), (size_t)_lexer->YYLeng()};
         }
         CompUnit::PtrT &root() {
             return _root;
         }
+
+        /** @property preclude{get;set;}
+         * @brief 预先解析好的公共源码(比如运行时函数的声明). 它的全局作用域会成为本
+         *        单元全局作用域的父作用域, 所以一份 preclude 解析一次就能被很多单元共用.
+         *        必须在语法分析之前设置; 本单元持有它的引用, 保证它活得足够久.
+         * @warning preclude 被多个线程上的单元共用时只能读, 不能再修改. */
+        PtrT const &get_preclude() const { return _preclude; }
+        void set_preclude(PtrT preclude) { _preclude = std::move(preclude); }
+
+        /** @property global_scope{get;}
+         * @brief 本单元的全局作用域要接到哪个作用域上: 有 preclude 时是 preclude
+         *        的全局作用域, 否则是 `CompUnit::Predefined` 的作用域. */
+        Scope *get_global_scope() const {
+            if (_preclude != nullptr && _preclude->_root != nullptr)
+                return _preclude->_root->scope_self();
+            return CompUnit::Predefined.scope_self();
+        }
+
+        /** @property sink{get;set;}
+         * @brief 流式语法分析的接收者, 见 TopLevelSink. 为 null 时分析完整个单元
+         *        以后再统一登记. 必须在语法分析之前设置. */
+        TopLevelSink *get_sink() const { return _sink; }
+        void set_sink(TopLevelSink *sink) { _sink = sink; }
+        bool is_streaming() const { return _sink != nullptr; }
+
+        /** @fn begin_function_body()
+         * @brief 语法分析器在函数体开始之前调用. 流式分析时函数体的结点放进单独的
+         *        区域, 以便整体释放.
+         * @fn end_function_body()
+         * @brief 函数体归约完、创建 Function 结点之前调用. */
+        void begin_function_body() {
+            if (is_streaming())
+                _node_arena.push_region();
+        }
+        void end_function_body() {
+            if (is_streaming())
+                _pending_body = _node_arena.pop_region();
+        }
+        /** @fn stream_declaration(unit, decl)
+         * @brief 把顶层声明追加到 unit. 流式分析时立即登记并交给接收者. */
+        void stream_declaration(CompUnit *unit, Declaration *decl) {
+            if (!is_streaming()) {
+                unit->append(Declaration::PtrT{decl});
+                return;
+            }
+            unit->stream_append(decl);
+            _sink->on_declaration(decl);
+        }
+        /** @fn stream_function(unit, func)
+         * @brief 把函数追加到 unit. 流式分析时立即登记, 交给接收者生成, 然后释放函数体. */
+        void stream_function(CompUnit *unit, Function *func) {
+            if (!is_streaming()) {
+                unit->append(Function::PtrT{func});
+                return;
+            }
+            NodeArena::Region body = std::move(_pending_body);
+            unit->stream_append(func);
+            _sink->on_function(func);
+            if (!func->is_extern()) {
+                _sink->on_release(func, body.get_nodes());
+                func->release_body();
+            }
+        }
+
+        /** @property node_arena{access;}
+         * @brief 这份源码的所有语法树结点都在这里, CodeContext 析构时一起释放. */
+        NodeArena &get_node_arena() { return _node_arena; }
+        /** @fn new_node<NodeT>(args...)
+         * @brief 在本 CodeContext 的结点竞技场里构造一个语法树结点. */
+        template<typename NodeT, typename... ArgsT>
+        NodeT *new_node(ArgsT &&...args) {
+            return _node_arena.make<NodeT>(std::forward<ArgsT>(args)...);
+        }
         CodeContext(std::istream *input_handle, bool input_owned = false, std::string const &filename = "<anonymous>")
-            : _input_handle(input_handle),
-              _input_owned(input_owned),
+            : _filename(filename),
+              _input_handle(input_handle),
+              _input_owned(input_owned) {
+            /* 词法分析器直接扫描一整块连续的源码, 所以先把输入一次读完 */
+            if (input_handle != nullptr) {
+                std::ostringstream buffer;
+                buffer << input_handle->rdbuf();
+                _source_code = std::move(buffer).str();
+            }
+            _lexer = std::make_shared<LexerT>(filename, _source_code);
+        }
+        CodeContext(SourceRegistry::MappingPtrT mapping, std::string const &filename)
+            : _mapping(std::move(mapping)),
               _filename(filename),
-              _lexer(std::make_shared<LexerT>(filename, input_handle, _source_code)),
-              _source_code() {
+              _input_handle(nullptr),
+              _input_owned(false) {
+            _lexer = std::make_shared<LexerT>(filename, _mapping->view());
         }
             
     private:
+        PtrT           _preclude;   // 最先声明, 最后析构: 本单元的作用域还挂在它上面
+        NodeArena      _node_arena;
+        NodeArena::Region _pending_body; // 流式分析时刚归约完、还没交给接收者的函数体
+        TopLevelSink  *_sink = nullptr;
         CompUnit::PtrT _comp_unit = nullptr;
-        LexPtrT        _lexer;
         std::string    _source_code;
+        SourceRegistry::MappingPtrT _mapping; // 映射模式下持有文件映射, 要比 _lexer 活得久
+        LexPtrT        _lexer;
         std::string    _filename;
         InputHandle    _input_handle;
         bool           _input_owned;
-        CompUnit::PtrT _root;
+        CompUnit::PtrT _root = nullptr;
     }; // class CodeContext
 } // namespace MYGL::Ast
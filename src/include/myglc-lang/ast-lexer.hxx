@@ -1,68 +1,152 @@
 /** @file ast-lexer.hxx MYGL Lexer */
 #pragma once
 
-
-#ifndef __FLEX_LEXER_H
-#include <FlexLexer.h>
-#endif
 #include <cstdint>
+#include <iostream>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 #include "util.hxx"
 
 namespace MYGL::Ast {
-    class Lexer: public yyFlexLexer/*, public std::enable_shared_from_this<Lexer>*/ {
+    /** @class LineTable
+     * @brief 源码每一行的起始偏移. 第一次查询行列号时才扫描源码建表, 之后每次
+     *        查询都是一次二分查找; 按顺序查询时通常连二分都不需要. */
+    class LineTable {
+    public:
+        explicit LineTable(std::string_view source = {})
+            : _source(source) {}
+
+        /** @fn reset(source)
+         * @brief 换一份源码, 旧表作废. */
+        void reset(std::string_view source) {
+            _source = source;
+            _line_starts.clear();
+            _hint = 0;
+        }
+
+        /** @fn locate(offset, line, col)
+         * @brief 计算偏移 offset 所在的行列. 行号从 1 开始, 列号从 0 开始,
+         *        和 `SourceLocation` 的约定一致. */
+        void locate(size_t offset, int &line, int &col);
+
+        /** @property line_count{get;} */
+        size_t get_line_count() {
+            if (_line_starts.empty())
+                _build();
+            return _line_starts.size();
+        }
+    private:
+        std::string_view      _source;
+        std::vector<uint32_t> _line_starts; // 为空表示还没有建表
+        size_t                _hint = 0;    // 上一次查到的行
+
+        void _build();
+    }; // class LineTable
+
+    /** @class Lexer
+     * @brief 手写的词法分析器. 直接在一整块连续的源码缓冲区上扫描, 空白和注释在
+     *        内部跳过, 词法单元是只记录 `{kind, offset, length}` 的 POD, 全部放在
+     *        一个数组里. 交给语法分析器的范围也只有偏移, 行列号要到报错、打印的时候
+     *        才算 (见 SourceLocation::resolve), 需要现算时用 locate().
+     *
+     * `yylex()`/`lex()` 的返回值和 ast-parser.y 的 token 编号一致, 可以直接替换
+     * 原来 flex 生成的词法分析器. */
+    class Lexer {
     public:
         using PtrT = std::shared_ptr<Lexer>;
         using UnownedPtrT = Lexer*;
 
+        /** @struct RawToken
+         * @brief 词法单元本体. kind 是 ast-parser.y 的 token 编号, 文件结束时是 YYEOF. */
+        struct RawToken {
+            uint32_t kind;
+            uint32_t offset;
+            uint32_t length;
+        }; // struct RawToken
+        using RawTokenListT = std::vector<RawToken>;
+
+        /** @class Token
+         * @brief 交给语法分析器的词法单元, 只记 `{offset, length}`, range() 时才拼出
+         *        SourceRange (不算行列号). 按值存进 bison 的 variant 里, 不单独分配内存. */
         class Token {
         public:
-            using PtrT = std::shared_ptr<Token>;
-            using UnownedPtrT = std::weak_ptr<Token>;
+            /* ast-parser.y 把词法单元声明成 `Token::PtrT`, 并用 `$n->range()` 访问,
+             * 所以 PtrT 就是 Token 自己, operator-> 返回 this. */
+            using PtrT = Token;
             using TypeId = uint64_t;
         public:
-            SourceRange source_range;
-            TypeId      type;
+            Lexer::UnownedPtrT lexer = nullptr;
+            uint32_t offset = 0;
+            uint32_t length = 0;
+            TypeId   type   = 0;
 
-            static PtrT from_lexer(Lexer::UnownedPtrT lexer, TypeId type) {
-                return std::make_shared<Token>(lexer, type);
-            }
-            SourceRange const &range() { return source_range; }
-            void println() {
+            Token() = default;
+            Token(Lexer::UnownedPtrT lexer, TypeId type);
+
+            SourceRange range() const { return lexer->range_of(offset, length); }
+            Token const *operator->() const { return this; }
+            void println() const {
+                SourceRange source_range = range();
                 std::cout << std::format("Token{{type:{}, range{:36s}`{}`}}",
                     type, source_range.to_string(), source_range.get_content()
                 ) << std::endl;
             }
-            Token(Lexer::UnownedPtrT lexer, TypeId type);
-        private:
         }; // class Token
     public:
-        Lexer(std::string filename, std::istream *ihandle, std::string &src_buffer)
-            : yyFlexLexer(ihandle, nullptr),
-              filename(filename), src_buffer(src_buffer) {
-            // yylex();
-            src_range = {
+        /** @fn Lexer(filename, src_buffer)
+         * @param src_buffer 完整的源码. Lexer 只保存视图, 源码(字符串或文件映射)要比 Lexer 活得久. */
+        Lexer(std::string filename, std::string_view src_buffer);
+        Lexer(Lexer const &) = delete;
+        Lexer &operator=(Lexer const &) = delete;
+        virtual ~Lexer() = default;
+
+        /** @fn tokenize()
+         * @brief 扫描整份源码, 生成词法单元数组. 只在第一次调用时扫描.
+         *        数组以一个 YYEOF 结尾. */
+        RawTokenListT const &tokenize();
+
+        /** @property tokens{get;} */
+        RawTokenListT const &get_tokens() const { return _tokens; }
+
+        /** @fn locate(offset)
+         * @brief 把源码偏移换算成 SourceLocation, 行列号查行表现算. */
+        SourceLocation locate(size_t offset);
+
+        /** @fn range_of(offset, length)
+         * @brief 源码里的一段范围, 只填偏移, 行列号留给 SourceLocation::resolve. */
+        SourceRange range_of(size_t offset, size_t length) const {
+            return {
                 filename.c_str(),
-                {&src_buffer, 0, 1, 0},
-                {&src_buffer, 0, 1, 0}
+                {&src_buffer, offset, 0, 0},
+                {&src_buffer, offset + length, 0, 0}
             };
         }
-        virtual ~Lexer() = default;
+        /** @property current_range{get;} 上一次 yylex() 取到的词法单元的范围 */
+        SourceRange get_current_range() const {
+            return range_of(_current.offset, _current.length);
+        }
 
-        int yylex() override;
-        Token::TypeId lex();
+        /** @fn yylex()
+         * @brief 取下一个词法单元并记下它的位置. 读到结尾以后一直返回 YYEOF. */
+        int yylex();
+        Token::TypeId lex() { return Token::TypeId(yylex()); }
         Token::TypeId lex(Token::PtrT &parser_lval)
         {
             Token::TypeId ret = lex();
-            parser_lval = Token::from_lexer(this, ret);
-            // parser_lval->println();
+            parser_lval = Token(this, ret);
             return ret;
         }
 
-        std::string   filename;
-        std::string  &src_buffer;
-        SourceRange  src_range;
-        Token::TypeId cur_type;
-    public:
+        std::string      filename;
+        std::string_view src_buffer; // SourceLocation::owner 指向这里
+        Token::TypeId    cur_type = 0;
+    private:
+        RawTokenListT _tokens;
+        RawToken      _current{0, 0, 0};
+        size_t        _next = 0;
+        bool          _tokenized = false;
+        LineTable     _lines;
     }; // class Lexer
 } // namespace MYGL::Ast
@@ -0,0 +1,100 @@
+#ifndef __MYGL_LANG_AST_NODE_ARENA_H__
+#define __MYGL_LANG_AST_NODE_ARENA_H__ 1L
+
+#include "base.hxx"
+#include "ast-node-decl.hxx"
+#include "base/mtb-arena.hxx"
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace MYGL::Ast {
+    /** @class NodeArena
+     * @brief 语法树结点的竞技场, 每个 CodeContext 一个. 结点按创建顺序连续地
+     *        排在几个大块里, 地址在 CodeContext 的整个生命期内都不变, 所以结点之间
+     *        可以直接用裸指针互相引用, 不需要引用计数.
+     *
+     * 竞技场析构时按创建顺序的逆序调用每个结点的析构函数, 然后一次性归还所有内存.
+     * 单个结点不能提前释放, 但是可以把一段时间里新建的结点整体放进一个区域(Region),
+     * 之后把区域整体释放掉. 流式语法分析用它在生成完 IR 以后释放函数体.
+     *
+     * @warning 线程不安全. 同一个竞技场同一时刻只应该在一个线程上创建结点. */
+    class NodeArena {
+    public:
+        /** @class Region
+         * @brief 一组一起创建、一起释放的结点, 有自己的块. 析构时按创建顺序的逆序
+         *        析构其中的结点并归还内存, 所以区域外面不能再留有指向区域里结点的指针. */
+        class Region {
+        public:
+            Region() = default;
+            explicit Region(size_t chunk_size);
+            Region(Region &&that) noexcept
+                : _arena(that._arena), _nodes(std::move(that._nodes)) {
+                that._arena = nullptr;
+            }
+            Region &operator=(Region &&that) noexcept;
+            ~Region() { clear(); }
+
+            /** @property nodes{get;} 按创建顺序排列的结点 */
+            std::vector<Node*> const &get_nodes() const { return _nodes; }
+            /** @property allocated_bytes{get;} */
+            size_t get_allocated_bytes() const {
+                return _arena == nullptr ? 0 : _arena->get_allocated_bytes();
+            }
+            bool empty() const { return _nodes.empty(); }
+
+            /** @fn clear()
+             * @brief 立即析构区域里的所有结点并归还内存. */
+            void clear();
+        private:
+            friend class NodeArena;
+            MTB::BumpArena    *_arena = nullptr;
+            std::vector<Node*> _nodes; // 按创建顺序排列, 析构时逆序遍历
+        }; // class Region
+    public:
+        NodeArena();
+        ~NodeArena();
+        NodeArena(NodeArena const &) = delete;
+        NodeArena &operator=(NodeArena const &) = delete;
+
+        /** @fn make<NodeT>(args...)
+         * @brief 在竞技场里构造一个 NodeT 结点, 参数原样转发给 NodeT 的构造函数.
+         *        有打开的区域时结点放进最内层的区域. */
+        template<typename NodeT, typename... ArgsT>
+        NodeT *make(ArgsT &&...args)
+        {
+            Region &target = _regions.empty() ? _root : _regions.back();
+            void  *memory = target._arena->allocate(sizeof(NodeT), alignof(NodeT));
+            NodeT *node;
+            try {
+                node = new(memory) NodeT(std::forward<ArgsT>(args)...);
+            } catch (...) {
+                target._arena->deallocate(memory);
+                throw;
+            }
+            target._nodes.push_back(node);
+            return node;
+        }
+
+        /** @fn push_region()
+         * @brief 打开一个新区域, 之后创建的结点都放进这个区域, 直到 pop_region(). */
+        void push_region();
+        /** @fn pop_region()
+         * @brief 关闭最内层的区域并交给调用者. 返回值析构时区域里的结点随之释放.
+         * @warning 没有打开的区域时返回空区域. */
+        Region pop_region();
+        /** @property nregions{get;} 打开着的区域个数 */
+        size_t get_nregions() const { return _regions.size(); }
+
+        /** @property nnodes{get;} 竞技场里的结点个数, 包括打开着的区域 */
+        size_t get_nnodes() const;
+        /** @property allocated_bytes{get;} 结点占用的字节数, 包括打开着的区域 */
+        size_t get_allocated_bytes() const;
+    private:
+        Region              _root;
+        std::vector<Region> _regions;
+    }; // class NodeArena
+} // namespace MYGL::Ast
+
+#endif
@@ -48,6 +48,7 @@ namespace MYGL::Ast {
     class IndexExpr;
 
 /** non-ast classes */
+    class NodeArena;
     class Scope;
     interface ScopeContainer;
     imcomplete class CodeVisitor;
@@ -60,4 +61,8 @@ namespace MYGL::Ast {
     struct SourceRange;
 } // namespace MYGL::Ast
 
+namespace MYGL::Utility {
+    struct SparseInitList;
+} // namespace MYGL::Utility
+
 #endif
\ No newline at end of file
@@ -49,11 +49,16 @@ namespace MYGL::Ast {
      *          Node *parent_node = nullptr,
      *          Scope *scope = nullptr)
      * @fn accept(CodeVisitor*) abstract
-     * @fn accept_children(CodeVisitor*) abstract */
-    imcomplete class Node: public std::enable_shared_from_this<Node> {
-    public:
-        /** @brief 指针定义: 每个Node都要定义一个带所有权和不带所有权的指针类型 */
-        using PtrT = std::shared_ptr<Node>;
+     * @fn accept_children(CodeVisitor*) abstract
+     *
+     * 结点都分配在所属 CodeContext 的 `NodeArena` 里, 随 CodeContext 一起释放.
+     * 结点之间只用裸指针互相引用, 不能单独 delete 某个结点. */
+    imcomplete class Node {
+    public:
+        /** @brief 指针定义: 每个Node都要定义 PtrT 与 UnownedPtrT 两个指针类型.
+         *  结点的所有权在 NodeArena 手里, 所以两者都是裸指针; PtrT 只用来标明
+         *  "这是语法树上的子结点". */
+        using PtrT = Node*;
         using UnownedPtrT = Node*;
     public:
         Scope *get_scope() const { return _scope; }
@@ -78,6 +83,7 @@ namespace MYGL::Ast {
         NodeType    _node_type;
         Node       *_parent_node;
     protected:
+        friend class NodeArena;
         Node(SourceRange const& range,
              NodeType node_type = NodeType::BASE,
              Node *parent_node = nullptr,
@@ -94,7 +100,7 @@ namespace MYGL::Ast {
      * @var prev protected unowned 前驱结点 */
     imcomplete class Statement: public Node {
     public:
-        using PtrT = std::shared_ptr<Statement>;
+        using PtrT = Statement*;
         using UnownedPtrT = Statement*;
         inline Statement *get_next() { return _next; }
         inline void set_next(Statement *next) {
@@ -124,13 +130,15 @@ namespace MYGL::Ast {
      * @brief 表达式基类
      *
      * @fn is_lvalue() const -> bool 是否为左值表达式
+     * @property fold_state{get;}   常量折叠的结果, 由 GenUtil::ExprChecker 填写
+     * @property folded_value{get;} 折叠出来的常量, 不是常量时为 null
      * @fn get_variable_list() abstract -> std::shared_ptr<VarListT>
      *     获取被使用的变量列表。
      * @fn register_this() abstract unused -> bool
      *     让父作用域注册自己，实际上是给自己的所有标识符找定义。 */
     imcomplete class Expression: public Node {
     public:
-        using PtrT = std::shared_ptr<Expression>;
+        using PtrT = Expression*;
         using UnownedPtrT = Expression*;
         using VarListT = std::map<std::string_view, Variable*>;
         enum class Operator {
@@ -141,9 +149,30 @@ namespace MYGL::Ast {
             ASSIGN, PLUS_ASSIGN, SUB_ASSIGN, MUL_ASSIGN, DIV_ASSIGN, MOD_ASSIGN
         }; // enum Operator
         static Operator OperatorFromStr(std::string_view op);
+        enum class FoldState: uint8_t {
+            UNKNOWN,      // 还没有折叠过
+            CONSTANT,     // 是常量, 值在 folded_value 里
+            NOT_CONSTANT
+        }; // enum FoldState
     public:
         bool is_lvalue() const { return _is_lvalue; }
         abstract std::shared_ptr<VarListT> get_variable_list() = 0;
+
+        FoldState get_fold_state() const { return _fold_state; }
+        /** @brief 所有查询者共享同一个值, 不能修改它. */
+        std::shared_ptr<Value> const &get_folded_value() const { return _folded_value; }
+        /** @fn set_folded(value)
+         * @brief 记下折叠结果. value 为 null 表示不是常量. */
+        void set_folded(std::shared_ptr<Value> value) {
+            _fold_state   = (value == nullptr) ? FoldState::NOT_CONSTANT: FoldState::CONSTANT;
+            _folded_value = std::move(value);
+        }
+        /** @fn reset_folded()
+         * @brief 忘掉折叠结果. 修改了表达式或者它引用的常量以后调用. */
+        void reset_folded() {
+            _fold_state = FoldState::UNKNOWN;
+            _folded_value.reset();
+        }
     protected:
         Expression(SourceRange const &range,
                    Node *parent = nullptr,
@@ -152,29 +181,33 @@ namespace MYGL::Ast {
                    bool is_lvalue = false);
         virtual ~Expression() override = default;
         bool _is_lvalue;
+        FoldState _fold_state = FoldState::UNKNOWN;
+        std::shared_ptr<Value> _folded_value;
     }; // class Expression
     /** @class Definition abstract
      * @brief 定义结点基类，从一个基础类型定义成员或类型的语句
      *
      * @var base_type{get; protected set;} 基础类型
      * @var name{get; protected set;} 名称，在不同子类里含义不同
+     * @var symbol{get;} 名称驻留后的符号, 作用域用它做键
      * @var base_type_string{access;}  基类型的字符串
      *
      * @fn register_this() abstract -> bool 让父作用域注册自己 */
     imcomplete class Definition: public Node {
     public:
-        using PtrT = std::shared_ptr<Definition>;
+        using PtrT = Definition*;
         using UnownedPtrT = Definition*;
     public:
         Type *base_type() const { return _base_type; }
         void set_base_type(Type *type) {
             _base_type = type;
         }
-        std::string_view name() const { return _name; }
+        std::string_view name() const { return _name.str(); }
+        MTB::Symbol    symbol() const { return _name; }
         abstract bool register_this() = 0;
     protected:
         Ast::Type       *_base_type;
-        std::string      _name;
+        MTB::Symbol      _name;
         /** @brief constructor for derived definitions for derived Definition
          * @param range     Definition所在的源码范围
          * @param base_type 定义的基础类型
@@ -213,14 +246,13 @@ namespace MYGL::Ast {
      * @fn Block(SourceRange const &range, Node *parent, Scope *parent_scope)
      * @fn statements() 读写 getter & setter
      * @fn get_statements() 只读getter
-     * @fn append((owned) Statement)
-     *     注意，append与prepend如果涉及智能指针，那必须使用右值引用。否则会导致内存泄漏。
-     * @fn prepend((owned) Statement)
+     * @fn append(Statement)
+     * @fn prepend(Statement)
      * @fn begin()
      * @fn end() */
     class Block: public Statement, public virtual ScopeContainer {
     public:
-        using PtrT = std::unique_ptr<Block>;
+        using PtrT = Block*;
         using UnownedPtrT = Block*;
         using StmtListT = std::deque<Statement::PtrT>;
     public:
@@ -249,20 +281,18 @@ namespace MYGL::Ast {
             if (stmt == nullptr)
                 return false;
             stmt->set_parent(this);
-            Statement::PtrT last = _statements.back();
-            last->set_next(stmt.get());
-            _statements.push_back(std::move(stmt));
+            if (!_statements.empty())
+                _statements.back()->set_next(stmt);
+            _statements.push_back(stmt);
             return true;
         }
         bool prepend(Statement::PtrT &&stmt) {
             if (stmt == nullptr)
                 return false;
             stmt->set_parent(this);
-            if (!_statements.empty()) {
-                Statement::PtrT first = _statements.front();
-                stmt->set_next(first.get());
-            }
-            _statements.push_front(std::move(stmt));
+            if (!_statements.empty())
+                stmt->set_next(_statements.front());
+            _statements.push_front(stmt);
             return true;
         }
         StmtListT::iterator begin() { return _statements.begin(); }
@@ -276,7 +306,7 @@ namespace MYGL::Ast {
      * @fn EmptyStmt(SourceRange) */
     class EmptyStmt final: public Statement {
     public:
-        using PtrT = std::shared_ptr<EmptyStmt>;
+        using PtrT = EmptyStmt*;
         using UnownedPtrT = EmptyStmt*;
     public:
         EmptyStmt(SourceRange const &range)
@@ -317,7 +347,7 @@ namespace MYGL::Ast {
      */
     class IfStmt final: public Statement {
     public:
-        using PtrT = std::shared_ptr<IfStmt>;
+        using PtrT = IfStmt*;
         using UnownedPtrT = IfStmt*;
     public:
         IfStmt(SourceRange const &range,
@@ -363,7 +393,7 @@ namespace MYGL::Ast {
      * @fn set_condition(Expression::PtrT &&) */
     class WhileStmt final: public Statement {
     public:
-        using PtrT = std::shared_ptr<WhileStmt>;
+        using PtrT = WhileStmt*;
         using UnownedPtrT = WhileStmt*;
     public:
         WhileStmt(SourceRange const &range,
@@ -399,7 +429,7 @@ namespace MYGL::Ast {
      * @fn set_function(FunctionPtrT) */
     class ReturnStmt final: public Statement {
     public:
-        using PtrT = std::shared_ptr<ReturnStmt>;
+        using PtrT = ReturnStmt*;
         using UnownedPtrT = ReturnStmt*;
     public:
         ReturnStmt(SourceRange const &range,
@@ -421,7 +451,7 @@ namespace MYGL::Ast {
      * @fn control_node() getter & setter */
     class BreakStmt final: public Statement {
     public:
-        using PtrT = std::shared_ptr<BreakStmt>;
+        using PtrT = BreakStmt*;
         using UnownedPtrT = BreakStmt*;
         using OwnerPtrT = Statement*;
     public:
@@ -443,7 +473,7 @@ namespace MYGL::Ast {
      * @fn control_node() getter & setter */
     class ContinueStmt final: public Statement {
     public:
-        using PtrT = std::shared_ptr<ContinueStmt>;
+        using PtrT = ContinueStmt*;
         using UnownedPtrT = ContinueStmt*;
         using OwnerPtrT = WhileStmt*;
     public:
@@ -467,7 +497,7 @@ namespace MYGL::Ast {
      * @fn set_expression(Expression::PtrT &&) */
     class ExprStmt final: public Statement {
     public:
-        using PtrT = std::shared_ptr<ExprStmt*>;
+        using PtrT = ExprStmt*;
         using UnownedPtrT = ExprStmt*;
     public:
         ExprStmt(SourceRange const &range,
@@ -517,7 +547,7 @@ namespace MYGL::Ast {
      * @fn expression{get; set;} */
     class UnaryExpr final: public Expression {
     public:
-        using PtrT = std::shared_ptr<UnaryExpr>;
+        using PtrT = UnaryExpr*;
         using UnownedPtrT = UnaryExpr*;
     public:
         UnaryExpr(SourceRange const &range,
@@ -566,7 +596,7 @@ namespace MYGL::Ast {
      * @fn set_rhs(Expression::PtrT &&) */
     class BinaryExpr final: public Expression {
     public:
-        using PtrT = std::shared_ptr<BinaryExpr>;
+        using PtrT = BinaryExpr*;
         using UnownedPtrT = BinaryExpr*;
     public:
         BinaryExpr(SourceRange const &range,
@@ -610,7 +640,7 @@ namespace MYGL::Ast {
      * @fn operator[](int index) */
     class CallParam final: public Expression {
     public:
-        using PtrT = std::shared_ptr<CallParam>;
+        using PtrT = CallParam*;
         using UnownedPtrT = CallParam*;
         using ExprListT = std::deque<Expression::PtrT>;
     public:
@@ -635,7 +665,7 @@ namespace MYGL::Ast {
     }; // class CallParam
     class Identifier final: public Expression {
     public:
-        using PtrT = std::shared_ptr<Identifier>;
+        using PtrT = Identifier*;
         using UnownedPtrT = Identifier*;
     public:
         Identifier(SourceRange const &range);
@@ -646,12 +676,15 @@ namespace MYGL::Ast {
         /* extends Expression */
         std::shared_ptr<VarListT> get_variable_list() override;
         std::string_view name() { return range().get_content(); }
+        /** @property symbol{get;} 标识符驻留后的符号, 构造时驻留一次 */
+        MTB::Symbol symbol() const { return _symbol; }
         Definition::UnownedPtrT get_definition() { return _definition; }
         void set_definition(Definition::UnownedPtrT definition) {
             _definition = definition;
         }
     private:
         Definition::UnownedPtrT _definition;
+        MTB::Symbol             _symbol;
     }; // class Identifier
     /** @class CallExpr
      * @brief 函数调用表达式
@@ -660,7 +693,7 @@ namespace MYGL::Ast {
      * @var param{get; set;} 参数列表 */
     class CallExpr final: public Expression {
     public:
-        using PtrT = std::shared_ptr<CallExpr>;
+        using PtrT = CallExpr*;
         using UnownedPtrT = CallExpr*;
     public:
         CallExpr(SourceRange const &range,
@@ -683,11 +716,17 @@ namespace MYGL::Ast {
         CallParam::PtrT _param;
     }; // class CallExpr
 
+    /** @class InitList final
+     * @brief 初始化列表, 可以嵌套.
+     *
+     * @property flattened{get;set;} 按偏移展开后的稀疏元素表, 由
+     *     Utility::SparseInitList::Get() 第一次用到时填写. 修改列表以后要清空它. */
     class InitList final: public Expression {
     public:
-        using PtrT = std::shared_ptr<InitList>;
+        using PtrT = InitList*;
         using UnownedPtrT = InitList*;
         using ExprListT = std::deque<Expression::PtrT>;
+        using FlattenedPtrT = std::shared_ptr<Utility::SparseInitList const>;
     public:
         InitList(SourceRange const &range);
         
@@ -703,8 +742,12 @@ namespace MYGL::Ast {
         bool append(Expression::PtrT &&item);
         bool prepend(Expression::PtrT const &item);
         bool prepend(Expression::PtrT &&item);
+
+        FlattenedPtrT const &get_flattened() const { return _flattened; }
+        void set_flattened(FlattenedPtrT value) { _flattened = std::move(value); }
     private:
-        ExprListT _expr_list;
+        ExprListT     _expr_list;
+        FlattenedPtrT _flattened;
     }; // class InitList
 
     /** @class IndexExpr final
@@ -719,7 +762,7 @@ namespace MYGL::Ast {
      * @fn prepend(Expression::PtrT &&) 把游离的索引结点移动到列表开头 */
     class IndexExpr final: public Expression {
     public:
-        using PtrT = std::shared_ptr<IndexExpr>;
+        using PtrT = IndexExpr*;
         using UnownedPtrT = IndexExpr*;
         using ExprListT = std::deque<Expression::PtrT>;
     public:
@@ -753,7 +796,7 @@ namespace MYGL::Ast {
     /** @class Value abstract*/
     imcomplete class Value: public Expression {
     public:
-        using PtrT = std::shared_ptr<Value>;
+        using PtrT = Value*;
         using UnownedPtrT = Value*;
 
         struct ivalue_agent {
@@ -811,7 +854,7 @@ namespace MYGL::Ast {
     }; // class StringValue
     class IntValue final: public Value {
     public:
-        using PtrT = std::shared_ptr<IntValue>;
+        using PtrT = IntValue*;
         using UnownedPtrT = IntValue*;
     public:
         IntValue(SourceRange const &range);
@@ -836,7 +879,7 @@ namespace MYGL::Ast {
 
     class FloatValue final: public Value {
     public:
-        using PtrT = std::shared_ptr<FloatValue>;
+        using PtrT = FloatValue*;
         using UnownedPtrT = FloatValue*;
     public:
         FloatValue(SourceRange const &range);
@@ -867,7 +910,7 @@ namespace MYGL::Ast {
      * @*/
     class AssignExpr final: public Expression {
     public:
-        using PtrT = std::shared_ptr<AssignExpr>;
+        using PtrT = AssignExpr*;
         using UnownedPtrT = AssignExpr*;
     public:
         AssignExpr(SourceRange const &range,
@@ -917,7 +960,7 @@ namespace MYGL::Ast {
  * @class Function final 函数定义 */
     class ArrayInfo final: public Node {
     public:
-        using PtrT = std::shared_ptr<ArrayInfo>;
+        using PtrT = ArrayInfo*;
         using UnownedPtrT = ArrayInfo*;
         using InfoListT = std::deque<Expression::PtrT>;
     public:
@@ -981,7 +1024,7 @@ namespace MYGL::Ast {
      * @fn array_info() 读/写数组信息 */
     class Type: public Definition {
     public:
-        using PtrT = std::shared_ptr<Type>;
+        using PtrT = Type*;
         using UnownedPtrT = Type*;
     public:
         Type(SourceRange const &range,
@@ -1044,9 +1087,9 @@ namespace MYGL::Ast {
         static Type &IntType;   /// int类型
         static Type &FloatType; /// float类型
         static Type &VoidType;  /// void类型
-        static std::shared_ptr<Type> OwnedIntType;
-        static std::shared_ptr<Type> OwnedFloatType;
-        static std::shared_ptr<Type> OwnedVoidType;
+        static std::unique_ptr<Type> OwnedIntType;
+        static std::unique_ptr<Type> OwnedFloatType;
+        static std::unique_ptr<Type> OwnedVoidType;
     }; // class Type
     class VarType final: public Type {};
 
@@ -1057,7 +1100,7 @@ namespace MYGL::Ast {
      * @fn variable_name() 返回变量的名称 */
     class Variable final: public Definition {
     public:
-        using PtrT = std::shared_ptr<Variable>;
+        using PtrT = Variable*;
         using UnownedPtrT = Variable*;
     public:
         Variable(SourceRange const &range,
@@ -1089,8 +1132,9 @@ namespace MYGL::Ast {
         bool is_constant() const noexcept { return _is_constant; }
         void set_constant(bool is_constant) { _is_constant = is_constant; }
 
-        /** @property real_type{get;} shared */
-        Type::PtrT get_real_type() const;
+        /** @property real_type{get;}
+         *  @brief 带上数组维度的完整类型. 需要新建类型结点时放进 arena 里. */
+        Type::PtrT get_real_type(NodeArena &arena) const;
         bool is_array_type() const { return get_array_info() != nullptr; }
 
         /** @property array_info{get;set;} */
@@ -1124,7 +1168,7 @@ namespace MYGL::Ast {
      * @fn  */
     class FuncParam final: public Node {
     public:
-        using PtrT = std::unique_ptr<FuncParam>;
+        using PtrT = FuncParam*;
         using UnownedPtrT = FuncParam*;
         using ParamListT = std::deque<Variable::PtrT>;
     public:
@@ -1149,7 +1193,7 @@ namespace MYGL::Ast {
     };
     class Function final: public Definition, public ScopeContainer {
     public:
-        using PtrT = std::shared_ptr<Function>;
+        using PtrT = Function*;
         using UnownedPtrT = Function*;
     public:
         Function(SourceRange const &range,
@@ -1172,7 +1216,7 @@ namespace MYGL::Ast {
 
         /** @property func_params{get;set;}
          *  @brief 函数参数 */
-        FuncParam::UnownedPtrT get_func_params() const { return _func_params.get(); }
+        FuncParam::UnownedPtrT get_func_params() const { return _func_params; }
         void set_func_params(FuncParam::PtrT &&fn_params);
 
         /** @property func_body{get;access;}
@@ -1182,11 +1226,22 @@ namespace MYGL::Ast {
 
         /** @property is_extern{get;} bool
          *  @brief 指示该函数是否只是声明而非定义 */
-        bool is_extern() const { return _func_body == nullptr; }
+        bool is_extern() const { return _func_body == nullptr && !_body_released; }
+
+        /** @fn release_body()
+         * @brief 流式语法分析生成完 IR 以后, 丢掉对函数体的引用. 函数仍然是定义,
+         *        签名和参数作用域都保留, 只是不能再访问函数体. 函数体的结点由调用者释放. */
+        void release_body() {
+            _body_released = _func_body != nullptr;
+            _func_body     = nullptr;
+        }
+        /** @property body_released{get;} */
+        bool is_body_released() const { return _body_released; }
     private:
         Scope::PtrT     _scope_self;
         Block::PtrT     _func_body;
         FuncParam::PtrT _func_params;
+        bool            _body_released = false;
     };
     /** @class Declaration abstract
      * @brief 声明语句，一种Statement. 在Sema扫描自己的时候，声明里的所有变量
@@ -1211,7 +1266,7 @@ namespace MYGL::Ast {
      * @fn register_this() */
     imcomplete class Declaration: public Statement {
     public:
-        using PtrT = std::shared_ptr<Declaration>;
+        using PtrT = Declaration*;
         using UnownedPtrT = Declaration*;
         using VarPtrT    = Variable::PtrT;
         using VarUnowned = Variable::UnownedPtrT;
@@ -1260,7 +1315,7 @@ namespace MYGL::Ast {
     }; // class Declaration
     class VarDecl final: public Declaration {
     public:
-        using PtrT = std::shared_ptr<VarDecl>;
+        using PtrT = VarDecl*;
         using UnownedPtrT = VarDecl*;
     public:
         VarDecl(SourceRange const &range,
@@ -1273,7 +1328,7 @@ namespace MYGL::Ast {
     }; // class VarDecl
     class ConstDecl final: public Declaration {
     public:
-        using PtrT = std::shared_ptr<ConstDecl>;
+        using PtrT = ConstDecl*;
         using UnownedPtrT = ConstDecl*;
     public:
         ConstDecl(SourceRange const &range,
@@ -1286,7 +1341,7 @@ namespace MYGL::Ast {
     }; // class ConstDecl
     class CompUnit final: public Node, public virtual ScopeContainer {
     public:
-        using PtrT = std::unique_ptr<CompUnit>;
+        using PtrT = CompUnit*;
         using UnownedPtrT = CompUnit*;
         using DeclListT = std::deque<Declaration::PtrT>;
         using FuncListT = std::deque<Function::PtrT>;
@@ -1316,6 +1371,21 @@ namespace MYGL::Ast {
         Variable *get_variable(cstring name) {
             return get_variable({name, strlen(name)});
         }
+
+        /** @fn open_streaming(owner_scope)
+         * @brief 流式语法分析: 先把本单元接到 owner_scope 上, 之后每个顶层声明和函数
+         *        一归约就用 stream_append() 登记, 不必等到整个单元分析完再 register_this().
+         *        登记按源码顺序进行, 所以函数只能调用在它前面声明过的函数.
+         * @fn stream_append(decl) 追加并登记一个顶层声明
+         * @fn stream_append(func) 追加并登记一个函数, 函数名重复时返回 false
+         * @fn close_streaming() 分析结束. 之后的 register_this() 什么也不做. */
+        void open_streaming(Scope *owner_scope);
+        bool stream_append(Declaration::PtrT decl);
+        bool stream_append(Function::PtrT func);
+        void close_streaming();
+        /** @property is_streaming{get;} */
+        bool is_streaming() const { return _streaming; }
+
         int traverse(FuncTraverseFunc fn_fntraverse, DeclTraverseFunc fn_decltraverse)
         {
             int cnt = 0;
@@ -1335,11 +1405,14 @@ namespace MYGL::Ast {
         /** @brief 预定义全局作用域，所有作用域的根作用域，每个源文件都一样。
          * 全局只读，存放编译器默认的变量、builtin函数、基本类型等。 */
         static CompUnit &Predefined;
-        static CompUnit::PtrT OwnedPredefined;
+        static std::unique_ptr<CompUnit> OwnedPredefined;
     private:
+        ScopedSymbolTable _symbol_table; // 注册时解析名字用, 见 ScopedSymbolTable
         Scope::PtrT _scope_self;
         DeclListT   _decls;
         FuncListT   _funcdefs;
+        bool        _streaming      = false;
+        bool        _stream_settled = false; // 流式登记已经完成
     }; // CompUnit
 
 } // namespace MYGL::Ast
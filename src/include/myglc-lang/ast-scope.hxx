@@ -1,12 +1,17 @@
 #pragma once
 #include "base.hxx"
 #include "ast-node-decl.hxx"
+#include "base/mtb-symbol.hxx"
+#include <cstdint>
 #include <memory>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 namespace MYGL::Ast {
 
+    class ScopedSymbolTable;
+
     /** @interface ScopeContainer */
     interface ScopeContainer {
         Node *owner_instance;
@@ -15,8 +20,14 @@ namespace MYGL::Ast {
 
     /** @class Scope
      * @brief 作用域，存储变量定义、函数定义(SysY没有函数声明，以后可能会支持)
+     *        名称都驻留成 `MTB::Symbol`, 查找时比较的是整数编号. 每个查找函数都有
+     *        以 string_view 为参数的版本, 会先把名称驻留成符号.
      * 
      * @var container{get;set;} 这个作用域所属的结点
+     * @var parent{get;set;} 父作用域. 编译单元的作用域在注册时才接到全局作用域上
+     * @var symbol_table{get;set;} 注册语法树时使用的扁平符号表, 构造时从父作用域继承.
+     *      当这个作用域正好是符号表的最内层作用域时, 各个 get_xxx 只在符号表里查一次,
+     *      不再沿父作用域链逐层查找.
      * 
      * @fn has_function(std::string_view) const -> bool
      * 检查当前作用域或其父作用域中是否存在指定名称的函数。
@@ -73,53 +84,83 @@ namespace MYGL::Ast {
         using PtrT = std::unique_ptr<Scope>;
         using UnownedPtrT = Scope*;
 
+        using SymbolT  = MTB::Symbol;
         using VarPtrT  = Variable*;
         using FuncPtrT = Function*;
-        using VarMapT  = std::unordered_map<std::string_view, VarPtrT>;
-        using FuncMapT = std::unordered_map<std::string_view, FuncPtrT>;
+        using VarMapT  = std::unordered_map<SymbolT, VarPtrT>;
+        using FuncMapT = std::unordered_map<SymbolT, FuncPtrT>;
 
         friend interface ScopeContainer;
     public:
         Scope(Scope *parent, ScopeContainer *container)
-            : _parent(parent), _container(container) {}
+            : _parent(parent), _container(container),
+              _symbol_table(parent == nullptr ? nullptr : parent->_symbol_table) {}
         
         Scope *parent() const { return _parent; }
+        void set_parent(Scope *parent) { _parent = parent; }
+        ScopedSymbolTable *get_symbol_table() const { return _symbol_table; }
+        void set_symbol_table(ScopedSymbolTable *table) { _symbol_table = table; }
         ScopeContainer *container() const { return _container; }
         Node *owner_node() const { return _container->owner_instance; }
         VarMapT &variables() { return _variables; }
         VarMapT &constants() { return _constants; }
         FuncMapT &functions() { return _functions; }
 
-        bool has_function(std::string_view name) const;
-        bool has_function_here(std::string_view name) const {
+        bool has_function(SymbolT name) const;
+        bool has_function_here(SymbolT name) const {
             return _functions.contains(name);
         }
-        FuncPtrT get_function(std::string_view name);
-        bool has_variable(std::string_view name) const;
-        bool has_variable_here(std::string_view name) const {
+        FuncPtrT get_function(SymbolT name) const;
+        bool has_variable(SymbolT name) const;
+        bool has_variable_here(SymbolT name) const {
             return _variables.contains(name);
         }
-        VarPtrT get_variable(std::string_view name);
-        bool has_constant(std::string_view name) const;
-        bool has_constant_here(std::string_view name) const {
+        VarPtrT get_variable(SymbolT name) const;
+        bool has_constant(SymbolT name) const;
+        bool has_constant_here(SymbolT name) const {
             return _constants.contains(name);
         }
-        VarPtrT get_constant(std::string_view name);
+        VarPtrT get_constant(SymbolT name) const;
 
-        bool has_constant_or_variable(std::string_view name) const;
-        bool has_constant_or_variable_here(std::string_view name) const {
+        bool has_constant_or_variable(SymbolT name) const;
+        bool has_constant_or_variable_here(SymbolT name) const {
             return has_constant_here(name) || has_variable_here(name);
         }
 
-        VarPtrT get_constant_or_variable(std::string_view name);
-        inline bool has_definition(std::string_view name) const {
-            return has_function(name) || has_constant(name) || has_variable(name);
+        VarPtrT get_constant_or_variable(SymbolT name) const;
+        inline bool has_definition(SymbolT name) const {
+            return get_definition(name) != nullptr;
+        }
+        Definition *get_definition(SymbolT name) const;
+
+        /* 以字符串为键的版本: 先驻留成符号再查找 */
+        bool has_function(std::string_view name) const      { return has_function(SymbolT{name}); }
+        bool has_function_here(std::string_view name) const { return has_function_here(SymbolT{name}); }
+        FuncPtrT get_function(std::string_view name) const  { return get_function(SymbolT{name}); }
+        bool has_variable(std::string_view name) const      { return has_variable(SymbolT{name}); }
+        bool has_variable_here(std::string_view name) const { return has_variable_here(SymbolT{name}); }
+        VarPtrT get_variable(std::string_view name) const   { return get_variable(SymbolT{name}); }
+        bool has_constant(std::string_view name) const      { return has_constant(SymbolT{name}); }
+        bool has_constant_here(std::string_view name) const { return has_constant_here(SymbolT{name}); }
+        VarPtrT get_constant(std::string_view name) const   { return get_constant(SymbolT{name}); }
+        bool has_constant_or_variable(std::string_view name) const {
+            return has_constant_or_variable(SymbolT{name});
+        }
+        bool has_constant_or_variable_here(std::string_view name) const {
+            return has_constant_or_variable_here(SymbolT{name});
+        }
+        VarPtrT get_constant_or_variable(std::string_view name) const {
+            return get_constant_or_variable(SymbolT{name});
+        }
+        bool has_definition(std::string_view name) const { return has_definition(SymbolT{name}); }
+        Definition *get_definition(std::string_view name) const {
+            return get_definition(SymbolT{name});
         }
-        Definition *get_definition(std::string_view name);
 
         bool add(FuncPtrT func);
         bool add(VarPtrT  var);
-        bool remove(std::string_view name);
+        bool remove(SymbolT name);
+        bool remove(std::string_view name) { return remove(SymbolT{name}); }
 
         Type *get_type(std::string_view name) const;
     private:
@@ -127,6 +168,94 @@ namespace MYGL::Ast {
         ScopeContainer *_container;
         VarMapT  _variables, _constants;
         FuncMapT _functions;
+        ScopedSymbolTable *_symbol_table;
+
+        /* 符号表里查不到的名字属于符号表以外的外层作用域(比如 preclude) */
+        bool   _uses_symbol_table() const;
+        Scope *_outside_symbol_table() const;
     }; // class Scope
 
+    /** @class ScopedSymbolTable
+     * @brief 扁平的带作用域符号表. 每个名字对应一个遮蔽栈, 栈顶是当前可见的定义,
+     *        所以解析一个名字只需要查一次哈希表, 与作用域嵌套多深无关.
+     *
+     * 注册语法树时, 每进入一个作用域(编译单元、函数、语句块)调用 `push_scope`,
+     * 离开时调用 `pop_scope`. 这期间 `Scope::add` 成功加入的定义会同时压进对应
+     * 名字的遮蔽栈, `pop_scope` 按日志把这一层压入的定义全部弹出.
+     *
+     * 同一层作用域里重名的定义按 函数 > 常量 > 变量 的顺序排在栈里, 与 Scope
+     * 沿父作用域链查找时的优先级一致.
+     *
+     * @fn push_scope(scope) 进入作用域. scope 里已有的定义(比如解析时就加入的函数)
+     *     会一并压栈.
+     * @fn try_push_scope(scope) -> bool 只有 scope 紧贴着当前最内层作用域(或者表是空的)
+     *     时才压栈, 免得把不相干的作用域叠在一起.
+     * @fn pop_scope() 离开最内层作用域
+     * @fn lookup(name) -> Definition* 名字当前可见的定义, 找不到时为 null */
+    class ScopedSymbolTable {
+    public:
+        using SymbolT = MTB::Symbol;
+        enum class Kind: uint8_t {
+            VARIABLE = 0, CONSTANT = 1, FUNCTION = 2,
+        }; // enum class Kind
+        struct Entry {
+            Definition *definition;
+            Scope      *scope;
+            Kind        kind;
+        }; // struct Entry
+
+        /** @class Frame
+         * @brief 在语句块、函数注册期间进入它的作用域, 析构时离开. scope 没有
+         *        符号表或者不能压栈时什么也不做. */
+        class Frame {
+        public:
+            explicit Frame(Scope *scope);
+            ~Frame();
+            Frame(Frame const &) = delete;
+            Frame &operator=(Frame const &) = delete;
+        private:
+            ScopedSymbolTable *_table;
+        }; // class Frame
+    public:
+        ScopedSymbolTable() = default;
+        ScopedSymbolTable(ScopedSymbolTable const &) = delete;
+        ScopedSymbolTable &operator=(ScopedSymbolTable const &) = delete;
+
+        /** @property current_scope{get;} 最内层作用域, 没有作用域时为 null */
+        Scope *current_scope() const {
+            return _levels.empty() ? nullptr : _levels.back().scope;
+        }
+        /** @property root_scope{get;} 最外层作用域, 没有作用域时为 null */
+        Scope *root_scope() const {
+            return _levels.empty() ? nullptr : _levels.front().scope;
+        }
+        size_t get_depth() const { return _levels.size(); }
+
+        void push_scope(Scope *scope);
+        bool try_push_scope(Scope *scope);
+        void pop_scope();
+        void define(SymbolT name, Definition *definition, Kind kind);
+
+        Definition *lookup(SymbolT name) const {
+            auto it = _stacks.find(name);
+            if (it == _stacks.end() || it->second.empty())
+                return nullptr;
+            return it->second.back().definition;
+        }
+        Function *lookup_function(SymbolT name) const;
+        Variable *lookup_variable(SymbolT name) const;
+        Variable *lookup_constant(SymbolT name) const;
+        Variable *lookup_constant_or_variable(SymbolT name) const;
+    private:
+        struct Level {
+            Scope *scope;
+            size_t log_mark;
+        }; // struct Level
+        std::unordered_map<SymbolT, std::vector<Entry>> _stacks;
+        std::vector<SymbolT> _log;    // 按压栈顺序记录的名字, pop_scope 据此回退
+        std::vector<Level>   _levels;
+
+        Entry const *_find_top(SymbolT name, bool (*pred)(Kind)) const;
+    }; // class ScopedSymbolTable
+
 } // namespace MYGL::Ast
@@ -0,0 +1,45 @@
+#ifndef __MYGL_LANG_AST_SOURCE_REGISTRY_H__
+#define __MYGL_LANG_AST_SOURCE_REGISTRY_H__ 1L
+
+#include "base.hxx"
+#include "base/mtb-mapped-file.hxx"
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace MYGL::Ast {
+    /** @class SourceRegistry
+     * @brief 源文件映射表. 同一个文件不管被多少个 CodeContext 打开, 都只 mmap 一次;
+     *        最后一个使用者释放映射后, 映射随之解除.
+     *
+     * 多个编译单元可以共用一张表(比如都包含同一份预定义源码), 所以表是线程安全的.
+     * 不指定时使用进程唯一的 `Global()` 表. */
+    class SourceRegistry {
+    public:
+        using MappingPtrT = std::shared_ptr<MTB::MappedFile const>;
+    public:
+        SourceRegistry() = default;
+        SourceRegistry(SourceRegistry const &) = delete;
+        SourceRegistry &operator=(SourceRegistry const &) = delete;
+
+        /** @fn open(filename)
+         * @brief 返回文件 filename 的只读映射. 文件已经被映射过、且映射还活着时直接
+         *        复用, 否则重新映射. 路径会先规范化, 所以 `a/../b.sy` 和 `b.sy` 是同一个文件.
+         * @throws NullException 打开或映射文件失败时 */
+        MappingPtrT open(std::string const &filename);
+
+        /** @property nmapped{get;} 当前还活着的映射个数 */
+        size_t get_nmapped() const;
+
+        /** @fn Global() static
+         * @brief 进程唯一的默认映射表. */
+        static SourceRegistry &Global();
+    private:
+        mutable std::mutex _lock;
+        std::unordered_map<std::string, std::weak_ptr<MTB::MappedFile const>> _files;
+    }; // class SourceRegistry
+} // namespace MYGL::Ast
+
+#endif
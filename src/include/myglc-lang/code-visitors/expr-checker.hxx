@@ -5,6 +5,17 @@
 
 namespace MYGL::GenUtil {
     using namespace Ast;
+    /** @class ExprChecker
+     * @brief 常量表达式求值器.
+     *
+     * 求值结果(包括"不是常量")记在表达式结点上(见 Expression::fold_state),
+     * 同一个表达式只计算一次, 之后的查询都是 O(1). 所有 ExprChecker 共享这些结果.
+     * 字面量不记录, 每次都返回新的副本.
+     *
+     * 结果只取决于语法树, 所以必须在标识符都找到定义以后才能求值.
+     *
+     * @warning 求值会写语法树. 多个线程共享同一棵语法树时, 要先用 fold_tree()
+     *          把它整个折叠一遍, 之后就只读不写了. */
     class ExprChecker
         : public CodeVisitor,
           public std::enable_shared_from_this<ExprChecker> {
@@ -12,24 +23,31 @@ namespace MYGL::GenUtil {
         using PtrT = std::shared_ptr<ExprChecker>;
         using UnownedPtrT = std::weak_ptr<ExprChecker>;
 
-        using VarMapT = std::unordered_map<Variable::UnownedPtrT, Value::PtrT>;
+        /** @brief 折叠出来的常量是临时结点, 不在语法树上, 也不进 NodeArena,
+         *  由被折叠的表达式结点和调用者共同持有. */
+        using ValuePtrT = std::shared_ptr<Value>;
     public:
         ExprChecker();
 
-        Value::PtrT try_calculate(Expression::UnownedPtrT expr) {
-            _constant_table.clear();
+        ValuePtrT try_calculate(Expression::UnownedPtrT expr) {
             return do_try_calculate(expr);
         }
-        Value::PtrT do_try_calculate(Expression::UnownedPtrT expr);
+        /** @fn do_try_calculate(expr)
+         * @brief 求 expr 的值. 不是常量时返回 null.
+         *        返回的值可能和别的查询者共享, 不能修改它. */
+        ValuePtrT do_try_calculate(Expression::UnownedPtrT expr);
 
         /** @brief 检查数值表达式是否为常量。
          * 注意，一旦碰到函数表达式、初始化列表等等，那一定会被判false */
         bool value_is_constant(Expression::UnownedPtrT expr) {
-            _constant_table.clear();
             return (do_try_calculate(expr) != nullptr);
         }
         /** @brief 检查初始化列表是否为常量 */
         bool list_is_constant(InitList::UnownedPtrT init_list);
+        /** @fn fold_tree(root)
+         * @brief 自底向上地折叠 root 下面的所有表达式, 把结果记在结点上.
+         *        之后对这些表达式的查询都不用再计算. */
+        void fold_tree(Node *root);
 
         bool visit(UnaryExpr::UnownedPtrT node) override;
         bool visit(BinaryExpr::UnownedPtrT node) override;
@@ -60,7 +78,6 @@ namespace MYGL::GenUtil {
         bool visit(ArrayInfo::UnownedPtrT node) override;
     private:
         Expression::UnownedPtrT _current_expr;
-        Value::PtrT             _cur_value;
-        VarMapT                 _constant_table;
+        ValuePtrT             _cur_value;
     }; // class ExprChecker
 } // namespace MYGL::IR
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "base/mtb-object.hxx"
+#include "mygl-ir/ir-constant-function.hxx"
+#include "mygl-ir/ir-constant.hxx"
+#include "mygl-ir/ir-instruction-base.hxx"
+#include "myglc-lang/ast-node-decl.hxx"
+#include <map>
+#include <unordered_map>
+
+namespace MYGL::IRGen::FunctionLocal {
+
+    /** @struct SymbolInfo
+     * @brief 函数内局部变量的定义: 语法树上的变量和生成出来的定义指令 (一般是 alloca). */
+    struct SymbolInfo {
+        Ast::Variable   *definition;
+        IR::Instruction *define_inst;
+    }; // struct SymbolInfo
+
+    /** @struct SymbolInfoMapper
+     * @brief 一个函数定义里局部变量和局部常量的映射表. 键是语法树上的变量结点,
+     *        函数体释放以后这些地址会被重用, 所以释放前要清空 (见 Generator::on_release). */
+    struct SymbolInfoMapper {
+        using AVarUPtr    = Ast::Variable::UnownedPtrT;
+        using SymbolMapT  = std::unordered_map<Ast::Variable*, SymbolInfo>;
+        using ConstMapT   = std::unordered_map<Ast::Variable*, MTB::owned<IR::Constant>>;
+
+        Ast::Function *afunc;
+        IR::Function  *ifunc;
+        SymbolMapT     symbol_map;
+        ConstMapT      const_map;
+    public:
+        SymbolInfo &register_local_variable(AVarUPtr avar, IR::Instruction *define_inst);
+        /** @throws NullException 变量没有登记过时 */
+        SymbolInfo &find_local_variable(AVarUPtr avar);
+
+        /** @fn register_local_constant(aconst, data)
+         * @brief 登记局部常量折叠出来的值. data 为 null 时什么也不做, 返回 null. */
+        IR::Constant *register_local_constant(AVarUPtr aconst, MTB::owned<IR::Constant> data);
+        /** @fn find_local_constant(aconst) 没有登记过时返回 null */
+        IR::Constant *find_local_constant(AVarUPtr aconst);
+    }; // struct SymbolInfoMapper
+
+    /** @class SymbolInfoManager
+     * @brief 按语法树函数结点管理每个函数的 SymbolInfoMapper, 并记住正在生成的那个. */
+    class SymbolInfoManager {
+    public:
+        using FuncMapT = std::map<Ast::Function*, SymbolInfoMapper>;
+    public:
+        /** 正在生成的函数的映射表, 不在函数里时为 null */
+        SymbolInfoMapper *current_symbol_info_map = nullptr;
+
+        /** @fn register_get_function(afunc, ifunc)
+         * @brief 取 afunc 的映射表, 没有时新建一个. afunc 对应的 IR 函数变了
+         *        (结点地址被重用) 时映射表会被清空. */
+        SymbolInfoMapper &register_get_function(Ast::Function *afunc, IR::Function *ifunc);
+
+        FuncMapT &func_map() { return _func_map; }
+    private:
+        FuncMapT _func_map;
+    }; // class SymbolInfoManager
+
+} // namespace MYGL::IRGen::FunctionLocal
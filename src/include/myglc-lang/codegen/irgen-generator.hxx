@@ -10,6 +10,7 @@
 #include "myglc-lang/ast-node.hxx"
 #include "myglc-lang/ast-code-visitor.hxx"
 #include "myglc-lang/code-visitors/expr-checker.hxx"
+#include "myglc-lang/codegen/irgen-function-local.hxx"
 #include "myglc-lang/codegen/irgen-type-forwarding.hxx"
 #include "myglc-lang/codegen/irgen-symbol-mapping.hxx"
 #include <cstdint>
@@ -21,6 +22,8 @@ namespace MYGL::IRGen {
     using namespace MTB;
     using namespace GenUtil;
 
+    /** @class Generator
+     * @brief 把一个编译单元的语法树翻译成 IR 模块. generate() 要在语法分析完成以后调用. */
     class Generator: public Object,
                      public CodeVisitor {
     public:
@@ -78,6 +81,10 @@ namespace MYGL::IRGen {
         bool visit(FuncParam::UnownedPtrT node) override;
         bool visit(ArrayInfo::UnownedPtrT node) override;
     private:
+        void _begin_module();
+        owned<IR::Builder> _finish_module();
+        void _declare_outer_functions(Scope *unit_scope);
+
         void _generate_constant_globl(Variable *constant);
         void _generate_variable_globl(Variable *variable);
 
@@ -0,0 +1,27 @@
+#pragma once
+#ifndef __MYGL_IRGEN_GLOBAL_INIT_H__
+#define __MYGL_IRGEN_GLOBAL_INIT_H__
+
+#include "base/mtb-object.hxx"
+#include "mygl-ir/ir-constant.hxx"
+#include "mygl-ir/irbase-type.hxx"
+#include "myglc-lang/ast-node.hxx"
+#include "myglc-lang/code-visitors/expr-checker.hxx"
+
+namespace MYGL::IRGen {
+
+/** @fn make_global_init(checker, variable, ir_type)
+ * @brief 全局量 variable 的初始值, ir_type 是它映射好的 IR 类型.
+ *
+ * 没有初始值时是零. 数组的初始化列表先一趟展开成 SparseInitList, 只为写出来的
+ * 非零元素生成常量; 没有元素的子数组保持全零, 不展开, 所以常量占用的内存只和
+ * 非零元素的个数有关.
+ *
+ * @throws Ast::NullException 初始值不是常量, 或者用单个值初始化数组时.
+ * @throws Utility::AstIndexerContext::BrokenListException 列表的形状和数组不符时. */
+MTB::owned<IR::Constant>
+make_global_init(GenUtil::ExprChecker &checker, Ast::Variable *variable, IR::Type *ir_type);
+
+} // namespace MYGL::IRGen
+
+#endif
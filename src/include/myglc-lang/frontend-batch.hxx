@@ -0,0 +1,88 @@
+#ifndef __MYGL_LANG_FRONTEND_BATCH_H__
+#define __MYGL_LANG_FRONTEND_BATCH_H__ 1L
+
+#include "base/mtb-object.hxx"
+#include "mygl-ir/ir-module.hxx"
+#include "myglc-lang/ast-code-context.hxx"
+#include "myglc-lang/ast-source-registry.hxx"
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MYGL::Driver {
+    /** @class BatchFrontend
+     * @brief 批量前端. 一次处理很多个 SysY 源文件: 每个文件是一个独立的编译单元,
+     *        在线程池上各自完成词法分析、语法分析和常量折叠 (ExprChecker::fold_tree).
+     *        已经生成好的 IR 模块用 link() 并行地链接成一个.
+     *
+     * 运行时函数声明(preclude)在构造时只解析一次, 所有单元共用它的语法树和作用域.
+     * 源文件通过同一张 SourceRegistry 映射进内存, 重复的文件只映射一次.
+     *
+     * 一个单元失败不影响其他单元: 失败原因记在 `Unit::error` 里.
+     *
+     * `__MTB_OBJECT_ATOMIC_REFCOUNT__` 为 0 时 check() 和 link() 都退化成单线程.
+     *
+     * @note 这里不生成 IR: IRGen::Generator 的语句和表达式 visit、IR::Builder、
+     *       TypeMapper 在树里还没有定义, 接上去链接不过. 能单独运行的只有全局量
+     *       初始值(IRGen::make_global_init), 它需要映射好的 IR 类型, 也就离不开
+     *       TypeMapper. 所以 link() 的输入目前只能是别处生成的模块, 比如
+     *       driver -l 读进来的二进制 IR. */
+    class BatchFrontend {
+    public:
+        /** @struct Unit
+         * @brief 一个编译单元的结果. */
+        struct Unit {
+            std::string            filename;
+            Ast::CodeContext::PtrT ctx;    // 只有 keep_ast 时保留, 否则检查完就释放
+            bool                   ok = false;
+            std::string            error;  // 失败原因, 成功时为空
+
+            bool is_ok() const { return ok; }
+        }; // struct Unit
+        using UnitListT = std::vector<Unit>;
+    public:
+        /** @fn BatchFrontend(preclude_source, nworkers)
+         * @param preclude_source 所有单元共用的公共源码, 一般是运行时函数的 extern 声明
+         * @param nworkers        工作线程数. 为 0 时取硬件线程数
+         * @throws NullException preclude 解析失败时 */
+        explicit BatchFrontend(std::string_view preclude_source, size_t nworkers = 0);
+        BatchFrontend(BatchFrontend const &) = delete;
+        BatchFrontend &operator=(BatchFrontend const &) = delete;
+
+        /** @property nworkers{get;} */
+        size_t get_nworkers() const { return _nworkers; }
+        /** @property keep_ast{get;set;}
+         * @brief 检查完以后是否保留每个单元的语法树. 默认不保留, 以便尽早释放内存. */
+        bool get_keep_ast() const     { return _keep_ast; }
+        void set_keep_ast(bool value) { _keep_ast = value; }
+
+        /** @property preclude{get;} 解析好的公共源码 */
+        Ast::CodeContext::PtrT const &get_preclude() const { return _preclude; }
+        /** @property registry{access;} 源文件映射表 */
+        Ast::SourceRegistry &registry() { return _registry; }
+
+        /** @fn check(filenames)
+         * @brief 并行检查所有文件. 结果按 filenames 的顺序排列, 与调度顺序无关. */
+        UnitListT check(std::vector<std::string> const &filenames);
+
+        /** @fn checkOne(filename)
+         * @brief 在当前线程上解析一个文件并折叠它的常量. 不抛异常, 错误记在返回值里. */
+        Unit checkOne(std::string const &filename);
+
+        /** @fn link(modules, name)
+         * @brief 把 modules 按顺序链接成一个名为 name 的新模块, 原来的模块保持不变.
+         *        和 IRUtil::link_modules() 的结果一样, 只是各模块先并行地序列化成
+         *        二进制格式 (引用计数不是原子的时候串行), 再依次合并进新模块.
+         * @throws IRUtil::LinkException 模块之间有重复定义或者声明不一致时 */
+        MTB::owned<IR::Module> link(std::span<IR::Module* const> modules, std::string_view name);
+    private:
+        Ast::CodeContext::PtrT _preclude;
+        Ast::SourceRegistry    _registry;
+        size_t                 _nworkers;
+        bool                   _keep_ast = false;
+    }; // class BatchFrontend
+} // namespace MYGL::Driver
+
+#endif
@@ -19,22 +19,28 @@ namespace MYGL::Ast {
      * @fn advance(uint32_t)
      * @fn advance_and_count(uint32_t) */
     struct SourceLocation {
-        std::string *owner;
+        std::string_view const *owner; // 整份源码, 可能直接指向文件映射
+
         size_t    location;
-        int line, col;   // 所处行列。
+        int line, col;   // 所处行列。line 为 0 表示还没算, 见 resolve()
 
-        inline char *actual() const {
+        inline char const *actual() const {
             return owner->data() + location;
         }
         inline std::string to_string() const {
-            return std::format("(line {}, col {})", line, col);
+            int l = line, c = col;
+            resolve(l, c);
+            return std::format("(line {}, col {})", l, c);
         }
+        /** @brief 取行列号. 词法分析器只记偏移, 不算行列 (line 为 0), 这时从 owner
+         *         开头数换行算出来; 只在报错、打印的时候用, 不缓存. */
+        void resolve(int &line, int &col) const;
         /** @brief 获取以该位置为中心，向左backwd个字符、向右fwd个字符的字串 */
         std::string_view get_content(int backwd = 0, int fwd = 10) const;
         /** @brief 获取以自己为基址的第index个字符. */
         const char &operator[](int index) const { return actual()[index]; }
         /** @brief 把自己当成const char*指针. */
-        char *operator*() const { return actual(); }
+        char const *operator*() const { return actual(); }
 
         /** @brief 如果源码没有结束的话就向后移动nchars个字符，并返回自己。 */
         SourceLocation &advance(uint32_t nchars = 1);
@@ -49,26 +49,48 @@ namespace MYGL::Utility {
         std::vector<int> step_list;         /// 每个维度对应的步数列表。
         int deepest = 0;
         int total, cur_step = 0, max_step = 0;
-        IntValue::PtrT result;
+        std::shared_ptr<IntValue> result; /// 省略的元素补出来的 0, 不在语法树上
     }; // struct IndexerContext
 
+    /** @struct SparseInitList
+     * @brief 一趟展开的初始化列表. 多维数组按行优先的顺序给每个元素编上偏移,
+     *        只记录列表里写出来的非零元素, 其余元素都是 0. 占用的内存和展开的
+     *        时间都只和列表本身的长度有关, 和数组的大小无关.
+     *
+     * 嵌套的子列表必须从它对应的子数组的开头开始, 否则抛 BrokenListException. */
+    struct SparseInitList {
+        struct Element {
+            size_t      offset;
+            Expression *expr;
+        }; // struct Element
+        using ElemListT = std::vector<Element>;
+        using PtrT      = std::shared_ptr<SparseInitList const>;
+
+        std::vector<int>    dimension_list; /// 展开时给的维度列表, 第一维可以是 0(省略)
+        std::vector<size_t> step_list;      /// 每个维度的下标加 1 时偏移的增量
+        ElemListT           elements;       /// 按偏移严格升序
+        size_t              total = 0;      /// 元素总数. 第一维省略时由列表长度推出
+
+        /** @fn at(offset)
+         * @brief 偏移为 offset 的元素. 没有写出来的元素(也就是 0)返回 null. */
+        Expression *at(size_t offset) const;
+        /** @fn offset_of(index_list, offset)
+         * @brief 把下标列表换算成偏移. 下标越界时返回 false. */
+        bool offset_of(std::vector<int> const &index_list, size_t &offset) const;
+
+        /** @fn Get(init_list, dimension_list)
+         * @brief 取 init_list 按 dimension_list 展开的结果. 结果缓存在 init_list 结点上,
+         *        同一个列表只展开一次.
+         * @throws AstIndexerContext::BrokenListException 列表的形状和维度不符时 */
+        static PtrT Get(InitList::UnownedPtrT init_list, std::vector<int> const &dimension_list);
+    }; // struct SparseInitList
+
+    /** @class AstIndexer
+     * @brief 按下标取初始化列表里的元素. 列表只展开一次(见 SparseInitList),
+     *        之后每次取元素都是二分查找. */
     class AstIndexer: protected AstIndexerContext {
     public:
-        class BrokenListException: public std::exception {
-        public:
-            BrokenListException(InitList::UnownedPtrT list, std::string_view msg)
-                : msg(std::format("BrokenList `{}`: {}",
-                      list->range().get_content(),
-                      msg)),
-                  list(list) {
-            }
-
-            cstring what() const noexcept override {
-                return msg.c_str();
-            }
-            std::string           msg;
-            InitList::UnownedPtrT list;
-        }; // class BrokenListException
+        using AstIndexerContext::BrokenListException;
     public:
         AstIndexer(InitList::UnownedPtrT init_list,
                 std::vector<int> const &dimension_list,
@@ -77,7 +99,7 @@ namespace MYGL::Utility {
         inline Expression::UnownedPtrT operator() () {
             Expression::UnownedPtrT ret;
             try {
-                ret = do_calculate(init_list, 0);
+                ret = do_calculate();
             } catch (BrokenListException &e) {
                 std::clog << e.what() << std::endl;
                 throw e;
@@ -85,7 +107,7 @@ namespace MYGL::Utility {
             return ret;
         }
     private:
-        Expression::UnownedPtrT do_calculate(InitList *node, int depth);
+        Expression::UnownedPtrT do_calculate();
     }; // class Indexer
 
     class AstArrayFiller: public AstIndexerContext {
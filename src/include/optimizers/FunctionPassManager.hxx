@@ -0,0 +1,80 @@
+#ifndef MYGL_FUNCTION_PASS_MANAGER_H
+#define MYGL_FUNCTION_PASS_MANAGER_H
+
+#include "base/mtb-object.hxx"
+#include "mygl-ir/ir-constant-function.hxx"
+#include "mygl-ir/ir-module.hxx"
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace MYGL::Optimizers {
+
+    /** @class FunctionPass
+     * @brief 函数级优化遍. 一次只看一个函数体, 不同函数之间互不影响, 所以
+     *        `FunctionPassManager` 会在多个线程上同时对不同函数调用 `runOnFunction`.
+     *
+     * 实现函数级优化遍时要遵守:
+     * - `runOnFunction` 要可重入: 不要往 Pass 对象自己身上写状态, 需要的临时数据放在栈上;
+     * - 只修改传进来的函数. 可以读全局变量和其他函数, 可以让指令使用常量/全局变量/函数,
+     *   但不要遍历或替换它们的使用链表, 也不要往 Module 里增删函数和全局变量;
+     * - 类型一律通过 Module 的 TypeContext 获取. */
+    imcomplete class FunctionPass: public MTB::Object {
+    public:
+        using RefT = MTB::owned<FunctionPass>;
+
+        /** @property name{get;} abstract */
+        abstract std::string_view get_name() const = 0;
+
+        /** @fn runOnFunction(fn) abstract
+         * @brief 对函数定义 fn 执行优化. fn 一定不是函数声明.
+         * @return 是否修改了 fn */
+        abstract bool runOnFunction(IR::Function *fn) = 0;
+    }; // imcomplete class FunctionPass
+
+    /** @class FunctionPassManager
+     * @brief 按顺序对模块里的每个函数定义执行一串函数级优化遍. 每个函数是一个任务,
+     *        由工作窃取线程池调度, 函数内部的所有遍在同一个线程上依次执行.
+     *
+     * 任务执行期间当前线程的竞技场会切换成函数自己的竞技场, 所以优化遍新建的
+     * 指令和函数体其他部分放在一起.
+     *
+     * 当 `__MTB_OBJECT_ATOMIC_REFCOUNT__` 为 0 时引用计数不是线程安全的, 此时
+     * 不论 nthreads 是多少都在调用线程上串行执行. */
+    class FunctionPassManager {
+    public:
+        using PassListT = std::vector<FunctionPass::RefT>;
+    public:
+        /** @fn FunctionPassManager(nthreads)
+         * @param nthreads 工作线程数. 0 表示取硬件线程数, 1 表示在调用线程上串行执行. */
+        explicit FunctionPassManager(size_t nthreads = 0);
+
+        /** @property passes{get;} */
+        PassListT const &get_passes() const { return _passes; }
+
+        /** @property nthreads{get;set;} */
+        size_t get_nthreads() const { return _nthreads; }
+        void   set_nthreads(size_t value) { _nthreads = value; }
+
+        /** @fn addPass(pass)
+         * @throws NullException 当 pass 为 null 时 */
+        FunctionPassManager &addPass(FunctionPass::RefT pass);
+
+        /** @fn run(module)
+         * @brief 对模块里的所有函数定义执行全部优化遍. 任一遍抛出异常时, 等其他已经
+         *        开始的函数执行完以后重新抛出第一个异常.
+         * @return 被修改过的函数个数 */
+        size_t run(IR::Module *module);
+
+        /** @fn runOnFunction(fn)
+         * @brief 在当前线程上对单个函数执行全部优化遍.
+         * @return fn 是否被修改 */
+        bool runOnFunction(IR::Function *fn);
+    private:
+        PassListT _passes;
+        size_t    _nthreads;
+    }; // class FunctionPassManager
+
+} // namespace MYGL::Optimizers
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef MYGL_GVN_PASS_H
+#define MYGL_GVN_PASS_H
+
+#include "optimizers/FunctionPassManager.hxx"
+#include <string_view>
+
+namespace MYGL::Optimizers {
+
+    /** @class GVNPass
+     * @brief 按支配树作用域的全局值编号, 删除重复计算的表达式.
+     *
+     * 参与编号的是没有副作用、结果只取决于操作数的指令: `BinarySSA`、`CompareSSA`、
+     * `CastSSA` 和 `GetElemPtrSSA`. 表达式的键是 (操作码, 类型, 附加标志, 操作数),
+     * 附加标志是二元运算的 sign_flag 或者比较的条件. 操作码满足交换律
+     * (`OpCode::is_swappable()`) 时两个操作数不分先后; 比较交换左右操作数以后把
+     * 条件里的小于和大于对调, 所以 `a < b` 和 `b > a` 是同一个表达式.
+     *
+     * 沿支配树先序遍历, 每个块能看到的表达式表只包含支配它的块里的指令. 遇到表里已有的
+     * 表达式时, 用 `IRUtil::usee_replace_this_with` 把这条指令换成表里那条 (代表) 再删除.
+     * 代表的使用者直接用它, 所以一个等价类始终只有一个值, 值编号就是这个值本身.
+     *
+     * 只删除被支配的完全冗余, 不做部分冗余消除, 也不跨 phi 识别等价.
+     * 不改变控制流图, 函数上缓存的支配树仍然有效. */
+    class GVNPass final: public FunctionPass {
+    public:
+        using RefT = MTB::owned<GVNPass>;
+    public:
+        std::string_view get_name() const final { return "gvn"; }
+        bool runOnFunction(IR::Function *fn) final;
+    }; // class GVNPass final
+
+} // namespace MYGL::Optimizers
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef MYGL_MEM2REG_PASS_H
+#define MYGL_MEM2REG_PASS_H
+
+#include "optimizers/FunctionPassManager.hxx"
+#include "mygl-ir/ir-instruction.hxx"
+#include <string_view>
+
+namespace MYGL::Optimizers {
+
+    /** @class Mem2RegPass
+     * @brief 把只被直接读写的标量 `alloca` 提升成 SSA 值.
+     *
+     * 可提升的 alloca 要满足: 元素类型是整数、浮点数或者指针; 所有使用者要么是以它为
+     * 操作数的 `load`, 要么是以它为目标的 `store`, 地址本身没有被存到别处或者传给别的
+     * 指令. 提升时按下面的顺序尝试:
+     * - 没有 `load`: 直接删掉所有 `store` 和 alloca;
+     * - 只有一条 `store`, 并且它支配所有 `load`: 每个 `load` 都换成存进去的值;
+     * - 所有读写都在同一个基本块里: 按指令顺序扫一遍, 每个 `load` 换成它前面最近一条
+     *   `store` 存的值, 前面没有 `store` 的换成 undef;
+     * - 其余情况: 在定值块的迭代支配边界上, 只给变量活跃进入的块放置 `phi`, 再沿支配树
+     *   走一遍完成重命名. 所有剩下的 alloca 共用这一趟遍历.
+     *
+     * 没有初值的读取得到 `undef`. 提升不改变控制流图, 所以函数上缓存的支配树仍然有效. */
+    class Mem2RegPass final: public FunctionPass {
+    public:
+        using RefT = MTB::owned<Mem2RegPass>;
+
+        /** @fn isPromotable(alloca) static
+         * @brief alloca 是否满足上面的可提升条件. */
+        static bool isPromotable(IR::AllocaSSA *alloca);
+    public:
+        std::string_view get_name() const final { return "mem2reg"; }
+        bool runOnFunction(IR::Function *fn) final;
+    }; // class Mem2RegPass final
+
+} // namespace MYGL::Optimizers
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef MYGL_SCCP_PASS_H
+#define MYGL_SCCP_PASS_H
+
+#include "optimizers/FunctionPassManager.hxx"
+#include <string_view>
+
+namespace MYGL::Optimizers {
+
+    /** @class SCCPPass
+     * @brief 稀疏条件常量传播 (Wegman-Zadeck).
+     *
+     * 每个指令的值取 "未定 / 常量 / 不是常量" 三种格值之一, 常量只有 `IntConst` 和
+     * `FloatConst`. 求解时维护两张工作表: 新变成可执行的控制流边, 以及格值下降了的
+     * 指令. 只有可执行的块里的指令会被求值; `PhiSSA` 只合并来自可执行边的入口;
+     * `br` 和 `switch` 的条件是常量时只有对应的那条边可执行.
+     *
+     * 求解完以后:
+     * - 格值是常量的指令被替换成常量并删除;
+     * - 只剩一个可执行后继的 `br`/`switch` 换成 `jump`, 其余后继里 PhiSSA 的入口一并摘掉;
+     * - 最后用 `IRUtil::Function::gc_mark_sweep` 删除从入口走不到的基本块.
+     *
+     * 可以折叠的运算是整数/浮点的算术、位运算、比较、类型转换、取反和 `select`.
+     * 除以零、移位越界之类结果未定义的运算不折叠. `load`、`call` 等读内存或者有副作用
+     * 的指令一律不是常量. */
+    class SCCPPass final: public FunctionPass {
+    public:
+        using RefT = MTB::owned<SCCPPass>;
+    public:
+        std::string_view get_name() const final { return "sccp"; }
+        bool runOnFunction(IR::Function *fn) final;
+    }; // class SCCPPass final
+
+} // namespace MYGL::Optimizers
+
+#endif
@@ -398,6 +398,7 @@ inline namespace basic_block_impl {
 
         if (target_it == _jumps_to.end()) {
             _jumps_to.insert(info);
+            _markCfgChanged();
             return 1;
         }
 
@@ -416,6 +417,7 @@ inline namespace basic_block_impl {
         size_t const& use_count = target_it->use_count;
         if (use_count == 1) {
             _jumps_to.erase(target_it);
+            _markCfgChanged();
         } else {
             size_t &mut_use_count = const_cast<size_t&>(use_count);
             mut_use_count--;
@@ -430,6 +432,7 @@ inline namespace basic_block_impl {
         if (target_it == _jumps_to.end())
             return;
         _jumps_to.erase(target_it);
+        _markCfgChanged();
     }
 
     size_t BasicBlock::addComesFrom(BasicBlock *comes_from)
@@ -486,6 +489,12 @@ inline namespace basic_block_impl {
         _comes_from.erase(target_it);
     }
 
+    void BasicBlock::_markCfgChanged()
+    {
+        if (_parent != nullptr)
+            get_parent()->markCfgChanged();
+    }
+
     BasicBlock *BasicBlock::get_default_next() const
     {
         IBasicBlockTerminator *terminator = get_terminator();
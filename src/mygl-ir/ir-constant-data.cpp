@@ -1,17 +1,112 @@
 #include "base/mtb-exception.hxx"
 #include "mygl-ir/ir-constant.hxx"
 #include "mygl-ir/irbase-value-visitor.hxx"
+#include <bit>
 #include <cmath>
+#include <mutex>
 #include <stdexcept>
+#include <unordered_map>
 
 namespace MYGL::IR {
 
 using MTB::owned;
 using oss = std::ostringstream;
 
+inline namespace constant_data_impl {
+    /** 整数、浮点常量的驻留表, 键是 (类型, 位模式).
+     *
+     * i32、f32 这些基本类型是所有 TypeContext 共用的单例, 同一个常量会出现在许多
+     * 模块里, 所以表是进程级的. 表里只存裸指针, 不延长常量的寿命: 常量析构时把
+     * 自己摘掉, 键里的类型因此也不会比常量活得久. 按键分段加锁, 并行生成各个单元
+     * 时只有碰巧落在同一段的常量才互相等待. */
+    class ConstantDataPool {
+    public:
+        struct Key {
+            Type    *type;
+            uint64_t bits;
+            bool operator==(Key const &) const = default;
+        }; // struct Key
+        struct KeyHasher {
+            size_t operator()(Key const &key) const noexcept {
+                uint64_t h = (reinterpret_cast<uintptr_t>(key.type) >> 4) ^
+                             (key.bits * 0x9E3779B97F4A7C15ull);
+                return size_t(h ^ (h >> 29));
+            }
+        }; // struct KeyHasher
+    public:
+        static ConstantDataPool &Global() {
+            /* 故意不析构: 静态对象里的常量在进程退出时析构, 那时还要查表 */
+            static ConstantDataPool *instance = new ConstantDataPool;
+            return *instance;
+        }
+
+        /** 查找 key 对应的常量, 没有就用 make() 造一个放进表里. */
+        template<typename ConstT, typename MakeT>
+        owned<ConstT> getOrCreate(Key const &key, MakeT &&make)
+        {
+            size_t hash  = KeyHasher{}(key);
+            Shard &shard = _shards[(hash >> 7) % NSHARDS];
+            std::lock_guard lock{shard.lock};
+            auto [iter, inserted] = shard.table.try_emplace(key, nullptr);
+            if (!inserted && tryRetain(iter->second)) {
+                owned<ConstT> ret{static_cast<ConstT*>(iter->second)};
+                iter->second->__dec_refcnt_and_test(); // 抵掉 tryRetain 加的那一次
+                return ret;
+            }
+            /* 表里没有, 或者旧常量的引用计数已经归零、析构函数还没来得及摘掉它 */
+            try {
+                owned<ConstT> ret = make();
+                iter->second = ret.get();
+                return ret;
+            } catch (...) {
+                if (inserted)
+                    shard.table.erase(iter);
+                throw;
+            }
+        }
+        /** 常量析构时调用. 表里的项已经换成新常量时不动它. */
+        void remove(Key const &key, ConstantData const *value)
+        {
+            Shard &shard = _shards[(KeyHasher{}(key) >> 7) % NSHARDS];
+            std::lock_guard lock{shard.lock};
+            if (auto iter = shard.table.find(key);
+                iter != shard.table.end() && iter->second == value)
+                shard.table.erase(iter);
+        }
+    private:
+        static constexpr size_t NSHARDS = 16;
+        struct Shard {
+            std::mutex lock;
+            std::unordered_map<Key, ConstantData*, KeyHasher> table;
+        }; // struct Shard
+        Shard _shards[NSHARDS];
+
+        /** 引用计数不为零时加一. 为零说明常量正在析构, 不能再交出去. */
+        static bool tryRetain(ConstantData *value)
+        {
+            if (value == nullptr)
+                return false;
+#if __MTB_OBJECT_ATOMIC_REFCOUNT__ != 0
+            int count = value->__ref_count__.load(std::memory_order_relaxed);
+            while (count > 0) {
+                if (value->__ref_count__.compare_exchange_weak(count, count + 1))
+                    return true;
+            }
+            return false;
+#else
+            if (value->__ref_count__ == 0)
+                return false;
+            value->__ref_count__++;
+            return true;
+#endif
+        }
+    }; // class ConstantDataPool
+} // inline namespace constant_data_impl
+
 /** @class Constant */
 Constant::Constant(ValueTID type_id, Type *value_type)
     : User(type_id, value_type) {
+    _use_list_shared = true;
 }
 Constant::ConstantKind Constant::get_const_kind() const
 {
@@ -32,9 +127,9 @@ owned<Constant> Constant::CreateZeroOrUndefined(Type *type)
     if (type == nullptr)
         throw NullException("value_type", "Value type connot be null");
     if (type->is_integer_type())
-        return new IntConst(static_cast<IntType*>(type), 0);
+        return IntConst::Create(static_cast<IntType*>(type), 0);
     if (type->is_float_type())
-        return new FloatConst(static_cast<FloatType*>(type), 0.0);
+        return FloatConst::Create(static_cast<FloatType*>(type), 0.0);
     if (type->is_array_type())
         return ArrayExpr::CreateEmpty(static_cast<ArrayType*>(type));
     return new UndefinedConst(type);
@@ -65,9 +160,9 @@ owned<ConstantData> ConstantData::CreateZero(Type *value_type) noexcept(false)
         };
     }
     if (value_type->is_integer_type())
-        return new IntConst(static_cast<IntType*>(value_type), 0);
+        return IntConst::Create(static_cast<IntType*>(value_type), 0);
     if (value_type->is_float_type())
-        return new FloatConst(static_cast<FloatType*>(value_type), 0.0);
+        return FloatConst::Create(static_cast<FloatType*>(value_type), 0.0);
     throw TypeMismatchException {
             value_type,
             (oss("type ") << value_type << " is not derived from `ValueType`").str(),
@@ -79,18 +174,39 @@ owned<ConstantData> ConstantData::CreateZero(Type *value_type) noexcept(false)
 /** @class IntConst */
 IntConst::IntConst(IntType *value_type, int64_t value)
     : ConstantData(ValueTID::INT_CONST, value_type),
-      _value(value_type->get_binary_bits(), value) {
-    _name = std::to_string(_value.get_signed_value());
+      _value(uint8_t(value_type->get_binary_bits()), value) {
 }
 IntConst::IntConst(IntType *value_type, APInt value, bool as_signed)
     : ConstantData(ValueTID::INT_CONST, value_type),
-      _value(value_type->get_binary_bits(), 0) {
+      _value(uint8_t(value_type->get_binary_bits()), 0) {
     _value.set_value(as_signed ?
                      value.get_signed_value():
                      value.get_unsigned_value());
-    _name = std::to_string(_value.get_signed_value());
 }
-IntConst::~IntConst() = default;
+IntConst::~IntConst()
+{
+    if (_interned) {
+        ConstantDataPool::Global().remove(
+            {get_value_type(), _value.get_unsigned_value()}, this);
+    }
+}
+
+void IntConst::set_value(APInt value)
+{
+    /* 驻留常量被所有模块共用, 改了值还会让它在驻留表里的键失效 */
+    if (_interned) {
+        crash_with_stacktrace(true, CURRENT_SRCLOC_F,
+            "MYGL::IR::IntConst::set_value(...): interned constant is immutable, copy() it first");
+    }
+    _value = value;
+}
+
+std::string IntConst::get_name_or_id() const
+{
+    if (!_name.empty())
+        return std::string{_name.str()};
+    return std::to_string(_value.get_signed_value());
+}
 
 owned<ConstantData> IntConst::castToClosest(Type *target) const
 {
@@ -99,12 +215,12 @@ owned<ConstantData> IntConst::castToClosest(Type *target) const
         IntType *ity = static_cast<IntType*>(target);
         uint8_t target_bits = ity->get_binary_bits();
         if (target_bits > value_ty->get_binary_bits())
-            return new IntConst(ity, get_value().sext(target_bits));
+            return Create(ity, get_value().sext(target_bits));
         return this;
     }
     if (target->is_float_type()) {
         FloatType *fty = static_cast<FloatType*>(target);
-        return new FloatConst(fty, get_float_value());
+        return FloatConst::Create(fty, get_float_value());
     }
     throw TypeMismatchException {
         target,
@@ -121,16 +237,16 @@ owned<ConstantData> IntConst::add(const owned<ConstantData> rhs) const
         IntType *rity = static_cast<IntType*>(rty);
         IntType *ret_ty = ity->get_binary_bits() >= rity->get_binary_bits() ?
                           ity: rity;
-        return new IntConst {
+        return Create(
             ret_ty,
             get_value() + rhs.static_get<IntConst>()->get_value()
-        };
+        );
     }
     if (rty->is_float_type()) {
-        return new FloatConst {
+        return FloatConst::Create(
             static_cast<FloatType*>(rty),
             get_float_value() + rhs->get_float_value()
-        };
+        );
     }
     return rhs->add(castToClosest(rty));
 }
@@ -145,10 +261,10 @@ owned<ConstantData> IntConst::mul(const owned<ConstantData> rhs) const
         IntType *irty = static_cast<IntType*>(rty);
         IntType *ret_ty = ity->get_binary_bits() >= irty->get_binary_bits() ?
                           ity: irty;
-        return new IntConst {
+        return Create(
             ret_ty,
             get_value() * rhs.static_get<IntConst>()->get_value()
-        };
+        );
     }
     return rhs->mul(castToClosest(rty));
 }
@@ -163,10 +279,10 @@ owned<ConstantData> IntConst::sdiv(const owned<ConstantData> rhs) const
         IntType *irty = static_cast<IntType*>(rty);
         IntType *ret_ty = ity->get_binary_bits() >= irty->get_binary_bits() ?
                           ity: irty;
-        return new IntConst {
+        return Create(
             ret_ty,
             get_value() / rhs.static_get<IntConst>()->get_value()
-        };
+        );
     }
     return castToClosest(rty)->sdiv(rhs);
 }
@@ -178,34 +294,34 @@ owned<ConstantData> IntConst::udiv(const owned<ConstantData> rhs) const
         IntType *irty = static_cast<IntType*>(rty);
         IntType *ret_ty = ity->get_binary_bits() >= irty->get_binary_bits() ?
                           ity: irty;
-        return new IntConst {
+        return Create(
             ret_ty,
             get_value().udiv(rhs.static_get<IntConst>()->get_value())
-        };
+        );
     }
     return castToClosest(rty)->udiv(rhs);
 }
 owned<ConstantData> IntConst::smod(const owned<ConstantData> rhs) const
 {
     if (rhs->is_integer()) {
-        return new IntConst {
+        return Create(
             static_cast<IntType*>(rhs->get_value_type()),
             get_value().srem({
                 get_value().get_binary_bits(),
                 rhs->get_int_value()
-            })};
+            }));
     }
     return castToClosest(rhs->get_value_type())->smod(rhs);
 }
 owned<ConstantData> IntConst::umod(const owned<ConstantData> rhs) const
 {
     if (rhs->is_integer()) {
-        return new IntConst {
+        return Create(
             static_cast<IntType*>(rhs->get_value_type()),
             get_value().srem({
                 get_value().get_binary_bits(),
                 int64_t(rhs->get_uint_value())
-            })};
+            }));
     }
     return castToClosest(rhs->get_value_type())->umod(rhs);
 }
@@ -236,19 +352,52 @@ CompareResult IntConst::compare(const owned<ConstantData> rhs) const
     return CompareResult::FALSE;
 }
 /** static class IntConst */
-static InlineInit<IntConst> _BooleanTrue(IntType::i1, 1),
-                            _BooleanFalse(IntType::i1, 0);
-owned<IntConst> IntConst::BooleanTrue(&_BooleanTrue.instance),
-                IntConst::BooleanFalse(&_BooleanFalse.instance);
+/* 用函数内的静态对象: 命名空间作用域的静态常量可能在 irbase-type.cpp 构造
+ * IntType::i1 之前就被构造, 那时读 i1 的位宽是未定义行为. */
+owned<IntConst> const &IntConst::BooleanTrue()
+{
+    static InlineInit<IntConst> instance(IntType::i1, 1);
+    static owned<IntConst> ret(&instance.instance);
+    return ret;
+}
+owned<IntConst> const &IntConst::BooleanFalse()
+{
+    static InlineInit<IntConst> instance(IntType::i1, 0);
+    static owned<IntConst> ret(&instance.instance);
+    return ret;
+}
+
+owned<IntConst> IntConst::Create(IntType *value_type, int64_t value)
+{
+    return Create(value_type, APInt{64, value});
+}
+owned<IntConst> IntConst::Create(IntType *value_type, APInt value, bool as_signed)
+{
+    if (value_type == IntType::i1)
+        return (value.get_unsigned_value() & 1) ? BooleanTrue(): BooleanFalse();
+    /* 先按目标位宽截断, 截断后的位模式才是键 */
+    APInt bits{uint8_t(value_type->get_binary_bits()), 0};
+    bits.set_value(as_signed ? value.get_signed_value(): value.get_unsigned_value());
+    return ConstantDataPool::Global().getOrCreate<IntConst>(
+        {value_type, bits.get_unsigned_value()},
+        [value_type, &bits]() {
+            owned<IntConst> ret = new IntConst(value_type, bits, false);
+            ret->_interned = true;
+            return ret;
+        });
+}
 /** end class IntConst */
 
 /** @class FloatConst */
-namespace float_const_impl {
-
-}
 owned<FloatConst> FloatConst::Create(FloatType *value_type, double value)
 {
-    RETURN_MTB_OWN(FloatConst, value_type, value);
+    return ConstantDataPool::Global().getOrCreate<FloatConst>(
+        {value_type, std::bit_cast<uint64_t>(value)},
+        [value_type, value]() {
+            owned<FloatConst> ret = new FloatConst(value_type, value);
+            ret->_interned = true;
+            return ret;
+        });
 }
 
 FloatConst::FloatConst(FloatType *value_type, double value) noexcept
@@ -256,7 +405,22 @@ FloatConst::FloatConst(FloatType *value_type, double value) noexcept
       _value(value) {
 }
 
-FloatConst::~FloatConst() = default;
+void FloatConst::set_value(double value)
+{
+    if (_interned) {
+        crash_with_stacktrace(true, CURRENT_SRCLOC_F,
+            "MYGL::IR::FloatConst::set_value(...): interned constant is immutable, copy() it first");
+    }
+    _value = value;
+}
+
+FloatConst::~FloatConst()
+{
+    if (_interned) {
+        ConstantDataPool::Global().remove(
+            {get_value_type(), std::bit_cast<uint64_t>(_value)}, this);
+    }
+}
 
 void FloatConst::accept(IValueVisitor &visitor) {
     visitor.visit(this);
@@ -290,9 +454,7 @@ owned<ConstantData> FloatConst::add(const owned<ConstantData> rhs) const
         );
     }
     if (rhs->is_integer()) {
-        return new FloatConst{
-            fty, get_float_value() + rhs->get_float_value()
-        };
+        return Create(fty, get_float_value() + rhs->get_float_value());
     }
     return rhs->castToClosest(fty)->add(castToClosest(rty));
 }
@@ -401,4 +563,10 @@ void UndefinedConst::accept(IValueVisitor &visitor) {
 }
 /** end class UndefinedConst */
 
+/** @class PoisonConst */
+void PoisonConst::accept(IValueVisitor &visitor) {
+    visitor.visit(this);
+}
+/** end class PoisonConst */
+
 } // namespace MYGL::IR
\ No newline at end of file
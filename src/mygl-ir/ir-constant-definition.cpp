@@ -141,6 +141,7 @@ try {
         _target->removeUseAsUsee(use);
     if (target != nullptr)
         target->addUseAsUsee(use);
+    _target = std::move(target);
 } catch (EmptySetException &e) {
     std::cerr << std::endl
               << Compatibility::osb_fmt("at GlobalVariable::set_target(owned<Constant> target)"
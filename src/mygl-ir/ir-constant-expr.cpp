@@ -1,5 +1,7 @@
 #include "mygl-ir/ir-constant.hxx"
 #include "mygl-ir/irbase-value-visitor.hxx"
+#include <algorithm>
+#include <format>
 
 inline namespace constexpr_impl {
 
@@ -96,6 +98,25 @@ CreateFromValueArray(ValueArrayT const& value_array, Type *content_type)
     ret->element_list()  = value_array;
     return ret;
 }
+owned<ArrayExpr> ArrayExpr::CreateSparse(ArrayType *array_type, SparseListT &&elements)
+{
+    size_t length = array_type->get_length();
+    for (size_t i = 0; i < elements.size(); i++) {
+        MTB_UNLIKELY_IF (elements[i].index >= length ||
+                         (i > 0 && elements[i].index <= elements[i - 1].index)) {
+            throw MTB::Exception {
+                MTB::ErrorLevel::CRITICAL,
+                std::format("ArrayExpr::CreateSparse: element #{} has index {} "
+                            "(array length {}, indices must be strictly increasing)",
+                            i, elements[i].index, length),
+                CURRENT_SRCLOC_F
+            };
+        }
+    }
+    owned<ArrayExpr> ret = own<ArrayExpr>(array_type);
+    ret->_sparse_list = std::move(elements);
+    return ret;
+}
 /** public class ArrayExpr */
 ArrayExpr::ArrayExpr(ArrayType *array_type)
     : ConstantExpr(ValueTID::ARRAY, array_type) {
@@ -114,6 +135,7 @@ ArrayExpr::ValueArrayT &ArrayExpr::element_list()
 
     ArrayType *array_type = static_cast<ArrayType*>(get_value_type());
     init_element_array(_element_list, array_type);
+    _expandSparse();
     return _element_list;
 }
 
@@ -125,6 +147,7 @@ ArrayExpr::get_element_list() const
     
     ArrayType *array_type = static_cast<ArrayType*>(get_value_type());
     init_element_array(const_cast<ValueArrayT&>(_element_list), array_type);
+    const_cast<ArrayExpr*>(this)->_expandSparse();
     return _element_list;
 }
 
@@ -133,6 +156,20 @@ owned<Value> ArrayExpr::getContent(size_t index)
     if (index < 0 || index >= get_content_nmemb()) {
         return new UndefinedConst(get_content_type()); 
     }
+    /* 稀疏数组按下标二分查找, 不展开. 取到的零子数组要放回稀疏表里,
+     * 这样调用者对它的修改才能反映到本数组上. */
+    if (is_sparse()) {
+        auto it = std::lower_bound(_sparse_list.begin(), _sparse_list.end(), index,
+            [](SparseElem const &elem, size_t index) { return elem.index < index; });
+        if (it != _sparse_list.end() && it->index == index)
+            return it->value;
+        Type *elem_type = get_element_type();
+        if (!elem_type->is_array_type())
+            return Constant::CreateZeroOrUndefined(elem_type);
+        owned<Value> subarray = ArrayExpr::CreateEmpty(static_cast<ArrayType*>(elem_type));
+        _sparse_list.insert(it, SparseElem{index, subarray});
+        return subarray;
+    }
     Value *value = element_list()[index];
     if (ArrayType *aty = dynamic_cast<ArrayType*>(value);
         !value->is_defined() && aty != nullptr) {
@@ -146,6 +183,15 @@ bool ArrayExpr::setContent(size_t index, owned<Value> content)
 {
     if (!content->get_value_type()->equals(get_content_type()))
         return false;
+    if (is_sparse()) {
+        auto it = std::lower_bound(_sparse_list.begin(), _sparse_list.end(), index,
+            [](SparseElem const &elem, size_t index) { return elem.index < index; });
+        if (it != _sparse_list.end() && it->index == index)
+            it->value = content;
+        else
+            _sparse_list.insert(it, SparseElem{index, content});
+        return true;
+    }
     if (_element_list.empty()) {
         ArrayType *arrty = static_cast<ArrayType*>(_value_type);
         _element_list.resize(arrty->get_length());
@@ -189,9 +235,33 @@ void ArrayExpr::traverseModify(ValueModifyClosure fn)
     }
 }
 
+void ArrayExpr::traverseNonZero(SparseReadClosure fn) const
+{
+    if (is_sparse()) {
+        for (SparseElem const &i: _sparse_list) {
+            if (fn(i.index, i.value))
+                break;
+        }
+        return;
+    }
+    for (size_t index = 0; index < _element_list.size(); index++) {
+        Value *i = _element_list[index];
+        if (i != nullptr && fn(index, i))
+            break;
+    }
+}
+
 bool ArrayExpr::is_zero() const
 {
     bool ret = true;
+    if (is_sparse()) {
+        for (SparseElem const &i: _sparse_list) {
+            auto c = dynamic_cast<Constant*>(i.value.get());
+            if (c == nullptr || !c->is_zero())
+                return false;
+        }
+        return true;
+    }
     if (_element_list.empty())
         return true;
     for (Value *i: _element_list) {
@@ -205,11 +275,19 @@ bool ArrayExpr::is_zero() const
 
 void ArrayExpr::reset() {
     _element_list.clear();
+    _sparse_list.clear();
 }
 void ArrayExpr::accept(IValueVisitor &visitor) {
     visitor.visit(this);
 }
 
+/** private class ArrayExpr */
+void ArrayExpr::_expandSparse()
+{
+    for (SparseElem &i: _sparse_list)
+        _element_list[i.index] = std::move(i.value);
+    _sparse_list.clear();
+}
 /** end class ArrayExpr */
 
 } // MYGL::IR
\ No newline at end of file
@@ -17,16 +17,33 @@ using namespace std::string_literals;
 using namespace std::string_view_literals;
 
 struct Function::BodyImpl {
+    /* 放在其他成员前面, 所以最后析构: 基本块和指令都析构完以后再 release,
+     * 没有被函数外持有的对象时所有块就在这里一起归还. */
+    struct ArenaOwner {
+        MTB::BumpArena *arena = nullptr;
+        ~ArenaOwner() {
+            if (arena != nullptr)
+                arena->release();
+        }
+    }; // struct ArenaOwner
+
+    ArenaOwner        arena_owner;
     Function         *parent;
+    MTB::BumpArena   *arena;
     BasicBlock::ListT basic_blocks;
     BasicBlock       *entry;
+    uint64_t          cfg_version = 1; // 从 1 开始, 默认构造的分析结果(版本 0)一定过期
+    DomTreePtrT       dominator_cache;
 public:
     void init(Function *parent) {
         this->parent = parent;
+        this->arena  = new MTB::BumpArena();
+        this->arena_owner.arena = arena;
 
         /* basic_blocks 是内联对象, 需要增加一次引用计数来保护 */
         this->basic_blocks.setInlineInit();
         /* 插入一个 entry */
+        MTB::ArenaScope  scope{arena};
         ReturnSSA::RefT  return_ssa = ReturnSSA::CreateDefault(parent);
         BasicBlock::RefT entry      = BasicBlock::CreateWithEnding(parent, return_ssa);
         this->entry = entry;
@@ -54,6 +71,9 @@ BasicBlock *Function::BodyImplProxy::get_entry() const {
 bool Function::BodyImplProxy::is_ssa() const {
     return impl->parent->is_ssa();
 }
+MTB::BumpArena *Function::BodyImplProxy::get_arena() const {
+    return impl->arena;
+}
 
 struct Function::MutableContext {
     Function                 *parent;
@@ -197,23 +217,16 @@ inline namespace function_impl {
         }; // throw NullException
     }
 
-    struct arg_vgetset_base {
-        Argument *arg_unowned;
-    protected:
-        always_inline Use::SetResult do_set(Value *value) {
-            arg_unowned->set_name(value->get_name_or_id());
+    /* 参数槽位的设置钩子. 参数被 Function 独占, 不能被替换, 所以"设置"参数
+     * 的语义是把参数改成新值的名字. */
+    static Use::SetResult arg_set_hook(User *, Use *use, Value *value)
+    {
+        if (value == nullptr)
             return {false};
-        }
-        always_inline Argument *do_get() const {
-            return arg_unowned;
-        }
-    };
-    delegate arg_vget: public arg_vgetset_base {
-        Value *operator()() const { return do_get(); }
-    };
-    delegate arg_vset: public arg_vgetset_base {
-        Use::SetResult operator()(Value *value) { return do_set(value); }
-    };
+        Argument *arg = static_cast<Argument*>(use->get_usee());
+        arg->set_name(value->get_name_or_id());
+        return {false};
+    }
 } // inline namespace function_impl
 
 /** @class Function */
@@ -246,7 +259,7 @@ RefT CreateFromFunctionType(FunctionType     * fty,
 Function::Function(PointerType *type, std::string const& name,
                    Module    *parent, bool     is_declaration)
     : Definition(ValueTID::FUNCTION, type, parent) {
-    _name = name;
+    _name = MTB::Symbol{name};
     auto fty = static_cast<FunctionType*>(type->get_target_type());
     auto &param = fty->get_param_list();
     uint32_t iter = 0, argnum = param.size();
@@ -254,13 +267,13 @@ Function::Function(PointerType *type, std::string const& name,
 
     /* 遍历参数表, 注册参数. 注意, Argument被Function独占所有权, 所以set_usee()动不了它 */
     for (Type *ti: param) {
-        auto arg = own<Argument>(ti, "", this);
-        arg->set_id(iter);
-        _argument_list[iter] = {
-            arg,
-            addValue(arg_vget{arg},
-                              arg_vset{arg})
-        };
+        ArgUsePair &pair = _argument_list[iter];
+        pair.argument = own<Argument>(ti, "", this);
+        pair.argument->set_id(iter);
+        /* Function 是参数的所有者而不是使用者, 所以不登记到参数的 list_as_usee 里 */
+        pair.use_arg = new Use(this, reinterpret_cast<Use::SlotT*>(&pair.argument.__ptr),
+                               Use::SlotKind::OWNED_PTR, arg_set_hook);
+        addUseAsUser(pair.use_arg);
         iter++;
     }
     if (!is_declaration)
@@ -270,6 +283,10 @@ Function::Function(PointerType *type, std::string const& name,
 Function::~Function() {
     if (_body_impl == nullptr)
         return;
+    /* 把所有基本块和指令标记为 FINALIZED, 它们析构时就不会再检查 use-def
+     * 关系; 指令对函数外的值(全局变量、其他函数、常量)的 Use 在析构时自己
+     * 从使用链表上摘下来. 随后 BodyImpl 析构, 基本块列表先释放, 竞技场最后
+     * release, 这时通常已经没有存活对象, 所有块一起归还. */
     for (BasicBlock *i: _body_impl->basic_blocks)
         i->on_function_finalize();
 }
@@ -310,6 +327,11 @@ BasicBlock *Function::get_entry() const {
     chk_has_body(this);
     return _body_impl->entry;
 }
+MTB::BumpArena *Function::get_arena() const {
+    if (_body_impl == nullptr)
+        return nullptr;
+    return _body_impl->arena;
+}
 void Function::set_entry(BasicBlock *entry)
 {
     if (entry == get_entry())
@@ -326,6 +348,22 @@ void Function::set_entry(BasicBlock *entry)
         };
     }
     _body_impl->entry = entry;
+    markCfgChanged();
+}
+
+uint64_t Function::get_cfg_version() const {
+    return _body_impl == nullptr ? 0 : _body_impl->cfg_version;
+}
+void Function::markCfgChanged() {
+    if (_body_impl != nullptr)
+        _body_impl->cfg_version++;
+}
+Function::DomTreePtrT Function::get_dominator_cache() const {
+    return _body_impl == nullptr ? nullptr : _body_impl->dominator_cache;
+}
+void Function::set_dominator_cache(DomTreePtrT tree) {
+    if (_body_impl != nullptr)
+        _body_impl->dominator_cache = std::move(tree);
 }
 size_t Function::collectGarbage() {
     return 0;
@@ -14,7 +14,7 @@ inline namespace alloca_ssa_impl {
     using namespace std::string_view_literals;
 
     static size_t get_real_align(size_t align) {
-        return get_next_power_of_two(align);
+        return fill_to_power_of_two(align);
     }
 
     static PointerType*
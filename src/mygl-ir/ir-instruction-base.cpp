@@ -53,7 +53,10 @@ inline namespace instruction_impl {
         {OpCodeT::SHL,  "shl"}, {OpCodeT::LSHR, "lshr"}, {OpCodeT::ASHR, "ashr"},
 
         {OpCodeT::CALL, "call"}, {OpCodeT::RET, "ret"},
+        {OpCodeT::SELECT, "select"},
         {OpCodeT::GET_ELEMENT_PTR, "getelementptr"},
+        {OpCodeT::EXTRACT_ELEMENT, "extractelement"},
+        {OpCodeT::INSERT_ELEMENT,  "insertelement"},
         {OpCodeT::MEMMOVE, "memmove"},
         {OpCodeT::MEMSET, "memset"},
 
@@ -91,6 +94,20 @@ std::string_view Instruction::OpCode::getString() const
     return name_map.at(self);
 }
 
+Instruction::OpCode Instruction::OpCode::FromString(std::string_view name)
+{
+    using namespace instruction_impl;
+    using NameOpCodeMapT = std::unordered_map<std::string_view, self_t>;
+    static NameOpCodeMapT const opcode_map = []() {
+        NameOpCodeMapT ret;
+        for (auto &[opcode, opcode_name]: opcode_name_map)
+            ret.emplace(opcode_name, opcode);
+        return ret;
+    }();
+    auto it = opcode_map.find(name);
+    return it == opcode_map.end() ? OpCode{NONE} : OpCode{it->second};
+}
+
 /** end enum Instruction::OpCode */
 
 /** @class Instruction.ListAction */
@@ -377,11 +377,31 @@ inline namespace binary_ssa_impl {
         : Instruction(ValueTID::BINARY_SSA, value_type, opcode),
           _sign_flag(sign_flag),
           _operands{std::move(lhs), std::move(rhs)} {
-        MYGL_ADD_USEE_PROPERTY(lhs);
-        MYGL_ADD_USEE_PROPERTY(rhs);
+        addValue(_operands[0]);
+        addValue(_operands[1]);
     }
     BinarySSA::~BinarySSA() = default;
 
+    bool BinarySSA::trySwapOperands()
+    {
+        if (!get_opcode().is_swappable())
+            return false;
+        /* Use 指向的是槽位而不是值, 交换槽位里的值以后, 两个值登记的 Use
+         * 也要跟着交换. */
+        Use *lhs_use = _list_as_user.at(0);
+        Use *rhs_use = _list_as_user.at(1);
+        if (_operands[0] != nullptr)
+            _operands[0]->removeUseAsUsee(lhs_use);
+        if (_operands[1] != nullptr)
+            _operands[1]->removeUseAsUsee(rhs_use);
+        std::swap(_operands[0], _operands[1]);
+        if (_operands[0] != nullptr)
+            _operands[0]->addUseAsUsee(lhs_use);
+        if (_operands[1] != nullptr)
+            _operands[1]->addUseAsUsee(rhs_use);
+        return true;
+    }
+
     bool BinarySSA::set_lhs(owned<Value> lhs)
     {
         if (_operands[0] == lhs)
@@ -452,10 +472,8 @@ inline namespace binary_ssa_impl {
 
         /* 被清除的仅仅是自己所在的基本块, 不能一次清空所有的 use 关系,
          * 所以只能查找并释放 use-def 关系 */
-        auto use_iter = _list_as_user.begin();
-        Use *lhs_use = use_iter.get();
-        ++use_iter;
-        Use *rhs_use = use_iter.get();
+        Use *lhs_use = _list_as_user.at(0);
+        Use *rhs_use = _list_as_user.at(1);
 
         if (_operands[0] != nullptr) {
             _operands[0]->removeUseAsUsee(lhs_use);
@@ -16,34 +16,6 @@ namespace MYGL::IR {
             }
             return callee->get_return_type();
         }
-
-        struct arg_vsetter {
-            CallSSA *caller;
-            int   arg_index;
-        public:
-            Use::SetResult operator()(Value *usee)
-            {
-                CallSSA::ArgUseTuple &arguse_ref = caller->arguments()[arg_index];
-                owned<Value> &usee_ref = arguse_ref.arg;
-                Use           *arg_use = arguse_ref.arg_use;
-                if (usee_ref == usee)
-                    return Use::SetResult{false};
-                if (usee_ref != nullptr)
-                    usee_ref->removeUseAsUsee(arg_use);
-                if (usee != nullptr)
-                    usee_ref->addUseAsUsee(arg_use);
-                return Use::SetResult{false};
-            }
-        }; // struct arg_vsetter
-
-        struct arg_vgetter {
-            CallSSA *caller;
-            int   arg_index;
-        public:
-            Value *operator()() const {
-                return caller->get_arguments().at(arg_index).arg;
-            }
-        }; // struct arg_vgetter
     } // inline namespace call_ssa_impl
 
     CallSSA::CallSSA(owned<Function> callee, ValueArrayT const& arguments)
@@ -90,8 +62,7 @@ namespace MYGL::IR {
             }
             to_iter->arg      = arg;
             to_iter->arg_type = arg->get_value_type();
-            to_iter->arg_use  = addValue(arg_vgetter{this, count},
-                                        arg_vsetter{this, count});
+            to_iter->arg_use  = addValue(to_iter->arg);
             to_iter++, from_iter++, count++;
         }
     }
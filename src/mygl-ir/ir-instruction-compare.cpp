@@ -43,6 +43,35 @@ inline namespace compare_ssa_impl {
         return type_ctx->getIntType(1);
     }
 } // inline namespace compare_ssa_impl
+/* ================ [struct CompareSSA::Condition] ================ */
+    Condition::u8string8_t Condition::getString() const noexcept
+    {
+        u8string8_t ret{};
+        std::string_view relation;
+        switch (get_compare_result()) {
+        case CompareResult::FALSE: relation = "false"; break;
+        case CompareResult::TRUE:  relation = "true";  break;
+        case CompareResult::EQ:    relation = "eq";    break;
+        case CompareResult::NE:    relation = "ne";    break;
+        case CompareResult::LT:    relation = "lt";    break;
+        case CompareResult::LE:    relation = "le";    break;
+        case CompareResult::GT:    relation = "gt";    break;
+        case CompareResult::GE:    relation = "ge";    break;
+        }
+        size_t len = 0;
+        /* 恒真/恒假没有前缀; 整数的相等比较不分符号; 浮点比较分有序(o)与无序(u) */
+        bool is_constant = relation.size() > 2;
+        bool is_equality = get_compare_result() == CompareResult::EQ ||
+                           get_compare_result() == CompareResult::NE;
+        if (is_float_op() && !is_constant)
+            ret[len++] = is_signed_ordered() ? 'o' : 'u';
+        else if (!is_float_op() && !is_constant && !is_equality)
+            ret[len++] = is_signed_ordered() ? 's' : 'u';
+        for (char c: relation)
+            ret[len++] = c;
+        return ret;
+    }
+
 /* ================ [static class CompareSSA] ================ */
     RefT CompareSSA::CreateICmp(CompareResult condition, bool is_signed,
                                 owned<Value> lhs, owned<Value> rhs)
@@ -118,7 +147,7 @@ inline namespace compare_ssa_impl {
         : Instruction(ValueTID::COMPARE_SSA,
                       construct_get_boolean(operand_type), opcode),
           _lhs(std::move(lhs)), _rhs(std::move(rhs)),
-          _operand_type(operand_type) {
+          _operand_type(operand_type), _condition(condition) {
         MYGL_ADD_USEE_PROPERTY(lhs);
         MYGL_ADD_USEE_PROPERTY(rhs);
     }
@@ -204,10 +233,8 @@ inline namespace compare_ssa_impl {
     }
     void CompareSSA::on_parent_finalize()
     {
-        auto use_iter = _list_as_user.begin();
-        Use *ulhs = use_iter.get();
-        ++use_iter;
-        Use *urhs = use_iter.get();
+        Use *ulhs = _list_as_user.at(0);
+        Use *urhs = _list_as_user.at(1);
         if (_lhs != nullptr) {
             _lhs->removeUseAsUsee(ulhs);
             _lhs.reset();
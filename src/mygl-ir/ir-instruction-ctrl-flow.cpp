@@ -13,51 +13,18 @@ namespace MYGL::IR {
     using namespace std::string_literals;
 
 /** @class PhiSSA */
-namespace phi_ssa_impl {
-    delegate bvpair_vgetter {
-        PhiSSA     *self;
-        BasicBlock *block;
-    public:
-        Value *operator()() const {
-            return self->get_operands().at(block).value;
-        }
-    }; // delegate bvpair_vgetter
-
-    delegate bvpair_vsetter {
-        PhiSSA     *self;
-        BasicBlock *block;
-    public:
-        Use::SetResult operator()(Value *rhs)
-        {
-            /* `rhs` 为 `null` 是移除指令, 所以执行 `remove_this()` */
-            if (rhs == nullptr) {
-                return remove_this();
-            }
-            MTB_UNLIKELY_IF (rhs->get_value_type() != self->get_value_type())
-                return Use::SetResult{false};
-
-            auto &operands = self->operands();
-            auto self_it = operands.find(block);
-            if (self_it == operands.end())
-                return Use::SetResult{false};
-            self_it->second.value = rhs;
-            return Use::SetResult{false};
-        }
-
-        Use::SetResult remove_this()
-        {
-            auto &operands = self->operands();
-            auto self_it = operands.find(block);
-            if (self_it == operands.end())
-                return Use::SetResult{false};
-            operands.erase(self_it);
-            return Use::SetResult{true};
+/* ========== [ public class PhiSSA ] ========== */
+    ValueUsePair &PhiSSA::IncomingList::at(BasicBlock *block)
+    {
+        iterator it = find(block);
+        MTB_UNLIKELY_IF (it == end()) {
+            throw std::out_of_range {
+                "PhiSSA.operands: block is not an incoming block of this phi"
+            };
         }
-    }; // struct bvpair_vsetter
-
-} // namespace phi_ssa_impl
+        return it->second;
+    }
 
-/* ========== [ public class PhiSSA ] ========== */
     PhiSSA::PhiSSA(BasicBlock *parent, Type *value_type, size_t id)
         : Instruction(ValueTID::PHI_SSA, value_type, OpCode::PHI) {
         _id = id;
@@ -67,8 +34,6 @@ namespace phi_ssa_impl {
 
     bool PhiSSA::setValueFrom(BasicBlock *block, owned<Value> value)
     {
-        using namespace phi_ssa_impl;
-
         /* 检查 Value 的类型是否与自己的返回类型匹配 */
         if (value->get_value_type() != get_value_type()) {
             throw ValueTypeUnmatchException {
@@ -80,22 +45,75 @@ namespace phi_ssa_impl {
 
         auto it = _operands.find(block);
         if (it == _operands.end()) {
-        /* 没有注册 block, 则要为新的 BasicBlock 注册两个 Use */
-            auto [it, success] = _operands.insert({
-                block, {std::move(value)}
-            });
-            /* 注册 `Value`
-             * `BasicBlock` 只是 Value 的入口条件, 不作为操作数处理. */
-            Use *uvalue = addValue(bvpair_vgetter{this, block},
-                                   bvpair_vsetter{this, block});
-            it->second.use = uvalue;
+        /* 没有注册 block, 则要为新的 BasicBlock 注册一个 Use.
+         * `BasicBlock` 只是 Value 的入口条件, 不作为操作数处理. */
+            auto &entries = _operands._entries;
+            size_t capacity = entries.capacity();
+            entries.push_back({block, {std::move(value), nullptr}});
+            if (entries.capacity() != capacity)
+                _rebind_incoming_slots(0);
+            ValueUsePair &vupair = entries.back().second;
+            vupair.use = addValue(vupair.value, _incoming_set_hook);
         } else {
         /* 注册了 block, 则直接移动 */
+            Use *use = it->second.use;
+            if (it->second.value != nullptr)
+                it->second.value->removeUseAsUsee(use);
+            value->addUseAsUsee(use);
             it->second.value = std::move(value);
         }
         return true;
     }
 
+    Use::SetResult PhiSSA::_incoming_set_hook(User *user, Use *use, Value *rhs)
+    {
+        PhiSSA *self = static_cast<PhiSSA*>(user);
+        if (rhs == nullptr) {
+            /* 入口被删除以后 Use 由调用者销毁 */
+            auto &entries = self->_operands._entries;
+            for (auto it = entries.begin(); it != entries.end(); ++it) {
+                if (it->second.use != use)
+                    continue;
+                self->_erase_incoming(it);
+                return Use::SetResult{true};
+            }
+            return Use::SetResult{false};
+        }
+        MTB_UNLIKELY_IF (rhs->get_value_type() != self->get_value_type())
+            return Use::SetResult{false};
+
+        owned<Value> &slot = use->owned_slot();
+        if (slot == rhs)
+            return Use::SetResult{false};
+        if (slot != nullptr)
+            slot->removeUseAsUsee(use);
+        rhs->addUseAsUsee(use);
+        slot = owned<Value>(rhs);
+        return Use::SetResult{false};
+    }
+
+    owned<Value> PhiSSA::_erase_incoming(IncomingList::iterator it)
+    {
+        ValueUsePair &vupair = it->second;
+        owned<Value> ret = std::move(vupair.value);
+        if (ret != nullptr)
+            ret->removeUseAsUsee(vupair.use);
+        size_t index = it - _operands.begin();
+        _operands._entries.erase(it);
+        _rebind_incoming_slots(index);
+        return ret;
+    }
+
+    void PhiSSA::_rebind_incoming_slots(size_t first)
+    {
+        auto &entries = _operands._entries;
+        for (size_t i = first; i < entries.size(); i++) {
+            ValueUsePair &vupair = entries[i].second;
+            if (vupair.use != nullptr)
+                rebindSlot(vupair.use, vupair.value);
+        }
+    }
+
     BasicBlock *PhiSSA::findIncomingBlock(Value *value)
     {
         for (auto &[block, vupair]: _operands) {
@@ -111,10 +129,9 @@ namespace phi_ssa_impl {
         if (iter == _operands.end())
             return nullptr;
 
-        ValueUsePair &vupair = iter->second;
-        owned<Value> ret = std::move(vupair.value);
-        owned<Use>   use = vupair.use->get_modifier().remove_this();
-        _operands.erase(iter);
+        Use *use = iter->second.use;
+        owned<Value> ret = _erase_incoming(iter);
+        removeUseAsUser(use);
         return ret;
     }
 
@@ -182,13 +199,18 @@ namespace phi_ssa_impl {
 
     void PhiSSA::on_parent_finalize()
     {
-        for (auto &[b, c]: _operands)
-            c.value->removeUseAsUsee(c.use);
-        _operands.clear();
+        for (auto &[b, c]: _operands) {
+            if (c.value != nullptr)
+                c.value->removeUseAsUsee(c.use);
+        }
+        /* 槽位都在 _operands 里, 清空前先销毁指向它们的 Use */
+        _list_as_user.clear();
+        _operands._entries.clear();
         _connect_status = Instruction::ConnectStatus::FINALIZED;
     }
     void PhiSSA::on_function_finalize() {
-        _operands.clear();
+        _list_as_user.clear();
+        _operands._entries.clear();
         _connect_status = Instruction::ConnectStatus::FINALIZED;
     }
 /** end class PhiSSA */
@@ -420,8 +442,19 @@ BranchSSA::RefT BranchSSA::Create(owned<Value> condition, BasicBlock *if_true, B
             _if_true->addUseAsUsee(use);
     }
 
-    void BranchSSA::swapTargets() {
+    void BranchSSA::swapTargets()
+    {
+        Use *ufalse = _list_as_user.at(0);
+        Use *utrue  = _list_as_user.at(1);
+        if (_default_target != nullptr)
+            _default_target->removeUseAsUsee(ufalse);
+        if (_if_true != nullptr)
+            _if_true->removeUseAsUsee(utrue);
         std::swap(_default_target, _if_true);
+        if (_default_target != nullptr)
+            _default_target->addUseAsUsee(ufalse);
+        if (_if_true != nullptr)
+            _if_true->addUseAsUsee(utrue);
     }
 
 /** overrides {JumpBase, Instruction, ...} */
@@ -486,17 +519,15 @@ BranchSSA::RefT BranchSSA::Create(owned<Value> condition, BasicBlock *if_true, B
 
     void BranchSSA::clean_targets()
     {
-        auto iter = _list_as_user.begin();
         if (_parent != nullptr && _default_target != nullptr) {
             _default_target->removeComesFrom(_parent);
             _parent->removeJumpsTo(_default_target);
-            _default_target->removeUseAsUsee(iter.get());
+            _default_target->removeUseAsUsee(_list_as_user.at(0));
         }
-        iter = iter.get_next_iterator();
         if (_parent != nullptr && _if_true != nullptr) {
             _if_true->removeComesFrom(_parent);
             _parent->removeJumpsTo(_if_true);
-            _if_true->removeUseAsUsee(iter.get());
+            _if_true->removeUseAsUsee(_list_as_user.at(1));
         }
     }
 
@@ -586,30 +617,34 @@ BranchSSA::RefT BranchSSA::Create(owned<Value> condition, BasicBlock *if_true, B
 namespace switch_ssa_impl {
     using namespace capatibility;
 
-    struct vsetter {
-        SwitchSSA  *self;
-        int64_t case_num;
-    public:
-        Use::SetResult operator() (Value *value)
-        {
-            if (value == nullptr)
-                return remove_this();
+    /* case 跳转目标槽位的设置钩子. `value` 为 `null` 表示移除整个 case. */
+    static Use::SetResult case_set_hook(User *user, Use *use, Value *value)
+    {
+        SwitchSSA *self = static_cast<SwitchSSA*>(user);
+        SwitchSSA::CaseMapT &case_map = self->cases();
+        auto iter = case_map.begin();
+        while (iter != case_map.end() && iter->second.target_use != use)
+            iter++;
+        if (iter == case_map.end())
+            return {false};
+
+        if (value != nullptr) {
             if (value->get_type_id() != ValueTID::BASIC_BLOCK)
                 return {false};
-            self->setCase(case_num, static_cast<BasicBlock*>(value));
-            return Use::SetResult{false};
+            self->setCase(iter->first, static_cast<BasicBlock*>(value));
+            return {false};
         }
-
-        Use::SetResult remove_this()
-        {
-            SwitchSSA::CaseMapT &case_map = self->cases();
-            auto iter = case_map.find(case_num);
-            if (iter == case_map.end())
-                return {false};
-            case_map.erase(iter);
-            return {true};
+        /* 槽位在 map 结点里, 结点删除后 Use 由调用者销毁 */
+        BasicBlock *parent = self->get_parent();
+        BasicBlock *target = iter->second.target;
+        if (parent != nullptr) {
+            parent->removeJumpsTo(target);
+            target->removeComesFrom(parent);
         }
-    }; // struct vsetter
+        target->removeUseAsUsee(use);
+        case_map.erase(iter);
+        return {true};
+    }
 
     static void verify_condition_type_or_throw(Value *condition, SourceLocation srcloc)
     {
@@ -637,6 +672,8 @@ namespace switch_ssa_impl {
         // 一个 BasicBlock 最多只有一条指令能管理 jumps_to, 在这里刚好是SwitchSSA这一条。
         // SwitchSSA 掌控着 BasicBlock 所有的 jumps_to, 所以可以直接清空.
         parent->jumps_to().clear();
+        if (Function *function = parent->get_parent())
+            function->markCfgChanged();
         self->get_default_target()->removeComesFrom(parent);
         for (auto &i: self->cases()) {
             BasicBlock *case_target = i.second.target;
@@ -792,10 +829,9 @@ try {
             // 出现了新 case: 插入一个新跳转目标
             auto [i, b] = _cases.insert({case_number, {block, nullptr}});
 
-            // 为新出现的跳转目标创建一个新 Use
-            Use *target_use = addValue(
-                [this, case_number]()->Value* { return getCase(case_number); },
-                vsetter{this, case_number});
+            // 为新出现的跳转目标创建一个新 Use, 同时登记到 block 上.
+            // map 结点的地址不会变, 可以直接当作槽位.
+            Use *target_use = addValue(i->second.target, case_set_hook);
             i->second.target_use = target_use; // 保存 Use
 
             // 连接父结点与跳转目标
@@ -803,7 +839,6 @@ try {
                 _parent->addJumpsTo(block);
                 block->addComesFrom(_parent);
             }
-            block->addUseAsUsee(target_use);
         } else {
             // 复用原有的 case: 移除原有的跳转目标并插入新的
             BasicBlock *orig = case_it->second.target;
@@ -845,8 +880,7 @@ try {
             target->removeComesFrom(_parent);
         }
         target->removeUseAsUsee(case_use);
-        auto it = case_use->get_modifier();
-        it.remove_this();
+        removeUseAsUser(case_use);
         return true;
     }
     SwitchSSA::BlockCaseIterator
@@ -48,7 +48,7 @@ CreateFromComptimeIndex(owned<Value> array, IntType *ity, uint32_t index)
         "ExtractElemSSA::Create...()::ity"sv,
         {}, CURRENT_SRCLOC_F
     };
-    auto vidx = own<IntConst>(ity, index);
+    auto vidx = IntConst::Create(ity, int64_t(index));
     return Create(std::move(array), std::move(vidx));
 }
 /* ================ [ public class ExtractElemSSA ] ================ */
@@ -141,14 +141,12 @@ void ExtractElemSSA::on_parent_plug(BasicBlock *parent)
 }
 void ExtractElemSSA::on_parent_finalize()
 {
-    auto use_it = _list_as_user.begin();
-    Use *arr_use = use_it.get();
+    Use *arr_use = _list_as_user.at(0);
     if (_array != nullptr) {
         _array->removeUseAsUsee(arr_use);
         _array.reset();
     }
-    ++use_it;
-    Use *idx_use = use_it.get();
+    Use *idx_use = _list_as_user.at(1);
     if (_index != nullptr) {
         _index->removeUseAsUsee(idx_use);
         _index.reset();
@@ -157,14 +155,12 @@ void ExtractElemSSA::on_parent_finalize()
 }
 void ExtractElemSSA::on_function_finalize()
 {
-    auto use_it = _list_as_user.begin();
-    Use *arr_use = use_it.get();
+    Use *arr_use = _list_as_user.at(0);
     if (_array != nullptr) {
         _array->removeUseAsUsee(arr_use);
         _array.reset();
     }
-    ++use_it;
-    Use *idx_use = use_it.get();
+    Use *idx_use = _list_as_user.at(1);
     if (_index != nullptr) {
         _index->removeUseAsUsee(idx_use);
         _index.reset();
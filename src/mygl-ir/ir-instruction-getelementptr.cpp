@@ -115,39 +115,6 @@ namespace MYGL::IR {
             return ret_tlstack;
         }
 #   endif
-
-        struct index_vsetter {
-            GetElemPtrSSA  *self;
-            uint32_t index_order;
-
-            Use::SetResult operator()(Value *index) {
-                return index == nullptr ?
-                       remove_this() : set_usee(index);
-            }
-        private:
-            Use::SetResult set_usee(Value *index)
-            {
-                check_type_integer_or_throw(index->get_value_type());
-                ValueUsePair &pairef = self->indexes()[index_order];
-                owned<Value> &valref = pairef.value;
-                if (valref != nullptr)
-                    valref->removeUseAsUsee(pairef.use);
-                if (index != nullptr)
-                    index->addUseAsUsee(pairef.use);
-                valref = index;
-                return Use::SetResult{false};
-            }
-
-            Use::SetResult remove_this()
-            {
-                ValueUsePair &pairef = self->indexes()[index_order];
-                owned<Value> &valref = pairef.value;
-                if (valref != nullptr)
-                    valref->removeUseAsUsee(pairef.use);
-                valref = nullptr;
-                return Use::SetResult{false};
-            }
-        };
     } // inline namespace getelemptr_impl
 
     GetElemPtrSSA::RefT GetElemPtrSSA::
@@ -207,9 +174,7 @@ namespace MYGL::IR {
         _indexes.resize(indexes.size());
         for (uint32_t i = 0; i < _indexes.size(); i++) {
             _indexes[i].value = indexes[i];
-            _indexes[i].use = addValue(
-                [this, i]() { return get_indexes()[i].value.get(); },
-                index_vsetter{this, i});
+            _indexes[i].use   = addValue(_indexes[i].value);
         }
     }
 
@@ -251,7 +216,9 @@ namespace MYGL::IR {
     {
         if (index_order >= _indexes.size())
             return false;
-        index_vsetter{this, uint32_t(index_order)}(index);
+        if (index != nullptr)
+            check_type_integer_or_throw(index->get_value_type());
+        _indexes[index_order].use->set_usee(index);
         return true;
     }
 
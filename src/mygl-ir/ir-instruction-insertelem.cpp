@@ -168,21 +168,18 @@ void InsertElemSSA::on_parent_plug(BasicBlock *parent)
 }
 void InsertElemSSA::on_parent_finalize()
 {
-    auto use_it = _list_as_user.begin();
     if (_array != nullptr) {
-        Use *arr_use = use_it.get();
+        Use *arr_use = _list_as_user.at(0);
         _array->removeUseAsUsee(arr_use);
         _array.reset();
     }
-    ++use_it;
     if (_element != nullptr) {
-        Use *elm_use = use_it.get();
+        Use *elm_use = _list_as_user.at(1);
         _element->removeUseAsUsee(elm_use);
         _element.reset();
     }
-    ++use_it;
     if (_index != nullptr) {
-        Use *idx_use = use_it.get();
+        Use *idx_use = _list_as_user.at(2);
         _index->removeUseAsUsee(idx_use);
         _index.reset();
     }
@@ -190,21 +187,18 @@ void InsertElemSSA::on_parent_finalize()
 }
 void InsertElemSSA::on_function_finalize()
 {
-    auto use_it = _list_as_user.begin();
     if (_array != nullptr) {
-        Use *arr_use = use_it.get();
+        Use *arr_use = _list_as_user.at(0);
         _array->removeUseAsUsee(arr_use);
         _array.reset();
     }
-    ++use_it;
     if (_element != nullptr) {
-        Use *elm_use = use_it.get();
+        Use *elm_use = _list_as_user.at(1);
         _element->removeUseAsUsee(elm_use);
         _element.reset();
     }
-    ++use_it;
     if (_index != nullptr) {
-        Use *idx_use = use_it.get();
+        Use *idx_use = _list_as_user.at(2);
         _index->removeUseAsUsee(idx_use);
         _index.reset();
     }
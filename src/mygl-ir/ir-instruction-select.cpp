@@ -171,12 +171,9 @@ inline namespace select_ssa_impl {
         if (_connect_status == Instruction::ConnectStatus::FINALIZED)
             return;
 
-        auto use_iter = _list_as_user.begin();
-        Use *use_if_false = use_iter.get();
-        ++use_iter;
-        Use *use_if_true  = use_iter.get();
-        ++use_iter;
-        Use *use_cond     = use_iter.get();
+        Use *use_if_false = MYGL_USE_OF(IF_FALSE);
+        Use *use_if_true  = MYGL_USE_OF(IF_TRUE);
+        Use *use_cond     = MYGL_USE_OF(CONDITION);
 
         if (_if_false != nullptr) {
             _if_false->removeUseAsUsee(use_if_false);
@@ -186,9 +186,8 @@ inline namespace store_ssa_impl {
             set_source(std::move(source));
             return;
         }
-        auto iter = _list_as_user.begin();
-        Use *src = iter.get();
-        Use *tgt = iter.get_next_iterator().get();
+        Use *src = _list_as_user.at(0);
+        Use *tgt = _list_as_user.at(1);
         _target_pointer_type = construct_check_get_target_type(source, target, CURRENT_SRCLOC_F);
         if (_source != nullptr)
             _source->removeUseAsUsee(src);
@@ -227,9 +226,8 @@ inline namespace store_ssa_impl {
     }
     void StoreSSA::on_parent_finalize()
     {
-        auto iter = _list_as_user.begin();
-        Use *usrc = iter.get();
-        Use *utgt = iter.get_next_iterator().get();
+        Use *usrc = _list_as_user.at(0);
+        Use *utgt = _list_as_user.at(1);
         if (_source != nullptr) {
             _source->removeUseAsUsee(usrc);
             _source.reset();
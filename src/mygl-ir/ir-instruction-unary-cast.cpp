@@ -582,11 +582,16 @@ namespace MYGL::IR {
     }
     void CastSSA::on_parent_finalize()
     {
+        /* 不走 set_operand(nullptr): 类型转换的检查函数不接受空操作数 */
+        if (_operand != nullptr)
+            _operand->removeUseAsUsee(_list_as_user.at(0));
         _operand.reset();
+        _connect_status = Instruction::ConnectStatus::FINALIZED;
     }
     void CastSSA::on_function_finalize()
     {
-        return on_parent_finalize();
+        _operand.reset();
+        _connect_status = Instruction::ConnectStatus::FINALIZED;
     }
 /* =============== [end class CastSSA] ============== */
 
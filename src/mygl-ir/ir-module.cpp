@@ -24,31 +24,32 @@ Module::Module(std::string_view name, size_t machine_word_size)
 }
 Module::~Module() = default;
 
-Function *Module::getFunction(std::string const& name)
+Function *Module::getFunction(std::string_view name)
 {
-    auto iter = _functions.find(name);
+    auto iter = _functions.find(Symbol{name});
     if (iter == _functions.end())
         return nullptr;
     return iter->second.get();
 }
-Function *Module::getFunction(std::string_view name) {
-    return getFunction(std::string{name});
+Function *Module::getFunction(std::string const& name) {
+    return getFunction(std::string_view{name});
 }
 Module::SetDefError Module::
 setFunction(std::string const& name, Function::RefT fn)
 {
     if (fn == nullptr)
         return SetDefError::ARG_NULL;
+    Symbol key{name};
 
-    auto fiter = _functions.find(name);
+    auto fiter = _functions.find(key);
     if (fiter != _functions.end())
         return FN_EXIST;
 
-    auto viter = _global_variables.find(name);
+    auto viter = _global_variables.find(key);
     if (viter != _global_variables.end())
         return GVAR_EXIST;
 
-    _functions.insert({name, std::move(fn)});
+    _functions.insert({key, std::move(fn)});
     return SetDefError::OK;
 }
 Module::SetDefError Module::
@@ -56,18 +57,19 @@ setOrReplaceFunction(std::string const& name, owned<Function> fn)
 {
     if (fn == nullptr)
         return SetDefError::ARG_NULL;
+    Symbol key{name};
 
-    auto viter = _global_variables.find(name);
+    auto viter = _global_variables.find(key);
     if (viter != _global_variables.end())
         return GVAR_EXIST;
 
-    _functions.insert_or_assign(name, std::move(fn));
+    _functions.insert_or_assign(key, std::move(fn));
     return SetDefError::OK;
 }
 
 GlobalVariable *Module::getGlobalVariable(std::string const& name)
 {
-    auto iter = _global_variables.find(name);
+    auto iter = _global_variables.find(Symbol{name});
     if (iter == _global_variables.end())
         return nullptr;
     return iter->second.get();
@@ -77,16 +79,17 @@ setGlobalVariable(std::string const& name, owned<GlobalVariable> gvar)
 {
     if (gvar == nullptr)
         return SetDefError::ARG_NULL;
+    Symbol key{name};
 
-    auto fiter = _functions.find(name);
+    auto fiter = _functions.find(key);
     if (fiter != _functions.end())
         return FN_EXIST;
 
-    auto viter = _global_variables.find(name);
+    auto viter = _global_variables.find(key);
     if (viter != _global_variables.end())
         return GVAR_EXIST;
 
-    _global_variables.insert({name, std::move(gvar)});
+    _global_variables.insert({key, std::move(gvar)});
     return SetDefError::OK;
 }
 Module::SetDefError Module::
@@ -94,12 +97,13 @@ setOrReplaceGlobalVariable(std::string const& name, owned<GlobalVariable> gvar)
 {
     if (gvar == nullptr)
         return SetDefError::ARG_NULL;
+    Symbol key{name};
 
-    auto fiter = _functions.find(name);
+    auto fiter = _functions.find(key);
     if (fiter != _functions.end())
         return FN_EXIST;
 
-    _global_variables.insert_or_assign(name, std::move(gvar));
+    _global_variables.insert_or_assign(key, std::move(gvar));
     return SetDefError::OK;
 }
 
@@ -129,8 +133,9 @@ setOrReplaceDefinition(std::string const& name, owned<Definition> definition)
 {
     if (definition == nullptr)
         return SetDefError::ARG_NULL;
+    Symbol key{name};
 
-    if (auto fiter = _functions.find(name);
+    if (auto fiter = _functions.find(key);
         fiter != _functions.end()) {
         if (definition.get() == fiter->second.get())
             return SetDefError::OK;
@@ -139,7 +144,7 @@ setOrReplaceDefinition(std::string const& name, owned<Definition> definition)
         _functions.erase(fiter);
     }
 
-    if (auto viter = _global_variables.find(name);
+    if (auto viter = _global_variables.find(key);
         viter != _global_variables.end()) {
         if (definition.get() == viter->second.get())
             return SetDefError::OK;
@@ -149,12 +154,12 @@ setOrReplaceDefinition(std::string const& name, owned<Definition> definition)
     }
 
     if (definition->is_function()) {
-        _functions.insert({name, definition.static_get<Function>()});
+        _functions.insert({key, definition.static_get<Function>()});
         return SetDefError::OK;
     }
     if (definition->is_global_variable()) {
         _global_variables.insert({
-            name, definition.static_get<GlobalVariable>()
+            key, definition.static_get<GlobalVariable>()
         });
         return SetDefError::OK;
     }
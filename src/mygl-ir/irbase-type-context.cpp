@@ -1,5 +1,7 @@
 #include "mygl-ir/irbase-type-context.hxx"
+#include <algorithm>
 #include <cstdio>
+#include <mutex>
 
 #define ity_map _optimized_int_type_map
 
@@ -26,12 +28,15 @@ TypeContext::TypeContext(size_t machine_word_size)
 }
 
 bool TypeContext::hasType(Type *type) const {
+    std::lock_guard lock{_lock};
     return _type_set.contains(type);
 }
 Type *TypeContext::getOrRegisterType(Type *type)
 {
-    if (hasType(type))
-        return _type_set.find(type)->get();
+    std::lock_guard lock{_lock};
+    /* 只查一次表: find 的结果同时回答"有没有"和"是哪个" */
+    if (auto it = _type_set.find(type); it != _type_set.end())
+        return it->get();
     _type_set.insert(type);
     if (type->get_type_context() == nullptr)
         type->set_type_context(this);
@@ -39,13 +44,14 @@ Type *TypeContext::getOrRegisterType(Type *type)
 } 
 Type* TypeContext::getOrRegisterType(owned<Type> type)
 {
-    if (hasType(type))
-        return _type_set.find(type)->get();
+    std::lock_guard lock{_lock};
+    if (auto it = _type_set.find(type); it != _type_set.end())
+        return it->get();
     Type *raw_ty = type;
     _type_set.insert(std::move(type));
-    // 针对IntType做特殊加速处理
-    if (type->get_type_id() == TypeTID::INT_TYPE) {
-        IntType *ity = static_cast<IntType*>(type.get());
+    // 针对IntType做特殊加速处理. type 已经被移走了, 只能用 raw_ty
+    if (raw_ty->get_type_id() == TypeTID::INT_TYPE) {
+        IntType *ity = static_cast<IntType*>(raw_ty);
         ity_map.insert({ity->get_binary_bits(), ity});
     }
     if (raw_ty->get_type_context() == nullptr)
@@ -55,6 +61,7 @@ Type* TypeContext::getOrRegisterType(owned<Type> type)
 
 IntType *TypeContext::getIntType(size_t binary_bits, bool is_unsigned)
 {
+    std::lock_guard lock{_lock};
     if (auto iter = ity_map.find(binary_bits);
         iter != ity_map.end())
         return iter->second.get();
@@ -76,24 +83,29 @@ FunctionType *TypeContext::getFunctionType(
                             Type *return_type,
                             FTypeListT const &param_list)
 {
-    Type *rret_ty = getOrRegisterType(return_type);
-    auto fty = own<FunctionType>(rret_ty, param_list);
-    fty->set_type_context(this);
-    return static_cast<FunctionType*>(getOrRegisterType(fty.get()));
+    std::lock_guard lock{_lock};
+    Type  *rret_ty = getOrRegisterType(return_type);
+    size_t hash    = hashFunctionKey(rret_ty, param_list);
+    if (FunctionType *fty = findFunctionType(rret_ty, param_list, hash))
+        return fty;
+    return internFunctionType(own<FunctionType>(rret_ty, param_list), hash);
 }
 FunctionType *TypeContext::getFunctionType(
                             Type *return_type,
                             FTypeListT &&param_list)
 {
-    Type *rret_ty = getOrRegisterType(return_type);
-    auto fty = own<FunctionType>(rret_ty, std::move(param_list));
-    fty->set_type_context(this);
-    return static_cast<FunctionType*>(getOrRegisterType(fty.get()));
+    std::lock_guard lock{_lock};
+    Type  *rret_ty = getOrRegisterType(return_type);
+    size_t hash    = hashFunctionKey(rret_ty, param_list);
+    if (FunctionType *fty = findFunctionType(rret_ty, param_list, hash))
+        return fty;
+    return internFunctionType(own<FunctionType>(rret_ty, std::move(param_list)), hash);
 }
 PointerType *TypeContext::getFunctionPointer(
                                     owned<Type> return_type,
                                     FTypeListT const &param_list)
 {
+    std::lock_guard lock{_lock};
     Type *fty = getFunctionType(return_type, param_list);
     if (fty == nullptr) throw NullException {
         "TypeContext::getFunctionPointer()::...fty",
@@ -105,33 +117,56 @@ PointerType *TypeContext::getFunctionPointer(
 
 ArrayType *TypeContext::getArrayType(Type *element_type, size_t length)
 {
+    std::lock_guard lock{_lock};
+    /* 快速路径: 调用者给的通常就是注册过的类型 */
+    if (auto it = _array_type_map.find({element_type, length});
+        it != _array_type_map.end())
+        return it->second;
+
     element_type = getOrRegisterType(element_type);
+    ArrayKey key{element_type, length};
+    if (auto it = _array_type_map.find(key);
+        it != _array_type_map.end())
+        return it->second;
+
     owned<ArrayType> arrty = new ArrayType(*this, element_type, length);
-    Type *ret = getOrRegisterType(std::move(arrty).static_get<Type>());
-    return static_cast<ArrayType*>(ret);
+    auto ret = static_cast<ArrayType*>(
+        getOrRegisterType(std::move(arrty).static_get<Type>()));
+    _array_type_map.insert({key, ret});
+    return ret;
 }
 ArrayType *TypeContext::getMultiDimensionArray(Type *element_type,
                                                AIndexListT const &length_list)
 {
-    owned<Type> ret{getOrRegisterType(element_type)};
+    std::lock_guard lock{_lock};
+    Type *ret = getOrRegisterType(element_type);
     for (auto i = length_list.rbegin();
-         i != length_list.rend(); i--) {
+         i != length_list.rend(); ++i) {
         size_t leng = *i;
         if (leng == 0)
             return nullptr;
         ret = getArrayType(ret, leng);
     }
-    return ret.dynamic_get<ArrayType>();
+    return dynamic_cast<ArrayType*>(ret);
 }
 
 PointerType *TypeContext::getPointerType(Type *elemty, bool is_const)
 {
+    std::lock_guard lock{_lock};
+    if (auto it = _pointer_type_map.find({elemty, is_const});
+        it != _pointer_type_map.end())
+        return it->second;
+
     elemty = getOrRegisterType(elemty);
     if (elemty == nullptr) throw NullException {
         "TypeContext::getFunctionPointer()::...elemty",
         "Registeded element type is NULL. What's wrong?",
         CURRENT_SRCLOC_F
     }; // fty == nullptr
+    PointerKey key{elemty, is_const};
+    if (auto it = _pointer_type_map.find(key);
+        it != _pointer_type_map.end())
+        return it->second;
 
     auto pty = own<PointerType>(elemty, is_const);
     pty->set_type_context(this);
@@ -142,8 +177,78 @@ PointerType *TypeContext::getPointerType(Type *elemty, bool is_const)
         "Returned element type is NULL. What's wrong?",
         CURRENT_SRCLOC_F
     }; // fty == nullptr
-    return pty.get();
-    // return makeType<PointerType>(elemty, is_const);
+    /* 返回驻留的类型而不是临时对象: 相同类型已经存在时临时对象马上会被释放 */
+    auto pret = static_cast<PointerType*>(ret);
+    _pointer_type_map.insert({key, pret});
+    return pret;
+}
+
+/* ========== [TypeContext private] ========== */
+static inline size_t type_key_mix(size_t seed, size_t value)
+{
+    return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+size_t TypeContext::KeyHasher::operator()(ArrayKey const &key) const noexcept
+{
+    size_t ret = std::hash<Type*>()(key.element);
+    return type_key_mix(ret, key.length);
+}
+size_t TypeContext::KeyHasher::operator()(PointerKey const &key) const noexcept
+{
+    size_t ret = std::hash<Type*>()(key.target);
+    return type_key_mix(ret, key.is_constant);
+}
+
+bool TypeContext::FunctionKeyEqual::
+operator()(FunctionKey const &lhs, FunctionKey const &rhs) const
+{
+    return lhs.hash        == rhs.hash        &&
+           lhs.return_type == rhs.return_type &&
+           lhs.param_list  == rhs.param_list;
+}
+bool TypeContext::FunctionKeyEqual::
+operator()(FunctionKeyView const &lhs, FunctionKey const &rhs) const
+{
+    if (lhs.hash        != rhs.hash        ||
+        lhs.return_type != rhs.return_type ||
+        lhs.param_list.size() != rhs.param_list.size())
+        return false;
+    return std::equal(lhs.param_list.begin(), lhs.param_list.end(),
+                      rhs.param_list.begin());
+}
+
+size_t TypeContext::hashFunctionKey(Type *return_type, FTypeListT const &param_list)
+{
+    size_t ret = std::hash<Type*>()(return_type);
+    for (Type *i: param_list)
+        ret = type_key_mix(ret, std::hash<Type*>()(i));
+    return type_key_mix(ret, param_list.size());
+}
+
+FunctionType *TypeContext::findFunctionType(Type *return_type,
+                                            FTypeListT const &param_list,
+                                            size_t hash) const
+{
+    auto it = _function_type_map.find(FunctionKeyView{return_type, param_list, hash});
+    if (it == _function_type_map.end())
+        return nullptr;
+    return it->second;
+}
+
+FunctionType *TypeContext::internFunctionType(owned<FunctionType> fty, size_t hash)
+{
+    fty->set_type_context(this);
+    auto ret = static_cast<FunctionType*>(getOrRegisterType(fty.get()));
+    FTypeListT const &params = fty->get_param_list();
+    _function_type_map.insert({
+        FunctionKey{
+            fty->get_return_type(),
+            std::vector<Type*>(params.begin(), params.end()),
+            hash
+        }, ret
+    });
+    return ret;
 }
 /** end class TypeContext */
 
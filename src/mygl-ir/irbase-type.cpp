@@ -38,7 +38,7 @@ inline size_t fill_to(size_t size, size_t align)
     size_t mod = size % align;
     return (ret + (mod != 0)) * align;
 }
-inline size_t get_next_power_of_two(size_t x)
+size_t get_next_power_of_two(size_t x)
 {
     x |= x >> 1;
     x |= x >> 2;
@@ -80,7 +80,8 @@ type_context_get_machine_word_size(const TypeContext &ctx) {
 
 /** @class Type */
 Type::Type(TypeTID type_id, Type *base_type, TypeContext *ctx) noexcept
-    : _type_id(type_id), _base_type(base_type), _type_context(ctx) {
+    : _type_id(type_id), _base_type(base_type), _type_context(ctx),
+      _hash_cached(false), _cached_hash(0) {
     if (ctx != nullptr)
         _machine_word_size = ctx->get_machine_word_size();
 }
@@ -354,7 +355,7 @@ size_t ArrayType::get_instance_align() const
 size_t ArrayType::get_hash() const
 {
     std::hash<size_t> hasher;
-    size_t elem_type = get_element_type()->get_hash();
+    size_t elem_type = get_element_type()->get_cached_hash();
     size_t type_id = hasher(size_t(_type_id));
     return hash_combine(elem_type, type_id, hasher(_length));
 }
@@ -432,10 +433,10 @@ size_t FunctionType::get_hash() const
     std::hash<size_t> hasher;
     size_t ret = hash_combine(
         hasher(size_t(TypeTID::FUNCTION_TYPE)),
-        get_return_type()->get_hash()
+        get_return_type()->get_cached_hash()
     );
     for (Type *i : get_param_list())
-        ret = hash_combine(ret, i->get_hash());
+        ret = hash_combine(ret, i->get_cached_hash());
     return ret;
 }
 bool FunctionType::weakly_equals(const Type *that) const
@@ -542,7 +543,7 @@ size_t PointerType::get_hash() const
 {
     std::hash<size_t> hasher;
     size_t type_id = hasher(size_t(get_type_id()));
-    size_t target  = get_target_type()->get_hash();
+    size_t target  = get_target_type()->get_cached_hash();
     return hash_combine(type_id, target, size_t(_is_constant));
 }
 
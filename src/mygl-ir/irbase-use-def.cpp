@@ -1,7 +1,9 @@
 #include "base/mtb-compatibility.hxx"
 #include "mygl-ir/irbase-use-def.hxx"
 #include <algorithm>
+#include <mutex>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 
 namespace MYGL::IRBase {
@@ -38,17 +40,52 @@ Value::Value(ValueTID type_id, Type *value_type, uint32_t id)
 
 Value::~Value() = default;
 
+inline namespace shared_use_list_impl {
+    /* 按 Value 地址分段的锁. 共享值的数量一般远多于线程数, 一把全局锁会让所有
+     * 引用常量的指令都排队, 分段以后只有碰巧落在同一段的值才互相等待. */
+    constexpr size_t NSTRIPES = 64;
+    std::mutex stripes[NSTRIPES];
+
+    uint8_t stripe_index(Value const *value) {
+        uintptr_t addr = reinterpret_cast<uintptr_t>(value);
+        return uint8_t((addr >> 4) % NSTRIPES);
+    }
+    std::mutex &stripe_of(Value const *value) {
+        return stripes[stripe_index(value)];
+    }
+    static_assert(NSTRIPES <= Use::NOT_SHARED);
+} // inline namespace shared_use_list_impl
+
+std::atomic_int Value::ConcurrentUseScope::_nactive{0};
+
+/* 不在并行区间里也要记下锁编号: Use 可能在区间开始以后才销毁 */
+void Value::_addSharedUseAsUsee(Use *use)
+{
+    if (ConcurrentUseScope::is_active()) {
+        std::lock_guard lock{stripe_of(this)};
+        _list_as_usee.push_front(use);
+    } else {
+        _list_as_usee.push_front(use);
+    }
+    use->_usee_stripe = stripe_index(this);
+}
+void Value::_removeSharedUseAsUsee(Use *use)
+{
+    std::lock_guard lock{stripe_of(this)};
+    UseeList::remove(use);
+}
+
 std::string Value::get_name_or_id() const
 {
     if (_name.empty())
         return std::to_string(_id);
-    return _name;
+    return std::string{_name.str()};
 }
-std::string &Value::initNameAsId()
+std::string_view Value::initNameAsId()
 {
     if (_name.empty())
-        _name = std::to_string(_id);
-    return _name;
+        _name = MTB::Symbol{std::to_string(_id)};
+    return _name.str();
 }
 /** end class Value */
 
@@ -58,40 +95,43 @@ User::User(ValueTID type_id, Type *value_type)
 
 User::~User() = default;
 
-bool User::addUseAsUser(owned<Use> use)
+bool User::addUseAsUser(Use *use)
 {
     for (Use *i : _list_as_user) {
         if (i == use)
             return false;
     }
-    Use *puse = use;
-    _list_as_user.append(std::move(use));
+    use->set_user(this);
+    _list_as_user.append(use);
     return true;
 }
 bool User::removeUseAsUser(Use *use)
 {
     if (use->_user != this) return false;
-    use->get_modifier().remove_this();
-    return true;
+    return _list_as_user.remove(use);
 }
 
-Use *User::addValue(Use::UseeGetHandle get_usee, Use::UseeSetHandle set_usee)
+Use *User::_addSlot(Use::SlotT *slot, Use::SlotKind kind, SetHook set_hook)
 {
-    Use *ret = new Use(this, std::move(get_usee), std::move(set_usee));
+    Use *ret = new Use(this, slot, kind, set_hook);
     _list_as_user.append(ret);
+    if (Value *usee = *slot; usee != nullptr)
+        usee->addUseAsUsee(ret);
     return ret;
 }
-Use *User::addUncheckedValue(Value *&value)
-{
-    Use *ret = new Use(this, value);
-    _list_as_user.append(ret);
-    return ret;
+Use *User::addValue(Value *&slot, SetHook set_hook) {
+    return _addSlot(&slot, Use::SlotKind::RAW_PTR, set_hook);
+}
+Use *User::addValue(owned<Value> &slot, SetHook set_hook) {
+    return _addSlot(&slot.__ptr, Use::SlotKind::OWNED_PTR, set_hook);
 }
-Use *User::addUncheckedValue(owned<Value> &value)
+void User::clearUseAsUser()
 {
-    Use *ret = new Use(this, value);
-    _list_as_user.append(ret);
-    return ret;
+    for (Use *i : _list_as_user) {
+        if (Value *usee = i->get_usee(); usee != nullptr)
+            usee->removeUseAsUsee(i);
+    }
+    _list_as_user.clear();
 }
 size_t User::replaceAllUsee(Value *pattern, Value *new_usee)
 {
@@ -106,42 +146,127 @@ size_t User::replaceAllUsee(Value *pattern, Value *new_usee)
 }
 /** end class User */
 
+/** @class UseeList */
+size_t UseeList::size() const
+{
+    size_t ret = 0;
+    for (Use *u = _head; u != nullptr; u = u->_next_usee)
+        ret++;
+    return ret;
+}
+void UseeList::clear()
+{
+    Use *u = _head;
+    while (u != nullptr) {
+        Use *next = u->_next_usee;
+        u->_next_usee      = nullptr;
+        u->_prev_usee_next = nullptr;
+        u = next;
+    }
+    _head = nullptr;
+}
+/** end class UseeList */
+
+/** @class UseList */
+UseList::~UseList()
+{
+    clear();
+    if (_data != _inline)
+        delete[] _data;
+}
+
+Use *UseList::at(size_t index) const
+{
+    if (index >= _size) {
+        throw std::out_of_range {
+            osb_fmt("UseList index ", index, " out of range ", _size)
+        };
+    }
+    return _data[index];
+}
+
+void UseList::append(Use *use)
+{
+    MTB_UNLIKELY_IF (_size == _capacity) {
+        uint32_t capacity = _capacity * 2;
+        Use    **data     = new Use*[capacity];
+        std::copy(_data, _data + _size, data);
+        if (_data != _inline)
+            delete[] _data;
+        _data     = data;
+        _capacity = capacity;
+    }
+    _data[_size++] = use;
+}
+
+bool UseList::remove(Use *use)
+{
+    Use **end = _data + _size;
+    Use **pos = std::find(_data, end, use);
+    if (pos == end)
+        return false;
+    std::copy(pos + 1, end, pos);
+    _size--;
+    delete use;
+    return true;
+}
+
+void UseList::clear()
+{
+    for (Use *i : *this)
+        delete i;
+    _size = 0;
+}
+/** end class UseList */
+
 /** @class Use */
-Use::Use(User *user, UseeGetHandle get_usee, UseeSetHandle set_usee)
-    : _user(std::move(user)),
-      _get_handle(std::move(get_usee)),
-      _set_handle(std::move(set_usee)),
-      _proxy{nullptr} {
-}
-Use::Use(User *user, Value *&usee)
-    : _user(user) {
-    Value **pusee = &usee;
-    _get_handle = [pusee](){ return *pusee; };
-    _set_handle = [pusee](Value *value)-> SetResult {
-        *pusee = value;
-        return SetResult{false};
-    };
-}
-Use::Use(User *user, owned<Value> &usee)
-    : _user(user) {
-    owned<Value> *pusee = &usee;
-    _get_handle = [pusee]() { return pusee->get(); };
-    _set_handle = [pusee](Value *value) mutable {
-        *pusee = owned(value);
-        return SetResult{false};
-    };
-}
-
-Use::~Use() = default;
+Use::~Use()
+{
+    MTB_UNLIKELY_IF (_usee_stripe != NOT_SHARED &&
+                     Value::ConcurrentUseScope::is_active()) {
+        std::lock_guard lock{stripes[_usee_stripe]};
+        UseeList::remove(this);
+        return;
+    }
+    UseeList::remove(this);
+}
+
+void Use::set_usee(Value *usee)
+{
+    if (_set_hook != nullptr) {
+        _set_hook(_user, this, usee);
+        return;
+    }
+    Value *orig = *_slot;
+    if (orig == usee)
+        return;
+    if (orig != nullptr)
+        orig->removeUseAsUsee(this);
+    if (_kind == SlotKind::RAW_PTR) {
+        *_slot = usee;
+    } else {
+        /* owned(nullptr_t) 和 owned(ObjT*) 是两个构造函数, 后者不接受 null */
+        owned<Value> &oslot = owned_slot();
+        if (usee == nullptr)
+            oslot = nullptr;
+        else
+            oslot = owned<Value>(usee);
+    }
+    if (usee != nullptr)
+        usee->addUseAsUsee(this);
+}
 
 bool Use::remove_usee()
 {
-    owned<Use> wasted = nullptr;
-    SetResult result = _set_handle(nullptr);
-    if (result.use_dies) {
-        wasted = get_modifier().remove_this();
+    if (_set_hook == nullptr) {
+        set_usee(nullptr);
         return false;
     }
+    SetResult result = _set_hook(_user, this, nullptr);
+    if (result.use_dies) {
+        _user->removeUseAsUser(this);
+        return true;
+    }
     return false;
 }
 
@@ -150,12 +275,7 @@ owned<Value> Use::swapUseeOut(Value *usee)
     owned<Value> orig = get_usee();
     if (orig == usee)
         return orig;
-    orig->removeUseAsUsee(this);
     set_usee(usee);
-    auto &usee_la_usee = usee->get_list_as_usee();
-
-    if (std::find(usee_la_usee.cbegin(), usee_la_usee.cend(), this) == usee_la_usee.end())
-        usee->addUseAsUsee(this);
     return orig;
 }
 /** end class Use */
@@ -55,4 +55,18 @@ IR::BasicBlock *split_end(IR::BasicBlock *current)
     return ns.get();
 }
 
+void replace_terminator(IR::BasicBlock *block, owned<Instruction> terminator)
+{
+    if (block == nullptr) {
+        crash_with_stacktrace(true, CURRENT_SRCLOC_F,
+            "MYGL::IRUtil::BasicBlock::replace_terminator(...)::block is [null]");
+    }
+    owned<Instruction> old = block->swapOutEnding(std::move(terminator));
+    if (old == block->get_terminator()->get_instance())
+        return;
+    /* 被换下来的指令已经收到断连信号, 跳转关系解除了. 操作数的 Use 在 old
+     * 析构时自己从各个值的使用链表上摘下来 */
+    old->set_connect_status(Instruction::ConnectStatus::FINALIZED);
+}
+
 } // namespace MYGL::IRUtil::BasicBlock
\ No newline at end of file
@@ -0,0 +1,1216 @@
+#include "base/mtb-arena.hxx"
+#include "base/mtb-exception.hxx"
+#include "base/mtb-mapped-file.hxx"
+#include "base/mtb-object.hxx"
+#include "mygl-ir/ir-basic-value.hxx"
+#include "mygl-ir/ir-basicblock.hxx"
+#include "mygl-ir/ir-constant.hxx"
+#include "mygl-ir/ir-constant-function.hxx"
+#include "mygl-ir/ir-instruction.hxx"
+#include "mygl-ir/ir-module.hxx"
+#include "mygl-ir/irbase-type.hxx"
+#include "mygl-ir/irbase-use-def.hxx"
+#include "mygl-ir/utils/irutil-bitcode.hxx"
+#include "mygl-ir/utils/irutil-value-replace.hxx"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <string_view>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace MYGL::IRUtil {
+
+using namespace IR;
+using namespace IRBase;
+using namespace MTB;
+using OpCode = Instruction::OpCode;
+
+inline namespace bitcode_impl {
+    using namespace std::string_view_literals;
+
+    static constexpr uint8_t  bitcode_magic[4] = { 'M', 'Y', 'B', 'C' };
+    static constexpr uint32_t bitcode_version  = 2;
+
+    /** 常量池条目的种类 */
+    enum class ConstKind: uint8_t {
+        INT, FLOAT, ZERO, UNDEFINED, POISON, ARRAY, DEFINITION,
+        SPARSE_ARRAY, // 只存非零元素: 个数, 然后每个元素是"下标增量, 常量编号"
+    }; // enum class ConstKind
+
+    /** 操作数编码的低 2 位 */
+    enum OperandTag: uint8_t {
+        OPERAND_NULL    = 0, // 空操作数
+        OPERAND_CONST   = 1, // 常量池下标
+        OPERAND_BACKREF = 2, // 已定义的局部值, 高位是"当前编号 - 操作数编号"
+        OPERAND_FORWARD = 3, // 后面才定义的局部值, 高位是"操作数编号 - 当前编号", 后跟类型
+    }; // enum OperandTag
+
+    enum GlobalFlag: uint8_t {
+        GVAR_MUTABLE  = 0b01,
+        GVAR_HAS_INIT = 0b10,
+    }; // enum GlobalFlag
+
+    /** @class ByteWriter
+     * @brief 只追加的字节缓冲区, 整数用 LEB128 变长编码. */
+    class ByteWriter {
+    public:
+        std::vector<uint8_t> &bytes() { return _bytes; }
+        size_t size() const { return _bytes.size(); }
+
+        void u8(uint8_t value) { _bytes.push_back(value); }
+        void uleb(uint64_t value) {
+            do {
+                uint8_t byte = value & 0x7F;
+                value >>= 7;
+                _bytes.push_back(value != 0 ? (byte | 0x80) : byte);
+            } while (value != 0);
+        }
+        /* zigzag 编码, 让绝对值小的负数也只占一个字节 */
+        void sleb(int64_t value) {
+            uleb((uint64_t(value) << 1) ^ uint64_t(value >> 63));
+        }
+        void f64(double value) {
+            uint64_t bits = std::bit_cast<uint64_t>(value);
+            for (int i = 0; i < 8; i++)
+                _bytes.push_back(uint8_t(bits >> (i * 8)));
+        }
+        void str(std::string_view value) {
+            uleb(value.size());
+            _bytes.insert(_bytes.end(), value.begin(), value.end());
+        }
+        void append(ByteWriter const &that) {
+            _bytes.insert(_bytes.end(), that._bytes.begin(), that._bytes.end());
+        }
+    private:
+        std::vector<uint8_t> _bytes;
+    }; // class ByteWriter
+
+    /** @class ByteReader
+     * @brief ByteWriter 的逆操作. 越界或者编码不合法时抛出 BitcodeException. */
+    class ByteReader {
+    public:
+        ByteReader(uint8_t const *begin, uint8_t const *end)
+            : _cur(begin), _end(end) {}
+
+        bool ends() const { return _cur == _end; }
+
+        uint8_t u8() {
+            MTB_UNLIKELY_IF (_cur == _end)
+                throw BitcodeException{"unexpected end of bitcode"sv, CURRENT_SRCLOC_F};
+            return *_cur++;
+        }
+        uint64_t uleb() {
+            uint64_t ret = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                uint8_t byte = u8();
+                ret |= uint64_t(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0)
+                    return ret;
+            }
+            throw BitcodeException{"LEB128 integer too long"sv, CURRENT_SRCLOC_F};
+        }
+        int64_t sleb() {
+            uint64_t value = uleb();
+            return int64_t(value >> 1) ^ -int64_t(value & 1);
+        }
+        double f64() {
+            uint64_t bits = 0;
+            for (int i = 0; i < 8; i++)
+                bits |= uint64_t(u8()) << (i * 8);
+            return std::bit_cast<double>(bits);
+        }
+        /** 返回的字符串直接指向输入字节, 不做拷贝 */
+        std::string_view str() {
+            size_t len = _take(uleb());
+            return {reinterpret_cast<char const*>(_cur - len), len};
+        }
+        /** 切出接下来的 size 个字节作为子读取器 */
+        ByteReader sub(uint64_t size) {
+            size_t len = _take(size);
+            return ByteReader{_cur - len, _cur};
+        }
+        /** 读一个元素个数. 每个元素至少占一个字节, 所以个数不会超过剩余字节数 */
+        size_t count() {
+            uint64_t n = uleb();
+            MTB_UNLIKELY_IF (n > uint64_t(_end - _cur))
+                throw BitcodeException{"element count out of range"sv, CURRENT_SRCLOC_F};
+            return n;
+        }
+    private:
+        uint8_t const *_cur, *_end;
+
+        size_t _take(uint64_t size) {
+            MTB_UNLIKELY_IF (size > uint64_t(_end - _cur))
+                throw BitcodeException{"unexpected end of bitcode"sv, CURRENT_SRCLOC_F};
+            _cur += size;
+            return size;
+        }
+    }; // class ByteReader
+
+    [[noreturn]] static void throw_unsupported(std::string_view what, std::string_view name,
+                                               SourceLocation location = CURRENT_SRCLOC)
+    {
+        throw BitcodeException {
+            std::format("bitcode does not support {} `{}`", what, name),
+            location
+        };
+    }
+
+    [[noreturn]] static void throw_malformed(std::string_view what,
+                                             SourceLocation location = CURRENT_SRCLOC)
+    {
+        throw BitcodeException {
+            std::format("malformed bitcode: {}", what),
+            location
+        };
+    }
+
+/* ================ [ModuleEncoder] ================ */
+
+    /** @class ModuleEncoder
+     * @brief 类型表和常量池在写函数体的过程中按需增长, 所以先把各段分别写进
+     *        自己的缓冲区, 最后按文件格式的顺序拼起来. */
+    class ModuleEncoder {
+    public:
+        explicit ModuleEncoder(Module *module): _module(module) {}
+        std::vector<uint8_t> encode();
+    private:
+        Module *_module;
+
+        ByteWriter _types;
+        uint32_t   _ntypes = 0;
+        std::unordered_map<Type*, uint32_t> _type_ids;
+
+        ByteWriter _consts;
+        uint32_t   _nconsts = 0;
+        std::unordered_map<Value*, uint32_t> _const_ids;
+
+        std::vector<std::pair<std::string_view, GlobalVariable*>> _gvars;
+        std::vector<std::pair<std::string_view, Function*>>       _functions;
+        std::unordered_map<Value*, uint32_t> _def_ids;
+
+        /* 当前函数的局部编号: 参数和指令共用一套编号, 基本块单独编号 */
+        std::unordered_map<Value*, uint32_t>      _local_ids;
+        std::unordered_map<BasicBlock*, uint32_t> _block_ids;
+
+        uint32_t _typeId(Type *type);
+        uint32_t _constId(Constant *value);
+        void _writeOperand(ByteWriter &out, uint32_t cur, Value *operand);
+        void _writeBlock(ByteWriter &out, BasicBlock *block);
+        void _writeFunction(ByteWriter &out, Function *fn);
+        void _writeInstruction(ByteWriter &out, uint32_t cur, Instruction *inst);
+    }; // class ModuleEncoder
+
+    uint32_t ModuleEncoder::_typeId(Type *type)
+    {
+        if (auto it = _type_ids.find(type); it != _type_ids.end())
+            return it->second;
+
+        /* 先给依赖的类型编号, 保证类型表里被依赖者在前 */
+        ByteWriter entry;
+        TypeTID tid = type->get_type_id();
+        entry.uleb(uint64_t(tid));
+        switch (tid) {
+        case TypeTID::VOID:
+        case TypeTID::LABEL_TYPE:
+            break;
+        case TypeTID::INT_TYPE: {
+            auto ity = static_cast<IntType*>(type);
+            entry.uleb(ity->get_binary_bits());
+            entry.u8(uint8_t(ity->is_signed()) | uint8_t(ity->is_constant() << 1));
+        }   break;
+        case TypeTID::FLOAT_TYPE: {
+            auto fty = static_cast<FloatType*>(type);
+            entry.uleb(fty->get_index_nbits());
+            entry.uleb(fty->get_tail_nbits());
+            entry.uleb(fty->get_base_number());
+            entry.str(fty->get_name());
+        }   break;
+        case TypeTID::ARRAY_TYPE: {
+            auto aty = static_cast<ArrayType*>(type);
+            uint32_t elem = _typeId(aty->get_element_type());
+            entry.uleb(elem);
+            entry.uleb(aty->get_length());
+        }   break;
+        case TypeTID::FUNCTION_TYPE: {
+            auto fty = static_cast<FunctionType*>(type);
+            uint32_t ret = _typeId(fty->get_return_type());
+            std::vector<uint32_t> params;
+            for (Type *i: fty->get_param_list())
+                params.push_back(_typeId(i));
+            entry.uleb(ret);
+            entry.uleb(params.size());
+            for (uint32_t i: params)
+                entry.uleb(i);
+        }   break;
+        case TypeTID::POINTER_TYPE: {
+            auto pty = static_cast<PointerType*>(type);
+            uint32_t target = _typeId(pty->get_target_type());
+            entry.uleb(target);
+            entry.u8(pty->is_constant());
+        }   break;
+        default:
+            throw_unsupported("type"sv, type->toString(), CURRENT_SRCLOC_F);
+        }
+        _types.append(entry);
+        _type_ids.insert({type, _ntypes});
+        return _ntypes++;
+    }
+
+    uint32_t ModuleEncoder::_constId(Constant *value)
+    {
+        if (auto it = _const_ids.find(value); it != _const_ids.end())
+            return it->second;
+
+        ByteWriter entry;
+        switch (value->get_type_id()) {
+        case ValueTID::INT_CONST: {
+            auto ic = static_cast<IntConst*>(value);
+            entry.u8(uint8_t(ConstKind::INT));
+            entry.uleb(_typeId(ic->get_value_type()));
+            entry.sleb(ic->get_int_value());
+        }   break;
+        case ValueTID::FLOAT_CONST: {
+            auto fc = static_cast<FloatConst*>(value);
+            entry.u8(uint8_t(ConstKind::FLOAT));
+            entry.uleb(_typeId(fc->get_value_type()));
+            entry.f64(fc->get_float_value());
+        }   break;
+        case ValueTID::ZERO_CONST:
+            entry.u8(uint8_t(ConstKind::ZERO));
+            break;
+        case ValueTID::UNDEFINED:
+        case ValueTID::POISON: {
+            bool poison = value->get_type_id() == ValueTID::POISON;
+            entry.u8(uint8_t(poison ? ConstKind::POISON : ConstKind::UNDEFINED));
+            entry.uleb(_typeId(value->get_value_type()));
+        }   break;
+        case ValueTID::ARRAY: {
+            /* 零填充的数组元素表为空, 原样保存, 不展开 */
+            auto arr = static_cast<ArrayExpr*>(value);
+            if (arr->is_sparse()) {
+                std::vector<std::pair<uint64_t, uint32_t>> elems;
+                size_t prev = 0;
+                for (ArrayExpr::SparseElem const &i: arr->unsafe_get_sparse_list()) {
+                    auto ci = dynamic_cast<Constant*>(i.value.get());
+                    if (ci == nullptr)
+                        throw_unsupported("array element"sv, i.value->get_name_or_id(), CURRENT_SRCLOC_F);
+                    elems.push_back({i.index - prev, _constId(ci)});
+                    prev = i.index;
+                }
+                entry.u8(uint8_t(ConstKind::SPARSE_ARRAY));
+                entry.uleb(_typeId(arr->get_value_type()));
+                entry.uleb(elems.size());
+                for (auto [delta, id]: elems) {
+                    entry.uleb(delta);
+                    entry.uleb(id);
+                }
+                break;
+            }
+            std::vector<uint32_t> elems;
+            for (Value *i: arr->unsafe_get_raw_element_list()) {
+                auto ci = dynamic_cast<Constant*>(i);
+                if (i != nullptr && ci == nullptr)
+                    throw_unsupported("array element"sv, i->get_name_or_id(), CURRENT_SRCLOC_F);
+                elems.push_back(ci == nullptr ? 0 : _constId(ci) + 1);
+            }
+            entry.u8(uint8_t(ConstKind::ARRAY));
+            entry.uleb(_typeId(arr->get_value_type()));
+            entry.uleb(elems.size());
+            for (uint32_t i: elems)
+                entry.uleb(i);
+        }   break;
+        case ValueTID::DEFINITION:
+        case ValueTID::FUNCTION:
+        case ValueTID::GLOBAL_VARIABLE: {
+            auto it = _def_ids.find(value);
+            if (it == _def_ids.end())
+                throw_unsupported("definition from another module"sv,
+                                  value->get_name_or_id(), CURRENT_SRCLOC_F);
+            entry.u8(uint8_t(ConstKind::DEFINITION));
+            entry.uleb(it->second);
+        }   break;
+        default:
+            throw_unsupported("constant"sv, value->get_name_or_id(), CURRENT_SRCLOC_F);
+        }
+        _consts.append(entry);
+        _const_ids.insert({value, _nconsts});
+        return _nconsts++;
+    }
+
+    void ModuleEncoder::_writeOperand(ByteWriter &out, uint32_t cur, Value *operand)
+    {
+        if (operand == nullptr) {
+            out.uleb(OPERAND_NULL);
+            return;
+        }
+        if (auto c = dynamic_cast<Constant*>(operand); c != nullptr) {
+            out.uleb(uint64_t(_constId(c)) << 2 | OPERAND_CONST);
+            return;
+        }
+        auto it = _local_ids.find(operand);
+        if (it == _local_ids.end())
+            throw_unsupported("operand"sv, operand->get_name_or_id(), CURRENT_SRCLOC_F);
+        uint32_t id = it->second;
+        if (id < cur) {
+            out.uleb(uint64_t(cur - id) << 2 | OPERAND_BACKREF);
+        } else {
+            out.uleb(uint64_t(id - cur) << 2 | OPERAND_FORWARD);
+            out.uleb(_typeId(operand->get_value_type()));
+        }
+    }
+
+    void ModuleEncoder::_writeInstruction(ByteWriter &out, uint32_t cur, Instruction *inst)
+    {
+        OpCode opcode = inst->get_opcode();
+        out.uleb(uint64_t(OpCode::self_t(opcode)));
+        out.uleb(_typeId(inst->get_value_type()));
+        out.str(inst->get_name());
+
+        auto operand = [&](Value *value) { _writeOperand(out, cur, value); };
+        auto block   = [&](BasicBlock *bb) { out.uleb(_block_ids.at(bb)); };
+
+        switch (opcode) {
+        case OpCode::PHI: {
+            auto phi = static_cast<PhiSSA*>(inst);
+            out.uleb(phi->get_operands().size());
+            for (auto &[from, vu]: phi->get_operands()) {
+                block(from);
+                operand(vu.value);
+            }
+        }   break;
+        case OpCode::JUMP:
+            block(static_cast<JumpSSA*>(inst)->get_target());
+            break;
+        case OpCode::BR: {
+            auto br = static_cast<BranchSSA*>(inst);
+            operand(br->get_condition());
+            block(br->get_if_true());
+            block(br->get_if_false());
+        }   break;
+        case OpCode::SWITCH: {
+            auto sw = static_cast<SwitchSSA*>(inst);
+            operand(sw->get_condition());
+            block(sw->get_default_target());
+            out.uleb(sw->get_cases().size());
+            for (auto &[number, target]: sw->get_cases()) {
+                out.sleb(number);
+                block(target.target);
+            }
+        }   break;
+        case OpCode::SELECT: {
+            auto sel = static_cast<BinarySelectSSA*>(inst);
+            operand(sel->get_condition());
+            operand(sel->get_if_true());
+            operand(sel->get_if_false());
+        }   break;
+        case OpCode::ALLOCA:
+            out.uleb(static_cast<AllocaSSA*>(inst)->get_align());
+            break;
+        case OpCode::LOAD: {
+            auto load = static_cast<LoadSSA*>(inst);
+            operand(load->get_operand());
+            out.uleb(load->get_align());
+        }   break;
+        case OpCode::STORE: {
+            auto store = static_cast<StoreSSA*>(inst);
+            operand(store->get_source());
+            operand(store->get_target());
+            out.uleb(store->get_align());
+        }   break;
+        case OpCode::ITOF: case OpCode::UTOF: case OpCode::FTOI:
+        case OpCode::ZEXT: case OpCode::SEXT: case OpCode::BITCAST:
+        case OpCode::TRUNC: case OpCode::FPEXT: case OpCode::FPTRUNC:
+        case OpCode::INEG: case OpCode::FNEG: case OpCode::NOT:
+            operand(static_cast<UnarySSA*>(inst)->get_operand());
+            break;
+        case OpCode::ADD:  case OpCode::FADD: case OpCode::SUB:  case OpCode::FSUB:
+        case OpCode::MUL:  case OpCode::FMUL: case OpCode::SDIV: case OpCode::UDIV:
+        case OpCode::FDIV: case OpCode::UREM: case OpCode::SREM: case OpCode::FREM:
+        case OpCode::AND:  case OpCode::OR:   case OpCode::XOR:  case OpCode::SHL:
+        case OpCode::LSHR: case OpCode::ASHR: {
+            auto bin = static_cast<BinarySSA*>(inst);
+            out.u8(uint8_t(bin->get_sign_flag()));
+            operand(bin->get_lhs());
+            operand(bin->get_rhs());
+        }   break;
+        case OpCode::CALL: {
+            auto call = static_cast<CallSSA*>(inst);
+            operand(call->get_callee());
+            out.uleb(call->get_arguments().size());
+            for (auto &i: call->get_arguments())
+                operand(i.arg);
+        }   break;
+        case OpCode::RET:
+            operand(static_cast<ReturnSSA*>(inst)->get_result());
+            break;
+        case OpCode::GET_ELEMENT_PTR: {
+            auto gep = static_cast<GetElemPtrSSA*>(inst);
+            operand(gep->get_collection());
+            out.uleb(gep->get_indexes().size());
+            for (auto &i: gep->get_indexes())
+                operand(i.value);
+        }   break;
+        case OpCode::EXTRACT_ELEMENT: {
+            auto ext = static_cast<ExtractElemSSA*>(inst);
+            operand(ext->get_array());
+            operand(ext->get_index());
+        }   break;
+        case OpCode::INSERT_ELEMENT: {
+            auto ins = static_cast<InsertElemSSA*>(inst);
+            operand(ins->get_array());
+            operand(ins->get_element());
+            operand(ins->get_index());
+        }   break;
+        case OpCode::ICMP:
+        case OpCode::FCMP: {
+            auto cmp = static_cast<CompareSSA*>(inst);
+            out.u8(uint8_t(CompareSSA::Condition::self_t(cmp->get_condition())));
+            operand(cmp->get_lhs());
+            operand(cmp->get_rhs());
+        }   break;
+        case OpCode::UNREACHABLE:
+            break;
+        default:
+            throw_unsupported("instruction"sv, opcode.getString(), CURRENT_SRCLOC_F);
+        }
+    }
+
+    void ModuleEncoder::_writeBlock(ByteWriter &out, BasicBlock *block)
+    {
+        out.str(block->get_name());
+        out.uleb(block->get_instruction_list().size());
+        for (Instruction *i: block->instruction_list())
+            _writeInstruction(out, _local_ids.at(i), i);
+    }
+
+    void ModuleEncoder::_writeFunction(ByteWriter &out, Function *fn)
+    {
+        /* 入口基本块排第一, 其余按函数体顺序. 先编好号, 才能写向后引用. */
+        BasicBlock *entry = fn->get_entry();
+        std::vector<BasicBlock*> blocks{entry};
+        for (BasicBlock *i: fn->body()) {
+            if (i != entry)
+                blocks.push_back(i);
+        }
+        _local_ids.clear();
+        _block_ids.clear();
+        uint32_t nlocals = 0;
+        for (auto &i: fn->get_argument_list())
+            _local_ids.insert({i.argument.get(), nlocals++});
+        for (uint32_t index = 0; BasicBlock *i: blocks) {
+            _block_ids.insert({i, index++});
+            for (Instruction *inst: i->instruction_list())
+                _local_ids.insert({inst, nlocals++});
+        }
+
+        out.uleb(blocks.size());
+        for (auto &i: fn->get_argument_list())
+            out.str(i.argument->get_name());
+        for (BasicBlock *i: blocks)
+            _writeBlock(out, i);
+    }
+
+    std::vector<uint8_t> ModuleEncoder::encode()
+    {
+        /* unordered_map 的遍历顺序不确定, 按名称排序以保证输出确定 */
+        for (auto &[name, gvar]: _module->global_variables())
+            _gvars.push_back({name, gvar.get()});
+        for (auto &[name, fn]: _module->functions())
+            _functions.push_back({name, fn.get()});
+        std::sort(_gvars.begin(), _gvars.end());
+        std::sort(_functions.begin(), _functions.end());
+        uint32_t ndefs = 0;
+        for (auto &i: _gvars)
+            _def_ids.insert({i.second, ndefs++});
+        for (auto &i: _functions)
+            _def_ids.insert({i.second, ndefs++});
+
+        ByteWriter defs;
+        defs.uleb(_gvars.size());
+        for (auto &[name, gvar]: _gvars) {
+            bool has_init = !gvar->is_declaration();
+            defs.str(name);
+            defs.uleb(_typeId(gvar->get_target_type()));
+            defs.u8((gvar->target_is_mutable() ? GVAR_MUTABLE  : 0) |
+                    (has_init                  ? GVAR_HAS_INIT : 0));
+            defs.uleb(gvar->get_align());
+        }
+        defs.uleb(_functions.size());
+        for (auto &[name, fn]: _functions) {
+            defs.str(name);
+            defs.uleb(_typeId(fn->get_value_type()));
+            defs.u8(fn->is_declaration());
+        }
+
+        ByteWriter bodies;
+        for (auto &[name, fn]: _functions) {
+            if (fn->is_declaration())
+                continue;
+            ByteWriter body;
+            _writeFunction(body, fn);
+            bodies.uleb(body.size());
+            bodies.append(body);
+        }
+
+        ByteWriter inits;
+        for (auto &[name, gvar]: _gvars) {
+            if (!gvar->is_declaration())
+                inits.uleb(_constId(gvar->get_target()));
+        }
+
+        ByteWriter out;
+        for (uint8_t i: bitcode_magic)
+            out.u8(i);
+        out.uleb(bitcode_version);
+        out.uleb(_module->get_type_ctx().get_machine_word_size());
+        out.str(_module->get_name());
+        out.uleb(_ntypes);
+        out.append(_types);
+        out.append(defs);
+        out.uleb(_nconsts);
+        out.append(_consts);
+        out.append(inits);
+        out.append(bodies);
+        return std::move(out.bytes());
+    }
+
+/* ================ [ModuleDecoder] ================ */
+
+    /** @class ModuleDecoder
+     * @brief 按文件格式的顺序重建模块. 所有基本块在读函数体之前就建好, 所以跳转
+     *        目标总是已知的; 向前引用的局部值先用同类型的 undefined 常量占位,
+     *        等被引用的指令建好以后再整体替换.
+     *
+     * 链接模式(`decodeInto`)下不新建模块, 定义表里的名字先在目标模块里查找,
+     * 找到了就合并到已有的定义上. */
+    class ModuleDecoder {
+    public:
+        explicit ModuleDecoder(std::span<uint8_t const> bytes)
+            : _in(bytes.data(), bytes.data() + bytes.size()) {}
+        owned<Module> decode();
+        void decodeInto(Module *target);
+    private:
+        ByteReader    _in;
+        owned<Module> _module;
+        Module       *_target = nullptr; // 读出来的定义放进这个模块
+        TypeContext  *_ctx    = nullptr;
+        bool          _linking = false;
+
+        std::vector<Type*>           _types;
+        std::vector<GlobalVariable*> _gvars;
+        std::vector<uint8_t>         _gvar_flags;
+        std::vector<Function*>       _functions;
+        std::vector<uint8_t>         _function_has_body; // 链接时已有的定义不一定是本模块的
+        std::vector<owned<Value>>    _consts;
+
+        /* 当前函数 */
+        std::vector<Value*>      _locals;
+        std::vector<BasicBlock*> _blocks;
+        std::unordered_map<uint32_t, std::vector<owned<Value>>> _pending;
+
+        Type *_readType(ByteReader &in);
+        Type *_readType(ByteReader &in, TypeTID expected);
+        BasicBlock  *_readBlock(ByteReader &in);
+        owned<Value> _readOperand(ByteReader &in, uint32_t cur);
+
+        size_t _readHeader(std::string_view &name);
+        void _readTypeTable();
+        void _readDefinitions();
+        GlobalVariable *_linkGlobalVariable(std::string const &name, Type *type,
+                                            uint8_t flags, size_t align);
+        Function       *_linkFunction(std::string const &name, PointerType *pty,
+                                      bool is_declaration);
+        void _readModule();
+        void _readConstantPool();
+        void _readFunction(ByteReader &in, Function *fn);
+        Instruction::RefT _readInstruction(ByteReader &in, BasicBlock *parent);
+        void _resolveForward(uint32_t id, Instruction *inst);
+    }; // class ModuleDecoder
+
+    Type *ModuleDecoder::_readType(ByteReader &in)
+    {
+        uint64_t index = in.uleb();
+        MTB_UNLIKELY_IF (index >= _types.size())
+            throw_malformed("type index out of range"sv);
+        return _types[index];
+    }
+    Type *ModuleDecoder::_readType(ByteReader &in, TypeTID expected)
+    {
+        Type *ret = _readType(in);
+        MTB_UNLIKELY_IF (ret->get_type_id() != expected)
+            throw_malformed(std::format("unexpected type {}", ret->toString()));
+        return ret;
+    }
+    BasicBlock *ModuleDecoder::_readBlock(ByteReader &in)
+    {
+        uint64_t index = in.uleb();
+        MTB_UNLIKELY_IF (index >= _blocks.size())
+            throw_malformed("basic block index out of range"sv);
+        return _blocks[index];
+    }
+
+    owned<Value> ModuleDecoder::_readOperand(ByteReader &in, uint32_t cur)
+    {
+        uint64_t code  = in.uleb();
+        uint64_t value = code >> 2;
+        switch (OperandTag(code & 0b11)) {
+        case OPERAND_NULL:
+            return nullptr;
+        case OPERAND_CONST:
+            MTB_UNLIKELY_IF (value >= _consts.size())
+                throw_malformed("constant index out of range"sv);
+            return _consts[value];
+        case OPERAND_BACKREF:
+            MTB_UNLIKELY_IF (value == 0 || value > cur)
+                throw_malformed("operand index out of range"sv);
+            return _locals[cur - value];
+        case OPERAND_FORWARD: default: {
+            owned<Value> placeholder = own<UndefinedConst>(_readType(in));
+            _pending[cur + value].push_back(placeholder);
+            return placeholder;
+        }
+        }
+    }
+
+    void ModuleDecoder::_resolveForward(uint32_t id, Instruction *inst)
+    {
+        auto it = _pending.find(id);
+        if (it == _pending.end())
+            return;
+        for (owned<Value> &i: it->second) {
+            MTB_UNLIKELY_IF (!i->get_value_type()->equals(inst->get_value_type()))
+                throw_malformed("forward reference type mismatch"sv);
+            usee_replace_this_with(i, inst);
+        }
+        _pending.erase(it);
+    }
+
+    void ModuleDecoder::_readTypeTable()
+    {
+        size_t ntypes = _in.count();
+        _types.reserve(ntypes);
+        for (size_t i = 0; i < ntypes; i++) {
+            Type *type = nullptr;
+            switch (TypeTID(_in.uleb())) {
+            case TypeTID::VOID:
+                type = VoidType::voidty;
+                break;
+            case TypeTID::LABEL_TYPE:
+                type = LabelType::labelty;
+                break;
+            case TypeTID::INT_TYPE: {
+                size_t  nbits = _in.uleb();
+                uint8_t flags = _in.u8();
+                bool is_unsigned = (flags & 0b01) == 0;
+                bool is_constant = (flags & 0b10) != 0;
+                type = is_constant ?
+                       _ctx->makeType<IntType>(nbits, is_unsigned, is_constant):
+                       _ctx->getIntType(nbits, is_unsigned);
+            }   break;
+            case TypeTID::FLOAT_TYPE: {
+                size_t index = _in.uleb();
+                size_t tail  = _in.uleb();
+                size_t base  = _in.uleb();
+                std::string_view name = _in.str();
+                type = _ctx->makeType<FloatType>(index, tail, base, name);
+            }   break;
+            case TypeTID::ARRAY_TYPE: {
+                Type  *elem = _readType(_in);
+                size_t len  = _in.uleb();
+                type = _ctx->getArrayType(elem, len);
+            }   break;
+            case TypeTID::FUNCTION_TYPE: {
+                Type *ret = _readType(_in);
+                TypeContext::FTypeListT params;
+                for (size_t n = _in.count(); n > 0; n--)
+                    params.push_back(_readType(_in));
+                type = _ctx->getFunctionType(ret, std::move(params));
+            }   break;
+            case TypeTID::POINTER_TYPE: {
+                Type *target = _readType(_in);
+                type = _ctx->getPointerType(target, _in.u8() != 0);
+            }   break;
+            default:
+                throw_malformed("unknown type kind"sv);
+            }
+            _types.push_back(type);
+        }
+    }
+
+    void ModuleDecoder::_readDefinitions()
+    {
+        Module *module = _target;
+        for (size_t n = _in.count(); n > 0; n--) {
+            std::string name{_in.str()};
+            Type   *type  = _readType(_in);
+            uint8_t flags = _in.u8();
+            size_t  align = _in.uleb();
+            if (_linking && module->getGlobalVariable(name) != nullptr) {
+                _gvars.push_back(_linkGlobalVariable(name, type, flags, align));
+                _gvar_flags.push_back(flags);
+                continue;
+            }
+            owned<GlobalVariable> gvar = GlobalVariable::CreateExternRaw(
+                module, _ctx->getPointerType(type), (flags & GVAR_MUTABLE) != 0);
+            gvar->set_name(name);
+            gvar->set_align(align);
+            MTB_UNLIKELY_IF (module->setGlobalVariable(name, gvar) != Module::OK)
+                throw_malformed(std::format("duplicated definition `{}`", name));
+            _gvars.push_back(gvar);
+            _gvar_flags.push_back(flags);
+        }
+        for (size_t n = _in.count(); n > 0; n--) {
+            std::string name{_in.str()};
+            auto pty = static_cast<PointerType*>(_readType(_in, TypeTID::POINTER_TYPE));
+            bool is_declaration = _in.u8() != 0;
+            _function_has_body.push_back(!is_declaration);
+            if (_linking && module->getFunction(name) != nullptr) {
+                _functions.push_back(_linkFunction(name, pty, is_declaration));
+                continue;
+            }
+            Function::RefT fn = Function::Create(pty, name, module, is_declaration);
+            MTB_UNLIKELY_IF (module->setFunction(name, fn) != Module::OK)
+                throw_malformed(std::format("duplicated definition `{}`", name));
+            _functions.push_back(fn);
+        }
+    }
+
+    GlobalVariable *ModuleDecoder::_linkGlobalVariable(std::string const &name, Type *type,
+                                                       uint8_t flags, size_t align)
+    {
+        GlobalVariable *gvar = _target->getGlobalVariable(name);
+        MTB_UNLIKELY_IF (gvar->get_target_type() != type) {
+            throw LinkException {
+                std::format("global variable `{}` redeclared as `{}`, was `{}`",
+                            name, type->toString(), gvar->get_target_type()->toString())
+            };
+        }
+        if ((flags & GVAR_HAS_INIT) == 0)
+            return gvar;
+        MTB_UNLIKELY_IF (!gvar->is_declaration())
+            throw LinkException{std::format("duplicated definition of global variable `{}`", name)};
+        /* 声明遇到定义: 可变性和对齐以定义为准, 初始值在读完常量池以后再设置 */
+        gvar->set_target_is_mutable((flags & GVAR_MUTABLE) != 0);
+        gvar->set_align(align);
+        return gvar;
+    }
+
+    Function *ModuleDecoder::_linkFunction(std::string const &name, PointerType *pty,
+                                           bool is_declaration)
+    {
+        Function *fn = _target->getFunction(name);
+        MTB_UNLIKELY_IF (fn->get_value_ptr_type() != pty) {
+            throw LinkException {
+                std::format("function `{}` redeclared as `{}`, was `{}`",
+                            name, pty->toString(), fn->get_value_ptr_type()->toString())
+            };
+        }
+        if (is_declaration)
+            return fn;
+        MTB_UNLIKELY_IF (!fn->is_declaration())
+            throw LinkException{std::format("duplicated definition of function `{}`", name)};
+        fn->enableBody();
+        return fn;
+    }
+
+    void ModuleDecoder::_readConstantPool()
+    {
+        size_t nconsts = _in.count();
+        _consts.reserve(nconsts);
+        for (size_t i = 0; i < nconsts; i++) {
+            owned<Value> value;
+            switch (ConstKind(_in.u8())) {
+            case ConstKind::INT: {
+                auto ity = static_cast<IntType*>(_readType(_in, TypeTID::INT_TYPE));
+                value = IntConst::Create(ity, _in.sleb());
+            }   break;
+            case ConstKind::FLOAT: {
+                auto fty = static_cast<FloatType*>(_readType(_in, TypeTID::FLOAT_TYPE));
+                value = FloatConst::Create(fty, _in.f64());
+            }   break;
+            case ConstKind::ZERO:
+                value = own<ZeroDataConst>(*_ctx);
+                break;
+            case ConstKind::UNDEFINED:
+                value = own<UndefinedConst>(_readType(_in));
+                break;
+            case ConstKind::POISON:
+                value = own<PoisonConst>(_readType(_in));
+                break;
+            case ConstKind::ARRAY: {
+                auto aty = static_cast<ArrayType*>(_readType(_in, TypeTID::ARRAY_TYPE));
+                owned<ArrayExpr> arr = ArrayExpr::CreateEmpty(aty);
+                size_t nelems = _in.count();
+                Value::ValueArrayT &elems = arr->unsafe_raw_element_list();
+                elems.reserve(nelems);
+                for (size_t n = 0; n < nelems; n++) {
+                    uint64_t index = _in.uleb();
+                    MTB_UNLIKELY_IF (index > i)
+                        throw_malformed("array element index out of range"sv);
+                    elems.push_back(index == 0 ? nullptr : _consts[index - 1]);
+                }
+                value = arr;
+            }   break;
+            case ConstKind::SPARSE_ARRAY: {
+                auto aty = static_cast<ArrayType*>(_readType(_in, TypeTID::ARRAY_TYPE));
+                size_t nelems = _in.count();
+                ArrayExpr::SparseListT elems;
+                elems.reserve(nelems);
+                uint64_t index = 0;
+                for (size_t n = 0; n < nelems; n++) {
+                    index += _in.uleb();
+                    uint64_t id = _in.uleb();
+                    MTB_UNLIKELY_IF (id >= i || index >= aty->get_length() ||
+                                     (n > 0 && index <= elems.back().index))
+                        throw_malformed("sparse array element out of range"sv);
+                    elems.push_back({index, _consts[id]});
+                }
+                value = ArrayExpr::CreateSparse(aty, std::move(elems));
+            }   break;
+            case ConstKind::DEFINITION: {
+                uint64_t index = _in.uleb();
+                if (index < _gvars.size())
+                    value = _gvars[index];
+                else if (index - _gvars.size() < _functions.size())
+                    value = _functions[index - _gvars.size()];
+                else
+                    throw_malformed("definition index out of range"sv);
+            }   break;
+            default:
+                throw_malformed("unknown constant kind"sv);
+            }
+            _consts.push_back(std::move(value));
+        }
+    }
+
+    Instruction::RefT ModuleDecoder::_readInstruction(ByteReader &in, BasicBlock *parent)
+    {
+        uint64_t raw_opcode = in.uleb();
+        MTB_UNLIKELY_IF (raw_opcode >= OpCode::OPCODE_RESERVED_FOR_COUNTING)
+            throw_malformed("unknown opcode"sv);
+        OpCode opcode{size_t(raw_opcode)};
+        Type  *type = _readType(in);
+        std::string_view name = in.str();
+        uint32_t cur = _locals.size();
+
+        auto operand = [&]() { return _readOperand(in, cur); };
+        Instruction::RefT ret;
+        switch (opcode) {
+        case OpCode::PHI: {
+            owned<PhiSSA> phi = own<PhiSSA>(parent, type);
+            for (size_t n = in.count(); n > 0; n--) {
+                BasicBlock  *from  = _readBlock(in);
+                owned<Value> value = operand();
+                phi->setValueFrom(from, std::move(value));
+            }
+            ret = phi;
+        }   break;
+        case OpCode::JUMP:
+            ret = JumpSSA::Create(parent, _readBlock(in));
+            break;
+        case OpCode::BR: {
+            owned<Value> cond = operand();
+            BasicBlock *if_true  = _readBlock(in);
+            BasicBlock *if_false = _readBlock(in);
+            ret = BranchSSA::Create(std::move(cond), if_true, if_false);
+        }   break;
+        case OpCode::SWITCH: {
+            owned<Value> cond = operand();
+            owned<SwitchSSA> sw = SwitchSSA::Create(std::move(cond), _readBlock(in));
+            for (size_t n = in.count(); n > 0; n--) {
+                int64_t number = in.sleb();
+                sw->setCase(number, _readBlock(in));
+            }
+            ret = sw;
+        }   break;
+        case OpCode::SELECT: {
+            owned<Value> cond     = operand();
+            owned<Value> if_true  = operand();
+            owned<Value> if_false = operand();
+            ret = own<BinarySelectSSA>(type, std::move(cond),
+                                       std::move(if_true), std::move(if_false));
+        }   break;
+        case OpCode::ALLOCA:
+            MTB_UNLIKELY_IF (!type->is_pointer_type())
+                throw_malformed("alloca type should be pointer"sv);
+            ret = own<AllocaSSA>(static_cast<PointerType*>(type), in.uleb());
+            break;
+        case OpCode::LOAD: {
+            owned<Value> ptr = operand();
+            ret = own<LoadSSA>(std::move(ptr), in.uleb());
+        }   break;
+        case OpCode::STORE: {
+            owned<Value> source = operand();
+            owned<Value> target = operand();
+            Type *pty = target->get_value_type();
+            MTB_UNLIKELY_IF (!pty->is_pointer_type())
+                throw_malformed("store target should be pointer"sv);
+            ret = own<StoreSSA>(std::move(source), std::move(target),
+                                static_cast<PointerType*>(pty), in.uleb());
+        }   break;
+        case OpCode::ITOF: case OpCode::UTOF: case OpCode::FTOI:
+        case OpCode::ZEXT: case OpCode::SEXT: case OpCode::BITCAST:
+        case OpCode::TRUNC: case OpCode::FPEXT: case OpCode::FPTRUNC:
+            ret = own<CastSSA>(opcode, type, operand());
+            break;
+        case OpCode::INEG: case OpCode::FNEG: case OpCode::NOT:
+            ret = own<UnaryOperationSSA>(opcode, operand());
+            break;
+        case OpCode::ADD:  case OpCode::FADD: case OpCode::SUB:  case OpCode::FSUB:
+        case OpCode::MUL:  case OpCode::FMUL: case OpCode::SDIV: case OpCode::UDIV:
+        case OpCode::FDIV: case OpCode::UREM: case OpCode::SREM: case OpCode::FREM:
+        case OpCode::AND:  case OpCode::OR:   case OpCode::XOR:  case OpCode::SHL:
+        case OpCode::LSHR: case OpCode::ASHR: {
+            auto sign_flag = BinarySSA::SignFlag(in.u8());
+            owned<Value> lhs = operand();
+            owned<Value> rhs = operand();
+            ret = own<BinarySSA>(opcode, type, sign_flag, std::move(lhs), std::move(rhs));
+        }   break;
+        case OpCode::CALL: {
+            owned<Value> callee = operand();
+            auto fn = dynamic_cast<Function*>(callee.get());
+            MTB_UNLIKELY_IF (fn == nullptr)
+                throw_malformed("callee should be a function"sv);
+            Value::ValueArrayT args(in.count());
+            for (owned<Value> &i: args)
+                i = operand();
+            ret = own<CallSSA>(fn, args);
+        }   break;
+        case OpCode::RET: {
+            Function *fn = parent->get_parent();
+            ret = own<ReturnSSA>(fn, fn->get_return_type(), operand());
+        }   break;
+        case OpCode::GET_ELEMENT_PTR: {
+            MTB_UNLIKELY_IF (!type->is_pointer_type())
+                throw_malformed("getelementptr type should be pointer"sv);
+            owned<Value> collection = operand();
+            Value::ValueArrayT indexes(in.count());
+            for (owned<Value> &i: indexes)
+                i = operand();
+            ret = own<GetElemPtrSSA>(static_cast<PointerType*>(type),
+                                     std::move(collection), indexes);
+        }   break;
+        case OpCode::EXTRACT_ELEMENT: {
+            owned<Value> array = operand();
+            owned<Value> index = operand();
+            Type *aty = array->get_value_type();
+            MTB_UNLIKELY_IF (!aty->is_array_type())
+                throw_malformed("extractelement operand should be array"sv);
+            ret = own<ExtractElemSSA>(std::move(array), std::move(index),
+                                      static_cast<ArrayType*>(aty), type);
+        }   break;
+        case OpCode::INSERT_ELEMENT: {
+            owned<Value> array   = operand();
+            owned<Value> element = operand();
+            owned<Value> index   = operand();
+            ret = own<InsertElemSSA>(std::move(array), std::move(element), std::move(index));
+        }   break;
+        case OpCode::ICMP:
+        case OpCode::FCMP: {
+            CompareSSA::Condition cond{size_t(in.u8())};
+            owned<Value> lhs = operand();
+            owned<Value> rhs = operand();
+            Type *operand_type = lhs->get_value_type();
+            ret = own<CompareSSA>(opcode, cond, operand_type, std::move(lhs), std::move(rhs));
+        }   break;
+        case OpCode::UNREACHABLE:
+            ret = own<UnreachableSSA>();
+            break;
+        default:
+            throw_unsupported("instruction"sv, opcode.getString(), CURRENT_SRCLOC_F);
+        }
+        ret->set_name(name);
+        return ret;
+    }
+
+    void ModuleDecoder::_readFunction(ByteReader &in, Function *fn)
+    {
+        /* 函数体的指令都放进函数自己的竞技场 */
+        ArenaScope scope{fn->get_arena()};
+
+        size_t nblocks = in.count();
+        MTB_UNLIKELY_IF (nblocks == 0)
+            throw_malformed("function without entry"sv);
+        _blocks.assign({fn->get_entry()});
+        for (size_t i = 1; i < nblocks; i++) {
+            BasicBlock::RefT block = BasicBlock::Create(fn);
+            fn->body().append(block);
+            _blocks.push_back(block);
+        }
+
+        _locals.clear();
+        _pending.clear();
+        for (auto &i: fn->argument_list()) {
+            i.argument->set_name(in.str());
+            _locals.push_back(i.argument);
+        }
+        for (BasicBlock *block: _blocks) {
+            block->set_name(in.str());
+            size_t ninsts = in.count();
+            MTB_UNLIKELY_IF (ninsts == 0)
+                throw_malformed("basic block without terminator"sv);
+            for (size_t i = 0; i < ninsts; i++) {
+                Instruction::RefT inst = _readInstruction(in, block);
+                uint32_t id = _locals.size();
+                _locals.push_back(inst);
+                _resolveForward(id, inst);
+
+                bool is_last = i + 1 == ninsts;
+                MTB_UNLIKELY_IF (inst->ends_basic_block() != is_last)
+                    throw_malformed("terminator is not at the end of basic block"sv);
+                if (is_last)
+                    block->set_terminator(std::move(inst));
+                else
+                    block->append(std::move(inst));
+            }
+        }
+        MTB_UNLIKELY_IF (!_pending.empty() || !in.ends())
+            throw_malformed(std::format("bad function body `{}`", fn->get_name()));
+    }
+
+    size_t ModuleDecoder::_readHeader(std::string_view &name)
+    {
+        for (uint8_t i: bitcode_magic) {
+            MTB_UNLIKELY_IF (_in.u8() != i)
+                throw_malformed("bad magic number"sv);
+        }
+        MTB_UNLIKELY_IF (_in.uleb() != bitcode_version)
+            throw_malformed("unsupported version"sv);
+        size_t machine_word_size = _in.uleb();
+        name = _in.str();
+        return machine_word_size;
+    }
+
+    owned<Module> ModuleDecoder::decode()
+    {
+        std::string_view name;
+        size_t machine_word_size = _readHeader(name);
+        _module = Module::Create(name, machine_word_size);
+        _target = _module.get();
+        _ctx    = &_module->type_ctx();
+        _readModule();
+        return std::move(_module);
+    }
+
+    void ModuleDecoder::decodeInto(Module *target)
+    {
+        std::string_view name;
+        size_t machine_word_size = _readHeader(name);
+        _target  = target;
+        _ctx     = &target->type_ctx();
+        _linking = true;
+        MTB_UNLIKELY_IF (machine_word_size != _ctx->get_machine_word_size()) {
+            throw LinkException {
+                std::format("module `{}` has machine word size {}, expected {}",
+                            name, machine_word_size, _ctx->get_machine_word_size())
+            };
+        }
+        _readModule();
+    }
+
+    void ModuleDecoder::_readModule()
+    {
+        _readTypeTable();
+        _readDefinitions();
+        _readConstantPool();
+        for (size_t i = 0; i < _gvars.size(); i++) {
+            if ((_gvar_flags[i] & GVAR_HAS_INIT) == 0)
+                continue;
+            uint64_t index = _in.uleb();
+            MTB_UNLIKELY_IF (index >= _consts.size())
+                throw_malformed("constant index out of range"sv);
+            auto init = dynamic_cast<Constant*>(_consts[index].get());
+            _gvars[i]->set_target(init);
+        }
+        for (size_t i = 0; i < _functions.size(); i++) {
+            if (!_function_has_body[i])
+                continue;
+            ByteReader body = _in.sub(_in.uleb());
+            _readFunction(body, _functions[i]);
+        }
+        MTB_UNLIKELY_IF (!_in.ends())
+            throw_malformed("trailing bytes"sv);
+    }
+} // inline namespace bitcode_impl
+
+std::vector<uint8_t> write_bitcode(Module *module)
+{
+    MTB_UNLIKELY_IF (module == nullptr) {
+        throw NullException {
+            "write_bitcode(module)"sv,
+            std::string{}, CURRENT_SRCLOC_F
+        };
+    }
+    return ModuleEncoder{module}.encode();
+}
+
+void write_bitcode_file(Module *module, std::string const &path)
+{
+    std::vector<uint8_t> bytes = write_bitcode(module);
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    MTB_UNLIKELY_IF (fd < 0) {
+        throw BitcodeException {
+            std::format("open(\"{}\") failed: {}", path, std::strerror(errno))
+        };
+    }
+    size_t written = 0;
+    while (written < bytes.size()) {
+        ssize_t n = ::write(fd, bytes.data() + written, bytes.size() - written);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0) {
+            int err = errno;
+            ::close(fd);
+            throw BitcodeException {
+                std::format("write(\"{}\") failed: {}", path, std::strerror(err))
+            };
+        }
+        written += size_t(n);
+    }
+    ::close(fd);
+}
+
+owned<Module> read_bitcode(std::span<uint8_t const> bytes)
+{
+    return ModuleDecoder{bytes}.decode();
+}
+
+owned<Module> read_bitcode_file(std::string const &path)
+{
+    MappedFile file;
+    MTB_UNLIKELY_IF (!file.open(path)) {
+        throw BitcodeException {
+            std::format("mmap(\"{}\") failed: {}", path, std::strerror(errno))
+        };
+    }
+    return read_bitcode(file.bytes());
+}
+
+void link_bitcode(Module *target, std::span<uint8_t const> bytes)
+{
+    MTB_UNLIKELY_IF (target == nullptr) {
+        throw NullException {
+            "link_bitcode(target)"sv,
+            std::string{}, CURRENT_SRCLOC_F
+        };
+    }
+    ModuleDecoder{bytes}.decodeInto(target);
+}
+
+owned<Module> link_modules(std::string_view name, std::span<Module* const> modules)
+{
+    size_t machine_word_size = global_machine_word_size;
+    if (!modules.empty() && modules.front() != nullptr)
+        machine_word_size = modules.front()->get_type_ctx().get_machine_word_size();
+    owned<Module> ret = Module::Create(name, machine_word_size);
+    for (Module *module: modules)
+        link_bitcode(ret.get(), write_bitcode(module));
+    return ret;
+}
+
+} // namespace MYGL::IRUtil
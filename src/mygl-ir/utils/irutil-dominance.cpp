@@ -0,0 +1,258 @@
+#include "mygl-ir/utils/irutil-dominance.hxx"
+#include "base/mtb-exception.hxx"
+#include "mygl-ir/ir-instruction.hxx"
+#include <algorithm>
+
+namespace MYGL::IRUtil {
+
+using namespace IR;
+using namespace std::string_view_literals;
+
+inline namespace dominance_impl {
+    static void check_function_body(Function *fn, MTB::SourceLocation const &srcloc)
+    {
+        if (fn == nullptr) throw NullException {
+            "DominatorTree::Build()::fn"sv, {}, srcloc
+        };
+        if (fn->is_declaration()) throw NullException {
+            "DominatorTree::Build()::fn.body"sv,
+            "function declaration has no body", srcloc
+        };
+    }
+} // inline namespace dominance_impl
+
+/** @class DominatorTree */
+
+DominatorTree::PtrT DominatorTree::Get(Function *fn)
+{
+    check_function_body(fn, CURRENT_SRCLOC_F);
+    PtrT cached = fn->get_dominator_cache();
+    if (cached != nullptr && cached->is_valid())
+        return cached;
+    PtrT ret = Build(fn);
+    fn->set_dominator_cache(ret);
+    return ret;
+}
+
+DominatorTree::PtrT DominatorTree::Build(Function *fn)
+{
+    check_function_body(fn, CURRENT_SRCLOC_F);
+    return std::make_shared<DominatorTree const>(fn);
+}
+
+DominatorTree::DominatorTree(Function *fn)
+    : _function(fn), _cfg_version(fn->get_cfg_version()) {
+    _build();
+}
+
+uint32_t DominatorTree::indexOf(BasicBlock const *block) const
+{
+    auto iter = _index.find(block);
+    return iter == _index.end() ? NPOS : iter->second;
+}
+
+BasicBlock *DominatorTree::get_idom(BasicBlock const *block) const
+{
+    uint32_t index = indexOf(block);
+    if (index == NPOS || _idom[index] == NPOS)
+        return nullptr;
+    return _blocks[_idom[index]];
+}
+
+DominatorTree::BlockSpanT DominatorTree::get_children(BasicBlock const *block) const
+{
+    uint32_t index = indexOf(block);
+    if (index == NPOS)
+        return {};
+    return BlockSpanT{_children.data() + _child_begin[index],
+                      _child_begin[index + 1] - _child_begin[index]};
+}
+
+bool DominatorTree::dominates(BasicBlock const *a, BasicBlock const *b) const
+{
+    uint32_t ia = indexOf(a), ib = indexOf(b);
+    if (ia == NPOS || ib == NPOS)
+        return false;
+    return _tree_in[ia] <= _tree_in[ib] &&
+           _tree_in[ib] <  _tree_in[ia] + _tree_size[ia];
+}
+bool DominatorTree::dominates(BasicBlock const *a, Instruction const *inst) const
+{
+    return inst != nullptr && dominates(a, inst->get_parent());
+}
+
+DominatorTree::BlockSpanT DominatorTree::get_frontier(BasicBlock const *block) const
+{
+    uint32_t index = indexOf(block);
+    if (index == NPOS)
+        return {};
+    if (!_has_frontier)
+        _computeFrontier();
+    return BlockSpanT{_frontier.data() + _frontier_begin[index],
+                      _frontier_begin[index + 1] - _frontier_begin[index]};
+}
+
+/* private class DominatorTree */
+
+void DominatorTree::_build()
+{
+    /* 1. 深度优先遍历, 先序编号. 后继按终止指令里的顺序访问, 所以同一个函数的
+     *    编号是确定的. 后继表顺手压成一维, 之后求前驱不用再问终止指令. */
+    BasicBlock *entry = _function->get_entry();
+    std::vector<uint32_t>    parent;
+    std::vector<uint32_t>    succ_begin;
+    std::vector<BasicBlock*> succ_list;
+    struct Frame { uint32_t index; uint32_t next; };
+    std::vector<Frame> stack;
+
+    auto visit = [&](BasicBlock *block, uint32_t from) {
+        uint32_t index = uint32_t(_blocks.size());
+        _index.emplace(block, index);
+        _blocks.push_back(block);
+        parent.push_back(from);
+        succ_begin.push_back(uint32_t(succ_list.size()));
+        if (IBasicBlockTerminator *terminator = block->get_terminator()) {
+            terminator->traverse_targets([&succ_list](BasicBlock *target) {
+                if (target != nullptr)
+                    succ_list.push_back(target);
+                return false;
+            });
+        }
+        /* 后继表按编号排, 而编号就是入栈顺序, 所以这里记下的结尾一直有效 */
+        succ_begin.push_back(uint32_t(succ_list.size()));
+        stack.push_back({index, succ_begin[2 * index]});
+    };
+    visit(entry, NPOS);
+    while (!stack.empty()) {
+        Frame &top = stack.back();
+        if (top.next == succ_begin[2 * top.index + 1]) {
+            _rpo.push_back(_blocks[top.index]);
+            stack.pop_back();
+            continue;
+        }
+        BasicBlock *target = succ_list[top.next++];
+        if (!_index.contains(target))
+            visit(target, top.index);
+    }
+    std::reverse(_rpo.begin(), _rpo.end());
+
+    uint32_t n = uint32_t(_blocks.size());
+
+    /* 2. 前驱表, 只保留可达的前驱, 同样压成一维 */
+    std::vector<uint32_t> pred_begin(n + 1, 0);
+    std::vector<uint32_t> pred_list;
+    for (uint32_t v = 0; v < n; v++) {
+        for (uint32_t i = succ_begin[2 * v]; i < succ_begin[2 * v + 1]; i++)
+            pred_begin[_index[succ_list[i]] + 1]++;
+    }
+    for (uint32_t v = 0; v < n; v++)
+        pred_begin[v + 1] += pred_begin[v];
+    pred_list.resize(pred_begin[n]);
+    {
+        std::vector<uint32_t> fill(pred_begin.begin(), pred_begin.end() - 1);
+        for (uint32_t v = 0; v < n; v++) {
+            for (uint32_t i = succ_begin[2 * v]; i < succ_begin[2 * v + 1]; i++)
+                pred_list[fill[_index[succ_list[i]]]++] = v;
+        }
+    }
+
+    /* 3. Semi-NCA. 先按先序的逆序求半支配者, eval 的路径压缩用显式栈展开;
+     *    再按先序沿着树往上找, 直接支配者是半支配者和父结点的最近公共祖先. */
+    std::vector<uint32_t> semi(n), label(n), ancestor(n, NPOS);
+    std::vector<uint32_t> path;
+    for (uint32_t v = 0; v < n; v++)
+        semi[v] = label[v] = v;
+    auto eval = [&](uint32_t v) -> uint32_t {
+        if (ancestor[v] == NPOS)
+            return v;
+        path.clear();
+        uint32_t u = v;
+        while (ancestor[ancestor[u]] != NPOS) {
+            path.push_back(u);
+            u = ancestor[u];
+        }
+        for (size_t i = path.size(); i-- > 0;) {
+            uint32_t x = path[i], a = ancestor[x];
+            if (semi[label[a]] < semi[label[x]])
+                label[x] = label[a];
+            ancestor[x] = ancestor[a];
+        }
+        return label[v];
+    };
+    for (uint32_t w = n; w-- > 1;) {
+        for (uint32_t i = pred_begin[w]; i < pred_begin[w + 1]; i++)
+            semi[w] = std::min(semi[w], semi[eval(pred_list[i])]);
+        ancestor[w] = parent[w];
+    }
+    _idom.assign(parent.begin(), parent.end());
+    for (uint32_t w = 1; w < n; w++) {
+        while (_idom[w] > semi[w])
+            _idom[w] = _idom[_idom[w]];
+    }
+
+    /* 4. 子结点表和先序区间. 直接支配者的编号一定比自己小, 所以逆序一趟就能
+     *    累加出子树大小, 正序一趟就能给每棵子树分配连续的先序号. */
+    _child_begin.assign(n + 1, 0);
+    for (uint32_t w = 1; w < n; w++)
+        _child_begin[_idom[w] + 1]++;
+    for (uint32_t v = 0; v < n; v++)
+        _child_begin[v + 1] += _child_begin[v];
+    _children.resize(n == 0 ? 0 : n - 1);
+    {
+        std::vector<uint32_t> fill(_child_begin.begin(), _child_begin.end() - 1);
+        for (uint32_t w = 1; w < n; w++)
+            _children[fill[_idom[w]]++] = _blocks[w];
+    }
+    _tree_size.assign(n, 1);
+    for (uint32_t w = n; w-- > 1;)
+        _tree_size[_idom[w]] += _tree_size[w];
+    _tree_in.assign(n, 0);
+    std::vector<uint32_t> next_free(n, 0);
+    next_free[0] = 1;
+    for (uint32_t w = 1; w < n; w++) {
+        uint32_t d = _idom[w];
+        _tree_in[w]   = next_free[d];
+        next_free[d] += _tree_size[w];
+        next_free[w]  = _tree_in[w] + 1;
+    }
+}
+
+void DominatorTree::_computeFrontier() const
+{
+    /* Cooper-Harvey-Kennedy: 从汇合点的每个前驱沿支配树往上走, 直到汇合点的
+     * 直接支配者为止, 路上的块的支配边界都含有这个汇合点.
+     * 函数入口本身算作入口块的一个隐含前驱, 所以只要有回边指向入口, 入口就是
+     * 汇合点. 入口没有直接支配者, 从回边的源头一直走到树根为止. */
+    uint32_t n = uint32_t(_blocks.size());
+    std::vector<std::vector<uint32_t>> frontier(n);
+    for (uint32_t b = 0; b < n; b++) {
+        auto const &preds = _blocks[b]->get_comes_from();
+        if (preds.size() + (b == 0 ? 1 : 0) < 2)
+            continue;
+        for (BasicBlock::TargetInfo const &info: preds) {
+            uint32_t runner = indexOf(info.target_block);
+            while (runner != NPOS && runner != _idom[b]) {
+                if (frontier[runner].empty() || frontier[runner].back() != b)
+                    frontier[runner].push_back(b);
+                runner = _idom[runner];
+            }
+        }
+    }
+    _frontier_begin.assign(n + 1, 0);
+    for (uint32_t v = 0; v < n; v++) {
+        std::sort(frontier[v].begin(), frontier[v].end());
+        frontier[v].erase(std::unique(frontier[v].begin(), frontier[v].end()),
+                          frontier[v].end());
+        _frontier_begin[v + 1] = _frontier_begin[v] + uint32_t(frontier[v].size());
+    }
+    _frontier.resize(_frontier_begin[n]);
+    for (uint32_t v = 0; v < n; v++) {
+        for (uint32_t i = 0; i < frontier[v].size(); i++)
+            _frontier[_frontier_begin[v] + i] = _blocks[frontier[v][i]];
+    }
+    _has_frontier = true;
+}
+
+/** end class DominatorTree */
+
+} // namespace MYGL::IRUtil
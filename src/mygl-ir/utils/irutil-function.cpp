@@ -0,0 +1,103 @@
+#include "mygl-ir/utils/irutil-function.hxx"
+#include "base/mtb-exception.hxx"
+#include "mygl-ir/ir-basicblock.hxx"
+#include "mygl-ir/ir-constant.hxx"
+#include "mygl-ir/ir-instruction.hxx"
+#include "mygl-ir/utils/irutil-basicblock.hxx"
+#include "mygl-ir/utils/irutil-value-replace.hxx"
+#include <unordered_set>
+#include <vector>
+
+namespace MYGL::IRUtil::Function {
+
+using namespace IR;
+using namespace std::string_view_literals;
+
+inline namespace function_impl {
+    using BlockSetT = std::unordered_set<IR::BasicBlock const*>;
+
+    /** 从入口出发沿终止指令的跳转目标能走到的基本块 */
+    static BlockSetT mark_reachable(IR::Function *function)
+    {
+        BlockSetT reachable;
+        std::vector<IR::BasicBlock*> worklist{function->get_entry()};
+        reachable.insert(function->get_entry());
+        while (!worklist.empty()) {
+            IR::BasicBlock *block = worklist.back();
+            worklist.pop_back();
+            IBasicBlockTerminator *terminator = block->get_terminator();
+            if (terminator == nullptr)
+                continue;
+            terminator->traverse_targets([&](IR::BasicBlock *target) {
+                if (target != nullptr && reachable.insert(target).second)
+                    worklist.push_back(target);
+                return false;
+            });
+        }
+        return reachable;
+    }
+} // inline namespace function_impl
+
+size_t gc_mark_sweep(IR::Function *function)
+{
+    if (function == nullptr) throw NullException {
+        "gc_mark_sweep()::function"sv, {}, CURRENT_SRCLOC_F
+    };
+    if (function->is_declaration())
+        return 0;
+
+    BlockSetT reachable = mark_reachable(function);
+    std::vector<IR::BasicBlock*> dead;
+    for (IR::BasicBlock *block: function->body()) {
+        if (!reachable.contains(block))
+            dead.push_back(block);
+    }
+    if (dead.empty())
+        return 0;
+
+    /* 1. 可达的后继里, PhiSSA 来自死块的入口没有意义了 */
+    for (IR::BasicBlock *block: dead) {
+        for (IR::BasicBlock::TargetInfo const &info: block->get_jumps_to()) {
+            if (!reachable.contains(info.target_block))
+                continue;
+            for (Instruction *inst: info.target_block->instruction_list()) {
+                if (inst->get_type_id() != ValueTID::PHI_SSA)
+                    break;
+                auto phi = static_cast<PhiSSA*>(inst);
+                if (phi->get_operands().contains(block))
+                    phi->remove(block);
+            }
+        }
+    }
+
+    /* 2. 死块里定义的值不支配任何可达的使用者, 剩下的使用者不是死块自己就是
+     *    不会执行到的地方, 统一换成 undef. 这样死块之间也不再互相引用. */
+    for (IR::BasicBlock *block: dead) {
+        for (Instruction *inst: block->instruction_list()) {
+            if (inst->get_list_as_usee().empty())
+                continue;
+            owned<Value> undef = own<UndefinedConst>(inst->get_value_type());
+            IRUtil::usee_replace_this_with(inst, undef);
+        }
+    }
+
+    /* 3. 先在所有死块都还活着的时候断开它们的跳转关系, 再逐条删掉指令,
+     *    最后删除基本块. 删除顺序因此和块之间的跳转无关. */
+    for (IR::BasicBlock *block: dead)
+        IRUtil::BasicBlock::replace_terminator(block, own<UnreachableSSA>());
+    for (IR::BasicBlock *block: dead) {
+        std::vector<Instruction*> insts;
+        for (Instruction *inst: block->instruction_list()) {
+            if (!inst->ends_basic_block())
+                insts.push_back(inst);
+        }
+        for (Instruction *inst: insts)
+            inst->removeThisIfUnused();
+        block->get_modifier().remove_this();
+    }
+    /* 删掉的块已经没有父结点了, 它们的跳转关系变化通知不到函数, 这里补一次 */
+    function->markCfgChanged();
+    return dead.size();
+}
+
+} // namespace MYGL::IRUtil::Function
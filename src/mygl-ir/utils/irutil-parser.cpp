@@ -0,0 +1,904 @@
+#include "base/mtb-arena.hxx"
+#include "base/mtb-exception.hxx"
+#include "base/mtb-mapped-file.hxx"
+#include "base/mtb-object.hxx"
+#include "mygl-ir/ir-basic-value.hxx"
+#include "mygl-ir/ir-basicblock.hxx"
+#include "mygl-ir/ir-constant.hxx"
+#include "mygl-ir/ir-constant-function.hxx"
+#include "mygl-ir/ir-instruction.hxx"
+#include "mygl-ir/ir-module.hxx"
+#include "mygl-ir/irbase-type.hxx"
+#include "mygl-ir/irbase-use-def.hxx"
+#include "mygl-ir/utils/irutil-parser.hxx"
+#include "mygl-ir/utils/irutil-value-replace.hxx"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <format>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace MYGL::IRUtil {
+
+using namespace IR;
+using namespace IRBase;
+using namespace MTB;
+using OpCode = Instruction::OpCode;
+
+ParseException::ParseException(size_t line, size_t column, std::string_view msg,
+                               SourceLocation location)
+    : MTB::Exception(MTB::ErrorLevel::CRITICAL,
+                     std::format("{}:{}: {}", line, column, msg), location),
+      line(line), column(column) {}
+
+inline namespace parser_impl {
+    using namespace std::string_view_literals;
+
+    static inline bool is_name_char(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+               (c >= '0' && c <= '9') || c == '_' || c == '.' || c == '$';
+    }
+    static inline bool is_space_char(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+    /** Writer 给没有名字的值生成的编号, 读入后不作为名称 */
+    static inline bool is_slot_name(std::string_view name) {
+        return !name.empty() &&
+               std::all_of(name.begin(), name.end(),
+                           [](char c) { return c >= '0' && c <= '9'; });
+    }
+
+    /** 行号列号只在出错时才从文本开头数出来 */
+    [[noreturn]] static void throw_parse_error(std::string_view text, size_t pos,
+                                               std::string_view msg,
+                                               SourceLocation location = CURRENT_SRCLOC)
+    {
+        std::string_view before = text.substr(0, std::min(pos, text.size()));
+        size_t line   = 1 + std::count(before.begin(), before.end(), '\n');
+        size_t bol    = before.rfind('\n');
+        size_t column = bol == before.npos ? before.size() + 1
+                                           : before.size() - bol;
+        throw ParseException{line, column, msg, location};
+    }
+
+    /** @fn parse_condition(word, is_float, out)
+     * @brief `CompareSSA::Condition::getString()` 的逆运算. */
+    static bool parse_condition(std::string_view word, bool is_float,
+                                CompareSSA::Condition &out)
+    {
+        if (word == "false"sv || word == "true"sv) {
+            out = {word == "true"sv ? CompareResult::TRUE : CompareResult::FALSE,
+                   is_float, false};
+            return true;
+        }
+        /* 整数的相等比较没有前缀, 不区分符号, 按有符号比较读入 */
+        bool signed_or_ordered = true;
+        if (word.size() == 3) {
+            char prefix = word[0];
+            if (is_float && (prefix == 'o' || prefix == 'u'))
+                signed_or_ordered = prefix == 'o';
+            else if (!is_float && (prefix == 's' || prefix == 'u'))
+                signed_or_ordered = prefix == 's';
+            else
+                return false;
+            word.remove_prefix(1);
+        } else if (is_float || (word != "eq"sv && word != "ne"sv)) {
+            return false;
+        }
+        CompareResult result;
+        if (word == "eq"sv)      result = CompareResult::EQ;
+        else if (word == "ne"sv) result = CompareResult::NE;
+        else if (word == "lt"sv) result = CompareResult::LT;
+        else if (word == "le"sv) result = CompareResult::LE;
+        else if (word == "gt"sv) result = CompareResult::GT;
+        else if (word == "ge"sv) result = CompareResult::GE;
+        else
+            return false;
+        out = {result, is_float, signed_or_ordered};
+        return true;
+    }
+
+    /** @class ModuleParser
+     * @brief 在输入文本上移动游标构造模块. 先扫一遍顶层定义的头部, 建好全局变量
+     *        和函数; 再依次读全局变量初始值和函数体. 每个函数体先找出所有标签建好
+     *        基本块, 所以跳转目标总是已知的; 向前引用的局部值先用同类型的
+     *        undefined 常量占位, 等被引用的指令建好以后再整体替换. */
+    class ModuleParser {
+    public:
+        explicit ModuleParser(std::string_view text): _text(text) {}
+        owned<Module> parse();
+    private:
+        struct PendingGlobal {
+            GlobalVariable *gvar;
+            Type           *target_type;
+            size_t          init_pos;
+        }; // struct PendingGlobal
+        struct PendingFunction {
+            Function *fn;
+            std::vector<std::string_view> arg_names;
+            size_t body_pos, body_end;
+        }; // struct PendingFunction
+
+        std::string_view _text;
+        size_t           _pos = 0;
+        owned<Module>    _module;
+        TypeContext     *_ctx = nullptr;
+
+        std::unordered_map<std::string_view, Value*> _defs;
+        std::vector<PendingGlobal>   _globals;
+        std::vector<PendingFunction> _functions;
+
+        /* 当前函数 */
+        std::unordered_map<std::string_view, Value*>      _locals;
+        std::unordered_map<std::string_view, BasicBlock*> _blocks;
+        struct PendingLocal {
+            size_t first_use;
+            std::vector<owned<Value>> placeholders;
+        }; // struct PendingLocal
+        std::unordered_map<std::string_view, PendingLocal> _pending;
+
+        [[noreturn]] void _error(std::string_view msg,
+                                 SourceLocation location = CURRENT_SRCLOC) const {
+            throw_parse_error(_text, _pos, msg, location);
+        }
+        /* 词法 */
+        void _skipSpace();
+        bool _tryConsume(char c);
+        void _expect(char c);
+        std::string_view _peekWord();
+        std::string_view _readWord();
+        bool _tryKeyword(std::string_view keyword);
+        void _expectKeyword(std::string_view keyword);
+        std::string_view _readName(char prefix);
+        std::string_view _readLiteral();
+        uint64_t _readUInt();
+        int64_t  _readInt();
+
+        /* 语法 */
+        Type *_parseType();
+        owned<Value> _parseValue(Type *type);
+        owned<Value> _parseTypedValue();
+        owned<Value> _parseArray(Type *type);
+        owned<Value> _parseZero(Type *type);
+        BasicBlock  *_parseBlockRef();
+        BasicBlock  *_parseLabel();
+        size_t       _parseAlign();
+
+        void _scanDefinitions();
+        void _scanGlobal();
+        void _scanFunction(bool is_declaration);
+        void _parseFunction(PendingFunction &pending);
+        Instruction::RefT _parseInstruction(BasicBlock *parent);
+        void _defineLocal(std::string_view name, Value *value, size_t pos);
+    }; // class ModuleParser
+
+/* ================ [ModuleParser: 词法] ================ */
+
+    void ModuleParser::_skipSpace()
+    {
+        while (_pos < _text.size()) {
+            char c = _text[_pos];
+            if (is_space_char(c)) {
+                _pos++;
+            } else if (c == ';') {
+                size_t eol = _text.find('\n', _pos);
+                _pos = eol == _text.npos ? _text.size() : eol + 1;
+            } else {
+                break;
+            }
+        }
+    }
+    bool ModuleParser::_tryConsume(char c)
+    {
+        _skipSpace();
+        if (_pos < _text.size() && _text[_pos] == c) {
+            _pos++;
+            return true;
+        }
+        return false;
+    }
+    void ModuleParser::_expect(char c)
+    {
+        MTB_UNLIKELY_IF (!_tryConsume(c))
+            _error(std::format("expected `{}`", c));
+    }
+    std::string_view ModuleParser::_peekWord()
+    {
+        _skipSpace();
+        size_t end = _pos;
+        while (end < _text.size() && is_name_char(_text[end]))
+            end++;
+        return _text.substr(_pos, end - _pos);
+    }
+    std::string_view ModuleParser::_readWord()
+    {
+        std::string_view ret = _peekWord();
+        MTB_UNLIKELY_IF (ret.empty())
+            _error("expected identifier"sv);
+        _pos += ret.size();
+        return ret;
+    }
+    bool ModuleParser::_tryKeyword(std::string_view keyword)
+    {
+        if (_peekWord() != keyword)
+            return false;
+        _pos += keyword.size();
+        return true;
+    }
+    void ModuleParser::_expectKeyword(std::string_view keyword)
+    {
+        MTB_UNLIKELY_IF (!_tryKeyword(keyword))
+            _error(std::format("expected `{}`", keyword));
+    }
+    std::string_view ModuleParser::_readName(char prefix)
+    {
+        _expect(prefix);
+        size_t begin = _pos;
+        while (_pos < _text.size() && is_name_char(_text[_pos]))
+            _pos++;
+        MTB_UNLIKELY_IF (_pos == begin)
+            _error(std::format("expected name after `{}`", prefix));
+        return _text.substr(begin, _pos - begin);
+    }
+    /** 数字或者关键字常量: `-12`、`1.5e+10`、`-inf`、`undef`... */
+    std::string_view ModuleParser::_readLiteral()
+    {
+        _skipSpace();
+        size_t begin = _pos;
+        if (_pos < _text.size() && (_text[_pos] == '-' || _text[_pos] == '+'))
+            _pos++;
+        while (_pos < _text.size()) {
+            char c = _text[_pos];
+            bool is_exp_sign = (c == '-' || c == '+') &&
+                               (_text[_pos - 1] == 'e' || _text[_pos - 1] == 'E');
+            if (!is_name_char(c) && !is_exp_sign)
+                break;
+            _pos++;
+        }
+        MTB_UNLIKELY_IF (_pos == begin)
+            _error("expected value"sv);
+        return _text.substr(begin, _pos - begin);
+    }
+    uint64_t ModuleParser::_readUInt()
+    {
+        std::string_view word = _readLiteral();
+        uint64_t ret = 0;
+        auto [end, ec] = std::from_chars(word.data(), word.data() + word.size(), ret);
+        MTB_UNLIKELY_IF (ec != std::errc{} || end != word.data() + word.size())
+            throw_parse_error(_text, _pos - word.size(),
+                std::format("bad unsigned integer `{}`", word));
+        return ret;
+    }
+    int64_t ModuleParser::_readInt()
+    {
+        std::string_view word = _readLiteral();
+        char const *first = word.data(), *last = first + word.size();
+        int64_t ret = 0;
+        auto [end, ec] = std::from_chars(first, last, ret);
+        /* 超出 int64 范围的无符号数按位模式读入 */
+        if (ec == std::errc::result_out_of_range && word[0] != '-') {
+            uint64_t uret = 0;
+            auto uresult = std::from_chars(first, last, uret);
+            end = uresult.ptr;
+            ec  = uresult.ec;
+            ret = std::bit_cast<int64_t>(uret);
+        }
+        MTB_UNLIKELY_IF (ec != std::errc{} || end != last)
+            throw_parse_error(_text, _pos - word.size(),
+                std::format("bad integer `{}`", word));
+        return ret;
+    }
+
+/* ================ [ModuleParser: 类型与操作数] ================ */
+
+    /** 类型语法: `void`, `label`, `i<N>`, `u<N>`, `float`, `double`, `[<N> x <type>]`,
+     *  以及后缀 `*` 与 `(<param types>)`. */
+    Type *ModuleParser::_parseType()
+    {
+        Type *ret = nullptr;
+        size_t begin = (_skipSpace(), _pos);
+        if (_tryConsume('[')) {
+            size_t length = _readUInt();
+            _expectKeyword("x"sv);
+            Type *elem = _parseType();
+            _expect(']');
+            ret = _ctx->getArrayType(elem, length);
+        } else {
+            std::string_view word = _readWord();
+            if (word == "void"sv) {
+                ret = VoidType::voidty;
+            } else if (word == "label"sv) {
+                ret = LabelType::labelty.get();
+            } else if (word == "float"sv || word == "f32"sv) {
+                ret = _ctx->getIeeeF32();
+            } else if (word == "double"sv || word == "f64"sv) {
+                ret = _ctx->getIeeeF64();
+            } else if (word.size() > 1 && (word[0] == 'i' || word[0] == 'u') &&
+                       is_slot_name(word.substr(1))) {
+                size_t nbits = 0;
+                std::from_chars(word.data() + 1, word.data() + word.size(), nbits);
+                ret = _ctx->getIntType(nbits, word[0] == 'u');
+            } else {
+                throw_parse_error(_text, begin, std::format("unknown type `{}`", word));
+            }
+        }
+
+        while (true) {
+            if (_tryConsume('*')) {
+                ret = _ctx->getPointerType(ret);
+            } else if (_tryConsume('(')) {
+                TypeContext::FTypeListT params;
+                if (!_tryConsume(')')) {
+                    do params.push_back(_parseType());
+                    while (_tryConsume(','));
+                    _expect(')');
+                }
+                ret = _ctx->getFunctionType(ret, std::move(params));
+            } else {
+                return ret;
+            }
+        }
+    }
+
+    owned<Value> ModuleParser::_parseValue(Type *type)
+    {
+        _skipSpace();
+        size_t begin = _pos;
+        char c = _pos < _text.size() ? _text[_pos] : '\0';
+        if (c == '%') {
+            std::string_view name = _readName('%');
+            if (auto it = _locals.find(name); it != _locals.end())
+                return it->second;
+            owned<Value> placeholder = own<UndefinedConst>(type);
+            auto [pending, _] = _pending.try_emplace(name, PendingLocal{begin, {}});
+            pending->second.placeholders.push_back(placeholder);
+            return placeholder;
+        }
+        if (c == '@') {
+            std::string_view name = _readName('@');
+            auto it = _defs.find(name);
+            MTB_UNLIKELY_IF (it == _defs.end())
+                throw_parse_error(_text, begin, std::format("undefined global `@{}`", name));
+            return it->second;
+        }
+        if (c == '[')
+            return _parseArray(type);
+
+        std::string_view word = _readLiteral();
+        if (word == "undef"sv)
+            return own<UndefinedConst>(type);
+        if (word == "poison"sv)
+            return own<PoisonConst>(type);
+        if (word == "zeroinitializer"sv)
+            return _parseZero(type);
+        if (type->is_integer_type()) {
+            auto ity = static_cast<IntType*>(type);
+            if (word == "true"sv || word == "false"sv)
+                return IntConst::Create(ity, int64_t(word == "true"sv));
+            _pos = begin;
+            return IntConst::Create(ity, _readInt());
+        }
+        if (type->is_float_type()) {
+            double value = 0;
+            char const *last = word.data() + word.size();
+            auto [end, ec] = std::from_chars(word.data(), last, value);
+            MTB_UNLIKELY_IF (ec != std::errc{} || end != last)
+                throw_parse_error(_text, begin, std::format("bad float `{}`", word));
+            return FloatConst::Create(static_cast<FloatType*>(type), value);
+        }
+        throw_parse_error(_text, begin,
+            std::format("unexpected `{}` for type {}", word, type->toString()));
+    }
+    owned<Value> ModuleParser::_parseTypedValue()
+    {
+        Type *type = _parseType();
+        return _parseValue(type);
+    }
+
+    /** 数组常量: `[<type> <value>, ...]`. 元素写成 `zeroinitializer` 时原始元素
+     *  列表里存空指针, 和 Writer 的输出规则相反. */
+    owned<Value> ModuleParser::_parseArray(Type *type)
+    {
+        size_t begin = _pos;
+        MTB_UNLIKELY_IF (!type->is_array_type())
+            _error(std::format("array constant for type {}", type->toString()));
+        auto aty = static_cast<ArrayType*>(type);
+        Type *elem_type = aty->get_element_type();
+        owned<ArrayExpr> arr = ArrayExpr::CreateEmpty(aty);
+        Value::ValueArrayT &elems = arr->unsafe_raw_element_list();
+
+        _expect('[');
+        if (_tryConsume(']'))
+            return arr;
+        elems.reserve(aty->get_length());
+        do {
+            size_t elem_pos = (_skipSpace(), _pos);
+            MTB_UNLIKELY_IF (!_parseType()->equals(elem_type))
+                throw_parse_error(_text, elem_pos, "array element type mismatch"sv);
+            if (_tryKeyword("zeroinitializer"sv))
+                elems.push_back(nullptr);
+            else
+                elems.push_back(_parseValue(elem_type));
+        } while (_tryConsume(','));
+        _expect(']');
+        MTB_UNLIKELY_IF (elems.size() > aty->get_length())
+            throw_parse_error(_text, begin, "too many array elements"sv);
+        return arr;
+    }
+    owned<Value> ModuleParser::_parseZero(Type *type)
+    {
+        if (type->is_array_type())
+            return ArrayExpr::CreateEmpty(static_cast<ArrayType*>(type));
+        if (type->is_integer_type())
+            return IntConst::Create(static_cast<IntType*>(type), int64_t(0));
+        if (type->is_float_type())
+            return FloatConst::Create(static_cast<FloatType*>(type), 0.0);
+        _error(std::format("no zero value for type {}", type->toString()));
+    }
+
+    BasicBlock *ModuleParser::_parseBlockRef()
+    {
+        size_t begin = (_skipSpace(), _pos);
+        std::string_view name = _readName('%');
+        auto it = _blocks.find(name);
+        MTB_UNLIKELY_IF (it == _blocks.end())
+            throw_parse_error(_text, begin, std::format("undefined label `%{}`", name));
+        return it->second;
+    }
+    BasicBlock *ModuleParser::_parseLabel()
+    {
+        _expectKeyword("label"sv);
+        return _parseBlockRef();
+    }
+    size_t ModuleParser::_parseAlign()
+    {
+        _expect(',');
+        _expectKeyword("align"sv);
+        return _readUInt();
+    }
+
+/* ================ [ModuleParser: 顶层定义] ================ */
+
+    void ModuleParser::_scanDefinitions()
+    {
+        while (true) {
+            _skipSpace();
+            if (_pos >= _text.size())
+                return;
+            if (_text[_pos] == '@') {
+                _scanGlobal();
+                continue;
+            }
+            size_t begin = _pos;
+            std::string_view word = _readWord();
+            if (word == "define"sv)
+                _scanFunction(false);
+            else if (word == "declare"sv)
+                _scanFunction(true);
+            else
+                throw_parse_error(_text, begin,
+                    std::format("expected top-level definition, got `{}`", word));
+        }
+    }
+
+    /** `@<name> = [external ]dso_local global|constant <type>[ <init>], align <N>`
+     *  初始值留到所有定义都建好以后再读, 这里直接跳到行尾. */
+    void ModuleParser::_scanGlobal()
+    {
+        size_t begin = _pos;
+        std::string_view name = _readName('@');
+        _expect('=');
+        bool is_extern = _tryKeyword("external"sv);
+        _tryKeyword("dso_local"sv);
+        bool is_mutable = _tryKeyword("global"sv);
+        if (!is_mutable)
+            _expectKeyword("constant"sv);
+        Type *type = _parseType();
+
+        owned<GlobalVariable> gvar = GlobalVariable::CreateExternRaw(
+            _module, _ctx->getPointerType(type), is_mutable);
+        gvar->set_name(name);
+        MTB_UNLIKELY_IF (_module->setGlobalVariable(std::string{name}, gvar) != Module::OK ||
+                         !_defs.emplace(name, gvar.get()).second) {
+            throw_parse_error(_text, begin, std::format("duplicated definition `@{}`", name));
+        }
+        if (is_extern) {
+            gvar->set_align(_parseAlign());
+            return;
+        }
+        _globals.push_back({gvar, type, _pos});
+        size_t eol = _text.find('\n', _pos);
+        _pos = eol == _text.npos ? _text.size() : eol + 1;
+    }
+
+    /** `define|declare dso_local <ret> @<name>(<type> [%<arg>], ...)`
+     *  函数体留到所有定义都建好以后再读, 这里直接跳到行首的 `}`. */
+    void ModuleParser::_scanFunction(bool is_declaration)
+    {
+        _tryKeyword("dso_local"sv);
+        Type *ret_type = _parseType();
+        size_t begin = (_skipSpace(), _pos);
+        std::string_view name = _readName('@');
+
+        PendingFunction pending{};
+        TypeContext::FTypeListT params;
+        _expect('(');
+        if (!_tryConsume(')')) {
+            do {
+                params.push_back(_parseType());
+                _skipSpace();
+                if (!is_declaration)
+                    pending.arg_names.push_back(_readName('%'));
+            } while (_tryConsume(','));
+            _expect(')');
+        }
+        FunctionType *fty = _ctx->getFunctionType(ret_type, std::move(params));
+        Function::RefT fn = Function::Create(_ctx->getPointerType(fty),
+                                             std::string{name}, _module, is_declaration);
+        MTB_UNLIKELY_IF (_module->setFunction(std::string{name}, fn) != Module::OK ||
+                         !_defs.emplace(name, fn.get()).second) {
+            throw_parse_error(_text, begin, std::format("duplicated definition `@{}`", name));
+        }
+        if (is_declaration)
+            return;
+
+        _expect('{');
+        size_t end = _text.find("\n}"sv, _pos);
+        MTB_UNLIKELY_IF (end == _text.npos)
+            _error(std::format("unterminated function body `@{}`", name));
+        pending.fn       = fn;
+        pending.body_pos = _pos;
+        pending.body_end = end + 1;
+        _functions.push_back(std::move(pending));
+        _pos = end + 2;
+    }
+
+/* ================ [ModuleParser: 函数体] ================ */
+
+    void ModuleParser::_defineLocal(std::string_view name, Value *value, size_t pos)
+    {
+        MTB_UNLIKELY_IF (!_locals.emplace(name, value).second)
+            throw_parse_error(_text, pos, std::format("redefinition of `%{}`", name));
+        if (!is_slot_name(name))
+            value->set_name(name);
+
+        auto it = _pending.find(name);
+        if (it == _pending.end())
+            return;
+        for (owned<Value> &i: it->second.placeholders) {
+            MTB_UNLIKELY_IF (!i->get_value_type()->equals(value->get_value_type()))
+                throw_parse_error(_text, pos, std::format("`%{}` type mismatch", name));
+            usee_replace_this_with(i, value);
+        }
+        _pending.erase(it);
+    }
+
+    void ModuleParser::_parseFunction(PendingFunction &pending)
+    {
+        Function *fn = pending.fn;
+        /* 函数体的指令都放进函数自己的竞技场 */
+        ArenaScope scope{fn->get_arena()};
+
+        _locals.clear();
+        _blocks.clear();
+        _pending.clear();
+        for (size_t i = 0; i < pending.arg_names.size(); i++)
+            _defineLocal(pending.arg_names[i], fn->argumentAt(i), pending.body_pos);
+
+        /* 先找出所有从行首开始的标签, 按出现顺序建好基本块 */
+        std::string_view body = _text.substr(pending.body_pos,
+                                             pending.body_end - pending.body_pos);
+        for (size_t line = 0; line < body.size(); ) {
+            size_t end = line;
+            while (end < body.size() && is_name_char(body[end]))
+                end++;
+            if (end != line && end < body.size() && body[end] == ':') {
+                std::string_view name = body.substr(line, end - line);
+                BasicBlock *block = fn->get_entry();
+                if (!_blocks.empty()) {
+                    BasicBlock::RefT new_block = BasicBlock::Create(fn);
+                    fn->body().append(new_block);
+                    block = new_block;
+                }
+                MTB_UNLIKELY_IF (!_blocks.emplace(name, block).second) {
+                    throw_parse_error(_text, pending.body_pos + line,
+                        std::format("redefinition of label `{}`", name));
+                }
+                if (!is_slot_name(name))
+                    block->set_name(name);
+            }
+            size_t eol = body.find('\n', line);
+            line = eol == body.npos ? body.size() : eol + 1;
+        }
+        _pos = pending.body_pos;
+        MTB_UNLIKELY_IF (_blocks.empty())
+            _error(std::format("function `{}` without entry label", fn->get_name()));
+
+        BasicBlock *block = nullptr;
+        bool terminated = true;
+        while ((_skipSpace(), _pos) < pending.body_end) {
+            std::string_view word = _peekWord();
+            size_t after = _pos + word.size();
+            if (!word.empty() && after < _text.size() && _text[after] == ':') {
+                MTB_UNLIKELY_IF (!terminated)
+                    _error("basic block without terminator"sv);
+                block = _blocks.at(word);
+                terminated = false;
+                _pos = after + 1;
+                continue;
+            }
+            MTB_UNLIKELY_IF (terminated)
+                _error("instruction after terminator"sv);
+            Instruction::RefT inst = _parseInstruction(block);
+            terminated = inst->ends_basic_block();
+            if (terminated)
+                block->set_terminator(std::move(inst));
+            else
+                block->append(std::move(inst));
+        }
+        MTB_UNLIKELY_IF (!terminated)
+            _error("basic block without terminator"sv);
+        if (!_pending.empty()) {
+            auto &[name, pending_local] = *_pending.begin();
+            throw_parse_error(_text, pending_local.first_use,
+                std::format("undefined value `%{}`", name));
+        }
+        _pos = pending.body_end + 1;
+    }
+
+    Instruction::RefT ModuleParser::_parseInstruction(BasicBlock *parent)
+    {
+        size_t begin = (_skipSpace(), _pos);
+        std::string_view name;
+        if (_text[_pos] == '%') {
+            name = _readName('%');
+            _expect('=');
+        }
+        size_t opcode_pos = (_skipSpace(), _pos);
+        std::string_view opcode_name = _readWord();
+        OpCode opcode = OpCode::FromString(opcode_name);
+
+        Instruction::RefT ret;
+        switch (opcode) {
+        case OpCode::PHI: {
+            Type *type = _parseType();
+            owned<PhiSSA> phi = own<PhiSSA>(parent, type);
+            do {
+                _expect('[');
+                owned<Value> value = _parseValue(type);
+                _expect(',');
+                /* LLVM 兼容格式不写 label */
+                _tryKeyword("label"sv);
+                BasicBlock *from = _parseBlockRef();
+                _expect(']');
+                phi->setValueFrom(from, std::move(value));
+            } while (_tryConsume(','));
+            ret = phi;
+        }   break;
+        case OpCode::BR:
+            if (_tryKeyword("label"sv)) {
+                ret = JumpSSA::Create(parent, _parseBlockRef());
+            } else {
+                owned<Value> cond = _parseTypedValue();
+                _expect(',');
+                BasicBlock *if_true = _parseLabel();
+                _expect(',');
+                BasicBlock *if_false = _parseLabel();
+                ret = BranchSSA::Create(std::move(cond), if_true, if_false);
+            }
+            break;
+        case OpCode::SWITCH: {
+            owned<Value> cond = _parseTypedValue();
+            _expect(',');
+            owned<SwitchSSA> sw = SwitchSSA::Create(std::move(cond), _parseLabel());
+            _expect('[');
+            while (!_tryConsume(']')) {
+                (void)_parseType();
+                int64_t number = _readInt();
+                _expect(',');
+                sw->setCase(number, _parseLabel());
+            }
+            ret = sw;
+        }   break;
+        case OpCode::SELECT: {
+            owned<Value> cond = _parseTypedValue();
+            _expect(',');
+            owned<Value> if_true = _parseTypedValue();
+            _expect(',');
+            owned<Value> if_false = _parseTypedValue();
+            Type *type = if_true->get_value_type();
+            ret = own<BinarySelectSSA>(type, std::move(cond),
+                                       std::move(if_true), std::move(if_false));
+        }   break;
+        case OpCode::ALLOCA: {
+            Type *type = _parseType();
+            ret = own<AllocaSSA>(_ctx->getPointerType(type), _parseAlign());
+        }   break;
+        case OpCode::LOAD: {
+            (void)_parseType();
+            _expect(',');
+            owned<Value> ptr = _parseTypedValue();
+            ret = own<LoadSSA>(std::move(ptr), _parseAlign());
+        }   break;
+        case OpCode::STORE: {
+            owned<Value> source = _parseTypedValue();
+            _expect(',');
+            size_t target_pos = (_skipSpace(), _pos);
+            owned<Value> target = _parseTypedValue();
+            Type *pty = target->get_value_type();
+            MTB_UNLIKELY_IF (!pty->is_pointer_type())
+                throw_parse_error(_text, target_pos, "store target should be pointer"sv);
+            ret = own<StoreSSA>(std::move(source), std::move(target),
+                                static_cast<PointerType*>(pty), _parseAlign());
+        }   break;
+        case OpCode::ITOF: case OpCode::UTOF: case OpCode::FTOI:
+        case OpCode::ZEXT: case OpCode::SEXT: case OpCode::BITCAST:
+        case OpCode::TRUNC: case OpCode::FPEXT: case OpCode::FPTRUNC: {
+            owned<Value> operand = _parseTypedValue();
+            _expectKeyword("to"sv);
+            ret = own<CastSSA>(opcode, _parseType(), std::move(operand));
+        }   break;
+        case OpCode::INEG: case OpCode::FNEG: case OpCode::NOT:
+            ret = own<UnaryOperationSSA>(opcode, _parseTypedValue());
+            break;
+        case OpCode::ADD:  case OpCode::FADD: case OpCode::SUB:  case OpCode::FSUB:
+        case OpCode::MUL:  case OpCode::FMUL: case OpCode::SDIV: case OpCode::UDIV:
+        case OpCode::FDIV: case OpCode::UREM: case OpCode::SREM: case OpCode::FREM:
+        case OpCode::AND:  case OpCode::OR:   case OpCode::XOR:  case OpCode::SHL:
+        case OpCode::LSHR: case OpCode::ASHR: {
+            auto sign_flag = BinarySSA::SignFlag::NONE;
+            if (_tryKeyword("nsw"sv))
+                sign_flag = BinarySSA::SignFlag::NSW;
+            else if (_tryKeyword("nuw"sv))
+                sign_flag = BinarySSA::SignFlag::NUW;
+            Type *type = _parseType();
+            owned<Value> lhs = _parseValue(type);
+            _expect(',');
+            owned<Value> rhs = _parseValue(type);
+            ret = own<BinarySSA>(opcode, type, sign_flag, std::move(lhs), std::move(rhs));
+        }   break;
+        case OpCode::CALL: {
+            (void)_parseType();
+            size_t callee_pos = (_skipSpace(), _pos);
+            owned<Value> callee = _parseValue(VoidType::voidty);
+            auto fn = dynamic_cast<Function*>(callee.get());
+            MTB_UNLIKELY_IF (fn == nullptr)
+                throw_parse_error(_text, callee_pos, "callee should be a function"sv);
+            Value::ValueArrayT args;
+            _expect('(');
+            if (!_tryConsume(')')) {
+                do {
+                    Type *type = _parseType();
+                    _tryKeyword("noundef"sv);
+                    args.push_back(_parseValue(type));
+                } while (_tryConsume(','));
+                _expect(')');
+            }
+            ret = own<CallSSA>(fn, args);
+        }   break;
+        case OpCode::RET: {
+            Function *fn = parent->get_parent();
+            Type *type = _parseType();
+            owned<Value> result = type->is_void_type() ? nullptr : _parseValue(type);
+            ret = own<ReturnSSA>(fn, fn->get_return_type(), std::move(result));
+        }   break;
+        case OpCode::GET_ELEMENT_PTR: {
+            _tryKeyword("inbounds"sv);
+            Type *type = _parseType();
+            MTB_UNLIKELY_IF (!type->is_pointer_type())
+                throw_parse_error(_text, opcode_pos, "getelementptr type should be pointer"sv);
+            _expect(',');
+            owned<Value> collection = _parseTypedValue();
+            Value::ValueArrayT indexes;
+            while (_tryConsume(','))
+                indexes.push_back(_parseTypedValue());
+            ret = own<GetElemPtrSSA>(static_cast<PointerType*>(type),
+                                     std::move(collection), indexes);
+        }   break;
+        case OpCode::EXTRACT_ELEMENT: {
+            Type *type = _parseType();
+            _expect(',');
+            owned<Value> array = _parseTypedValue();
+            Type *aty = array->get_value_type();
+            MTB_UNLIKELY_IF (!aty->is_array_type())
+                throw_parse_error(_text, opcode_pos, "extractelement operand should be array"sv);
+            _expect(',');
+            owned<Value> index = _parseTypedValue();
+            ret = own<ExtractElemSSA>(std::move(array), std::move(index),
+                                      static_cast<ArrayType*>(aty), type);
+        }   break;
+        case OpCode::INSERT_ELEMENT: {
+            owned<Value> array = _parseTypedValue();
+            _expect(',');
+            owned<Value> element = _parseTypedValue();
+            _expect(',');
+            owned<Value> index = _parseTypedValue();
+            ret = own<InsertElemSSA>(std::move(array), std::move(element), std::move(index));
+        }   break;
+        case OpCode::ICMP:
+        case OpCode::FCMP: {
+            size_t cond_pos = (_skipSpace(), _pos);
+            std::string_view cond_name = _readWord();
+            CompareSSA::Condition cond{size_t(0)};
+            MTB_UNLIKELY_IF (!parse_condition(cond_name, opcode == OpCode::FCMP, cond)) {
+                throw_parse_error(_text, cond_pos,
+                    std::format("bad {} condition `{}`", opcode_name, cond_name));
+            }
+            Type *type = _parseType();
+            owned<Value> lhs = _parseValue(type);
+            _expect(',');
+            owned<Value> rhs = _parseValue(type);
+            ret = own<CompareSSA>(opcode, cond, type, std::move(lhs), std::move(rhs));
+        }   break;
+        case OpCode::UNREACHABLE:
+            ret = own<UnreachableSSA>();
+            break;
+        default:
+            throw_parse_error(_text, opcode_pos,
+                std::format("unsupported instruction `{}`", opcode_name));
+        }
+
+        if (!name.empty()) {
+            MTB_UNLIKELY_IF (ret->get_value_type()->is_void_type())
+                throw_parse_error(_text, begin, std::format("`%{}` names a void value", name));
+            _defineLocal(name, ret, begin);
+        }
+        return ret;
+    }
+
+    owned<Module> ModuleParser::parse()
+    {
+        /* 首行 `; module <name>` 是模块名 */
+        std::string_view module_name;
+        if (constexpr auto header = "; module "sv; _text.starts_with(header)) {
+            size_t eol = _text.find('\n');
+            module_name = _text.substr(header.size(), eol == _text.npos ? eol
+                                                      : eol - header.size());
+            if (module_name.ends_with('\r'))
+                module_name.remove_suffix(1);
+        }
+        _module = Module::Create(module_name, global_machine_word_size);
+        _ctx    = &_module->type_ctx();
+
+        _scanDefinitions();
+        for (PendingGlobal &i: _globals) {
+            _pos = i.init_pos;
+            _skipSpace();
+            if (_pos < _text.size() && _text[_pos] != ',') {
+                size_t init_pos = _pos;
+                owned<Value> init = _parseValue(i.target_type);
+                auto const_init = dynamic_cast<Constant*>(init.get());
+                MTB_UNLIKELY_IF (const_init == nullptr)
+                    throw_parse_error(_text, init_pos, "initializer should be constant"sv);
+                i.gvar->set_target(const_init);
+            }
+            i.gvar->set_align(_parseAlign());
+        }
+        for (PendingFunction &i: _functions)
+            _parseFunction(i);
+        return std::move(_module);
+    }
+} // inline namespace parser_impl
+
+owned<Module> parse_ir(std::string_view text)
+{
+    return ModuleParser{text}.parse();
+}
+
+owned<Module> parse_ir_file(std::string const &path)
+{
+    MappedFile file;
+    MTB_UNLIKELY_IF (!file.open(path)) {
+        throw ParseException {
+            0, 0, std::format("mmap(\"{}\") failed: {}", path, std::strerror(errno)),
+            CURRENT_SRCLOC_F
+        };
+    }
+    return parse_ir(file.view());
+}
+
+} // namespace MYGL::IRUtil
@@ -0,0 +1,40 @@
+#include "base/mtb-exception.hxx"
+#include "mygl-ir/irbase-use-def.hxx"
+#include "mygl-ir/utils/irutil-value-replace.hxx"
+
+namespace MYGL::IRUtil {
+
+using namespace IRBase;
+using namespace std::string_view_literals;
+
+owned<Value> usee_replace_this_with(Value *old_usee, Value *new_usee)
+{
+    MTB_UNLIKELY_IF (old_usee == nullptr) {
+        throw NullException {
+            "usee_replace_this_with(old_usee)"sv,
+            std::string{}, CURRENT_SRCLOC_F
+        };
+    }
+    MTB_UNLIKELY_IF (new_usee == nullptr) {
+        throw NullException {
+            "usee_replace_this_with(new_usee)"sv,
+            std::string{}, CURRENT_SRCLOC_F
+        };
+    }
+    /* 替换过程中 old_usee 可能失去最后一个持有者, 先保住它 */
+    owned<Value> ret = old_usee;
+    if (old_usee == new_usee)
+        return ret;
+
+    /* set_usee() 会把当前 Use 从链表里摘掉, 所以要先记住后继.
+     * 每个 Use 的摘除都是常数时间, 整个替换是 O(使用者数量). */
+    Use *use = old_usee->get_list_as_usee().front();
+    while (use != nullptr) {
+        Use *next = use->get_next_usee();
+        use->set_usee(new_usee);
+        use = next;
+    }
+    return ret;
+}
+
+} // namespace MYGL::IRUtil
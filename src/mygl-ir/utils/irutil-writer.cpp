@@ -1,4 +1,5 @@
 #include "base/mtb-object.hxx"
+#include "base/mtb-thread-pool.hxx"
 #include "mygl-ir/ir-basic-value.hxx"
 #include "mygl-ir/ir-basicblock.hxx"
 #include "mygl-ir/ir-constant.hxx"
@@ -7,18 +8,19 @@
 #include "mygl-ir/irbase-type.hxx"
 #include "mygl-ir/irbase-use-def.hxx"
 #include "mygl-ir/utils/ir-util-writer.hxx"
+#include <algorithm>
+#include <cerrno>
 #include <cstddef>
-#include <format>
+#include <fcntl.h>
 #include <string>
 #include <string_view>
+#include <unistd.h>
 
 using OpCode = MYGL::IR::Instruction::OpCode;
 using std::string_view;
 using twine = string_view;
 using std::string;
 
-#define do_write(fmt, ...) stream() << std::format(fmt __VA_OPT__(,) __VA_ARGS__)
-
 template<typename IsT, typename ObjT>
 bool is(ObjT *obj) { return dynamic_cast<IsT*>(obj) != nullptr; }
 
@@ -35,8 +37,24 @@ inline namespace writer_impl {
         "define", "declare"
     };
 
-    static string_view get_id_prefix(const Value *value) {
-        return is<Constant>(value)? "@": "%";
+    static char get_id_prefix(const Value *value) {
+        return is<Constant>(value)? '@': '%';
+    }
+
+    /** 按模块里登记的名称排序. 名称相同的定义不会出现, 所以结果是确定的. */
+    template<typename DefT>
+    static std::vector<std::pair<string_view, DefT*>>
+    sorted_definitions(auto const &def_map)
+    {
+        std::vector<std::pair<string_view, DefT*>> ret;
+        ret.reserve(def_map.size());
+        for (auto &[name, def]: def_map) {
+            if (def != nullptr)
+                ret.emplace_back(name, def.get());
+        }
+        std::sort(ret.begin(), ret.end(),
+            [](auto &l, auto &r) { return l.first < r.first; });
+        return ret;
     }
 }
 
@@ -44,81 +62,168 @@ inline namespace writer_impl {
 
 Writer::Writer(owned<Module> module, bool llvm_compatible)
     : _module(std::move(module)),
-      _indent(0), _llvm_compatible(llvm_compatible),
-      _indent_space("  ") {}
+      _indent(0), _indent_space("  "),
+      _llvm_compatible(llvm_compatible),
+      _shows_alias_target(false),
+      _nthreads(1) {}
 Writer::~Writer() = default;
 
+std::string_view Writer::render()
+{
+    if (_module == nullptr)
+        throw NullException("module");
+    _buffer.clear();
+    _indent = 0;
+    visit(get_module());
+    return _buffer.view();
+}
+
+void Writer::write(std::ostream &stream)
+{
+    render();
+    stream.write(_buffer.get_data(), std::streamsize(_buffer.get_size()));
+    /* 同步缓冲区 */
+    stream.flush();
+}
+
+bool Writer::writeTo(int fd)
+{
+    render();
+    return _buffer.writeTo(fd);
+}
+
+bool Writer::writeToFile(std::string const &path)
+{
+    render();
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+    bool ok = _buffer.writeTo(fd);
+    int saved_errno = errno;
+    ::close(fd);
+    errno = saved_errno;
+    return ok;
+}
+
 void Writer::visit(Module *module)
 {
-    do_write("; module {}\n", module->get_name());
+    _buffer << "; module " << module->get_name() << '\n';
+
+    auto gvar_list = sorted_definitions<GlobalVariable>(module->get_global_variables());
+    auto fn_list   = sorted_definitions<Function>(module->get_functions());
+    /* 没有名字的定义用模块里登记的名称引用 */
+    _def_names.clear();
+    for (auto &[name, gvar]: gvar_list) {
+        if (gvar->get_name().empty())
+            _def_names.emplace(gvar, name);
+    }
+    std::vector<Function*> fns;
+    fns.reserve(fn_list.size());
+    for (auto &[name, fn]: fn_list) {
+        if (fn->get_name().empty())
+            _def_names.emplace(fn, name);
+        fns.push_back(fn);
+    }
 
-    for (auto &i: module->global_variables())
-        i.second->accept(*this);
+    if (!gvar_list.empty())
+        _buffer << '\n';
+    for (auto &[name, gvar]: gvar_list)
+        gvar->accept(*this);
 
-    for (auto &i: module->functions())
-        i.second->accept(*this);
+    _write_functions(fns);
 }
 
 /** @brief 全局变量
  * - 语法:
- *   - `@id = external dso_local [global|constant] <type>, [align <align>]`
- *   - `@id = dso_local [global|constant] <type> <value>, [align <align>]` */
+ *   - `@id = external dso_local [global|constant] <type>, align <align>`
+ *   - `@id = dso_local [global|constant] <type> <value>, align <align>` */
 void Writer::visit(GlobalVariable *value)
 {
     static string_view global_mut_map[2] = {
         "constant", "global"
     };
-    static string_view decl_map[2] = {
-        "", "external"
-    };
 
-    string name = value->get_name_or_id();
-    twine  decl = decl_map[value->is_declaration()];
-    twine  mut_name  = global_mut_map[value->target_is_mutable()];
-    string type_name = value->get_target_type()->toString();
-    size_t align     = value->get_align();
+    _write_name('@', value);
+    _buffer << " = ";
+    if (value->is_declaration())
+        _buffer << "external ";
+    _buffer << "dso_local " << global_mut_map[value->target_is_mutable()] << ' ';
+    _write_type(value->get_target_type());
 
-    do_write("@{} = {} dso_local {} {}", name, decl, mut_name, type_name);
     Constant *const_target = value->get_target();
-    _write_operand(value);
+    if (!value->is_declaration() && const_target != nullptr) {
+        _buffer << ' ';
+        _write_operand(const_target);
+    }
+    _buffer << ", align ";
+    _buffer.appendUInt(value->get_align());
+    _buffer << '\n';
 }
 
 void Writer::visit(IntConst *value) {
     IntType *ity = static_cast<IntType*>(value->get_value_type());
-    if (ity->get_binary_bits() == 1) {
-        do_write("{}", value->is_zero() ? "false": "true");
-    } else {
-        do_write("{}", value->get_int_value());
-    }
+    if (ity->get_binary_bits() == 1)
+        _buffer << (value->is_zero() ? "false"sv: "true"sv);
+    else
+        _buffer.appendInt(value->get_int_value());
 }
 void Writer::visit(FloatConst *value) {
-    do_write("{}", value->get_value());
+    _buffer.appendDouble(value->get_value());
 }
 void Writer::visit(ZeroConst *value) {
-    (void)value;
-    do_write("0");
+    Type *type = value->get_value_type();
+    if (type->is_array_type())
+        _buffer << "zeroinitializer";
+    else
+        _buffer << '0';
 }
 void Writer::visit(UndefinedConst *value) {
     (void)value;
+    _buffer << "undef";
+}
+void Writer::visit(PoisonConst *value) {
+    (void)value;
+    _buffer << "poison";
 }
 /** @brief 数组表达式
  * - 语法: [<type> <value1>, <type> <value2>, ...]
- * (方括号不是可选，是真的方括号) */
+ * (方括号不是可选，是真的方括号)
+ * - 没有展开过的全零数组写成 `zeroinitializer`, 展开后还没赋值的空元素写成零值.
+ *   稀疏数组没有列出的元素同样写成零值.
+ *   这里只读原始元素列表, 不触发写时复制展开, 所以多个线程可以同时写同一个数组常量. */
 void Writer::visit(Array *value)
 {
+    auto &elements = value->unsafe_get_raw_element_list();
+    auto &sparse   = value->unsafe_get_sparse_list();
+    if (elements.empty() && sparse.empty()) {
+        _buffer << "zeroinitializer";
+        return;
+    }
     Type  *elem_type = value->get_element_type();
-    string elem_typename = elem_type->toString();
-
-    do_write("[");
-
-    for (size_t cnt = 1;
-         Value *i: value->element_list()) {
-        do_write("{}", elem_typename);
-        _write_operand(i);
-        if (cnt != value->get_element_list().size())
-            do_write(",");
+    size_t length    = elements.empty() ? value->get_array_type()->get_length()
+                                        : elements.size();
+    auto   next      = sparse.begin();
+    _buffer << '[';
+    for (size_t index = 0; index < length; index++) {
+        Value *i = nullptr;
+        if (!elements.empty()) {
+            i = elements[index];
+        } else if (next != sparse.end() && next->index == index) {
+            i = next->value;
+            ++next;
+        }
+        if (index != 0)
+            _buffer << ", ";
+        _write_type(elem_type);
+        _buffer << ' ';
+        if (i != nullptr)
+            _write_operand(i);
+        else if (elem_type->is_array_type())
+            _buffer << "zeroinitializer";
+        else
+            _buffer << '0';
     }
-    do_write("]");
+    _buffer << ']';
 }
 
 void Writer::visit(Function *value)
@@ -127,33 +232,38 @@ void Writer::visit(Function *value)
      * - 语法:
      *   - `declare dso_local <type> @<name>([<type1>, <type2>, ...])`
      *   - `define  dso_local <type> @<name>([<type1> %<arg1>, <type2> %<arg2>, ...]) */
-    string_view decldef = declaration_map[value->is_declaration()];
-    string fn_name = value->get_name_or_id();
-    string return_typestr = value->get_return_type()->toString();
-    do_write("{} dso_local {} @{}(",
-             decldef, return_typestr, fn_name);
-    for (size_t cnt = 1;
+    if (!value->is_declaration())
+        _number_slots(value);
+    _buffer << declaration_map[value->is_declaration()] << " dso_local ";
+    _write_type(value->get_return_type());
+    _buffer << ' ';
+    _write_name('@', value);
+    _buffer << '(';
+    for (size_t cnt = 0;
          auto &pi : value->get_argument_list()) {
         Argument *i = pi.argument;
-        do_write("{}", i->get_value_type()->toString());
-        if (!value->is_declaration())
-            do_write("%{}", i->get_name_or_id());
-        if (cnt != value->get_argument_list().size())
-            do_write(", ");
-        cnt++;
+        if (cnt++ != 0)
+            _buffer << ", ";
+        _write_type(i->get_value_type());
+        if (!value->is_declaration()) {
+            _buffer << ' ';
+            _write_name('%', i);
+        }
     }
-    do_write(")");
+    _buffer << ')';
 
     /* 函数体 */
-    if (value->is_declaration()) return;
-    do_write("{}", " {\n");
+    if (value->is_declaration()) {
+        _buffer << '\n';
+        return;
+    }
+    _buffer << " {\n";
 
     /* 函数体的入口基本块, 要排在第一个写入 */
     BasicBlock *entry = value->get_entry();
-    do_write("{}:", entry->get_name_or_id());
+    _write_name('\0', entry);
+    _buffer << ':';
     entry->accept(*this);
-    if (entry != value->body().back())
-        stream() << "\n\n";
 
     for (BasicBlock *i: value->body()) {
         /* 跳过入口基本块 */
@@ -161,12 +271,12 @@ void Writer::visit(Function *value)
             continue;
 
         /** 写入BasicBlock的ID */
-        do_write("{}:", i->get_name_or_id());
+        _buffer << "\n\n";
+        _write_name('\0', i);
+        _buffer << ':';
         i->accept(*this);
-        if (i != value->body().back())
-            stream() << "\n\n";
     }
-    do_write("\n}}\n");
+    _buffer << "\n}\n";
 }
 void Writer::visit(BasicBlock *value)
 {
@@ -178,198 +288,337 @@ void Writer::visit(BasicBlock *value)
     dec_indent();
 }
 void Writer::visit(Argument *value) {
-    do_write("{}", value->get_name_or_id());
+    _write_name('%', value);
 }
 /* 以下均为指令结点的visit方法。语法见指令结点自己的注释。 */
 void Writer::visit(PhiSSA *value)
 {
-    string type_string = value->get_value_type()->toString();
-    do_write("%{} = phi {} ", value->get_name_or_id(), type_string);
+    _write_name('%', value);
+    _buffer << " = phi ";
+    _write_type(value->get_value_type());
+    _buffer << ' ';
 
     /* 被Phi引用的值列表 */
-    for (size_t cnt = 1;
+    for (size_t cnt = 0;
          auto &i : value->get_operands()) {
-        do_write("[ ");
+        if (cnt++ != 0)
+            _buffer << ", ";
+        _buffer << "[ ";
         _write_operand(i.second.value);
-        if (_llvm_compatible)
-            do_write(", %{} ]", i.first->get_name_or_id());
-        else
-            do_write(", label %{} ]", i.first->get_name_or_id());
-        if (cnt != value->get_operands().size())
-            do_write(", ");
-        cnt++;
+        _buffer << (_llvm_compatible ? ", "sv: ", label "sv);
+        _write_name('%', i.first);
+        _buffer << " ]";
     }
 }
 void Writer::visit(LoadSSA *value)
 {
-    Value *operand = value->get_operand();
-    /* LoadSSA本身的类型 */
-    string type_string    = value
-                          ->get_value_type()
-                          ->toString();
-    /* 操作数的类型 */
-    string ptr_typestring = operand
-                          ->get_value_type()
-                          ->toString();
-
-    do_write("%{} = load {}, {} {}{}, align {}",
-             value->get_name_or_id(), type_string, ptr_typestring,
-             get_id_prefix(operand),
-             operand->get_name_or_id(),
-             value->get_align());
+    _write_name('%', value);
+    _buffer << " = load ";
+    _write_type(value->get_value_type());
+    _buffer << ", ";
+    _write_typed_operand(value->get_operand());
+    _buffer << ", align ";
+    _buffer.appendUInt(value->get_align());
 }
 void Writer::visit(CastSSA *value)
 {
-    Value *operand = value->get_operand();
-    string_view opcode = value->get_opcode().getString();
-    string src_type = operand->get_value_type()->toString();
-    string dst_type = value->get_value_type()->toString();
-    do_write("%{} = {} {} ",
-             value->get_name_or_id(), opcode, src_type);
-    _write_operand(operand);
-    do_write("to {}", dst_type);
+    _write_name('%', value);
+    _buffer << " = " << value->get_opcode().getString() << ' ';
+    _write_typed_operand(value->get_operand());
+    _buffer << " to ";
+    _write_type(value->get_value_type());
 }
 void Writer::visit(UnaryOperationSSA *value)
 {
-    Value *operand = value->get_operand();
-    string_view opcode = value->get_opcode().getString();
-    string type = operand->get_value_type()->toString();
-    do_write("%{} = {} {} ", value->get_name_or_id(), opcode, type);
-    _write_operand(operand);
+    _write_name('%', value);
+    _buffer << " = " << value->get_opcode().getString() << ' ';
+    _write_typed_operand(value->get_operand());
 }
 void Writer::visit(AllocaSSA *value)
 {
-    do_write("%{} = alloca {}, align {}",
-             value->get_name_or_id(),
-             value->get_element_type()->toString(),
-             value->get_align());
+    _write_name('%', value);
+    _buffer << " = alloca ";
+    _write_type(value->get_element_type());
+    _buffer << ", align ";
+    _buffer.appendUInt(value->get_align());
 }
 void Writer::visit(BinarySSA *value)
 {
-    Value *lhs = value->get_lhs();
-    Value *rhs = value->get_rhs();
-    string_view opcode = value->get_opcode().getString();
-    string type = value->get_value_type()->toString();
-    string sign_flag(BinarySSA::SignFlagGetString(
-                     value->get_sign_flag()));
-    if (!sign_flag.empty())
-        sign_flag.append(" ");
-
-    do_write("%{} = {} {}{} ",
-             value->get_name_or_id(), opcode, sign_flag, type);
+    string_view sign_flag = BinarySSA::SignFlagGetString(value->get_sign_flag());
 
-    _write_operand(lhs);
-    do_write(", ");
-    _write_operand(rhs);
+    _write_name('%', value);
+    _buffer << " = " << value->get_opcode().getString() << ' ';
+    if (!sign_flag.empty())
+        _buffer << sign_flag << ' ';
+    _write_typed_operand(value->get_lhs());
+    _buffer << ", ";
+    _write_operand(value->get_rhs());
 }
 void Writer::visit(UnreachableSSA *value)
 {
-    do_write("unreachable");
+    (void)value;
+    _buffer << "unreachable";
 }
 void Writer::visit(JumpSSA *value)
 {
-    BasicBlock *target = value->get_target();
-    do_write("br label %{}", target->get_name_or_id());
+    _buffer << "br label ";
+    _write_name('%', value->get_target());
 }
 void Writer::visit(BranchSSA *value)
 {
-    BasicBlock *true_target  = value->get_if_true();
-    BasicBlock *false_target = value->get_if_false();
-    Value      *condition    = value->get_condition();
-    do_write("br i1 ");
-    _write_operand(condition);
-    do_write(", label %{}, label %{}",
-             true_target->get_name_or_id(),
-             false_target->get_name_or_id());
+    _buffer << "br i1 ";
+    _write_operand(value->get_condition());
+    _buffer << ", label ";
+    _write_name('%', value->get_if_true());
+    _buffer << ", label ";
+    _write_name('%', value->get_if_false());
 }
 void Writer::visit(SwitchSSA *value)
 {
-    Value *condition      = value->get_condition();
-    string condition_type = condition->get_value_type()->toString();
-    do_write("switch {} ", condition_type);
-    _write_operand(condition);
-
-    do_write(", label %{} [", value->get_default_target()->get_name_or_id());
+    _buffer << "switch ";
+    _write_typed_operand(value->get_condition());
+    _buffer << ", label ";
+    _write_name('%', value->get_default_target());
+    _buffer << " [";
     add_indent();
     /* case列表。switch指令应该是唯一一个边写边换行的指令. */
     for (auto &i : value->get_cases()) {
         wrap_indent();
-        do_write("i64 {}, label %{}", i.first, i.second.target->get_name_or_id());
+        _buffer << "i64 ";
+        _buffer.appendInt(i.first);
+        _buffer << ", label ";
+        _write_name('%', i.second.target);
     }
     dec_indent();
-    do_write("]");
+    wrap_indent();
+    _buffer << ']';
+}
+void Writer::visit(BinarySelectSSA *value)
+{
+    _write_name('%', value);
+    _buffer << " = select i1 ";
+    _write_operand(value->get_condition());
+    _buffer << ", ";
+    _write_typed_operand(value->get_if_true());
+    _buffer << ", ";
+    _write_typed_operand(value->get_if_false());
 }
 void Writer::visit(CallSSA *value)
 {
-    Function *fn = value->get_callee();
-    string name = value->get_name_or_id();
-    string ret_type = value->get_value_type()->toString();
-    do_write("%{} = call {} @{}(",
-             name, ret_type, fn->get_name_or_id());
+    Type *ret_type = value->get_value_type();
+    /* 返回 void 的调用没有结果, 不写 `%id = ` */
+    if (!ret_type->is_void_type()) {
+        _write_name('%', value);
+        _buffer << " = ";
+    }
+    _buffer << "call ";
+    _write_type(ret_type);
+    _buffer << ' ';
+    _write_name('@', value->get_callee());
+    _buffer << '(';
 
-    for (size_t cnt = 1;
+    for (size_t cnt = 0;
          auto &[i, t, u]: value->get_arguments()) {
-        do_write("{} noundef ", i->get_value_type()->toString());
+        if (cnt++ != 0)
+            _buffer << ", ";
+        _write_type(i->get_value_type());
+        _buffer << " noundef ";
         _write_operand(i);
-        if (cnt != value->get_arguments().size())
-            do_write(", ");
-        cnt++;
     }
-    do_write(")");
+    _buffer << ')';
 }
 void Writer::visit(ReturnSSA *value)
 {
-    do_write("ret {} ", value->get_return_type()->toString());
-    // 由于Undefined不打印，所以不用特殊处理"ret void"的情况
+    Type *ret_type = value->get_return_type();
+    if (ret_type->is_void_type()) {
+        _buffer << "ret void";
+        return;
+    }
+    _buffer << "ret ";
+    _write_type(ret_type);
+    _buffer << ' ';
     _write_operand(value->get_result());
 }
 void Writer::visit(GetElemPtrSSA *value)
 {
-    Value *collection = value->get_collection();
-    string name  = value->get_name_or_id();
-    string collection_type = value->get_collection_type()->toString();
-    string value_type   = value->get_value_type()->toString();
-    string operand_type = collection->get_value_type()->toString();
-
-    do_write("%{} = getelementptr inbounds {}, {} ",
-             name, value_type, operand_type);
-    _write_operand(collection);
-    for (size_t cnt = 0;
-         Value *i: value->get_indexes()) {
-        do_write(", {} ", i->get_value_type()->toString());
-        _write_operand(i);
+    _write_name('%', value);
+    _buffer << " = getelementptr inbounds ";
+    _write_type(value->get_value_type());
+    _buffer << ", ";
+    _write_typed_operand(value->get_collection());
+    for (Value *i: value->get_indexes()) {
+        _buffer << ", ";
+        _write_typed_operand(i);
     }
 }
+void Writer::visit(ExtractElemSSA *value)
+{
+    _write_name('%', value);
+    _buffer << " = extractelement ";
+    _write_type(value->get_value_type());
+    _buffer << ", ";
+    _write_typed_operand(value->get_array());
+    _buffer << ", ";
+    _write_typed_operand(value->get_index());
+}
+void Writer::visit(InsertElemSSA *value)
+{
+    _write_name('%', value);
+    _buffer << " = insertelement ";
+    _write_typed_operand(value->get_array());
+    _buffer << ", ";
+    _write_typed_operand(value->get_element());
+    _buffer << ", ";
+    _write_typed_operand(value->get_index());
+}
 void Writer::visit(StoreSSA *value)
 {
-    Value *source = value->get_source();
-    Value *target = value->get_target();
-    Type *src_type = source->get_value_type();
-    Type *dst_type = target->get_value_type();
-    do_write("store {} ", src_type->toString());
-    _write_operand(source);
-    do_write(", {} ", dst_type->toString());
-    _write_operand(target);
-    do_write(", align {}", value->get_align());
+    _buffer << "store ";
+    _write_typed_operand(value->get_source());
+    _buffer << ", ";
+    _write_typed_operand(value->get_target());
+    _buffer << ", align ";
+    _buffer.appendUInt(value->get_align());
 }
 void Writer::visit(CompareSSA *value)
 {
-    Value *lhs = value->get_lhs();
-    Value *rhs = value->get_rhs();
-    /** TODO: 重写该方法. */
+    CompareSSA::Condition::u8string8_t cond = value->get_condition().getString();
+
+    _write_name('%', value);
+    _buffer << " = " << value->get_opcode().getString() << ' '
+            << string_view(cond.data()) << ' ';
+    _write_typed_operand(value->get_lhs());
+    _buffer << ", ";
+    _write_operand(value->get_rhs());
 }
-void Writer::visit(MoveInst *value) {
-    /** TODO: 重写该方法. */
+void Writer::visit(MoveInst *value)
+{
+    _buffer << "move ";
+    _write_type(value->get_value_type());
+    _buffer << ' ';
+    _write_name('%', value);
+    _buffer << "(r";
+    _buffer.appendInt(value->get_mutable()->get_index());
+    _buffer << "), ";
+    _write_operand(value->get_operand());
 }
 /** private class Writer */
 void Writer::_write_operand(Value *operand)
 {
     if (operand->uniquely_referenced())
-        stream() << std::format("{}{}", get_id_prefix(operand), operand->get_name_or_id());
+        _write_name(get_id_prefix(operand), operand);
     else
         operand->accept(*this);
 }
+void Writer::_write_typed_operand(Value *operand)
+{
+    _write_type(operand->get_value_type());
+    _buffer << ' ';
+    _write_operand(operand);
+}
+void Writer::_write_name(char prefix, Value *value)
+{
+    if (prefix != '\0')
+        _buffer << prefix;
+    string_view name = value->get_name();
+    if (!name.empty()) {
+        _buffer << name;
+        return;
+    }
+    if (auto it = _slots.find(value); it != _slots.end())
+        _buffer.appendUInt(it->second);
+    else if (auto it = _def_names.find(value); it != _def_names.end())
+        _buffer << it->second;
+    else
+        _buffer.appendUInt(value->get_id());
+}
+void Writer::_number_slots(Function *fn)
+{
+    /* 和 LLVM 一样按出现顺序给没有名字的参数、基本块、有值的指令编号.
+     * 入口基本块先写, 所以也先编号. */
+    _slots.clear();
+    uint32_t next = 0;
+    auto number = [this, &next](Value *value) {
+        if (value->get_name().empty())
+            _slots.emplace(value, next++);
+    };
+    for (auto &pi: fn->get_argument_list())
+        number(pi.argument);
+    auto number_block = [this, &number](BasicBlock *block) {
+        number(block);
+        for (Instruction *i: block->instruction_list()) {
+            if (!i->get_value_type()->is_void_type())
+                number(i);
+        }
+    };
+    BasicBlock *entry = fn->get_entry();
+    number_block(entry);
+    for (BasicBlock *i: fn->body()) {
+        if (i != entry)
+            number_block(i);
+    }
+}
+void Writer::_write_type(Type *type)
+{
+    auto it = _type_names.find(type);
+    if (it == _type_names.end())
+        it = _type_names.emplace(type, type->toString()).first;
+    _buffer << it->second;
+}
+void Writer::_write_functions(std::vector<Function*> const &fn_list)
+{
+    size_t nthreads = _nthreads == 0 ? MTB::ThreadPool::DefaultConcurrency()
+                                     : _nthreads;
+    nthreads = std::min(nthreads, fn_list.size());
+#if __MTB_OBJECT_ATOMIC_REFCOUNT__ == 0
+    nthreads = 1;
+#endif
+    if (nthreads <= 1) {
+        for (Function *fn: fn_list) {
+            _buffer << '\n';
+            fn->accept(*this);
+        }
+        return;
+    }
+
+    /* 把函数列表切成连续的若干段, 每段由一个子 Writer 生成, 最后按段的顺序拼接.
+     * 段数比线程数多几倍, 让大小不均的函数也能分摊到各个线程上.
+     * 子 Writer 在调用线程上创建和销毁, 工作线程只读 IR, 不改引用计数. */
+    size_t nchunks    = std::min(fn_list.size(), nthreads * 4);
+    size_t chunk_size = (fn_list.size() + nchunks - 1) / nchunks;
+    std::vector<owned<Writer>> chunk_writers;
+    chunk_writers.reserve(nchunks);
+    for (size_t begin = 0; begin < fn_list.size(); begin += chunk_size) {
+        owned<Writer> sub{new Writer(_module, _llvm_compatible)};
+        sub->_indent_space       = _indent_space;
+        sub->_shows_alias_target = _shows_alias_target;
+        sub->_nthreads           = 1;
+        sub->_def_names          = _def_names;
+        chunk_writers.push_back(std::move(sub));
+    }
+
+    MTB::ThreadPool pool{nthreads};
+    for (size_t i = 0; i < chunk_writers.size(); i++) {
+        Writer *sub   = chunk_writers[i];
+        size_t  begin = i * chunk_size;
+        size_t  end   = std::min(begin + chunk_size, fn_list.size());
+        pool.submit([sub, &fn_list, begin, end]() {
+            for (size_t j = begin; j < end; j++) {
+                sub->_buffer << '\n';
+                fn_list[j]->accept(*sub);
+            }
+        });
+    }
+    pool.wait();
+
+    size_t total = _buffer.get_size();
+    for (owned<Writer> &sub: chunk_writers)
+        total += sub->_buffer.get_size();
+    _buffer.reserve(total);
+    for (owned<Writer> &sub: chunk_writers)
+        _buffer.appendBuffer(sub->_buffer);
+}
 
 /** end class Writer */
 
-} // namespace MYGL::IRUtil
\ No newline at end of file
+} // namespace MYGL::IRUtil
@@ -0,0 +1,349 @@
+/** @file ast-lexer.cpp MYGL-C的词法分析器 */
+
+#include "myglc-lang/ast-code-context.hxx"
+#include "myglc-lang/ast-lexer.hxx"
+#include "myglc-lang/ast-parser.tab.hxx"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string_view>
+
+namespace MYGL::Ast {
+
+inline namespace lexer_impl {
+    using namespace std::string_view_literals;
+    using TokenKind = parser::token::token_kind_type;
+    using tok = parser::token;
+
+    enum CharClass: uint8_t {
+        CH_SPACE   = 0b00001, // 空白
+        CH_IDSTART = 0b00010, // [_A-Za-z]
+        CH_DIGIT   = 0b00100, // [0-9]
+        CH_XDIGIT  = 0b01000, // [0-9A-Fa-f]
+        CH_ODIGIT  = 0b10000, // [0-7]
+        CH_IDCHAR  = CH_IDSTART | CH_DIGIT,
+    }; // enum CharClass
+
+    static constexpr std::array<uint8_t, 256> char_class_map = []() {
+        std::array<uint8_t, 256> ret{};
+        for (unsigned char c: " \t\r\n"sv)
+            ret[c] |= CH_SPACE;
+        ret['_'] |= CH_IDSTART;
+        for (int c = 'a'; c <= 'z'; c++)
+            ret[c] |= CH_IDSTART;
+        for (int c = 'A'; c <= 'Z'; c++)
+            ret[c] |= CH_IDSTART;
+        for (int c = '0'; c <= '9'; c++)
+            ret[c] |= CH_DIGIT | CH_XDIGIT;
+        for (int c = '0'; c <= '7'; c++)
+            ret[c] |= CH_ODIGIT;
+        for (int c = 0; c < 6; c++)
+            ret['a' + c] |= CH_XDIGIT, ret['A' + c] |= CH_XDIGIT;
+        return ret;
+    }();
+
+    static inline bool is_class(char c, uint8_t cls) {
+        return (char_class_map[uint8_t(c)] & cls) != 0;
+    }
+    /** 越界时返回 '\0'. '\0' 不属于任何字符类, 所以扫描循环不用单独判断边界. */
+    static inline char peek(char const *p, char const *end) {
+        return p < end ? *p : '\0';
+    }
+    static inline char const *skip_class(char const *p, char const *end, uint8_t cls) {
+        while (p < end && is_class(*p, cls))
+            p++;
+        return p;
+    }
+
+    static TokenKind keyword_or_ident(std::string_view word)
+    {
+        switch (word.size()) {
+        case 2:
+            if (word == "if"sv)       return tok::T_IF;
+            break;
+        case 3:
+            if (word == "int"sv)      return tok::T_INT;
+            if (word == "for"sv)      return tok::T_FOR;
+            break;
+        case 4:
+            if (word == "void"sv)     return tok::T_VOID;
+            if (word == "else"sv)     return tok::T_ELSE;
+            if (word == "case"sv)     return tok::T_CASE;
+            break;
+        case 5:
+            if (word == "float"sv)    return tok::T_FLOAT;
+            if (word == "const"sv)    return tok::T_CONST;
+            if (word == "while"sv)    return tok::T_WHILE;
+            if (word == "break"sv)    return tok::T_BREAK;
+            break;
+        case 6:
+            if (word == "sizeof"sv)   return tok::T_OP_SIZEOF;
+            if (word == "switch"sv)   return tok::T_SWITCH;
+            if (word == "return"sv)   return tok::T_RETURN;
+            if (word == "extern"sv)   return tok::T_EXTERN;
+            break;
+        case 8:
+            if (word == "continue"sv) return tok::T_CONTINUE;
+            break;
+        }
+        return tok::T_IDENT;
+    }
+
+    /** 指数部分 `[<e>][+-]?<digits>+`. 不完整时不算指数, 返回 p. */
+    static char const *scan_exponent(char const *p, char const *end,
+                                     char e_lower, uint8_t digit_class)
+    {
+        if ((peek(p, end) | 0x20) != e_lower)
+            return p;
+        char const *q = p + 1;
+        if (peek(q, end) == '+' || peek(q, end) == '-')
+            q++;
+        char const *r = skip_class(q, end, digit_class);
+        return r == q ? p : r;
+    }
+
+    /** @fn scan_number(p, end, kind)
+     * @brief 整数与浮点数, 规则和原来的 flex 词法一致, 取最长匹配:
+     * - 十进制浮点: `1.5`, `1.5e3`, `.5`, `.5e3`, `1e3`. `1.` 不是浮点数.
+     * - 十六进制浮点: `0x1.8`, `0x1.8p3`, `0x.8`, `0x.8p3`, `0x1p3`.
+     * - 整数: `0x1F`, `017`, `123`. */
+    static char const *scan_number(char const *p, char const *end, TokenKind &kind)
+    {
+        kind = tok::T_FLOAT_CONST;
+        if (p[0] == '0' && peek(p + 1, end) == 'x') {
+            char const *int_end = skip_class(p + 2, end, CH_XDIGIT);
+            if (peek(int_end, end) == '.' && is_class(peek(int_end + 1, end), CH_XDIGIT)) {
+                char const *frac_end = skip_class(int_end + 1, end, CH_XDIGIT);
+                return scan_exponent(frac_end, end, 'p', CH_XDIGIT);
+            }
+            if (int_end != p + 2) {
+                char const *exp_end = scan_exponent(int_end, end, 'p', CH_XDIGIT);
+                if (exp_end == int_end)
+                    kind = tok::T_INT_CONST;
+                return exp_end;
+            }
+            /* `0x` 后面没有十六进制数字, 只有 `0` 是整数 */
+        }
+        char const *int_end = skip_class(p, end, CH_DIGIT);
+        if (peek(int_end, end) == '.' && is_class(peek(int_end + 1, end), CH_DIGIT)) {
+            char const *frac_end = skip_class(int_end + 1, end, CH_DIGIT);
+            return scan_exponent(frac_end, end, 'e', CH_DIGIT);
+        }
+        char const *exp_end = scan_exponent(int_end, end, 'e', CH_DIGIT);
+        if (exp_end != int_end)
+            return exp_end;
+        kind = tok::T_INT_CONST;
+        /* 八进制只取合法的前缀, `089` 会被切成 `0` 和 `89` */
+        if (p[0] == '0')
+            return skip_class(p + 1, end, CH_ODIGIT);
+        return int_end;
+    }
+
+    /** @fn skip_trivia(p, end)
+     * @brief 跳过空白与注释. 块注释没有结束时返回 nullptr. */
+    static char const *skip_trivia(char const *p, char const *end)
+    {
+        while (p < end) {
+            if (is_class(*p, CH_SPACE)) {
+                p++;
+                continue;
+            }
+            if (*p != '/')
+                break;
+            char next = peek(p + 1, end);
+            if (next == '/') {
+                auto eol = static_cast<char const*>(std::memchr(p, '\n', end - p));
+                p = eol == nullptr ? end : eol + 1;
+            } else if (next == '*') {
+                std::string_view rest{p + 2, size_t(end - p - 2)};
+                size_t close = rest.find("*/"sv);
+                if (close == rest.npos)
+                    return nullptr;
+                p = rest.data() + close + 2;
+            } else {
+                break;
+            }
+        }
+        return p;
+    }
+
+    /** @fn scan_token(p, end)
+     * @brief 从非空白字符 *p 开始读一个词法单元, 把 p 移到词法单元后面. */
+    static TokenKind scan_token(char const *&p, char const *end)
+    {
+        char c = *p;
+        if (is_class(c, CH_IDSTART)) {
+            char const *word_end = skip_class(p + 1, end, CH_IDCHAR);
+            std::string_view word{p, size_t(word_end - p)};
+            p = word_end;
+            return keyword_or_ident(word);
+        }
+        if (is_class(c, CH_DIGIT) ||
+            (c == '.' && is_class(peek(p + 1, end), CH_DIGIT))) {
+            TokenKind kind;
+            p = scan_number(p, end, kind);
+            return kind;
+        }
+
+        char next = peek(p + 1, end);
+        auto two = [&p](TokenKind kind) { p += 2; return kind; };
+        auto one = [&p](TokenKind kind) { p += 1; return kind; };
+        switch (c) {
+        case '(': return one(tok::T_OP_LQUOTE);
+        case ')': return one(tok::T_OP_RQUOTE);
+        case '[': return one(tok::T_OP_LBRACKET);
+        case ']': return one(tok::T_OP_RBRACKET);
+        case '{': return one(tok::T_OP_LBRACE);
+        case '}': return one(tok::T_OP_RBRACE);
+        case '+': return one(tok::T_OP_PLUS);
+        case '*': return one(tok::T_OP_STAR);
+        case '/': return one(tok::T_OP_SLASH);
+        case '%': return one(tok::T_OP_PERCENT);
+        case ';': return one(tok::T_SEMICOLON);
+        case ':': return one(tok::T_COLON);
+        case '?': return one(tok::T_QUESTION);
+        case ',': return one(tok::T_COMMA);
+        case '.': return one(tok::T_OP_DOT);
+        case '=':
+            if (next == '=') return two(tok::T_OP_EQ);
+            if (next == '>') return two(tok::T_OP_DARROW);
+            return one(tok::T_OP_ASSIGN);
+        case '!': return next == '=' ? two(tok::T_OP_NE) : one(tok::T_REL_NOT);
+        case '>': return next == '=' ? two(tok::T_OP_GE) : one(tok::T_OP_GT);
+        case '<': return next == '=' ? two(tok::T_OP_LE) : one(tok::T_OP_LT);
+        case '&': return next == '&' ? two(tok::T_REL_AND) : one(tok::T_OP_AND);
+        case '|': return next == '|' ? two(tok::T_REL_OR)  : one(tok::T_OP_OR);
+        case '-': return next == '>' ? two(tok::T_OP_SARROW) : one(tok::T_OP_SUB);
+        case '"': {
+            /* 字符串里的 `\"` 不结束字符串 */
+            char const *q = p + 1;
+            while (q < end && *q != '"')
+                q += (*q == '\\' && peek(q + 1, end) == '"') ? 2 : 1;
+            if (q >= end)
+                return one(tok::YYerror);
+            p = q + 1;
+            return tok::T_STRING_LITERAL;
+        }
+        default:
+            return one(tok::YYerror);
+        }
+    }
+} // inline namespace lexer_impl
+
+/** @class LineTable */
+
+void LineTable::_build()
+{
+    _line_starts.clear();
+    _line_starts.push_back(0);
+    char const *begin = _source.data();
+    char const *end   = begin + _source.size();
+    for (char const *p = begin; p < end; ) {
+        auto eol = static_cast<char const*>(std::memchr(p, '\n', end - p));
+        if (eol == nullptr)
+            break;
+        p = eol + 1;
+        _line_starts.push_back(uint32_t(p - begin));
+    }
+    _hint = 0;
+}
+
+void LineTable::locate(size_t offset, int &line, int &col)
+{
+    if (_line_starts.empty())
+        _build();
+    size_t nlines = _line_starts.size();
+    auto in_line = [this, nlines, offset](size_t index) {
+        return index < nlines && _line_starts[index] <= offset &&
+               (index + 1 == nlines || offset < _line_starts[index + 1]);
+    };
+    /* 语法分析器按顺序取词法单元, 大多数查询落在上一次的行或者下一行 */
+    size_t index = _hint;
+    if (!in_line(index)) {
+        if (in_line(index + 1)) {
+            index++;
+        } else {
+            auto it = std::upper_bound(_line_starts.begin(), _line_starts.end(), offset);
+            index = size_t(it - _line_starts.begin()) - 1;
+        }
+        _hint = index;
+    }
+    line = int(index + 1);
+    col  = int(offset - _line_starts[index]);
+}
+
+/** end class LineTable */
+
+/** @class Lexer */
+
+Lexer::Token::Token(Lexer::UnownedPtrT lexer, TypeId type)
+    : lexer(lexer),
+      offset(lexer->_current.offset),
+      length(lexer->_current.length),
+      type(type) {}
+
+Lexer::Lexer(std::string filename, std::string_view src_buffer)
+    : filename(std::move(filename)),
+      src_buffer(src_buffer),
+      _lines(src_buffer) {}
+
+Lexer::RawTokenListT const &Lexer::tokenize()
+{
+    if (_tokenized)
+        return _tokens;
+    _tokenized = true;
+    _lines.reset(src_buffer);
+
+    char const *begin = src_buffer.data();
+    char const *end   = begin + src_buffer.size();
+    /* 源码里的 '\0' 和文件结束一样 */
+    if (auto nul = static_cast<char const*>(std::memchr(begin, '\0', src_buffer.size())))
+        end = nul;
+
+    _tokens.clear();
+    /* 只按 1/16 预留一个起始容量, 不够再让 vector 自己增长. 注释和空白多的源码
+     * 词法单元很稀疏, 按上限预留会白占很多内存. */
+    _tokens.reserve(src_buffer.size() / 16 + 1);
+    for (char const *p = begin; ; ) {
+        char const *start = skip_trivia(p, end);
+        if (start == nullptr) {
+            /* 块注释没有结束: 报一个错误词法单元, 剩下的源码都不要了 */
+            _tokens.push_back({tok::YYerror, uint32_t(p - begin), uint32_t(end - p)});
+            p = end;
+            start = end;
+        }
+        if (start >= end) {
+            _tokens.push_back({tok::YYEOF, uint32_t(end - begin), 0});
+            break;
+        }
+        p = start;
+        TokenKind kind = scan_token(p, end);
+        _tokens.push_back({uint32_t(kind), uint32_t(start - begin), uint32_t(p - start)});
+    }
+    _next = 0;
+    return _tokens;
+}
+
+SourceLocation Lexer::locate(size_t offset)
+{
+    int line = 1, col = 0;
+    _lines.locate(offset, line, col);
+    return {&src_buffer, offset, line, col};
+}
+
+int Lexer::yylex()
+{
+    if (!_tokenized)
+        tokenize();
+    RawToken const &token = _tokens[_next];
+    /* 停在最后的 YYEOF 上 */
+    if (_next + 1 < _tokens.size())
+        _next++;
+    _current = token;
+    cur_type = token.kind;
+    return int(token.kind);
+}
+
+/** end class Lexer */
+
+} // namespace MYGL::Ast
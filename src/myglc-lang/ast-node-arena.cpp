@@ -0,0 +1,76 @@
+#include "myglc-lang/ast-node-arena.hxx"
+#include "myglc-lang/ast-node.hxx"
+
+
+namespace MYGL::Ast {
+/* @class NodeArena::Region */
+    NodeArena::Region::Region(size_t chunk_size)
+        : _arena(new MTB::BumpArena(chunk_size)) {}
+
+    NodeArena::Region &NodeArena::Region::operator=(Region &&that) noexcept
+    {
+        if (this == &that)
+            return *this;
+        clear();
+        _arena = that._arena;
+        _nodes = std::move(that._nodes);
+        that._arena = nullptr;
+        return *this;
+    }
+
+    void NodeArena::Region::clear()
+    {
+        for (auto i = _nodes.rbegin(); i != _nodes.rend(); ++i) {
+            Node *node = *i;
+            node->~Node();
+            _arena->deallocate(node);
+        }
+        _nodes.clear();
+        if (_arena != nullptr)
+            _arena->release();
+        _arena = nullptr;
+    }
+/* end class NodeArena::Region */
+
+/* @class NodeArena */
+    /* 一个源文件通常有成千上万个结点, 块开大一些可以少申请几次内存 */
+    NodeArena::NodeArena()
+        : _root(64 * 1024) {}
+
+    NodeArena::~NodeArena()
+    {
+        /* 内层区域里的结点创建得晚, 先析构 */
+        while (!_regions.empty())
+            _regions.pop_back();
+    }
+
+    void NodeArena::push_region()
+    {
+        /* 区域一般装一个函数体, 块开小一些, 免得小函数也占 64K */
+        _regions.emplace_back(16 * 1024);
+    }
+    NodeArena::Region NodeArena::pop_region()
+    {
+        if (_regions.empty())
+            return Region{};
+        Region ret = std::move(_regions.back());
+        _regions.pop_back();
+        return ret;
+    }
+
+    size_t NodeArena::get_nnodes() const
+    {
+        size_t ret = _root.get_nodes().size();
+        for (Region const &i: _regions)
+            ret += i.get_nodes().size();
+        return ret;
+    }
+    size_t NodeArena::get_allocated_bytes() const
+    {
+        size_t ret = _root.get_allocated_bytes();
+        for (Region const &i: _regions)
+            ret += i.get_allocated_bytes();
+        return ret;
+    }
+/* end class NodeArena */
+} // namespace MYGL::Ast
@@ -10,7 +10,7 @@
 namespace MYGL::Ast {
 /* public class CompUnit */
     // variable
-    CompUnit::PtrT CompUnit::OwnedPredefined = std::make_unique<CompUnit>(SourceRange{});
+    std::unique_ptr<CompUnit> CompUnit::OwnedPredefined = std::make_unique<CompUnit>(SourceRange{});
     CompUnit &CompUnit::Predefined = *OwnedPredefined;
 
     // constructor
@@ -18,6 +18,7 @@ namespace MYGL::Ast {
         : Node(range, NodeType::COMP_UNIT, &CompUnit::Predefined),
           _scope_self(std::make_unique<Scope>(nullptr, nullptr)) {
         owner_instance = this;
+        _scope_self->set_symbol_table(&_symbol_table);
     }
 
     // method
@@ -38,9 +39,14 @@ namespace MYGL::Ast {
     }
     bool CompUnit::register_this(Scope *owner_scope)
     {
+        if (_stream_settled)
+            return true;
         if (owner_scope == nullptr)
             owner_scope = CompUnit::Predefined.scope_self();
         _scope = owner_scope;
+        /* 全局作用域(比如预先解析好的运行时函数声明)里的名字在本单元里都可见 */
+        _scope_self->set_parent(owner_scope);
+        ScopedSymbolTable::Frame frame{_scope_self.get()};
         for (auto &i: _decls) {
             std::clog << std::format("got decl type {}", uint64_t(i->node_type())) << std::endl;
             i->register_this(_scope_self.get());
@@ -56,7 +62,7 @@ namespace MYGL::Ast {
     }
     bool CompUnit::append(Function::PtrT &&fndef)
     {
-        if (_scope_self->add(fndef.get()) == false)
+        if (_scope_self->add(fndef) == false)
             return false;
         fndef->set_parent(this);
         fndef->set_scope(_scope_self.get());
@@ -71,7 +77,7 @@ namespace MYGL::Ast {
     }
     bool CompUnit::prepend(Function::PtrT &&fndef)
     {
-        if (_scope_self->add(fndef.get()) == false)
+        if (_scope_self->add(fndef) == false)
             return false;
         fndef->set_parent(this);
         fndef->set_scope(_scope_self.get());
@@ -80,6 +86,36 @@ namespace MYGL::Ast {
         return true;
     }
 
+    void CompUnit::open_streaming(Scope *owner_scope)
+    {
+        if (owner_scope == nullptr)
+            owner_scope = CompUnit::Predefined.scope_self();
+        _scope = owner_scope;
+        _scope_self->set_parent(owner_scope);
+        /* 全局作用域在整个分析期间都压在符号表里, 函数和块的作用域压在它上面 */
+        _symbol_table.push_scope(_scope_self.get());
+        _streaming = true;
+    }
+    bool CompUnit::stream_append(Declaration::PtrT decl)
+    {
+        append(Declaration::PtrT{decl});
+        return decl->register_this(_scope_self.get());
+    }
+    bool CompUnit::stream_append(Function::PtrT func)
+    {
+        if (!append(Function::PtrT{func}))
+            return false;
+        return func->register_this(_scope_self.get());
+    }
+    void CompUnit::close_streaming()
+    {
+        if (!_streaming)
+            return;
+        _symbol_table.pop_scope();
+        _streaming      = false;
+        _stream_settled = true;
+    }
+
     Function *CompUnit::get_function(std::string_view name)
     {
         if (!_scope_self->has_function(name))
@@ -1,5 +1,6 @@
 #include "myglc-lang/ast-node-decl.hxx"
 #include "myglc-lang/ast-node.hxx"
+#include "myglc-lang/ast-node-arena.hxx"
 #include "myglc-lang/ast-code-visitor.hxx"
 #include "myglc-lang/ast-scope.hxx"
 #include "myglc-lang/ast-exception.hxx"
@@ -67,7 +68,7 @@ namespace MYGL::Ast {
     {
         std::string ret;
         for (auto &i: _array_info) {
-            auto conv = dynamic_cast<IntValue*>(i.get());
+            auto conv = dynamic_cast<IntValue*>(i);
             if (conv != nullptr && conv->get_value() == 0)
                 ret.append("[]");
             else
@@ -84,20 +85,21 @@ namespace MYGL::Ast {
     }
 /* end class ArrayInfo */
 /* @class Type */
-    Type::PtrT Type::OwnedIntType = std::make_shared<Type>(SourceRange{}, nullptr, "int", &CompUnit::Predefined, CompUnit::Predefined.scope_self());
-    Type::PtrT Type::OwnedFloatType = std::make_shared<Type>(SourceRange{}, &Type::VoidType, "float", &CompUnit::Predefined, CompUnit::Predefined.scope_self());
-    Type::PtrT Type::OwnedVoidType = std::make_shared<Type>(SourceRange{}, nullptr, "void", &CompUnit::Predefined, CompUnit::Predefined.scope_self());
+    std::unique_ptr<Type> Type::OwnedIntType = std::make_unique<Type>(SourceRange{}, nullptr, "int", &CompUnit::Predefined, CompUnit::Predefined.scope_self());
+    std::unique_ptr<Type> Type::OwnedFloatType = std::make_unique<Type>(SourceRange{}, &Type::VoidType, "float", &CompUnit::Predefined, CompUnit::Predefined.scope_self());
+    std::unique_ptr<Type> Type::OwnedVoidType = std::make_unique<Type>(SourceRange{}, nullptr, "void", &CompUnit::Predefined, CompUnit::Predefined.scope_self());
     Type &Type::IntType   = *OwnedIntType;
     Type &Type::FloatType = *OwnedFloatType;
     Type &Type::VoidType  = *OwnedVoidType;
 
+    /* 结点归 NodeArena 所有且不会被单独释放, 拷贝时和原类型共用同一个数组信息结点 */
     Type::Type(Type const &another)
         : Type(another._range,
                 another.base_type(),
                 another.type_name(),
                 another.parent(),
                 another.get_scope()) {
-        _array_info = std::make_shared<ArrayInfo>(*another._array_info);
+        _array_info = another._array_info;
     }
     Type::Type(Type &&rranother)
         : Type(rranother._range,
@@ -122,8 +124,8 @@ namespace MYGL::Ast {
     {
         if (this == another)
             return true;
-        ArrayInfo *larray_info = _array_info.get();
-        ArrayInfo *rarray_info = another->_array_info.get();
+        ArrayInfo *larray_info = _array_info;
+        ArrayInfo *rarray_info = another->_array_info;
         if (larray_info == rarray_info)
             return true;
         if (larray_info == nullptr ||
@@ -180,20 +182,21 @@ namespace MYGL::Ast {
         _init_expr = std::move(value);
     }
 
-    Type::PtrT Variable::get_real_type() const
+    Type::PtrT Variable::get_real_type(NodeArena &arena) const
     {
         if (_array_info == nullptr || _array_info->array_size() == 0)
-            return std::static_pointer_cast<Type>(shared_from_this());
-        Type::PtrT ret = std::make_shared<Type>(*_base_type);
+            return _base_type;
+        Type::PtrT ret = arena.make<Type>(*_base_type);
         if (ret->get_array_info() == nullptr) {
-            ret->set_array_info(std::make_shared<ArrayInfo>(_array_info));
+            ret->set_array_info(arena.make<ArrayInfo>(_array_info));
         } else {
-            ArrayInfo::PtrT info     = std::move(ret->get_array_info());
-            ArrayInfo::PtrT new_info = std::make_shared<ArrayInfo>(_array_info);
+            /* 基础类型的数组信息还被别的结点引用着, 只能拷贝, 不能挪走 */
+            ArrayInfo::PtrT info     = ret->get_array_info();
+            ArrayInfo::PtrT new_info = arena.make<ArrayInfo>(_array_info);
             ArrayInfo::InfoListT &new_info_list = new_info->array_info();
             for (auto &i: info->array_info())
-                new_info_list.push_back(std::move(i));
-            ret->set_array_info(std::move(new_info));
+                new_info_list.push_back(i);
+            ret->set_array_info(new_info);
         }
         return ret;
     }
@@ -271,7 +274,8 @@ namespace MYGL::Ast {
           _scope_self(nullptr) {
         _node_type = NodeType::FUNC_DEF;
         _func_params->set_parent(this);
-        _func_body->set_parent(this);
+        if (_func_body != nullptr)  // extern 函数声明没有函数体
+            _func_body->set_parent(this);
         owner_instance = this;
     }
 
@@ -284,7 +288,8 @@ namespace MYGL::Ast {
         return visitor->visit(this);
     }
     bool Function::accept_children(CodeVisitor *visitor) {
-        return (_func_params->accept(visitor)) && (_func_body->accept(visitor));
+        return (_func_params->accept(visitor)) &&
+               (_func_body == nullptr || _func_body->accept(visitor));
     }
     bool Function::register_this(Scope *owner)
     {
@@ -292,8 +297,9 @@ namespace MYGL::Ast {
             return false;
         _scope_self = std::make_unique<Scope>(owner, this);
         set_scope(owner);
+        ScopedSymbolTable::Frame frame{_scope_self.get()};
         return _func_params->register_this(_scope_self.get()) &&
-               _func_body->register_this(_scope_self.get());
+               (_func_body == nullptr || _func_body->register_this(_scope_self.get()));
     }
     void Function::set_func_params(FuncParam::PtrT &&fn_params)
     {
@@ -268,14 +268,14 @@ namespace MYGL::Ast {
         set_scope(os);
         /* register function name*/
         _name->set_scope(os);
-        std::string_view name = _name->name();
-        if (!os->has_function(name)) {
+        MTB::Symbol name = _name->symbol();
+        if (Function *func = os->get_function(name); func == nullptr) {
             std::clog << std::format(
                 "Detected external function `{}`",
-                name
+                name.str()
             ) << std::endl;
         } else {
-            _name->set_definition(os->get_function(name));
+            _name->set_definition(func);
         }
         return _param->register_this(os);
     }
@@ -390,7 +390,7 @@ namespace MYGL::Ast {
 
 /* @class Identifier */
     Identifier::Identifier(SourceRange const &range)
-        : Expression(range) {
+        : Expression(range), _symbol(range.get_content()) {
         _node_type = NodeType::IDENT;
         _is_lvalue = true;
     }
@@ -413,12 +413,12 @@ namespace MYGL::Ast {
             throw NullException(this, ErrorLevel::WARNING,
                 std::format("(Identifier \"{}\") owner scope is NULL", name()));
         }
-        if (!owner_scope->has_definition(name())) {
+        _definition = owner_scope->get_definition(_symbol);
+        if (_definition == nullptr) {
             std::clog << std::format("owner scope does not have definition of `{}`",
                 name()) << std::endl;
             return false;
         }
-        _definition = owner_scope->get_definition(name());
         Variable::UnownedPtrT def_as_var = dynamic_cast<Variable*>(_definition);
         _is_lvalue = (def_as_var != nullptr) && !(def_as_var->is_constant());
         return true;
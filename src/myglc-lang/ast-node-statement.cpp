@@ -14,7 +14,7 @@
 
 
 #define _M_SET_STMT_EX(child, expr, true_return, false_return) {\
-    if ((expr).get() == (child).get()) {\
+    if ((expr) == (child)) {\
         true_return;\
     } else if ((expr) != nullptr) {\
         (expr)->set_parent(this);\
@@ -29,7 +29,7 @@
     _M_SET_STMT_EX(child, expr, {return true;}, {return false;})
 
 #define _M_MOVE_STMT_EX(child, rrexpr, true_return, false_return) {\
-    if ((rrexpr).get() == (child).get()) {\
+    if ((rrexpr) == (child)) {\
         true_return;\
     } else if ((rrexpr) != nullptr) {\
         (rrexpr)->set_parent(this);\
@@ -97,6 +97,7 @@ namespace MYGL::Ast {
     {
         set_scope(owner_scope);
         _scope_self = std::make_unique<Scope>(owner_scope, this);
+        ScopedSymbolTable::Frame frame{_scope_self.get()};
         /* Block is a scope container */
         for (auto &i : _statements) {
             if (i->register_this(_scope_self.get()) == false)
@@ -395,7 +396,7 @@ namespace MYGL::Ast {
     {
         for (auto &i : _variables) {
             if (i->name() == name)
-                return i.get();
+                return i;
         }
         return nullptr;
     }
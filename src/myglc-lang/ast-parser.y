@@ -12,6 +12,7 @@ using Token = Lexer::Token;
 %code top {
 #include "../include/myglc-lang/ast-parser.tab.hxx"
 #include "base/mtb-exception.hxx"
+#include "base/mtb-compatibility.hxx"
 static auto yylex(parser::value_type *val_type,
                   parser::location_type *location,
                   Lexer *lexer) {
@@ -19,13 +20,13 @@ static auto yylex(parser::value_type *val_type,
     auto ret = lexer->lex(token);
 //     token->println();
     val_type->as<Token::PtrT>() = token;
-    *location = lexer->src_range;
+    *location = lexer->get_current_range();
     return ret;
 }
 }
 
 %define api.namespace {MYGL::Ast}
-/* 我用智能指针当语法单元/词法单元，为了避免智能指针类型不同导致的内存错误，所以只能使用variant了 */
+/* 语法单元是 NodeArena 里各种结点的裸指针, 词法单元按值存放, 类型各不相同, 所以只能使用variant了 */
 %define api.value.type variant
 %define api.location.type {SourceRange}
 
@@ -38,16 +39,9 @@ static auto yylex(parser::value_type *val_type,
 %locations
 
 %{
-// template<typename Tp, typename... Args>
-// inline auto news(Args... args) -> std::shared_ptr<Tp> {
-//     return std::make_shared<Tp>(args...);
-// }
-// template<typename Tp, typename... Args>
-// inline auto newu(Args... args) -> std::unique_ptr<Tp> {
-//     return std::make_unique<Tp>(args...);
-// }
-#define news std::make_shared
-#define newu std::make_unique
+/* 所有结点都分配在 ctx 的 NodeArena 里, 和 CodeContext 同生共死. */
+#define news ctx.new_node
+#define newu ctx.new_node
 
 template<typename T1, typename T2>
 SourceRange merge_range(T1 const &s1, T2 const &s2) {
@@ -56,15 +50,13 @@ SourceRange merge_range(T1 const &s1, T2 const &s2) {
     return ret;
 }
 
+/* 语法错误只让当前编译单元失败: 抛给 parse() 的调用者, 不结束进程 */
 void parser::error(parser::location_type const &location, std::string const &msg)
 {
     using namespace MTB::Compatibility;
-    MTB::crash_with_stacktrace(
-        true, CURRENT_SRCLOC_F,
-        rt_fmt("location %s: %s",
-               location.to_string().c_str(),
-               msg.c_str())
-    );
+    throw syntax_error(location, rt_fmt("location %s: %s",
+                                        location.to_string().c_str(),
+                                        msg.c_str()));
 }
 
 %}
@@ -153,7 +145,7 @@ void parser::error(parser::location_type const &location, std::string const &msg
 %token <Token::PtrT> T_PUBLIC
 %token <Token::PtrT> T_PRIVATE
 %token <Token::PtrT> T_PROTECTED
-%token <Token::PtrT> 
+%token <Token::PtrT> T_EXTERN
 
 %%
 MYGLProgram: CompUnit {
@@ -161,27 +153,34 @@ MYGLProgram: CompUnit {
                         if ($$ == nullptr) {
                             throw NullException(nullptr, ErrorLevel::FATAL, "Bad CompUnit\n");
                         }
-                        $$->register_this(CompUnit::Predefined.scope_self());
+                        /* 流式分析时每个顶层结点已经登记过了, 这里只是收尾 */
+                        $$->close_streaming();
+                        $$->register_this(ctx.get_global_scope());
                         ctx.sync_lexer();
                         ctx.root() = std::move($$);
                         YYACCEPT;
                     }
            ;
 
-CompUnit: Decl CompUnit {
-                        $2->prepend(std::move($1));
-                        $$ = std::move($2);
+/* 左递归: 顶层结点按源码顺序归约, 流式分析时归约一个就交出去一个 */
+CompUnit: CompUnit Decl {
+                        ctx.stream_declaration($1, $2);
+                        $$ = std::move($1);
                     }
-        | FuncDef CompUnit {
-                        $2->prepend(std::move($1));
-                        $$ = std::move($2);
+        | CompUnit FuncDef {
+                        ctx.stream_function($1, $2);
+                        $$ = std::move($1);
                     }
-        | Decl {        auto mccv = std::make_unique<CompUnit>($1->range());
-                        mccv->append(std::move($1));
+        | Decl {        auto mccv = news<CompUnit>($1->range());
+                        if (ctx.is_streaming())
+                            mccv->open_streaming(ctx.get_global_scope());
+                        ctx.stream_declaration(mccv, $1);
                         $$ = std::move(mccv);
                }
-        | FuncDef {     auto mccv = std::make_unique<CompUnit>($1->range());
-                        mccv->append(std::move($1));
+        | FuncDef {     auto mccv = news<CompUnit>($1->range());
+                        if (ctx.is_streaming())
+                            mccv->open_streaming(ctx.get_global_scope());
+                        ctx.stream_function(mccv, $1);
                         $$ = std::move(mccv);
                }
         ;
@@ -193,20 +192,20 @@ Decl: ConstDecl {   $$ = std::move($1); }
 ConstDecl: T_CONST Type ConstDef T_SEMICOLON {
                     SourceRange new_range = $1->range();
                     new_range.end = $4->range().end;
-                    $$ = news<ConstDecl>(new_range, $2.get(), nullptr, nullptr);
+                    $$ = news<ConstDecl>(new_range, $2, nullptr, nullptr);
                     $$->append(std::move($3));
                 }
          | T_CONST Type ConstDefs T_SEMICOLON {
                     SourceRange new_range = $1->range();
                     new_range.end = $4->range().end;
-                    $$ = news<ConstDecl>(new_range, $2.get(), nullptr, nullptr);
+                    $$ = news<ConstDecl>(new_range, $2, nullptr, nullptr);
                     $$->append(std::move($3));
                     $3.reset();
                 }
          ;
 
 ConstDefs: ConstDef T_COMMA ConstDef {
-                    $$ = news<Declaration::VarListT>();
+                    $$ = std::make_shared<Declaration::VarListT>();
                     $$->push_back(std::move($1));
                     $$->push_back(std::move($3));
                 }
@@ -281,19 +280,18 @@ ConstInitVals: T_COMMA ConstInitVal {
              ;
 
 VarDecl: Type VarDef T_SEMICOLON {
-                    $$ = news<VarDecl>(merge_range($1, $3), $1.get());
+                    $$ = news<VarDecl>(merge_range($1, $3), $1);
                     $$->append(std::move($2));
-                    $1.reset();
                 }
        | Type VarDef VarDecls T_SEMICOLON {
-                    $$ = news<VarDecl>(merge_range($1, $4), $1.get());
+                    $$ = news<VarDecl>(merge_range($1, $4), $1);
                     $$->append(std::move($2));
                     $$->append(std::move($3));
                 }
        ;
 
 VarDecls: T_COMMA VarDef {
-                    $$ = news<Declaration::VarListT>();
+                    $$ = std::make_shared<Declaration::VarListT>();
                     $$->push_front(std::move($2));
                 }
         | T_COMMA VarDef VarDecls {
@@ -358,26 +356,46 @@ InitVals: T_COMMA InitVal {
                 }
         ;
 
-FuncDef: Type T_IDENT T_OP_LQUOTE T_OP_RQUOTE Block {
+FuncDef: Type T_IDENT T_OP_LQUOTE T_OP_RQUOTE FuncBodyBegin Block {
+                    ctx.end_function_body();
                     $$ = news<Function>(
-                        merge_range($1, $5),
-                        $1.get(), $2->range().get_content(),
+                        merge_range($1, $6),
+                        $1, $2->range().get_content(),
                         newu<FuncParam>(merge_range($3, $4)),
-                        std::move($5)
+                        std::move($6)
                     );
-                    $1.reset();
                 }
-       | Type T_IDENT T_OP_LQUOTE FuncParams T_OP_RQUOTE Block {
+       | Type T_IDENT T_OP_LQUOTE FuncParams T_OP_RQUOTE FuncBodyBegin Block {
+                    ctx.end_function_body();
                     $$ = news<Function>(
-                        merge_range($1, $6),
-                        $1.get(), $2->range().get_content(),
+                        merge_range($1, $7),
+                        $1, $2->range().get_content(),
                         std::move($4),
-                        std::move($6)
+                        std::move($7)
+                    );
+                }
+       | T_EXTERN Type T_IDENT T_OP_LQUOTE T_OP_RQUOTE T_SEMICOLON {
+                    $$ = news<Function>(
+                        merge_range($1, $6),
+                        $2, $3->range().get_content(),
+                        newu<FuncParam>(merge_range($4, $5)),
+                        nullptr
+                    );
+                }
+       | T_EXTERN Type T_IDENT T_OP_LQUOTE FuncParams T_OP_RQUOTE T_SEMICOLON {
+                    $$ = news<Function>(
+                        merge_range($1, $7),
+                        $2, $3->range().get_content(),
+                        std::move($5),
+                        nullptr
                     );
-                    $1.reset();
                 }
        ;
 
+/* 函数体的结点从这里开始创建. 流式分析时放进单独的区域, 生成完 IR 就整体释放 */
+FuncBodyBegin: %empty { ctx.begin_function_body(); }
+             ;
+
 FuncParams: FuncParam {
                     $$ = newu<FuncParam>($1->range());
                     $$->append(std::move($1));
@@ -392,7 +410,7 @@ FuncParams: FuncParam {
 FuncParam: Type T_IDENT {
                     $$ = news<Variable>(
                         merge_range($1, $2), true,
-                        $1.get(), $2->range().get_content());
+                        $1, $2->range().get_content());
                 }
          | Type T_IDENT T_OP_LBRACKET T_OP_RBRACKET {
                     auto empty_array = news<ArrayInfo>(merge_range($3, $4));
@@ -401,14 +419,14 @@ FuncParam: Type T_IDENT {
                     empty_array->append(std::move(empty_value));
                     $$ = news<Variable>(
                         merge_range($1, $4), true,
-                        $1.get(), $2->range().get_content(),
+                        $1, $2->range().get_content(),
                         std::move(empty_array)
                     );
                 }
          | Type T_IDENT ArraySubscripts {
                     $$ = news<Variable>(
                         merge_range($1, $3), true,
-                        $1.get(), $2->range().get_content(),
+                        $1, $2->range().get_content(),
                         std::move($3)
                     );
                 }
@@ -418,7 +436,7 @@ FuncParam: Type T_IDENT {
                     $5->prepend(std::move(empty_value));
                     $$ = news<Variable>(
                         merge_range($1, $5), true,
-                        $1.get(), $2->range().get_content(),
+                        $1, $2->range().get_content(),
                         std::move($5)
                     );
                 }
@@ -684,7 +702,7 @@ LOrExp: LAndExp {   $$ = std::move($1); }
       | LAndExp T_REL_OR LOrExp {
                     SourceRange range = $1->range();
                     range.end = $3->range().end;
-                    $$ = std::make_shared<BinaryExpr>(
+                    $$ = news<BinaryExpr>(
                         range, Expression::Operator::OR,
                         std::move($1), std::move($3));
                 }
@@ -693,8 +711,8 @@ LOrExp: LAndExp {   $$ = std::move($1); }
 ConstExp: AddExp { $$ = std::move($1); }
         ;
 
-Type: T_INT {   $$ = Type::OwnedIntType;   }
-    | T_FLOAT { $$ = Type::OwnedFloatType; }
-    | T_VOID {  $$ = Type::OwnedVoidType;  }
+Type: T_INT {   $$ = &Type::IntType;   }
+    | T_FLOAT { $$ = &Type::FloatType; }
+    | T_VOID {  $$ = &Type::VoidType;  }
     ;
 %%
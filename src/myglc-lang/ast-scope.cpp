@@ -4,74 +4,126 @@
 
 
 namespace MYGL::Ast {
-    bool Scope::has_function(std::string_view name) const
+/* @class Scope */
+    bool Scope::_uses_symbol_table() const {
+        return _symbol_table != nullptr && _symbol_table->current_scope() == this;
+    }
+    Scope *Scope::_outside_symbol_table() const {
+        return _symbol_table->root_scope()->parent();
+    }
+
+    bool Scope::has_function(SymbolT name) const
     {
+        if (_uses_symbol_table())
+            return get_function(name) != nullptr;
         return (_functions.contains(name) ||
                 (_parent != nullptr &&
                  _parent->has_function(name)));
     }
-    Function *Scope::get_function(std::string_view name)
+    Function *Scope::get_function(SymbolT name) const
     {
-        if (_functions.contains(name))
-            return _functions[name];
+        if (_uses_symbol_table()) {
+            if (Function *ret = _symbol_table->lookup_function(name))
+                return ret;
+            Scope *outside = _outside_symbol_table();
+            return outside == nullptr ? nullptr : outside->get_function(name);
+        }
+        if (auto it = _functions.find(name); it != _functions.end())
+            return it->second;
         else if (_parent != nullptr)
             return _parent->get_function(name);
         else
             return nullptr;
     }
-    bool Scope::has_variable(std::string_view name) const
+    bool Scope::has_variable(SymbolT name) const
     {
+        if (_uses_symbol_table())
+            return get_variable(name) != nullptr;
         return (_variables.contains(name) ||
                 (_parent != nullptr &&
                  _parent->has_variable(name)));
     }
 
-    Variable *Scope::get_variable(std::string_view name)
+    Variable *Scope::get_variable(SymbolT name) const
     {
-        if (_variables.contains(name))
-            return _variables[name];
+        if (_uses_symbol_table()) {
+            if (Variable *ret = _symbol_table->lookup_variable(name))
+                return ret;
+            Scope *outside = _outside_symbol_table();
+            return outside == nullptr ? nullptr : outside->get_variable(name);
+        }
+        if (auto it = _variables.find(name); it != _variables.end())
+            return it->second;
         else if (_parent != nullptr)
             return _parent->get_variable(name);
         else
             return nullptr;
     }
 
-    bool Scope::has_constant(std::string_view name) const
+    bool Scope::has_constant(SymbolT name) const
     {
+        if (_uses_symbol_table())
+            return get_constant(name) != nullptr;
         return (_constants.contains(name) ||
                 (_parent != nullptr &&
                  _parent->has_constant(name)));
     }
 
-    Variable *Scope::get_constant(std::string_view name)
+    Variable *Scope::get_constant(SymbolT name) const
     {
-        if (_constants.contains(name))
-            return _constants[name];
+        if (_uses_symbol_table()) {
+            if (Variable *ret = _symbol_table->lookup_constant(name))
+                return ret;
+            Scope *outside = _outside_symbol_table();
+            return outside == nullptr ? nullptr : outside->get_constant(name);
+        }
+        if (auto it = _constants.find(name); it != _constants.end())
+            return it->second;
         else if (_parent != nullptr)
             return _parent->get_constant(name);
         else
             return nullptr;
     }
-    Variable *Scope::get_constant_or_variable(std::string_view name)
+    bool Scope::has_constant_or_variable(SymbolT name) const
     {
-        if (_constants.contains(name))
-            return _constants[name];
-        else if (_variables.contains(name))
-            return _variables[name];
+        if (_uses_symbol_table())
+            return get_constant_or_variable(name) != nullptr;
+        return (has_constant_or_variable_here(name) ||
+                (_parent != nullptr &&
+                 _parent->has_constant_or_variable(name)));
+    }
+    Variable *Scope::get_constant_or_variable(SymbolT name) const
+    {
+        if (_uses_symbol_table()) {
+            if (Variable *ret = _symbol_table->lookup_constant_or_variable(name))
+                return ret;
+            Scope *outside = _outside_symbol_table();
+            return outside == nullptr ? nullptr : outside->get_constant_or_variable(name);
+        }
+        if (auto it = _constants.find(name); it != _constants.end())
+            return it->second;
+        else if (auto it = _variables.find(name); it != _variables.end())
+            return it->second;
         else if (_parent != nullptr)
             return _parent->get_constant_or_variable(name);
         else
             return nullptr;
     }
 
-    Definition *Scope::get_definition(std::string_view name)
-    {
-        if (_functions.contains(name))
-            return _functions[name];
-        else if (_constants.contains(name))
-            return _constants[name];
-        else if (_variables.contains(name))
-            return _variables[name];
+    Definition *Scope::get_definition(SymbolT name) const
+    {
+        if (_uses_symbol_table()) {
+            if (Definition *ret = _symbol_table->lookup(name))
+                return ret;
+            Scope *outside = _outside_symbol_table();
+            return outside == nullptr ? nullptr : outside->get_definition(name);
+        }
+        if (auto it = _functions.find(name); it != _functions.end())
+            return it->second;
+        else if (auto it = _constants.find(name); it != _constants.end())
+            return it->second;
+        else if (auto it = _variables.find(name); it != _variables.end())
+            return it->second;
         else if (_parent != nullptr)
             return _parent->get_definition(name);
         else
@@ -80,34 +132,130 @@ namespace MYGL::Ast {
 
     bool Scope::add(Function::UnownedPtrT func)
     {
-        if (has_function_here(func->name()))
+        if (has_function_here(func->symbol()))
             return false;
         func->set_scope(this);
-        _functions.insert({func->name(), func});
+        _functions.insert({func->symbol(), func});
+        if (_uses_symbol_table()) {
+            _symbol_table->define(func->symbol(), func,
+                                  ScopedSymbolTable::Kind::FUNCTION);
+        }
         return true;
     }
     bool Scope::add(Variable::UnownedPtrT var)
     {
-        if (has_variable_here(var->name()))
+        if (has_variable_here(var->symbol()))
             return false;
         var->set_scope(this);
         VarMapT *target_map = var->is_constant() ? &_constants: &_variables;
-        target_map->insert({var->name(), var});
+        target_map->insert({var->symbol(), var});
+        if (_uses_symbol_table()) {
+            _symbol_table->define(var->symbol(), var, var->is_constant() ?
+                                  ScopedSymbolTable::Kind::CONSTANT:
+                                  ScopedSymbolTable::Kind::VARIABLE);
+        }
         return true;
     }
 
-    bool Scope::remove(std::string_view name)
-    {
-        if (has_constant_here(name))
-            _constants.erase(name);
-        else if (has_variable_here(name))
-            _variables.erase(name);
-        else if (has_function_here(name))
-            _functions.erase(name);
-        else
-            return false;
+    bool Scope::remove(SymbolT name)
+    {
+        return _constants.erase(name) != 0 ||
+               _variables.erase(name) != 0 ||
+               _functions.erase(name) != 0;
+    }
+/* end class Scope */
 
+/* @class ScopedSymbolTable */
+    void ScopedSymbolTable::push_scope(Scope *scope)
+    {
+        _levels.push_back({scope, _log.size()});
+        for (auto &[name, func]: scope->functions())
+            define(name, func, Kind::FUNCTION);
+        for (auto &[name, cons]: scope->constants())
+            define(name, cons, Kind::CONSTANT);
+        for (auto &[name, vari]: scope->variables())
+            define(name, vari, Kind::VARIABLE);
+    }
+    bool ScopedSymbolTable::try_push_scope(Scope *scope)
+    {
+        if (!_levels.empty() && current_scope() != scope->parent())
+            return false;
+        push_scope(scope);
         return true;
     }
+    void ScopedSymbolTable::pop_scope()
+    {
+        if (_levels.empty())
+            return;
+        /* 内层的定义总在外层的上面, 所以每条日志弹出对应名字的栈顶即可 */
+        size_t mark = _levels.back().log_mark;
+        while (_log.size() > mark) {
+            _stacks[_log.back()].pop_back();
+            _log.pop_back();
+        }
+        _levels.pop_back();
+    }
+    void ScopedSymbolTable::define(SymbolT name, Definition *definition, Kind kind)
+    {
+        Scope *scope = current_scope();
+        std::vector<Entry> &stack = _stacks[name];
+        /* 同一层里优先级高的定义要留在栈顶, 新定义插到它们下面 */
+        auto pos = stack.end();
+        while (pos != stack.begin() && (pos - 1)->scope == scope &&
+               uint8_t((pos - 1)->kind) > uint8_t(kind))
+            --pos;
+        stack.insert(pos, {definition, scope, kind});
+        _log.push_back(name);
+    }
 
+    ScopedSymbolTable::Entry const *
+    ScopedSymbolTable::_find_top(SymbolT name, bool (*pred)(Kind)) const
+    {
+        auto it = _stacks.find(name);
+        if (it == _stacks.end())
+            return nullptr;
+        std::vector<Entry> const &stack = it->second;
+        for (auto i = stack.rbegin(); i != stack.rend(); ++i) {
+            if (pred(i->kind))
+                return &*i;
+        }
+        return nullptr;
+    }
+    Function *ScopedSymbolTable::lookup_function(SymbolT name) const
+    {
+        Entry const *ret = _find_top(name,
+            [](Kind k) { return k == Kind::FUNCTION; });
+        return ret == nullptr ? nullptr : static_cast<Function*>(ret->definition);
+    }
+    Variable *ScopedSymbolTable::lookup_variable(SymbolT name) const
+    {
+        Entry const *ret = _find_top(name,
+            [](Kind k) { return k == Kind::VARIABLE; });
+        return ret == nullptr ? nullptr : static_cast<Variable*>(ret->definition);
+    }
+    Variable *ScopedSymbolTable::lookup_constant(SymbolT name) const
+    {
+        Entry const *ret = _find_top(name,
+            [](Kind k) { return k == Kind::CONSTANT; });
+        return ret == nullptr ? nullptr : static_cast<Variable*>(ret->definition);
+    }
+    Variable *ScopedSymbolTable::lookup_constant_or_variable(SymbolT name) const
+    {
+        Entry const *ret = _find_top(name,
+            [](Kind k) { return k != Kind::FUNCTION; });
+        return ret == nullptr ? nullptr : static_cast<Variable*>(ret->definition);
+    }
+
+    ScopedSymbolTable::Frame::Frame(Scope *scope)
+        : _table(scope->get_symbol_table())
+    {
+        if (_table != nullptr && !_table->try_push_scope(scope))
+            _table = nullptr;
+    }
+    ScopedSymbolTable::Frame::~Frame()
+    {
+        if (_table != nullptr)
+            _table->pop_scope();
+    }
+/* end class ScopedSymbolTable */
 } // namespace MYGL::Ast
@@ -0,0 +1,51 @@
+#include "myglc-lang/ast-source-registry.hxx"
+#include "myglc-lang/ast-exception.hxx"
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <system_error>
+
+
+namespace MYGL::Ast {
+/* @class SourceRegistry */
+    SourceRegistry::MappingPtrT SourceRegistry::open(std::string const &filename)
+    {
+        std::error_code ec;
+        std::filesystem::path canonical = std::filesystem::weakly_canonical(filename, ec);
+        std::string key = ec ? filename : canonical.string();
+
+        std::lock_guard guard{_lock};
+        if (auto it = _files.find(key); it != _files.end()) {
+            if (MappingPtrT mapping = it->second.lock())
+                return mapping;
+        }
+
+        auto mapping = std::make_shared<MTB::MappedFile>();
+        if (!mapping->open(key)) {
+            int err = errno;
+            throw NullException(nullptr, ErrorLevel::FATAL,
+                std::format("cannot map source file `{}`: {}", filename, std::strerror(err)));
+        }
+        /* 顺便清掉已经失效的表项, 免得表只增不减 */
+        std::erase_if(_files, [](auto const &entry) { return entry.second.expired(); });
+        _files[key] = mapping;
+        return mapping;
+    }
+
+    size_t SourceRegistry::get_nmapped() const
+    {
+        std::lock_guard guard{_lock};
+        size_t ret = 0;
+        for (auto &[key, mapping]: _files)
+            ret += mapping.expired() ? 0 : 1;
+        return ret;
+    }
+
+    SourceRegistry &SourceRegistry::Global()
+    {
+        static SourceRegistry instance;
+        return instance;
+    }
+/* end class SourceRegistry */
+} // namespace MYGL::Ast
@@ -258,7 +258,8 @@ bool Printer::visit(Function::UnownedPtrT node)
         node->name());
     indent_inc(); {
         try_accept(node->get_func_params());
-        try_accept(node->get_func_body());
+        if (!node->is_extern())
+            try_accept(node->get_func_body());
     } indent_dec();
     return true;
 }
@@ -7,11 +7,12 @@
 namespace MYGL::GenUtil {
 
 using namespace Ast;
+using ValuePtrT = ExprChecker::ValuePtrT;
 
 static SourceRange anomymous_range = {
     "<anomymous>",
-    {nullptr, 0, 0},
-    {nullptr, 0, 0}
+    {nullptr, 0, 0, 0},
+    {nullptr, 0, 0, 0}
 };
 
 static double value_ptr_get_float(Value *val)
@@ -33,24 +34,25 @@ static int64_t value_ptr_get_int(Value *val)
         return 0;
 }
 
-static void calc_do_unary_neg(Value *val)
+/* 折叠结果会被共享, 一元运算总是生成新值, 不在原值上修改 */
+static void calc_do_unary_neg(ValuePtrT &val)
 {
-    if (IntValue *ival = dynamic_cast<IntValue*>(val);ival != nullptr) {
-        ival->value() = -ival->value();
-    } else if (auto fval = dynamic_cast<FloatValue*>(val); fval != nullptr) {
-        fval->value() = -fval->value();
-    }
+    if (val->node_type() == NodeType::INT_VALUE)
+        val = std::make_shared<IntValue>(-static_cast<IntValue*>(val.get())->get_value());
+    else if (val->node_type() == NodeType::FLOAT_VALUE)
+        val = std::make_shared<FloatValue>(-static_cast<FloatValue*>(val.get())->get_value());
 }
-static void calc_do_unary_not(Value::PtrT &val)
+static void calc_do_unary_not(ValuePtrT &val)
 {
-    if (IntValue *ival = dynamic_cast<IntValue*>(val.get());ival != nullptr) {
-        ival->value() = !ival->value();
-    } else if (auto fval = dynamic_cast<FloatValue*>(val.get()); fval != nullptr) {
-        int fnot = !fval->value();
+    if (val->node_type() == NodeType::INT_VALUE) {
+        int inot = !static_cast<IntValue*>(val.get())->get_value();
+        val = std::make_shared<IntValue>(inot);
+    } else if (val->node_type() == NodeType::FLOAT_VALUE) {
+        int fnot = !static_cast<FloatValue*>(val.get())->get_value();
         val = std::make_shared<IntValue>(fnot);
     }
 }
-static Value::PtrT calc_do_bin_add(Value::PtrT &lhs, Value::PtrT &rhs)
+static ValuePtrT calc_do_bin_add(ValuePtrT &lhs, ValuePtrT &rhs)
 {
     if (lhs->node_type() == NodeType::STRING_VALUE ||
         rhs->node_type() == NodeType::STRING_VALUE) {
@@ -66,7 +68,7 @@ static Value::PtrT calc_do_bin_add(Value::PtrT &lhs, Value::PtrT &rhs)
         );
     }
 }
-static Value::PtrT calc_do_bin_sub(Value::PtrT &lhs, Value::PtrT &rhs)
+static ValuePtrT calc_do_bin_sub(ValuePtrT &lhs, ValuePtrT &rhs)
 {
     if (lhs->node_type() == NodeType::STRING_VALUE ||
         rhs->node_type() == NodeType::STRING_VALUE) {
@@ -82,7 +84,7 @@ static Value::PtrT calc_do_bin_sub(Value::PtrT &lhs, Value::PtrT &rhs)
         );
     }
 }
-static Value::PtrT calc_do_bin_mul(Value::PtrT &lhs, Value::PtrT &rhs)
+static ValuePtrT calc_do_bin_mul(ValuePtrT &lhs, ValuePtrT &rhs)
 {
     if (lhs->node_type() == NodeType::STRING_VALUE ||
         rhs->node_type() == NodeType::STRING_VALUE) {
@@ -98,7 +100,7 @@ static Value::PtrT calc_do_bin_mul(Value::PtrT &lhs, Value::PtrT &rhs)
         );
     }
 }
-static Value::PtrT calc_do_bin_div(Value::PtrT &lhs, Value::PtrT &rhs)
+static ValuePtrT calc_do_bin_div(ValuePtrT &lhs, ValuePtrT &rhs)
 {
     if (lhs->node_type() == NodeType::STRING_VALUE ||
         rhs->node_type() == NodeType::STRING_VALUE) {
@@ -118,7 +120,7 @@ static Value::PtrT calc_do_bin_div(Value::PtrT &lhs, Value::PtrT &rhs)
         );
     }
 }
-static Value::PtrT calc_do_bin_mod(Value::PtrT &lhs, Value::PtrT &rhs)
+static ValuePtrT calc_do_bin_mod(ValuePtrT &lhs, ValuePtrT &rhs)
 {
     if (lhs->node_type() == NodeType::STRING_VALUE ||
         rhs->node_type() == NodeType::STRING_VALUE) {
@@ -138,7 +140,7 @@ static Value::PtrT calc_do_bin_mod(Value::PtrT &lhs, Value::PtrT &rhs)
         );
     }
 }
-static Value::PtrT calc_do_bin_and(Value::PtrT &lhs, Value::PtrT &rhs)
+static ValuePtrT calc_do_bin_and(ValuePtrT &lhs, ValuePtrT &rhs)
 {
     if (lhs->node_type() == NodeType::STRING_VALUE ||
         rhs->node_type() == NodeType::STRING_VALUE) {
@@ -157,7 +159,7 @@ static Value::PtrT calc_do_bin_and(Value::PtrT &lhs, Value::PtrT &rhs)
 
     return std::make_shared<IntValue>(result);
 }
-static Value::PtrT calc_do_bin_or(Value::PtrT &lhs, Value::PtrT &rhs)
+static ValuePtrT calc_do_bin_or(ValuePtrT &lhs, ValuePtrT &rhs)
 {
     if (lhs->node_type() == NodeType::STRING_VALUE ||
         rhs->node_type() == NodeType::STRING_VALUE) {
@@ -177,17 +179,6 @@ static Value::PtrT calc_do_bin_or(Value::PtrT &lhs, Value::PtrT &rhs)
     return std::make_shared<IntValue>(result);
 }
 
-static Expression::PtrT
-calc_do_index_initlist(InitList::UnownedPtrT init_list,
-                       std::vector<int> const &dimension_list,
-                       std::vector<int> const &index_list)
-{
-    auto ret = Utility::AstIndexer {
-        init_list, dimension_list, index_list
-    }()->shared_from_this();
-    return std::dynamic_pointer_cast<Expression>(ret);
-}
-
 #define CHECK_FAIL() {\
     return false;\
 }
@@ -197,22 +188,103 @@ calc_do_index_initlist(InitList::UnownedPtrT init_list,
     return false;\
 }
 
+/* 字面量求值本来就是 O(1), 不值得在结点上再存一份. 而且 AstArrayFiller
+ * 会原地改写省略了长度的第一维, 存下来反而会过时. */
+static bool fold_result_is_kept(Expression *expr)
+{
+    return expr->node_type() != NodeType::INT_VALUE &&
+           expr->node_type() != NodeType::FLOAT_VALUE;
+}
+
+inline namespace expr_checker_impl {
+    /** @class FoldWalker
+     * @brief ExprChecker::fold_tree() 用的遍历器. 先折叠子表达式再折叠自己,
+     *        这样每个表达式求值时子表达式都已经有结果了. */
+    class FoldWalker final: public CodeVisitor {
+    public:
+        explicit FoldWalker(ExprChecker &checker)
+            : _checker(checker) {}
+
+        bool visit(UnaryExpr::UnownedPtrT node) override    { return _fold(node); }
+        bool visit(BinaryExpr::UnownedPtrT node) override   { return _fold(node); }
+        bool visit(IndexExpr::UnownedPtrT node) override    { return _fold(node); }
+        bool visit(Identifier::UnownedPtrT node) override   { return _fold(node); }
+        /* 这些表达式一定不是常量, 只往下找 */
+        bool visit(CallParam::UnownedPtrT node) override    { return _walk(node); }
+        bool visit(CallExpr::UnownedPtrT node) override     { return _walk(node); }
+        bool visit(InitList::UnownedPtrT node) override     { return _walk(node); }
+        bool visit(AssignExpr::UnownedPtrT node) override   { return _walk(node); }
+        bool visit(IntValue::UnownedPtrT node) override     { return true; }
+        bool visit(FloatValue::UnownedPtrT node) override   { return true; }
+        bool visit(StringValue::UnownedPtrT node) override  { return true; }
+
+        bool visit(IfStmt::UnownedPtrT node) override       { return _walk(node); }
+        bool visit(WhileStmt::UnownedPtrT node) override    { return _walk(node); }
+        bool visit(EmptyStmt::UnownedPtrT node) override    { return true; }
+        bool visit(ReturnStmt::UnownedPtrT node) override   { return _walk(node); }
+        bool visit(BreakStmt::UnownedPtrT node) override    { return true; }
+        bool visit(ContinueStmt::UnownedPtrT node) override { return true; }
+        bool visit(Block::UnownedPtrT node) override        { return _walk(node); }
+        bool visit(ExprStmt::UnownedPtrT node) override     { return _walk(node); }
+        bool visit(ConstDecl::UnownedPtrT node) override    { return _walk(node); }
+        bool visit(VarDecl::UnownedPtrT node) override      { return _walk(node); }
+        bool visit(Function::UnownedPtrT node) override     { return _walk(node); }
+        bool visit(Variable::UnownedPtrT node) override     { return _walk(node); }
+        bool visit(Type::UnownedPtrT node) override         { return _walk(node); }
+        bool visit(CompUnit::UnownedPtrT node) override     { return _walk(node); }
+        bool visit(FuncParam::UnownedPtrT node) override    { return _walk(node); }
+        bool visit(ArrayInfo::UnownedPtrT node) override    { return _walk(node); }
+    private:
+        ExprChecker &_checker;
+
+        /* 子结点遍历的返回值只表示"遍历被打断", 这里总是继续 */
+        bool _walk(Node *node) {
+            node->accept_children(this);
+            return true;
+        }
+        bool _fold(Expression *expr) {
+            expr->accept_children(this);
+            try {
+                _checker.do_try_calculate(expr);
+            } catch (Utility::AstIndexerContext::BrokenListException &) {
+                /* 留给真正用到它的地方去报错 */
+            }
+            return true;
+        }
+    }; // class FoldWalker
+} // inline namespace expr_checker_impl
+
 ExprChecker::ExprChecker() = default;
 
-Value::PtrT ExprChecker::do_try_calculate(Expression::UnownedPtrT expr)
+ValuePtrT ExprChecker::do_try_calculate(Expression::UnownedPtrT expr)
 {
-    if (expr->accept(this) == false)
+    switch (expr->get_fold_state()) {
+    case Expression::FoldState::CONSTANT:
+        return expr->get_folded_value();
+    case Expression::FoldState::NOT_CONSTANT:
         return nullptr;
-    else
-        return _cur_value;
+    default:
+        break;
+    }
+    ValuePtrT value = (expr->accept(this) ? _cur_value : nullptr);
+    if (fold_result_is_kept(expr))
+        expr->set_folded(value);
+    return value;
+}
+void ExprChecker::fold_tree(Node *root)
+{
+    if (root == nullptr)
+        return;
+    FoldWalker walker{*this};
+    root->accept(&walker);
 }
 bool ExprChecker::list_is_constant(InitList::UnownedPtrT init_list)
 {
     for (auto &i: init_list->get_expr_list()) {
-        if (auto list = dynamic_cast<InitList*>(i.get());
+        if (auto list = dynamic_cast<InitList*>(i);
             (list != nullptr) && (!list_is_constant(list))) {
             return false;
-        } else if (!value_is_constant(i.get())) {
+        } else if (!value_is_constant(i)) {
             return false;
         }
     }
@@ -221,13 +293,14 @@ bool ExprChecker::list_is_constant(InitList::UnownedPtrT init_list)
 
 bool ExprChecker::visit(UnaryExpr::UnownedPtrT unary_expr)
 {
-    if (unary_expr->get_expression()->accept(this) == false)
+    _cur_value = do_try_calculate(unary_expr->get_expression());
+    if (_cur_value == nullptr)
         return false;
     switch (unary_expr->xoperator()) {
     case Ast::Expression::Operator::PLUS:
         break;
     case Ast::Expression::Operator::SUB:
-        calc_do_unary_neg(_cur_value.get());
+        calc_do_unary_neg(_cur_value);
         break;
     case Ast::Expression::Operator::NOT:
         calc_do_unary_not(_cur_value);
@@ -242,10 +315,10 @@ bool ExprChecker::visit(UnaryExpr::UnownedPtrT unary_expr)
  * 倘若出现变量/函数调用，会被判false的。 */
 bool ExprChecker::visit(BinaryExpr::UnownedPtrT node)
 {
-    auto lhs = do_try_calculate(node->get_lhs().get());
+    auto lhs = do_try_calculate(node->get_lhs());
     if (lhs == nullptr)
         return false;
-    auto rhs = do_try_calculate(node->get_rhs().get());
+    auto rhs = do_try_calculate(node->get_rhs());
     if (rhs == nullptr)
         return false;
     switch (node->get_operator()) {
@@ -288,7 +361,7 @@ bool ExprChecker::visit(CallExpr::UnownedPtrT node) CHECK_FAIL()
 /* 试着写了一下数组取索引的函数，不知道对不对。*/
 bool ExprChecker::visit(IndexExpr::UnownedPtrT node)
 {
-    Identifier::UnownedPtrT name = node->get_name().get();
+    Identifier::UnownedPtrT name = node->get_name();
     auto def = name->get_definition();
     /* 查找是否为函数/预定义函数(def == nullptr时就是预定义函数) */
     if (def == nullptr || def->node_type() == NodeType::FUNC_DEF)
@@ -317,14 +390,14 @@ bool ExprChecker::visit(IndexExpr::UnownedPtrT node)
     }
 
     // 如果没有init_expr, 就是空初始化，一律填0.
-    auto init_expr = var_def->get_init_expr().get();
+    auto init_expr = var_def->get_init_expr();
     if (init_expr == nullptr) {
         _cur_value = std::make_shared<IntValue>(0);
         return true;
     }
     // init_expr不是InitList类型的，相当于用标量初始化向量，报错
     auto init_list = dynamic_cast<InitList*>(init_expr);
-    if (init_expr == nullptr) {
+    if (init_list == nullptr) {
         std::clog << std::format(
                 "Syntax error at {}: do not use value to initialize array",
                 var_def->range().to_string());
@@ -337,7 +410,8 @@ bool ExprChecker::visit(IndexExpr::UnownedPtrT node)
     std::vector<int> dimension_list(def_dimension);
     for (int index = 0;
          auto &i: var_def->get_array_info()->get_array_info()) {
-        if (i->accept(this) == false ||
+        _cur_value = do_try_calculate(i);
+        if (_cur_value == nullptr ||
             _cur_value->node_type() != NodeType::INT_VALUE)
             return false;
         dimension_list[index] = value_ptr_get_int(_cur_value.get());
@@ -345,22 +419,27 @@ bool ExprChecker::visit(IndexExpr::UnownedPtrT node)
     }
     for (int index = 0;
          auto &i: node->get_index_list()) {
-        if (i->accept(this) == false ||
+        _cur_value = do_try_calculate(i);
+        if (_cur_value == nullptr ||
             _cur_value->node_type() != NodeType::INT_VALUE)
             return false;
         index_list[index] = value_ptr_get_int(_cur_value.get());
         index++;
     }
     // 上面的代码都是检查与初始化用的。
-    // 初始化列表的索引非常复杂，请参见类CalcDoIndexList::Calculator的实现。
-    Utility::AstIndexer index {
-        init_list, dimension_list, index_list
-    };
-    auto index_pointer = index();
-    if (index_pointer == nullptr)
+    // 初始化列表只展开一次, 结果挂在列表结点上, 之后每次取元素都是二分查找.
+    // 展开的规则请参见 Utility::SparseInitList.
+    auto flat = Utility::SparseInitList::Get(init_list, dimension_list);
+    size_t offset = 0;
+    if (!flat->offset_of(index_list, offset))
         return false;
-    bool ret = index_pointer->accept(this);
-    return ret;
+    Expression *element = flat->at(offset);
+    if (element == nullptr) {
+        _cur_value = std::make_shared<IntValue>(0);
+        return true;
+    }
+    _cur_value = do_try_calculate(element);
+    return _cur_value != nullptr;
 }
 bool ExprChecker::visit(Identifier::UnownedPtrT node)
 {
@@ -372,9 +451,11 @@ bool ExprChecker::visit(Identifier::UnownedPtrT node)
     /* 保险用的，指不定哪天就出现typedef了 */
     if (var_def == nullptr)
         return false;
-    if (!var_def->is_constant())
+    /* 函数参数在语法树里也标成常量, 但是没有初始值 */
+    if (!var_def->is_constant() || var_def->get_init_expr() == nullptr)
         return false;
-    return var_def->get_init_expr()->accept(this);
+    _cur_value = do_try_calculate(var_def->get_init_expr());
+    return _cur_value != nullptr;
 }
 bool ExprChecker::visit(IntValue::UnownedPtrT node)
 {
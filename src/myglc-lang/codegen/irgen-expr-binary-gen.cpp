@@ -57,7 +57,7 @@ inline namespace binary_impl {
             case Operator::GE:  ret = l >= r; break;
             default: return {};
         }
-        return new IntConst(boolty, ret);
+        return IntConst::Create(boolty, ret);
     }
     static inline owned<ConstantData>
     do_eval_float(FloatType *fty, Operator op, double l, double r)
@@ -255,7 +255,7 @@ inline namespace binary_impl {
     cast_iext(IntType *target, Value *operand, BasicBlock *current)
     {
         if (operand->get_type_id() == ValueTID::ZERO_CONST)
-            return new IntConst(target, 0);
+            return IntConst::Create(target, 0);
         auto oty = static_cast<IntType*>(operand->get_value_type());
         bool operand_bool = oty->get_binary_bits() == 1;
 
@@ -264,7 +264,7 @@ inline namespace binary_impl {
             int64_t value = operand_bool ?
                             iop->get_uint_value(): // bool 量直接使用 zext 扩展
                             iop->get_int_value();  // 其他量需要使用 sext 扩展
-            return new IntConst(target, value);
+            return IntConst::Create(target, value);
         }
 
         owned<CastSSA> ret;
@@ -280,7 +280,7 @@ inline namespace binary_impl {
     cast_fpext(FloatType *target, Value *operand, BasicBlock *current)
     {
         if (operand->get_type_id() == ValueTID::ZERO_CONST)
-            return new FloatConst(target, 0);
+            return FloatConst::Create(target, 0);
         auto oty = static_cast<FloatType*>(operand->get_value_type());
 
         if (operand->get_type_id() == ValueTID::FLOAT_CONST) {
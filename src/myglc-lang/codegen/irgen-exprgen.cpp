@@ -17,8 +17,8 @@ ExprGenerator::ExprGenerator(IR::BasicBlock *working_block,
 
 bool ExprGenerator::visit(Ast::BinaryExpr::UnownedPtrT bexp)
 {
-    Ast::Expression *lhs = bexp->get_lhs().get();
-    Ast::Expression *rhs = bexp->get_rhs().get();
+    Ast::Expression *lhs = bexp->get_lhs();
+    Ast::Expression *rhs = bexp->get_rhs();
     Operator         eop = bexp->get_operator();
     BinGenerator     gen{this, _runtime->current_block};
 
@@ -52,10 +52,10 @@ bool ExprGenerator::visit(Ast::BinaryExpr::UnownedPtrT bexp)
 
 bool ExprGenerator::visit(Ast::UnaryExpr *uexp)
 {
-    Ast::Expression *operand = uexp->get_expression().get();
+    Ast::Expression *operand = uexp->get_expression();
     ExprResult  &prev_result = _runtime->prev_result; 
     prev_result = {
-        uexp->get_expression().get(),
+        uexp->get_expression(),
         nullptr, 0, false,
     };
     if (!operand->accept(this))
@@ -97,7 +97,7 @@ bool ExprGenerator::visit(Ast::UnaryExpr *uexp)
 
         if (is_data_const(voperand)) {
             auto coperand = static_cast<ConstantData*>(voperand);
-            prev_result.result = new IntConst(boolty, !coperand->is_zero());
+            prev_result.result = IntConst::Create(boolty, !coperand->is_zero());
             break;
         } else if (is_boolty(operandty)) {
             result = UnaryOperationSSA::CreateNot(voperand);
@@ -127,7 +127,7 @@ bool ExprGenerator::visit(Ast::IntValue *ival)
 {
     _runtime->prev_result = {
         ival,
-        new IntConst(_runtime->i32ty, ival->get_value()),
+        IntConst::Create(_runtime->i32ty, ival->get_value()),
         0, false
     };
     return true;
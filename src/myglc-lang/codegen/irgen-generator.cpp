@@ -8,8 +8,10 @@
 #include "myglc-lang/ast-scope.hxx"
 #include "myglc-lang/codegen/irgen-type-forwarding.hxx"
 #include "myglc-lang/codegen/irgen-generator.hxx"
+#include "myglc-lang/codegen/irgen-global-init.hxx"
 #include <cstdio>
 #include <memory>
+#include <stack>
 #include <string_view>
 
 #define scope_ctx_save(scope) \
@@ -23,7 +25,6 @@ namespace MYGL::IRGen {
 using namespace MTB;
 
 using std::string_view;
-using std::static_pointer_cast;
 using AType = Ast::Type;
 using IType = IRBase::Type;
 using IFuncType = IRBase::FunctionType;
@@ -56,6 +57,7 @@ inline namespace generator_impl {
         }
         return nullptr;
     }
+
 } // inline namespace generator_impl
 
 struct Generator::RuntimeData {
@@ -97,16 +99,16 @@ owned<IR::Builder> Generator::generate()
     // visit this compile unit
     RuntimeData data {nullptr,{},{}};
     _runtime_data = &data;
-    visit(ctx.root().get());
-    // clear module context
-    _module       = nullptr;
-    _runtime_data = nullptr;
-    return _builder;
+    _begin_module();
+    visit(ctx.root());
+    return _finish_module();
 }
 
 bool Generator::visit(Ast::CompUnit::UnownedPtrT comp_unit)
 {
     Scope *scope     = comp_unit->scope_self();
+    _declare_outer_functions(scope);
+
     auto  &constants = scope->constants();
     for (auto &i: constants) {
         string_view name     = i.first;
@@ -136,19 +138,20 @@ bool Generator::visit(Ast::Function::UnownedPtrT afunc)
 
     TypeMapper::ATypeListT param_type_list = function_make_argument_typelist(afunc);
     ATypeUPtr   ureturn_type = afunc->get_return_type();
-    AType::PtrT oreturn_type = static_pointer_cast<AType>(ureturn_type->shared_from_this());
+    AType::PtrT oreturn_type = ureturn_type;
     IFuncType  *ifunc_ty     = _mapper.make_function_type(oreturn_type,
                                                           param_type_list);
     if (afunc->is_extern()) {
         _builder->declareFunction(afunc->name(), ifunc_ty);
     } else {
         IR::Function *ifunc = _builder->defineFunction(afunc->name(), ifunc_ty);
+        MTB::ArenaScope arena_scope{ifunc->get_arena()};
         _builder->selectFunction(ifunc);
         _current_scope = afunc->get_scope();
 
         SymbolInfoMapper &info = _symbol_info_manager.register_get_function(afunc, ifunc);
         _symbol_info_manager.current_symbol_info_map = &info;
-        visit(afunc->get_func_body().get());
+        visit(afunc->get_func_body());
     }
     return true;
 }
@@ -165,25 +168,47 @@ bool Generator::visit(Ast::Block::UnownedPtrT basic_block)
 
 /* private class Generator */
 
+void Generator::_begin_module()
+{
+    /* 每个编译单元生成一个自己的模块, 多个单元的模块之后再链接到一起 */
+    _builder = own<IR::Builder>();
+    _module  = _builder->createModule(ctx.get_filename());
+}
+
+owned<IR::Builder> Generator::_finish_module()
+{
+    // clear module context
+    _module       = nullptr;
+    _runtime_data = nullptr;
+    return _builder;
+}
+
+void Generator::_declare_outer_functions(Scope *unit_scope)
+{
+    /* preclude 等外层作用域里的函数只在本模块里声明, 定义由链接时的其他模块提供 */
+    for (Scope *outer = ctx.get_global_scope(); outer != nullptr; outer = outer->parent()) {
+        for (auto &[name, funcdecl]: outer->functions()) {
+            if (!funcdecl->is_extern())
+                continue;
+            if (!unit_scope->has_function_here(name))
+                visit(funcdecl);
+        }
+    }
+}
+
 void Generator::_generate_constant_globl(Variable *constant)
 {
-    Ast::Type::PtrT constant_type = constant->get_real_type();
+    Ast::Type::PtrT constant_type = constant->get_real_type(ctx.get_node_arena());
     IR::Type *ir_type = _mapper.make_ir_type(constant_type);
-    owned<IR::Constant> init_expr;
-    if (constant->get_init_expr() == nullptr) {
-        if (ir_type->is_array_type())
-            init_expr = IR::ArrayExpr::CreateEmpty(ir_type);
-        else
-            init_expr = IR::Constant::CreateZeroOrUndefined(ir_type);
-    } else {
-    }
+    owned<IR::Constant> init_expr = make_global_init(_checker, constant, ir_type);
     _builder->defineGlobalConstant(constant->name(), ir_type, init_expr);
 }
 void Generator::_generate_variable_globl(Variable *variable)
 {
-    Ast::Type::PtrT vartype = variable->get_real_type();
+    Ast::Type::PtrT vartype = variable->get_real_type(ctx.get_node_arena());
     IR::Type *ir_type = _mapper.make_ir_type(vartype);
-    _builder->defineGlobalVariable(variable->name(), ir_type, );
+    owned<IR::Constant> init_expr = make_global_init(_checker, variable, ir_type);
+    _builder->defineGlobalVariable(variable->name(), ir_type, init_expr);
 }
 
 void Generator::_visit_current_scope()
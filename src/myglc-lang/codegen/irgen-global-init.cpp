@@ -0,0 +1,117 @@
+#include "myglc-lang/codegen/irgen-global-init.hxx"
+#include "myglc-lang/ast-exception.hxx"
+#include "myglc-lang/util/expr-indexer.hxx"
+#include <format>
+#include <vector>
+
+namespace MYGL::IRGen {
+using namespace MTB;
+using IType = IRBase::Type;
+
+inline namespace global_init_impl {
+    /** 展开后的标量初始值: 行优先的偏移和已经转换好的 IR 常量 */
+    struct ScalarInit {
+        size_t              offset;
+        owned<IR::Constant> value;
+    }; // struct ScalarInit
+
+    static size_t array_type_scalar_count(IType *type)
+    {
+        size_t ret = 1;
+        while (type->is_array_type()) {
+            auto aty = static_cast<IR::ArrayType*>(type);
+            ret *= aty->get_length();
+            type = aty->get_element_type();
+        }
+        return ret;
+    }
+
+    /** 由按偏移升序排列的标量 [begin, end) 构造稀疏的数组常量. 没有元素的子数组
+     *  保持全零, 不展开. */
+    static owned<IR::ArrayExpr>
+    make_sparse_array(IR::ArrayType *aty, ScalarInit *begin, ScalarInit *end, size_t base)
+    {
+        if (begin == end)
+            return IR::ArrayExpr::CreateEmpty(aty);
+        IType *elem_type = aty->get_element_type();
+        size_t stride    = array_type_scalar_count(elem_type);
+        IR::ArrayExpr::SparseListT elems;
+        while (begin != end) {
+            size_t index = (begin->offset - base) / stride;
+            if (!elem_type->is_array_type()) {
+                elems.push_back({index, begin->value});
+                ++begin;
+                continue;
+            }
+            size_t      sub_base = base + index * stride;
+            ScalarInit *sub_end  = begin;
+            while (sub_end != end && sub_end->offset < sub_base + stride)
+                ++sub_end;
+            elems.push_back({index, make_sparse_array(static_cast<IR::ArrayType*>(elem_type),
+                                                      begin, sub_end, sub_base)});
+            begin = sub_end;
+        }
+        return IR::ArrayExpr::CreateSparse(aty, std::move(elems));
+    }
+
+    static owned<IR::Constant> make_scalar_constant(IType *type, Ast::Value *value)
+    {
+        if (type->is_float_type()) {
+            return IR::FloatConst::Create(static_cast<IR::FloatType*>(type),
+                                          double(value->get_float_value()));
+        }
+        return IR::IntConst::Create(static_cast<IR::IntType*>(type),
+                                    int64_t(value->get_int_value()));
+    }
+
+    static owned<IR::Constant>
+    calculate_scalar(GenUtil::ExprChecker &checker, Ast::Variable *variable,
+                     Ast::Expression *expr, IType *type)
+    {
+        GenUtil::ExprChecker::ValuePtrT value = checker.try_calculate(expr);
+        if (value == nullptr) {
+            throw Ast::NullException(expr, Ast::ErrorLevel::CRITICAL,
+                std::format("initializer of global `{}` is not a constant", variable->name()));
+        }
+        return make_scalar_constant(type, value.get());
+    }
+} // inline namespace global_init_impl
+
+owned<IR::Constant>
+make_global_init(GenUtil::ExprChecker &checker, Ast::Variable *variable, IR::Type *ir_type)
+{
+    Ast::Expression *init = variable->get_init_expr();
+    if (init == nullptr) {
+        if (ir_type->is_array_type())
+            return IR::ArrayExpr::CreateEmpty(static_cast<IR::ArrayType*>(ir_type));
+        return IR::Constant::CreateZeroOrUndefined(ir_type);
+    }
+    if (!ir_type->is_array_type())
+        return calculate_scalar(checker, variable, init, ir_type);
+
+    auto init_list = dynamic_cast<Ast::InitList*>(init);
+    if (init_list == nullptr) {
+        throw Ast::NullException(init, Ast::ErrorLevel::CRITICAL,
+            std::format("do not use value to initialize array `{}`", variable->name()));
+    }
+    /* 初始化列表一趟展开成稀疏表, 只为写出来的非零元素生成常量 */
+    std::vector<int> dimension_list;
+    IType *scalar_type = ir_type;
+    while (scalar_type->is_array_type()) {
+        auto aty = static_cast<IR::ArrayType*>(scalar_type);
+        dimension_list.push_back(int(aty->get_length()));
+        scalar_type = aty->get_element_type();
+    }
+    auto flat = Utility::SparseInitList::Get(init_list, dimension_list);
+    std::vector<ScalarInit> scalars;
+    scalars.reserve(flat->elements.size());
+    for (auto &[offset, expr]: flat->elements) {
+        owned<IR::Constant> element = calculate_scalar(checker, variable, expr, scalar_type);
+        if (!element->is_zero())
+            scalars.push_back({offset, std::move(element)});
+    }
+    return make_sparse_array(static_cast<IR::ArrayType*>(ir_type),
+                             scalars.data(), scalars.data() + scalars.size(), 0);
+}
+
+} // namespace MYGL::IRGen
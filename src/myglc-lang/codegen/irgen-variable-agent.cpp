@@ -8,6 +8,26 @@ namespace MYGL::IRGen::FunctionLocal {
 
 using Ast::Variable;
 using IR::Constant;
+using MTB::owned;
+
+/** @class SymbolInfoManager */
+
+SymbolInfoMapper &SymbolInfoManager::
+register_get_function(Ast::Function *afunc, IR::Function *ifunc)
+{
+    auto [iter, inserted] = _func_map.try_emplace(afunc, SymbolInfoMapper{afunc, ifunc, {}, {}});
+    SymbolInfoMapper &ret = iter->second;
+    if (!inserted && ret.ifunc != ifunc) {
+        ret.ifunc = ifunc;
+        ret.symbol_map.clear();
+        ret.const_map.clear();
+    }
+    return ret;
+}
+
+/** end class SymbolInfoManager */
+
+/** @class SymbolInfoMapper */
 
 SymbolInfo &SymbolInfoMapper::
 register_local_variable(Variable::UnownedPtrT   avar,
@@ -59,4 +79,6 @@ find_local_constant(AVarUPtr aconst)
     return iter->second;
 }
 
+/** end class SymbolInfoMapper */
+
 } // namespace MYGL::IRGen::FunctionLocal
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "myglc-lang/frontend-batch.hxx"
+#include "base/mtb-thread-pool.hxx"
+#include "mygl-ir/utils/irutil-bitcode.hxx"
+#include "myglc-lang/ast-exception.hxx"
+#include "myglc-lang/ast-parser.hxx"
+#include "myglc-lang/code-visitors/expr-checker.hxx"
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+
+
+namespace MYGL::Driver {
+
+/* @class BatchFrontend */
+    BatchFrontend::BatchFrontend(std::string_view preclude_source, size_t nworkers)
+        : _preclude(Ast::CodeContext::fromString(std::string{preclude_source})),
+          _nworkers(nworkers == 0 ? MTB::ThreadPool::DefaultConcurrency() : nworkers)
+    {
+        _preclude->filename() = "<preclude>";
+        Ast::Parser parser{*_preclude};
+        if (parser.try_parse() != 0 || _preclude->root() == nullptr) {
+            throw Ast::NullException(nullptr, Ast::ErrorLevel::FATAL,
+                                     "cannot parse the preclude source");
+        }
+        /* 各单元并发地查询 preclude 里的常量, 先折叠好, 之后就只读了 */
+        GenUtil::ExprChecker{}.fold_tree(_preclude->root());
+    }
+
+    BatchFrontend::Unit BatchFrontend::checkOne(std::string const &filename)
+    {
+        Unit unit{filename, nullptr, false, {}};
+        try {
+            Ast::CodeContext::PtrT ctx = Ast::CodeContext::fromMappedFile(filename, _registry);
+            ctx->set_preclude(_preclude);
+            /* 不用 try_parse(): 它把异常打印到 clog 就丢了, 这里要把原因记到单元上.
+             * 语法错误由 parser::error() 抛出 syntax_error. */
+            Ast::Parser parser{*ctx};
+            if (parser.parse() != 0 || ctx->root() == nullptr) {
+                unit.error = "syntax error";
+                return unit;
+            }
+            GenUtil::ExprChecker{}.fold_tree(ctx->root());
+            if (_keep_ast)
+                unit.ctx = std::move(ctx);
+            unit.ok = true;
+        } catch (std::exception &e) {
+            unit.error = e.what();
+        }
+        return unit;
+    }
+
+    BatchFrontend::UnitListT BatchFrontend::check(std::vector<std::string> const &filenames)
+    {
+        UnitListT units(filenames.size());
+        /* 语法树不用 MTB::Object 的引用计数, 各单元只读共用的 preclude, 总是可以并行 */
+        size_t nthreads = std::min(_nworkers, filenames.size());
+        if (nthreads <= 1) {
+            for (size_t i = 0; i < filenames.size(); i++)
+                units[i] = checkOne(filenames[i]);
+            return units;
+        }
+
+        MTB::ThreadPool pool{nthreads};
+        for (size_t i = 0; i < filenames.size(); i++) {
+            pool.submit([this, &units, &filenames, i]() {
+                units[i] = checkOne(filenames[i]);
+            });
+        }
+        pool.wait();
+        return units;
+    }
+
+    MTB::owned<IR::Module> BatchFrontend::link(std::span<IR::Module* const> modules,
+                                               std::string_view name)
+    {
+        /* 序列化只读模块, 可以并行; 合并要改同一个模块, 只能按顺序来 */
+        std::vector<std::vector<uint8_t>> bitcodes(modules.size());
+        size_t nthreads = std::min(_nworkers, modules.size());
+#if __MTB_OBJECT_ATOMIC_REFCOUNT__ == 0
+        /* 序列化时会碰到各模块共享的全局对象 (比如 VoidType) 的引用计数 */
+        nthreads = 1;
+#endif
+        if (nthreads <= 1) {
+            for (size_t i = 0; i < modules.size(); i++)
+                bitcodes[i] = IRUtil::write_bitcode(modules[i]);
+        } else {
+            MTB::ThreadPool pool{nthreads};
+            for (size_t i = 0; i < modules.size(); i++) {
+                pool.submit([&bitcodes, &modules, i]() {
+                    bitcodes[i] = IRUtil::write_bitcode(modules[i]);
+                });
+            }
+            pool.wait();
+        }
+
+        size_t machine_word_size = modules.empty() ? global_machine_word_size
+                                 : modules.front()->get_type_ctx().get_machine_word_size();
+        MTB::owned<IR::Module> ret = IR::Module::Create(name, machine_word_size);
+        for (std::vector<uint8_t> const &bitcode: bitcodes)
+            IRUtil::link_bitcode(ret.get(), bitcode);
+        return ret;
+    }
+/* end class BatchFrontend */
+} // namespace MYGL::Driver
@@ -16,6 +16,26 @@ namespace MYGL::Ast {
         return {actual() - backwd, last_len};
     }
 
+    void SourceLocation::resolve(int &line, int &col) const
+    {
+        line = this->line;
+        col  = this->col;
+        if (line != 0)
+            return;
+        line = 1;
+        char const *begin = owner->data();
+        char const *pos   = begin + std::min(location, owner->length());
+        char const *line_begin = begin;
+        for (char const *p = begin; p < pos; ) {
+            auto eol = static_cast<char const*>(std::memchr(p, '\n', pos - p));
+            if (eol == nullptr)
+                break;
+            line++;
+            p = line_begin = eol + 1;
+        }
+        col = int(pos - line_begin);
+    }
+
     SourceLocation &SourceLocation::advance(uint32_t nchars)
     {
         advance_and_count(nchars);
@@ -25,11 +45,15 @@ namespace MYGL::Ast {
     {
         int ret = 0;
         while (ret < nchars && location < owner->length()) {
-            if (is_newline(*actual()))
-                line++, col = 0;
-            else
-                col++;
+            /* 行列号还没算 (line 为 0) 时只移动偏移 */
+            if (line != 0) {
+                if (is_newline(*actual()))
+                    line++, col = 0;
+                else
+                    col++;
+            }
             location++;
+            ret++;
         }
         return ret;
     }
@@ -1,5 +1,8 @@
 #include "myglc-lang/util/expr-indexer.hxx"
 #include "myglc-lang/code-visitors/expr-checker.hxx"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <format>
 #include <vector>
 
@@ -26,13 +29,135 @@ AstIndexerContext::AstIndexerContext(InitList::UnownedPtrT init_list,
     }
 }
 
+namespace {
+    /** 一趟展开初始化列表. 每一层记下本层子数组的起点和终点, 标量元素占一个偏移,
+     *  子列表占一整个子数组. */
+    class InitListFlattener {
+    public:
+        explicit InitListFlattener(SparseInitList &flat)
+            : _flat(flat) {}
+
+        void operator()(InitList *root)
+        {
+            _root = root;
+            size_t limit = _flat.dimension_list.empty() || _flat.dimension_list[0] != 0
+                         ? _flat.total : SIZE_MAX;
+            size_t end = flatten(root, 0, 0, limit);
+            if (limit == SIZE_MAX) {
+                /* 第一维省略了, 按写出来的元素个数向上取整到整行 */
+                size_t row = _flat.step_list.empty() ? 1 : _flat.step_list[0];
+                _flat.total = (end + row - 1) / row * row;
+            }
+        }
+    private:
+        SparseInitList &_flat;
+        InitList       *_root = nullptr;
+
+        static bool is_literal_zero(Expression *expr)
+        {
+            if (expr->node_type() == NodeType::INT_VALUE)
+                return static_cast<IntValue*>(expr)->get_value() == 0;
+            if (expr->node_type() == NodeType::FLOAT_VALUE)
+                return static_cast<FloatValue*>(expr)->get_value() == 0.0 &&
+                       !std::signbit(static_cast<FloatValue*>(expr)->get_value());
+            return false;
+        }
+
+        size_t flatten(InitList *list, size_t depth, size_t base, size_t limit)
+        {
+            size_t offset = base;
+            for (Expression *i: list->get_expr_list()) {
+                auto sublist = dynamic_cast<InitList*>(i);
+                if (sublist == nullptr) {
+                    if (offset >= limit)
+                        throw_overflow(list);
+                    if (!is_literal_zero(i))
+                        _flat.elements.push_back({offset, i});
+                    offset++;
+                    continue;
+                }
+                if (depth >= _flat.step_list.size()) {
+                    throw AstIndexerContext::BrokenListException(_root,
+                        std::format("initializer list at {} is nested too deep",
+                                    sublist->range().to_string()));
+                }
+                size_t step = _flat.step_list[depth];
+                if ((offset - base) % step != 0) {
+                    throw AstIndexerContext::BrokenListException(_root,
+                        std::format("requires a multiple of {} steps, but got {}\n",
+                                    step, offset - base));
+                }
+                if (offset + step > limit)
+                    throw_overflow(list);
+                flatten(sublist, depth + 1, offset, offset + step);
+                offset += step;
+            }
+            return offset;
+        }
+        [[noreturn]] void throw_overflow(InitList *list)
+        {
+            throw AstIndexerContext::BrokenListException(_root,
+                std::format("this dimension (at {}) overflow: \n```\n{}\n```\n",
+                            list->range().to_string(), list->range().get_content()));
+        }
+    }; // class InitListFlattener
+} // anonymous namespace
+
+Expression *SparseInitList::at(size_t offset) const
+{
+    auto it = std::lower_bound(elements.begin(), elements.end(), offset,
+        [](Element const &elem, size_t offset) { return elem.offset < offset; });
+    if (it == elements.end() || it->offset != offset)
+        return nullptr;
+    return it->expr;
+}
+
+bool SparseInitList::offset_of(std::vector<int> const &index_list, size_t &offset) const
+{
+    if (index_list.size() > step_list.size() ||
+        (!step_list.empty() && step_list[0] == 0))
+        return false;
+    size_t ret = 0;
+    for (size_t i = 0; i < index_list.size(); i++) {
+        size_t length = (i == 0 && dimension_list[0] == 0)
+                      ? total / step_list[0]
+                      : size_t(dimension_list[i]);
+        if (index_list[i] < 0 || size_t(index_list[i]) >= length)
+            return false;
+        ret += size_t(index_list[i]) * step_list[i];
+    }
+    offset = ret;
+    return true;
+}
+
+SparseInitList::PtrT
+SparseInitList::Get(InitList::UnownedPtrT init_list, std::vector<int> const &dimension_list)
+{
+    if (auto &cached = init_list->get_flattened();
+        cached != nullptr && cached->dimension_list == dimension_list)
+        return cached;
+
+    auto flat = std::make_shared<SparseInitList>();
+    flat->dimension_list = dimension_list;
+    flat->step_list.resize(dimension_list.size());
+    size_t total = 1;
+    for (size_t i = dimension_list.size(); i-- > 0;) {
+        flat->step_list[i] = total;
+        total *= size_t(std::max(dimension_list[i], 0));
+    }
+    flat->total = total;
+    InitListFlattener{*flat}(init_list);
+    init_list->set_flattened(flat);
+    return flat;
+}
+
 AstIndexerContext::Dependency
 AstIndexerContext::createDependency(Variable::UnownedPtrT array)
 {
     if (array == nullptr || !array->is_array_type())
         return {};
-    auto arr_info = array->get_array_info().get();
-    auto init_expr = array->get_init_expr().get();
+    auto arr_info = array->get_array_info();
+    auto init_expr = array->get_init_expr();
     auto init_list = dynamic_cast<InitList*>(init_expr);
     size_t dimension = arr_info->get_dimension();
     GenUtil::ExprChecker checker;
@@ -44,7 +169,7 @@ AstIndexerContext::createDependency(Variable::UnownedPtrT array)
     };
     for (int step = 0;
          auto &i: arr_info->get_array_info()) {
-        auto result = checker.do_try_calculate(i.get());
+        auto result = checker.do_try_calculate(i);
         if ((result == nullptr) ||
             (result->node_type() != Ast::NodeType::INT_VALUE))
             return {};
@@ -71,32 +196,11 @@ AstIndexer::AstIndexer(InitList::UnownedPtrT init_list,
     : AstIndexerContext(init_list, dimension_list, index_list) {
 }
 
-Expression::UnownedPtrT AstIndexer::do_calculate(InitList *node, int depth)
+Expression::UnownedPtrT AstIndexer::do_calculate()
 {
-    int ilist_step = step_list[depth];
-
-    for (auto &i: node->get_expr_list()) {
-        InitList *ilist = dynamic_cast<InitList*>(i.get());
-        if (ilist == nullptr) {
-            if (cur_step == max_step)
-                return i.get();
-            cur_step++;
-            continue;
-        }
-        if (cur_step % ilist_step != 0) {
-            throw BrokenListException(
-                init_list,
-                std::format(
-                    "requires a multiple of {} steps, but got {}\n",
-                    ilist_step, cur_step
-            ));
-        }
-        if (cur_step + ilist_step < max_step) {
-            cur_step += ilist_step;
-            continue;
-        }
-        return do_calculate(ilist, depth + 1);
-    }
+    SparseInitList::PtrT flat = SparseInitList::Get(init_list, dimension_list);
+    if (Expression *ret = flat->at(max_step); ret != nullptr)
+        return ret;
     result = std::make_shared<IntValue>(0);
     return result.get();
 }
@@ -110,7 +214,7 @@ void AstArrayFiller::do_init() {
     int ilist_step = step_list[0];
     total = 0;
     for (auto &i: init_list->get_expr_list()) {
-        InitList *ilist = dynamic_cast<InitList*>(i.get());
+        InitList *ilist = dynamic_cast<InitList*>(i);
         if (ilist == nullptr) {
             total++;
             continue;
@@ -126,7 +230,7 @@ void AstArrayFiller::do_init() {
         total += ilist_step;
     }
     auto &first_dimension = _array->get_array_info()->array_info()[0];
-    auto first_dimension_value = dynamic_cast<IntValue*>(first_dimension.get());
+    auto first_dimension_value = dynamic_cast<IntValue*>(first_dimension);
     if (first_dimension_value != nullptr) {
         first_dimension_value->value() = total / ilist_step;
     }
@@ -142,7 +246,6 @@ void AstArrayFiller::do_fill(InitList *current, int depth)
     int ilist_step = step_list[depth];
     int ldstep = 0; // level-dependent step
     int ldstep_max = (depth == 0) ? (total) : (step_list[depth - 1]);
-    auto &array_info = _array->get_array_info()->array_info();
     for (auto &i: current->get_expr_list()) {
         if (ldstep >= ilist_step) {
             throw BrokenListException(
@@ -153,7 +256,7 @@ void AstArrayFiller::do_fill(InitList *current, int depth)
                     current->range().get_content())
             );
         }
-        InitList *ilist = dynamic_cast<InitList*>(i.get());
+        InitList *ilist = dynamic_cast<InitList*>(i);
         if (ilist == nullptr) {
             expr_list.push_back(i);
             ldstep++;
@@ -170,8 +273,9 @@ void AstArrayFiller::do_fill(InitList *current, int depth)
         ldstep += ilist_step;
     }
 
+    /* 补齐的 0 由 result 持有, 只放进展开后的列表, 不挂到语法树上 */
     while (ldstep < ilist_step - 1) {
-        array_info[cur_step + ldstep] = result;
+        expr_list.push_back(result.get());
         ldstep++;
     }
 }
@@ -0,0 +1,76 @@
+#include "optimizers/FunctionPassManager.hxx"
+#include "base/mtb-arena.hxx"
+#include "base/mtb-exception.hxx"
+#include "base/mtb-thread-pool.hxx"
+#include <algorithm>
+#include <atomic>
+
+namespace MYGL::Optimizers {
+
+using namespace MYGL::IR;
+
+FunctionPassManager::FunctionPassManager(size_t nthreads)
+    : _nthreads(nthreads) {}
+
+FunctionPassManager &FunctionPassManager::addPass(FunctionPass::RefT pass)
+{
+    if (pass == nullptr) throw NullException {
+        "FunctionPassManager::addPass()::pass",
+        "", CURRENT_SRCLOC_F
+    };
+    _passes.push_back(std::move(pass));
+    return *this;
+}
+
+bool FunctionPassManager::runOnFunction(Function *fn)
+{
+    MTB::ArenaScope scope{fn->get_arena()};
+    bool changed = false;
+    for (FunctionPass::RefT &pass: _passes)
+        changed |= pass->runOnFunction(fn);
+    return changed;
+}
+
+size_t FunctionPassManager::run(Module *module)
+{
+    if (module == nullptr) throw NullException {
+        "FunctionPassManager::run()::module",
+        "", CURRENT_SRCLOC_F
+    };
+    /* 按名称排序, 让串行执行和调度顺序都不依赖 unordered_map 的遍历顺序 */
+    std::vector<Function*> fn_list;
+    fn_list.reserve(module->get_functions().size());
+    for (auto &[name, fn]: module->get_functions()) {
+        if (fn != nullptr && !fn->is_declaration())
+            fn_list.push_back(fn.get());
+    }
+    std::sort(fn_list.begin(), fn_list.end(),
+        [](Function *l, Function *r) { return l->get_name() < r->get_name(); });
+
+    size_t nthreads = _nthreads == 0 ? MTB::ThreadPool::DefaultConcurrency()
+                                     : _nthreads;
+    nthreads = std::min(nthreads, fn_list.size());
+#if __MTB_OBJECT_ATOMIC_REFCOUNT__ == 0
+    nthreads = 1;
+#endif
+    if (nthreads <= 1) {
+        size_t nchanged = 0;
+        for (Function *fn: fn_list)
+            nchanged += runOnFunction(fn);
+        return nchanged;
+    }
+
+    std::atomic_size_t nchanged{0};
+    Value::ConcurrentUseScope concurrent_uses;
+    MTB::ThreadPool pool{nthreads};
+    for (Function *fn: fn_list) {
+        pool.submit([this, fn, &nchanged]() {
+            if (runOnFunction(fn))
+                nchanged.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+    pool.wait();
+    return nchanged.load();
+}
+
+} // namespace MYGL::Optimizers
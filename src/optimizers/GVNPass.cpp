@@ -0,0 +1,194 @@
+#include "optimizers/GVNPass.hxx"
+#include "mygl-ir/ir-basicblock.hxx"
+#include "mygl-ir/ir-constant.hxx"
+#include "mygl-ir/ir-instruction.hxx"
+#include "mygl-ir/utils/irutil-dominance.hxx"
+#include "mygl-ir/utils/irutil-value-replace.hxx"
+#include <functional>
+#include <unordered_set>
+#include <vector>
+
+namespace MYGL::Optimizers {
+
+using namespace MYGL::IR;
+using IRUtil::DominatorTree;
+using OpCode = Instruction::OpCode;
+
+inline namespace gvn_impl {
+    static inline size_t gvn_hash_mix(size_t seed, size_t value)
+    {
+        return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+    }
+
+    /** 参与编号的指令: 没有副作用, 结果只取决于操作码、类型和操作数 */
+    static bool is_numberable(Instruction const *inst)
+    {
+        switch (inst->get_type_id()) {
+        case ValueTID::BINARY_SSA:
+        case ValueTID::COMPARE_SSA:
+        case ValueTID::CAST_SSA:
+        case ValueTID::GET_ELEM_PTR_SSA:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    /** 交换比较的左右操作数时对调条件里的 LT 和 GT, 其余的位不变 */
+    static uint32_t mirror_condition(uint32_t condition)
+    {
+        uint32_t ret = condition & ~uint32_t(CompareResult::NE);
+        if (condition & CompareResult::LT)
+            ret |= CompareResult::GT;
+        if (condition & CompareResult::GT)
+            ret |= CompareResult::LT;
+        return ret;
+    }
+
+    /** 除 GetElemPtrSSA 以外的表达式都至多有两个操作数, 规范形式如下:
+     *  满足交换律的运算和比较按指针大小排好左右操作数, 这样 `a + b` 和 `b + a`
+     *  的形式相同. 只比较规范形式是否相同, 指针的大小顺序不影响结果. */
+    struct SimpleForm {
+        uint32_t flags;
+        Value   *lhs, *rhs;
+
+        bool operator==(SimpleForm const &) const = default;
+    }; // struct SimpleForm
+
+    static SimpleForm simple_form(Instruction const *inst)
+    {
+        switch (inst->get_type_id()) {
+        case ValueTID::BINARY_SSA: {
+            auto binary = static_cast<BinarySSA const*>(inst);
+            Value *lhs = binary->get_lhs(), *rhs = binary->get_rhs();
+            if (binary->get_opcode().is_swappable() && std::less<Value*>()(rhs, lhs))
+                std::swap(lhs, rhs);
+            return {uint32_t(binary->get_sign_flag()), lhs, rhs};
+        }
+        case ValueTID::COMPARE_SSA: {
+            auto cmp = static_cast<CompareSSA const*>(inst);
+            Value   *lhs  = cmp->get_lhs(), *rhs = cmp->get_rhs();
+            uint32_t cond = CompareSSA::Condition::self_t(cmp->get_condition());
+            if (std::less<Value*>()(rhs, lhs)) {
+                std::swap(lhs, rhs);
+                cond = mirror_condition(cond);
+            }
+            return {cond, lhs, rhs};
+        }
+        default: /* CastSSA */
+            return {0, static_cast<CastSSA const*>(inst)->get_operand(), nullptr};
+        }
+    }
+
+    /** 表达式的哈希和相等. 表里存的就是代表指令自己, 键每次从指令上现算.
+     *  代表的操作数都支配它, 在它进表之前就已经编号完毕, 进表以后不会再变. */
+    struct ExprHasher {
+        size_t operator()(Instruction const *inst) const noexcept
+        {
+            size_t ret = std::hash<OpCode>()(inst->get_opcode());
+            ret = gvn_hash_mix(ret, std::hash<Type*>()(inst->get_value_type()));
+            if (inst->get_type_id() == ValueTID::GET_ELEM_PTR_SSA) {
+                auto gep = static_cast<GetElemPtrSSA const*>(inst);
+                ret = gvn_hash_mix(ret, std::hash<Value*>()(gep->get_collection()));
+                for (ValueUsePair const &index: gep->get_indexes())
+                    ret = gvn_hash_mix(ret, std::hash<Value*>()(index));
+                return ret;
+            }
+            SimpleForm form = simple_form(inst);
+            ret = gvn_hash_mix(ret, form.flags);
+            ret = gvn_hash_mix(ret, std::hash<Value*>()(form.lhs));
+            return gvn_hash_mix(ret, std::hash<Value*>()(form.rhs));
+        }
+    }; // struct ExprHasher
+
+    struct ExprEqual {
+        bool operator()(Instruction const *a, Instruction const *b) const noexcept
+        {
+            if (a == b)
+                return true;
+            if (a->get_opcode()     != b->get_opcode()      ||
+                a->get_value_type() != b->get_value_type()  ||
+                a->get_type_id()    != b->get_type_id())
+                return false;
+            if (a->get_type_id() != ValueTID::GET_ELEM_PTR_SSA)
+                return simple_form(a) == simple_form(b);
+
+            auto ga = static_cast<GetElemPtrSSA const*>(a);
+            auto gb = static_cast<GetElemPtrSSA const*>(b);
+            auto const &ia = ga->get_indexes(), &ib = gb->get_indexes();
+            if (ga->get_collection() != gb->get_collection() || ia.size() != ib.size())
+                return false;
+            for (size_t i = 0; i < ia.size(); i++) {
+                if (ia[i].value != ib[i].value)
+                    return false;
+            }
+            return true;
+        }
+    }; // struct ExprEqual
+
+    using ExprTableT = std::unordered_set<Instruction*, ExprHasher, ExprEqual>;
+
+    /** 沿支配树先序遍历. 进入一个块时它新增的代表记在 undo 里, 离开它的子树时
+     *  从表里摘掉, 所以表里始终只有支配当前块的那些表达式. */
+    static size_t number_function(DominatorTree const &tree)
+    {
+        ExprTableT table;
+        std::vector<Instruction*> undo;
+        std::vector<Instruction*> redundant;
+        size_t nremoved = 0;
+
+        struct Frame {
+            DominatorTree::BlockSpanT children;
+            size_t next;
+            size_t undo_mark;
+        }; // struct Frame
+        std::vector<Frame> stack;
+        auto enter = [&](BasicBlock *block) {
+            stack.push_back({tree.get_children(block), 0, undo.size()});
+            for (Instruction *inst: block->instruction_list()) {
+                if (!is_numberable(inst))
+                    continue;
+                auto [iter, inserted] = table.insert(inst);
+                if (inserted) {
+                    undo.push_back(inst);
+                    continue;
+                }
+                /* 同一块里后面的指令马上就会看到替换后的操作数 */
+                IRUtil::usee_replace_this_with(inst, *iter);
+                redundant.push_back(inst);
+            }
+            /* 遍历指令链表的时候不能删指令, 等这个块走完再删 */
+            for (Instruction *inst: redundant)
+                inst->removeThisIfUnused();
+            nremoved += redundant.size();
+            redundant.clear();
+        };
+
+        enter(tree.get_entry());
+        while (!stack.empty()) {
+            Frame &top = stack.back();
+            if (top.next < top.children.size()) {
+                enter(top.children[top.next++]);
+                continue;
+            }
+            while (undo.size() > top.undo_mark) {
+                table.erase(undo.back());
+                undo.pop_back();
+            }
+            stack.pop_back();
+        }
+        return nremoved;
+    }
+} // inline namespace gvn_impl
+
+/** @class GVNPass */
+
+bool GVNPass::runOnFunction(IR::Function *fn)
+{
+    DominatorTree::PtrT tree = DominatorTree::Get(fn);
+    return number_function(*tree) > 0;
+}
+
+/** end class GVNPass */
+
+} // namespace MYGL::Optimizers
@@ -0,0 +1,428 @@
+#include "optimizers/Mem2RegPass.hxx"
+#include "mygl-ir/ir-basicblock.hxx"
+#include "mygl-ir/ir-constant.hxx"
+#include "mygl-ir/utils/irutil-dominance.hxx"
+#include "mygl-ir/utils/irutil-value-replace.hxx"
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace MYGL::Optimizers {
+
+using namespace MYGL::IR;
+using IRUtil::DominatorTree;
+
+inline namespace mem2reg_impl {
+    /** 一个可提升 alloca 的全部读写. 不可达块里的读写单独放在 dead 里, 它们不参与
+     *  提升: 读到的一律是 undef, 写直接删掉. */
+    struct AllocaInfo {
+        AllocaSSA                *alloca = nullptr;
+        std::vector<LoadSSA*>     loads  = {};
+        std::vector<StoreSSA*>    stores = {};
+        std::vector<Instruction*> dead   = {};
+        owned<Value>              undef  = nullptr;
+
+        Value *get_undef() {
+            if (undef == nullptr)
+                undef = own<UndefinedConst>(alloca->get_element_type());
+            return undef;
+        }
+    }; // struct AllocaInfo
+
+    /** 检查 alloca 的每个使用者, info 不为 null 时顺便把读写登记进去 */
+    static bool collect_uses(AllocaSSA *alloca, AllocaInfo *info)
+    {
+        Type *elemty = alloca->get_element_type();
+        if (elemty == nullptr || !(elemty->is_value_type() || elemty->is_pointer_type()))
+            return false;
+        for (Use *use: alloca->get_list_as_usee()) {
+            User *user = use->get_user();
+            switch (user->get_type_id()) {
+            case ValueTID::LOAD_SSA: {
+                auto load = static_cast<LoadSSA*>(user);
+                if (load->get_parent() == nullptr)
+                    return false;
+                if (info != nullptr)
+                    info->loads.push_back(load);
+            }   break;
+            case ValueTID::STORE_SSA: {
+                /* 把 alloca 的地址存到别处也算逃逸 */
+                auto store = static_cast<StoreSSA*>(user);
+                if (store->get_target() != alloca || store->get_source() == alloca ||
+                    store->get_parent() == nullptr)
+                    return false;
+                if (info != nullptr)
+                    info->stores.push_back(store);
+            }   break;
+            default:
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /** 基本块内的指令序号. 第一次问到某个块时给整个块编号, 之后是查表. */
+    class InstIndexCache {
+    public:
+        uint32_t indexOf(Instruction *inst) {
+            auto iter = _index.find(inst);
+            if (iter != _index.end())
+                return iter->second;
+            uint32_t n = 0;
+            for (Instruction *i: inst->get_parent()->instruction_list())
+                _index.emplace(i, n++);
+            return _index.at(inst);
+        }
+    private:
+        std::unordered_map<Instruction const*, uint32_t> _index;
+    }; // class InstIndexCache
+
+    /** 唯一的一条 store 支配所有 load 时, 每个 load 读到的都是它存的值 */
+    static bool promote_single_store(AllocaInfo &info, DominatorTree const &tree,
+                                     InstIndexCache &index)
+    {
+        StoreSSA   *store       = info.stores.front();
+        BasicBlock *store_block = store->get_parent();
+        for (LoadSSA *load: info.loads) {
+            BasicBlock *block = load->get_parent();
+            if (block == store_block) {
+                if (index.indexOf(load) < index.indexOf(store))
+                    return false;
+            } else if (!tree.dominates(store_block, block)) {
+                return false;
+            }
+        }
+        for (LoadSSA *load: info.loads)
+            IRUtil::usee_replace_this_with(load, store->get_source());
+        return true;
+    }
+
+    /** 读写都在同一个块里时, 每个 load 读到的是它前面最近一条 store 存的值 */
+    static void promote_single_block(AllocaInfo &info, InstIndexCache &index)
+    {
+        std::vector<std::pair<uint32_t, StoreSSA*>> stores;
+        stores.reserve(info.stores.size());
+        for (StoreSSA *store: info.stores)
+            stores.push_back({index.indexOf(store), store});
+        std::sort(stores.begin(), stores.end());
+
+        for (LoadSSA *load: info.loads) {
+            uint32_t at = index.indexOf(load);
+            auto iter = std::partition_point(stores.begin(), stores.end(),
+                [at](auto const &s) { return s.first < at; });
+            Value *value = iter == stores.begin() ? info.get_undef()
+                                                  : std::prev(iter)->second->get_source();
+            IRUtil::usee_replace_this_with(load, value);
+        }
+    }
+
+    /** @class SSABuilder
+     * @brief 对走不了快速路径的 alloca 做标准的 SSA 构造 (Cytron 等人的算法).
+     *
+     * phi 只放在变量活跃进入的块上 (剪枝 SSA), 所以不会产生没人用的 phi. 重命名是
+     * 沿支配树的一趟先序遍历, 所有 alloca 共用; 每个 alloca 的"当前值"放在一个数组里,
+     * 离开子树时按撤销日志恢复, 不用给每个子结点复制一份. */
+    class SSABuilder {
+    public:
+        SSABuilder(DominatorTree const &tree, std::vector<AllocaInfo*> allocas)
+            : _tree(tree), _allocas(std::move(allocas)),
+              _block_phis(tree.get_nblocks()) {
+            for (uint32_t a = 0; a < _allocas.size(); a++)
+                _alloca_index.emplace(_allocas[a]->alloca, a);
+        }
+
+        void run(InstIndexCache &index) {
+            std::vector<uint32_t> live(_tree.get_nblocks(), 0);
+            std::vector<uint32_t> stamp(_tree.get_nblocks(), 0);
+            for (uint32_t a = 0; a < _allocas.size(); a++)
+                _placePhis(a, index, live, stamp);
+            _rename();
+            _fillUnreachableIncomings();
+            _removeTrivialPhis();
+        }
+    private:
+        using PhiListT = std::vector<std::pair<uint32_t, PhiSSA*>>;
+
+        DominatorTree const    &_tree;
+        std::vector<AllocaInfo*> _allocas;
+        std::unordered_map<Value const*, uint32_t> _alloca_index;
+        std::vector<PhiListT>    _block_phis; // 按块编号, 新放的 phi 以及它们对应的 alloca
+        PhiListT                 _all_phis;
+
+        /** 第 a 个 alloca 的活跃进入块和 phi 位置. live 和 stamp 是各个 alloca 共用的
+         *  标记数组, 用 a + 1 做时间戳, 省掉每次清空. */
+        void _placePhis(uint32_t a, InstIndexCache &index,
+                        std::vector<uint32_t> &live, std::vector<uint32_t> &stamp)
+        {
+            AllocaInfo &info = *_allocas[a];
+            uint32_t    mark = a + 1;
+
+            /* 定值块, 以及每个定值块里第一条 store 的位置 */
+            std::unordered_map<uint32_t, uint32_t> first_store;
+            std::vector<uint32_t> defs;
+            for (StoreSSA *store: info.stores) {
+                uint32_t b  = _tree.indexOf(store->get_parent());
+                uint32_t at = index.indexOf(store);
+                auto [iter, inserted] = first_store.emplace(b, at);
+                if (inserted)
+                    defs.push_back(b);
+                else
+                    iter->second = std::min(iter->second, at);
+            }
+
+            /* 活跃进入: 块里有一条 load 排在所有 store 前面, 再沿前驱往回传,
+             * 传到定值块为止 */
+            std::vector<uint32_t> worklist;
+            for (LoadSSA *load: info.loads) {
+                uint32_t b = _tree.indexOf(load->get_parent());
+                if (live[b] == mark)
+                    continue;
+                auto iter = first_store.find(b);
+                if (iter != first_store.end() && iter->second < index.indexOf(load))
+                    continue;
+                live[b] = mark;
+                worklist.push_back(b);
+            }
+            while (!worklist.empty()) {
+                uint32_t b = worklist.back();
+                worklist.pop_back();
+                for (BasicBlock::TargetInfo const &pred: _tree.blockAt(b)->get_comes_from()) {
+                    uint32_t p = _tree.indexOf(pred.target_block);
+                    if (p == DominatorTree::NPOS || live[p] == mark || first_store.contains(p))
+                        continue;
+                    live[p] = mark;
+                    worklist.push_back(p);
+                }
+            }
+
+            /* 迭代支配边界. 不活跃的块不放 phi, 也不会成为新的定值点 */
+            Type *elemty = info.alloca->get_element_type();
+            worklist = std::move(defs);
+            while (!worklist.empty()) {
+                uint32_t b = worklist.back();
+                worklist.pop_back();
+                for (BasicBlock *y: _tree.get_frontier(_tree.blockAt(b))) {
+                    uint32_t yi = _tree.indexOf(y);
+                    if (stamp[yi] == mark)
+                        continue;
+                    stamp[yi] = mark;
+                    /* 有回边指向入口时入口也在支配边界里, 但是入口不放 phi: 入口处
+                     * 活跃的 alloca 只能在入口块里, 每次回到入口都是新的存储单元,
+                     * 先读后写读到的本来就是 undef */
+                    if (live[yi] != mark || yi == 0)
+                        continue;
+                    owned<PhiSSA> phi = own<PhiSSA>(y, elemty);
+                    y->prepend(phi);
+                    _block_phis[yi].push_back({a, phi.get()});
+                    _all_phis.push_back({a, phi.get()});
+                    if (!first_store.contains(yi))
+                        worklist.push_back(yi);
+                }
+            }
+        }
+
+        void _rename()
+        {
+            std::vector<Value*> current(_allocas.size(), nullptr);
+            std::vector<std::pair<uint32_t, Value*>> undo;
+            auto define = [&current, &undo](uint32_t a, Value *value) {
+                undo.push_back({a, current[a]});
+                current[a] = value;
+            };
+            auto value_of = [this, &current](uint32_t a) {
+                return current[a] != nullptr ? current[a] : _allocas[a]->get_undef();
+            };
+            auto find_alloca = [this](Value *ptr) {
+                auto iter = _alloca_index.find(ptr);
+                return iter == _alloca_index.end() ? DominatorTree::NPOS : iter->second;
+            };
+
+            struct Frame {
+                DominatorTree::BlockSpanT children;
+                size_t next;
+                size_t undo_mark;
+            }; // struct Frame
+            std::vector<Frame> stack;
+            auto enter = [&](BasicBlock *block) {
+                stack.push_back({_tree.get_children(block), 0, undo.size()});
+                for (auto &[a, phi]: _block_phis[_tree.indexOf(block)])
+                    define(a, phi);
+
+                for (Instruction *inst: block->instruction_list()) {
+                    if (inst->get_type_id() == ValueTID::LOAD_SSA) {
+                        auto load = static_cast<LoadSSA*>(inst);
+                        if (uint32_t a = find_alloca(load->get_operand()); a != DominatorTree::NPOS)
+                            IRUtil::usee_replace_this_with(load, value_of(a));
+                    } else if (inst->get_type_id() == ValueTID::STORE_SSA) {
+                        auto store = static_cast<StoreSSA*>(inst);
+                        if (uint32_t a = find_alloca(store->get_target()); a != DominatorTree::NPOS)
+                            define(a, store->get_source());
+                    }
+                }
+
+                IBasicBlockTerminator *terminator = block->get_terminator();
+                if (terminator == nullptr)
+                    return;
+                terminator->traverse_targets([&](BasicBlock *succ) {
+                    if (succ == nullptr)
+                        return false;
+                    for (auto &[a, phi]: _block_phis[_tree.indexOf(succ)])
+                        phi->setValueFrom(block, value_of(a));
+                    return false;
+                });
+            };
+
+            enter(_tree.get_entry());
+            while (!stack.empty()) {
+                Frame &top = stack.back();
+                if (top.next < top.children.size()) {
+                    enter(top.children[top.next++]);
+                    continue;
+                }
+                while (undo.size() > top.undo_mark) {
+                    current[undo.back().first] = undo.back().second;
+                    undo.pop_back();
+                }
+                stack.pop_back();
+            }
+        }
+
+        /** phi 所在块的不可达前驱也要有入口, 给 undef */
+        void _fillUnreachableIncomings()
+        {
+            for (auto &[a, phi]: _all_phis) {
+                for (BasicBlock::TargetInfo const &pred: phi->get_parent()->get_comes_from()) {
+                    if (!_tree.is_reachable(pred.target_block))
+                        phi->setValueFrom(pred.target_block, _allocas[a]->get_undef());
+                }
+            }
+        }
+
+        /** 删掉所有可达入口都是同一个值(或者自己)的 phi, 直到不再变化 */
+        void _removeTrivialPhis()
+        {
+            bool changed = true;
+            while (changed) {
+                changed = false;
+                for (auto &[a, phi]: _all_phis) {
+                    if (phi == nullptr)
+                        continue;
+                    Value *same    = nullptr;
+                    bool   trivial = true;
+                    for (auto &[from, vupair]: phi->get_operands()) {
+                        Value *value = vupair.value.get();
+                        if (!_tree.is_reachable(from) || value == phi || value == same)
+                            continue;
+                        if (same != nullptr) {
+                            trivial = false;
+                            break;
+                        }
+                        same = value;
+                    }
+                    if (!trivial)
+                        continue;
+                    IRUtil::usee_replace_this_with(phi, same != nullptr ? same
+                                                        : _allocas[a]->get_undef());
+                    phi->removeThisIfUnused();
+                    phi     = nullptr;
+                    changed = true;
+                }
+            }
+        }
+    }; // class SSABuilder
+
+    /** 提升完成以后删掉 alloca 和它的所有读写. load 的使用者都已经换掉了.
+     *  删除只是尽力而为, 返回 alloca 是否真的删掉了. */
+    static bool erase_promoted(AllocaInfo &info)
+    {
+        for (LoadSSA *load: info.loads)
+            load->removeThisIfUnused();
+        for (StoreSSA *store: info.stores)
+            store->removeThisIfUnused();
+        for (Instruction *inst: info.dead)
+            inst->removeThisIfUnused();
+        return info.alloca->removeThisIfUnused() != nullptr;
+    }
+
+    /** 提升一轮. 提升以后原先存着 alloca 地址的变量没了, 可能又有 alloca 变得可提升.
+     *  返回这一轮是否删掉了至少一个 alloca: 一个都没删掉时再来一轮还是同样的结果. */
+    static bool promote_round(Function *fn)
+    {
+        std::vector<AllocaInfo> allocas;
+        for (BasicBlock *block: fn->body()) {
+            for (Instruction *inst: block->instruction_list()) {
+                if (inst->get_type_id() != ValueTID::ALLOCA_SSA)
+                    continue;
+                AllocaInfo info{static_cast<AllocaSSA*>(inst)};
+                if (collect_uses(info.alloca, &info))
+                    allocas.push_back(std::move(info));
+            }
+        }
+        if (allocas.empty())
+            return false;
+
+        DominatorTree::PtrT tree = DominatorTree::Get(fn);
+        InstIndexCache index;
+        std::vector<AllocaInfo*> rest;
+        for (AllocaInfo &info: allocas) {
+            /* 不可达块里的读写先摘出去 */
+            auto unreachable = [&tree](Instruction *inst) {
+                return !tree->is_reachable(inst->get_parent());
+            };
+            for (LoadSSA *load: info.loads) {
+                if (unreachable(load)) {
+                    IRUtil::usee_replace_this_with(load, info.get_undef());
+                    info.dead.push_back(load);
+                }
+            }
+            for (StoreSSA *store: info.stores) {
+                if (unreachable(store))
+                    info.dead.push_back(store);
+            }
+            std::erase_if(info.loads,  unreachable);
+            std::erase_if(info.stores, unreachable);
+
+            if (info.loads.empty())
+                continue;
+            if (info.stores.size() == 1 && promote_single_store(info, *tree, index))
+                continue;
+
+            BasicBlock *block = info.loads.front()->get_parent();
+            bool single_block =
+                std::all_of(info.loads.begin(), info.loads.end(),
+                            [block](LoadSSA *i)  { return i->get_parent() == block; }) &&
+                std::all_of(info.stores.begin(), info.stores.end(),
+                            [block](StoreSSA *i) { return i->get_parent() == block; });
+            if (single_block)
+                promote_single_block(info, index);
+            else
+                rest.push_back(&info);
+        }
+        if (!rest.empty())
+            SSABuilder{*tree, std::move(rest)}.run(index);
+
+        bool removed = false;
+        for (AllocaInfo &info: allocas)
+            removed |= erase_promoted(info);
+        return removed;
+    }
+} // inline namespace mem2reg_impl
+
+/** @class Mem2RegPass */
+
+bool Mem2RegPass::isPromotable(AllocaSSA *alloca)
+{
+    return alloca != nullptr && collect_uses(alloca, nullptr);
+}
+
+bool Mem2RegPass::runOnFunction(Function *fn)
+{
+    bool changed = false;
+    while (promote_round(fn))
+        changed = true;
+    return changed;
+}
+
+/** end class Mem2RegPass */
+
+} // namespace MYGL::Optimizers
@@ -0,0 +1,650 @@
+#include "optimizers/SCCPPass.hxx"
+#include "mygl-ir/ir-basicblock.hxx"
+#include "mygl-ir/ir-constant.hxx"
+#include "mygl-ir/ir-instruction.hxx"
+#include "mygl-ir/utils/irutil-basicblock.hxx"
+#include "mygl-ir/utils/irutil-function.hxx"
+#include "mygl-ir/utils/irutil-value-replace.hxx"
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace MYGL::Optimizers {
+
+using namespace MYGL::IR;
+using OpCode = Instruction::OpCode;
+
+inline namespace sccp_impl {
+    /** 格值. 只会往下走: UNDEFINED -> CONSTANT -> OVERDEFINED.
+     *  常量不由格值持有: 指令操作数里的常量由指令持有, 折叠出来的新常量
+     *  由 SCCPSolver 持有. */
+    struct LatticeCell {
+        enum State: uint8_t {
+            UNDEFINED, CONSTANT, OVERDEFINED
+        }; // enum State
+        State         state = UNDEFINED;
+        ConstantData *value = nullptr;
+
+        static LatticeCell Constant(ConstantData *value) { return {CONSTANT, value}; }
+        static LatticeCell Overdefined() { return {OVERDEFINED, nullptr}; }
+    }; // struct LatticeCell
+
+    static bool same_constant(ConstantData *a, ConstantData *b)
+    {
+        if (a == b)
+            return true;
+        if (a->get_value_type() != b->get_value_type() ||
+            a->get_type_id()    != b->get_type_id())
+            return false;
+        if (a->get_type_id() == ValueTID::INT_CONST) {
+            return static_cast<IntConst*>(a)->get_value().equals(
+                   static_cast<IntConst*>(b)->get_value());
+        }
+        /* 浮点按位模式比较, 和常量驻留的规则一致 */
+        double da = static_cast<FloatConst*>(a)->get_value();
+        double db = static_cast<FloatConst*>(b)->get_value();
+        return std::memcmp(&da, &db, sizeof(double)) == 0;
+    }
+
+    /** 格上的交 */
+    static LatticeCell meet(LatticeCell const &a, LatticeCell const &b)
+    {
+        if (a.state == LatticeCell::UNDEFINED)
+            return b;
+        if (b.state == LatticeCell::UNDEFINED)
+            return a;
+        if (a.state == LatticeCell::CONSTANT && b.state == LatticeCell::CONSTANT &&
+            same_constant(a.value, b.value))
+            return a;
+        return LatticeCell::Overdefined();
+    }
+
+    static bool is_int_const(Value *value) {
+        return value->get_type_id() == ValueTID::INT_CONST;
+    }
+    static bool is_float_const(Value *value) {
+        return value->get_type_id() == ValueTID::FLOAT_CONST;
+    }
+    static APInt int_value_of(ConstantData *value) {
+        return static_cast<IntConst*>(value)->get_value();
+    }
+    static double float_value_of(ConstantData *value) {
+        return static_cast<FloatConst*>(value)->get_value();
+    }
+
+    /** FloatConst 统一存 double, 单精度的结果要先舍入到 float */
+    static owned<ConstantData> make_float(Type *type, double value)
+    {
+        auto floatty = static_cast<FloatType*>(type);
+        if (floatty->get_binary_bits() <= 32)
+            value = double(float(value));
+        return FloatConst::Create(floatty, value);
+    }
+
+    /* ================ [常量折叠] ================ *
+     * 整数运算在 64 位上做, 结果交给 IntConst::Create 截断到目标位宽.
+     * 返回 null 表示不能折叠: 操作码不认识, 或者结果未定义. */
+
+    static owned<ConstantData>
+    fold_int_binary(OpCode opcode, IntType *type, APInt lhs, APInt rhs)
+    {
+        size_t   bits = type->get_binary_bits();
+        uint64_t a  = lhs.get_unsigned_value(), b  = rhs.get_unsigned_value();
+        int64_t  sa = lhs.get_signed_value(),   sb = rhs.get_signed_value();
+        int64_t  smin = bits >= 64 ? INT64_MIN : -(int64_t(1) << (bits - 1));
+        uint64_t ret;
+        switch (opcode) {
+        case OpCode::ADD: ret = a + b; break;
+        case OpCode::SUB: ret = a - b; break;
+        case OpCode::MUL: ret = a * b; break;
+        case OpCode::SDIV:
+            if (sb == 0 || (sa == smin && sb == -1))
+                return nullptr;
+            ret = uint64_t(sa / sb);
+            break;
+        case OpCode::SREM:
+            if (sb == 0 || (sa == smin && sb == -1))
+                return nullptr;
+            ret = uint64_t(sa % sb);
+            break;
+        case OpCode::UDIV:
+            if (b == 0)
+                return nullptr;
+            ret = a / b;
+            break;
+        case OpCode::UREM:
+            if (b == 0)
+                return nullptr;
+            ret = a % b;
+            break;
+        case OpCode::AND: ret = a & b; break;
+        case OpCode::OR:  ret = a | b; break;
+        case OpCode::XOR: ret = a ^ b; break;
+        case OpCode::SHL:
+            if (b >= bits)
+                return nullptr;
+            ret = a << b;
+            break;
+        case OpCode::LSHR:
+            if (b >= bits)
+                return nullptr;
+            ret = a >> b;
+            break;
+        case OpCode::ASHR:
+            if (b >= bits)
+                return nullptr;
+            ret = uint64_t(sa >> b);
+            break;
+        default:
+            return nullptr;
+        }
+        return IntConst::Create(type, int64_t(ret));
+    }
+
+    static owned<ConstantData>
+    fold_float_binary(OpCode opcode, Type *type, double a, double b)
+    {
+        switch (opcode) {
+        case OpCode::ADD: case OpCode::FADD: return make_float(type, a + b);
+        case OpCode::SUB: case OpCode::FSUB: return make_float(type, a - b);
+        case OpCode::MUL: case OpCode::FMUL: return make_float(type, a * b);
+        case OpCode::FDIV: return make_float(type, a / b);
+        case OpCode::FREM: return make_float(type, std::fmod(a, b));
+        default:
+            return nullptr;
+        }
+    }
+
+    static owned<ConstantData>
+    fold_binary(BinarySSA *inst, ConstantData *lhs, ConstantData *rhs)
+    {
+        Type *type = inst->get_value_type();
+        if (type->is_integer_type() && is_int_const(lhs) && is_int_const(rhs)) {
+            return fold_int_binary(inst->get_opcode(), static_cast<IntType*>(type),
+                                   int_value_of(lhs), int_value_of(rhs));
+        }
+        if (type->is_float_type() && is_float_const(lhs) && is_float_const(rhs)) {
+            return fold_float_binary(inst->get_opcode(), type,
+                                     float_value_of(lhs), float_value_of(rhs));
+        }
+        return nullptr;
+    }
+
+    static owned<ConstantData>
+    fold_compare(CompareSSA *inst, ConstantData *lhs, ConstantData *rhs)
+    {
+        CompareSSA::Condition cond = inst->get_condition();
+        CompareResult relation;
+        if (cond.is_float_op()) {
+            if (!is_float_const(lhs) || !is_float_const(rhs))
+                return nullptr;
+            double a = float_value_of(lhs), b = float_value_of(rhs);
+            /* 有 NaN 时: 有序比较恒假, 无序比较恒真 */
+            if (std::isnan(a) || std::isnan(b))
+                return cond.is_ordered() ? IntConst::BooleanFalse() : IntConst::BooleanTrue();
+            relation = a < b ? CompareResult::LT : (a == b ? CompareResult::EQ : CompareResult::GT);
+        } else {
+            if (!is_int_const(lhs) || !is_int_const(rhs))
+                return nullptr;
+            APInt a = int_value_of(lhs), b = int_value_of(rhs);
+            if (cond.is_signed()) {
+                int64_t sa = a.get_signed_value(), sb = b.get_signed_value();
+                relation = sa < sb ? CompareResult::LT : (sa == sb ? CompareResult::EQ : CompareResult::GT);
+            } else {
+                uint64_t ua = a.get_unsigned_value(), ub = b.get_unsigned_value();
+                relation = ua < ub ? CompareResult::LT : (ua == ub ? CompareResult::EQ : CompareResult::GT);
+            }
+        }
+        /* 条件是 CompareResult 的位掩码, 实际关系落在掩码里就为真 */
+        bool result = (relation & cond.get_compare_result()) != 0;
+        return result ? IntConst::BooleanTrue() : IntConst::BooleanFalse();
+    }
+
+    static owned<ConstantData> fold_cast(CastSSA *inst, ConstantData *operand)
+    {
+        Type  *type   = inst->get_value_type();
+        OpCode opcode = inst->get_opcode();
+        if (type->is_integer_type()) {
+            auto intty = static_cast<IntType*>(type);
+            if (opcode == OpCode::FTOI) {
+                if (!is_float_const(operand))
+                    return nullptr;
+                /* 截断后超出目标类型范围的结果未定义 */
+                double value = std::trunc(float_value_of(operand));
+                double limit = std::ldexp(1.0, int(intty->get_binary_bits()) - 1);
+                if (!(value >= -limit && value < limit))
+                    return nullptr;
+                return IntConst::Create(intty, int64_t(value));
+            }
+            if (!is_int_const(operand))
+                return nullptr;
+            APInt value = int_value_of(operand);
+            switch (opcode) {
+            case OpCode::ZEXT: case OpCode::TRUNC:
+                return IntConst::Create(intty, int64_t(value.get_unsigned_value()));
+            case OpCode::SEXT:
+                return IntConst::Create(intty, value.get_signed_value());
+            default:
+                return nullptr;
+            }
+        }
+        if (type->is_float_type()) {
+            switch (opcode) {
+            case OpCode::ITOF:
+                if (!is_int_const(operand))
+                    return nullptr;
+                return make_float(type, double(int_value_of(operand).get_signed_value()));
+            case OpCode::UTOF:
+                if (!is_int_const(operand))
+                    return nullptr;
+                return make_float(type, double(int_value_of(operand).get_unsigned_value()));
+            case OpCode::FPEXT: case OpCode::FPTRUNC:
+                if (!is_float_const(operand))
+                    return nullptr;
+                return make_float(type, float_value_of(operand));
+            default:
+                return nullptr;
+            }
+        }
+        return nullptr;
+    }
+
+    static owned<ConstantData> fold_unary(UnaryOperationSSA *inst, ConstantData *operand)
+    {
+        Type *type = inst->get_value_type();
+        switch (inst->get_opcode()) {
+        case OpCode::INEG:
+            if (!type->is_integer_type() || !is_int_const(operand))
+                return nullptr;
+            return IntConst::Create(static_cast<IntType*>(type),
+                        int64_t(0 - int_value_of(operand).get_unsigned_value()));
+        case OpCode::NOT:
+            if (!type->is_integer_type() || !is_int_const(operand))
+                return nullptr;
+            return IntConst::Create(static_cast<IntType*>(type),
+                        int64_t(~int_value_of(operand).get_unsigned_value()));
+        case OpCode::FNEG:
+            if (!type->is_float_type() || !is_float_const(operand))
+                return nullptr;
+            return make_float(type, -float_value_of(operand));
+        default:
+            return nullptr;
+        }
+    }
+
+    /** @class SCCPSolver
+     * @brief 一次 SCCP 的全部状态. 指令和基本块先编好号, 之后格值、可执行标记
+     *        都是按编号下标的数组. */
+    class SCCPSolver {
+    public:
+        explicit SCCPSolver(IR::Function *fn): _function(fn) {
+            for (BasicBlock *block: fn->body()) {
+                _block_index.emplace(block, uint32_t(_blocks.size()));
+                _blocks.push_back(block);
+                for (Instruction *inst: block->instruction_list())
+                    _inst_index.emplace(inst, uint32_t(_inst_index.size()));
+            }
+            _executable.assign(_blocks.size(), false);
+            _cells.resize(_inst_index.size());
+        }
+
+        void solve()
+        {
+            _markExecutable(_function->get_entry());
+            do {
+                while (!_block_worklist.empty() || !_ssa_worklist.empty()) {
+                    while (!_ssa_worklist.empty()) {
+                        Instruction *inst = _ssa_worklist.back();
+                        _ssa_worklist.pop_back();
+                        _visitUsers(inst);
+                    }
+                    while (!_block_worklist.empty()) {
+                        BasicBlock *block = _block_worklist.back();
+                        _block_worklist.pop_back();
+                        for (Instruction *inst: block->instruction_list())
+                            _visit(inst);
+                    }
+                }
+            } while (_resolveUndefinedBranches());
+        }
+
+        bool rewrite()
+        {
+            bool changed = false;
+
+            /* 1. 格值是常量的指令换成常量 */
+            std::vector<Instruction*> folded;
+            for (uint32_t b = 0; b < _blocks.size(); b++) {
+                if (!_executable[b])
+                    continue;
+                for (Instruction *inst: _blocks[b]->instruction_list()) {
+                    if (_cellOf(inst).state == LatticeCell::CONSTANT)
+                        folded.push_back(inst);
+                }
+            }
+            for (Instruction *inst: folded) {
+                IRUtil::usee_replace_this_with(inst, _cellOf(inst).value);
+                inst->removeThisIfUnused();
+                changed = true;
+            }
+
+            /* 2. 只有一个可执行后继的条件跳转换成无条件跳转 */
+            for (uint32_t b = 0; b < _blocks.size(); b++) {
+                if (_executable[b])
+                    changed |= _foldTerminator(_blocks[b]);
+            }
+
+            /* 3. 删掉走不到的块 */
+            changed |= IRUtil::Function::gc_mark_sweep(_function) > 0;
+            return changed;
+        }
+    private:
+        IR::Function *_function;
+        std::vector<BasicBlock*> _blocks;
+        std::unordered_map<BasicBlock const*,  uint32_t> _block_index;
+        std::unordered_map<Value const*,       uint32_t> _inst_index;
+        std::vector<LatticeCell> _cells;
+        std::vector<bool>        _executable;
+        std::unordered_set<uint64_t> _feasible_edges;
+        std::vector<owned<ConstantData>> _folded; // 折叠出来的常量, 求解期间一直持有
+
+        std::vector<BasicBlock*>  _block_worklist; // 新变成可执行的块
+        std::vector<Instruction*> _ssa_worklist;   // 格值下降了的指令
+
+        uint64_t _edgeKey(BasicBlock *from, BasicBlock *to) const {
+            return (uint64_t(_block_index.at(from)) << 32) | _block_index.at(to);
+        }
+        bool _isFeasible(BasicBlock *from, BasicBlock *to) const {
+            return _feasible_edges.contains(_edgeKey(from, to));
+        }
+        bool _isExecutable(BasicBlock *block) const {
+            auto iter = _block_index.find(block);
+            return iter != _block_index.end() && _executable[iter->second];
+        }
+
+        /** 函数里的指令查表; 整数和浮点常量是它们自己; 其余的值(参数、全局量、
+         *  undef 等)一律不是常量. */
+        LatticeCell _cellOf(Value *value) const
+        {
+            auto iter = _inst_index.find(value);
+            if (iter != _inst_index.end())
+                return _cells[iter->second];
+            if (is_int_const(value) || is_float_const(value))
+                return LatticeCell::Constant(static_cast<ConstantData*>(value));
+            return LatticeCell::Overdefined();
+        }
+
+        void _update(Instruction *inst, LatticeCell const &cell)
+        {
+            LatticeCell &old = _cells[_inst_index.at(inst)];
+            LatticeCell  now = meet(old, cell);
+            if (now.state == old.state)
+                return;
+            old = std::move(now);
+            _ssa_worklist.push_back(inst);
+        }
+
+        void _markExecutable(BasicBlock *block)
+        {
+            uint32_t index = _block_index.at(block);
+            if (_executable[index])
+                return;
+            _executable[index] = true;
+            _block_worklist.push_back(block);
+        }
+        void _markEdge(BasicBlock *from, BasicBlock *to)
+        {
+            if (!_feasible_edges.insert(_edgeKey(from, to)).second)
+                return;
+            if (!_executable[_block_index.at(to)]) {
+                _markExecutable(to);
+                return;
+            }
+            /* 已经可执行的块多了一条入边, 只有 phi 需要重新合并 */
+            for (Instruction *inst: to->instruction_list()) {
+                if (inst->get_type_id() != ValueTID::PHI_SSA)
+                    break;
+                _visitPhi(static_cast<PhiSSA*>(inst));
+            }
+        }
+        void _markAllTargets(BasicBlock *block)
+        {
+            block->get_terminator()->traverse_targets([this, block](BasicBlock *target) {
+                if (target != nullptr)
+                    _markEdge(block, target);
+                return false;
+            });
+        }
+
+        void _visitUsers(Instruction *inst)
+        {
+            for (Use *use: inst->get_list_as_usee()) {
+                User *user = use->get_user();
+                if (!_inst_index.contains(user))
+                    continue;
+                auto user_inst = static_cast<Instruction*>(user);
+                if (_isExecutable(user_inst->get_parent()))
+                    _visit(user_inst);
+            }
+        }
+
+        void _visit(Instruction *inst)
+        {
+            switch (inst->get_type_id()) {
+            case ValueTID::PHI_SSA:
+                _visitPhi(static_cast<PhiSSA*>(inst));
+                break;
+            case ValueTID::BINARY_SSA: {
+                auto binary = static_cast<BinarySSA*>(inst);
+                _visitFoldable(inst, {binary->get_lhs(), binary->get_rhs()},
+                    [binary](ConstantData **c) { return fold_binary(binary, c[0], c[1]); });
+            }   break;
+            case ValueTID::COMPARE_SSA: {
+                auto cmp = static_cast<CompareSSA*>(inst);
+                _visitFoldable(inst, {cmp->get_lhs(), cmp->get_rhs()},
+                    [cmp](ConstantData **c) { return fold_compare(cmp, c[0], c[1]); });
+            }   break;
+            case ValueTID::CAST_SSA: {
+                auto cast = static_cast<CastSSA*>(inst);
+                _visitFoldable(inst, {cast->get_operand()},
+                    [cast](ConstantData **c) { return fold_cast(cast, c[0]); });
+            }   break;
+            case ValueTID::UNARY_OP_SSA: {
+                auto unary = static_cast<UnaryOperationSSA*>(inst);
+                _visitFoldable(inst, {unary->get_operand()},
+                    [unary](ConstantData **c) { return fold_unary(unary, c[0]); });
+            }   break;
+            case ValueTID::BINARY_SELECT_SSA:
+                _visitSelect(static_cast<BinarySelectSSA*>(inst));
+                break;
+            case ValueTID::JUMP_SSA:
+                _markEdge(inst->get_parent(), static_cast<JumpSSA*>(inst)->get_target());
+                break;
+            case ValueTID::BRANCH_SSA:
+                _visitBranch(static_cast<BranchSSA*>(inst));
+                break;
+            case ValueTID::SWITCH_SSA:
+                _visitSwitch(static_cast<SwitchSSA*>(inst));
+                break;
+            default:
+                /* 读内存、调用和其他不认识的指令 */
+                _update(inst, LatticeCell::Overdefined());
+                break;
+            }
+        }
+
+        void _visitPhi(PhiSSA *phi)
+        {
+            BasicBlock *block  = phi->get_parent();
+            LatticeCell merged;
+            for (auto &[from, vupair]: phi->get_operands()) {
+                Value *value = vupair.value.get();
+                if (value == nullptr || !_isFeasible(from, block))
+                    continue;
+                /* undef 可以取任何值, 所以不妨取其他入口的那个常量 */
+                ValueTID tid = value->get_type_id();
+                if (tid == ValueTID::UNDEFINED || tid == ValueTID::POISON)
+                    continue;
+                merged = meet(merged, _cellOf(value));
+                if (merged.state == LatticeCell::OVERDEFINED)
+                    break;
+            }
+            _update(phi, merged);
+        }
+
+        template<typename FoldT>
+        void _visitFoldable(Instruction *inst, std::initializer_list<Value*> operands, FoldT fold)
+        {
+            ConstantData *constants[2];
+            LatticeCell   cells[2];
+            size_t        n = 0;
+            for (Value *operand: operands) {
+                cells[n] = _cellOf(operand);
+                if (cells[n].state == LatticeCell::OVERDEFINED) {
+                    _update(inst, LatticeCell::Overdefined());
+                    return;
+                }
+                constants[n] = cells[n].value;
+                n++;
+            }
+            for (size_t i = 0; i < n; i++) {
+                if (cells[i].state == LatticeCell::UNDEFINED)
+                    return;
+            }
+            owned<ConstantData> result = fold(constants);
+            if (result == nullptr) {
+                _update(inst, LatticeCell::Overdefined());
+                return;
+            }
+            _update(inst, LatticeCell::Constant(result));
+            if (_cellOf(inst).value == result.get())
+                _folded.push_back(std::move(result));
+        }
+
+        void _visitSelect(BinarySelectSSA *select)
+        {
+            LatticeCell cond = _cellOf(select->get_condition());
+            switch (cond.state) {
+            case LatticeCell::UNDEFINED:
+                return;
+            case LatticeCell::CONSTANT:
+                _update(select, _cellOf(cond.value->is_zero() ? select->get_if_false()
+                                                              : select->get_if_true()));
+                return;
+            default:
+                _update(select, meet(_cellOf(select->get_if_true()),
+                                     _cellOf(select->get_if_false())));
+                return;
+            }
+        }
+
+        void _visitBranch(BranchSSA *br)
+        {
+            LatticeCell cond = _cellOf(br->get_condition());
+            switch (cond.state) {
+            case LatticeCell::UNDEFINED:
+                return;
+            case LatticeCell::CONSTANT:
+                _markEdge(br->get_parent(), cond.value->is_zero() ? br->get_if_false()
+                                                                  : br->get_if_true());
+                return;
+            default:
+                _markAllTargets(br->get_parent());
+                return;
+            }
+        }
+
+        void _visitSwitch(SwitchSSA *sw)
+        {
+            LatticeCell cond = _cellOf(sw->get_condition());
+            if (cond.state == LatticeCell::UNDEFINED)
+                return;
+            if (cond.state == LatticeCell::OVERDEFINED || !is_int_const(cond.value)) {
+                _markAllTargets(sw->get_parent());
+                return;
+            }
+            /* case 的键可能按有符号也可能按无符号写 (i1 的 true 有符号是 -1), 两种都查 */
+            auto const &cases = sw->get_cases();
+            APInt value = int_value_of(cond.value);
+            auto  iter  = cases.find(value.get_signed_value());
+            if (iter == cases.end())
+                iter = cases.find(int64_t(value.get_unsigned_value()));
+            _markEdge(sw->get_parent(), iter == cases.end() ? sw->get_default_target()
+                                                            : iter->second.target);
+        }
+
+        /** 求解收敛以后, 可执行块里还可能有条件始终未定的 br/switch (条件只来自
+         *  undef). 这时保守地认为所有后继都可执行, 再接着求解.
+         * @return 有没有新的可执行边 */
+        bool _resolveUndefinedBranches()
+        {
+            size_t nedges = _feasible_edges.size();
+            for (uint32_t b = 0; b < _blocks.size(); b++) {
+                if (!_executable[b])
+                    continue;
+                Instruction *terminator = _blocks[b]->get_terminator()->get_instance();
+                Value *cond = nullptr;
+                if (terminator->get_type_id() == ValueTID::BRANCH_SSA)
+                    cond = static_cast<BranchSSA*>(terminator)->get_condition();
+                else if (terminator->get_type_id() == ValueTID::SWITCH_SSA)
+                    cond = static_cast<SwitchSSA*>(terminator)->get_condition();
+                if (cond != nullptr && _cellOf(cond).state == LatticeCell::UNDEFINED)
+                    _markAllTargets(_blocks[b]);
+            }
+            return _feasible_edges.size() != nedges;
+        }
+
+        bool _foldTerminator(BasicBlock *block)
+        {
+            Instruction *terminator = block->get_terminator()->get_instance();
+            ValueTID     tid        = terminator->get_type_id();
+            if (tid != ValueTID::BRANCH_SSA && tid != ValueTID::SWITCH_SSA)
+                return false;
+
+            std::vector<BasicBlock*> targets;
+            BasicBlock *taken  = nullptr;
+            bool        unique = true;
+            block->get_terminator()->traverse_targets([&](BasicBlock *target) {
+                if (target == nullptr)
+                    return false;
+                targets.push_back(target);
+                if (_isFeasible(block, target)) {
+                    unique &= (taken == nullptr || taken == target);
+                    taken   = target;
+                }
+                return false;
+            });
+            if (taken == nullptr || !unique)
+                return false;
+
+            for (BasicBlock *target: targets) {
+                if (target == taken)
+                    continue;
+                for (Instruction *inst: target->instruction_list()) {
+                    if (inst->get_type_id() != ValueTID::PHI_SSA)
+                        break;
+                    auto phi = static_cast<PhiSSA*>(inst);
+                    if (phi->get_operands().contains(block))
+                        phi->remove(block);
+                }
+            }
+            IRUtil::BasicBlock::replace_terminator(block, JumpSSA::Create(block, taken));
+            return true;
+        }
+    }; // class SCCPSolver
+} // inline namespace sccp_impl
+
+/** @class SCCPPass */
+
+bool SCCPPass::runOnFunction(IR::Function *fn)
+{
+    SCCPSolver solver{fn};
+    solver.solve();
+    return solver.rewrite();
+}
+
+/** end class SCCPPass */
+
+} // namespace MYGL::Optimizers
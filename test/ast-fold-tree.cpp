@@ -0,0 +1,79 @@
+/** @file ast-fold-tree.cpp
+ * @brief ExprChecker::fold_tree() 和折叠结果记忆化的回归测试.
+ *
+ * 返回 0 表示全部通过, 否则是失败的检查个数. */
+#include "myglc-lang/ast-code-context.hxx"
+#include "myglc-lang/ast-parser.hxx"
+#include "myglc-lang/ast-scope.hxx"
+#include "myglc-lang/code-visitors/expr-checker.hxx"
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+using namespace MYGL::Ast;
+using MYGL::GenUtil::ExprChecker;
+
+namespace {
+    int nfailed = 0;
+
+    CodeContext::PtrT parse(std::string const &source)
+    {
+        CodeContext::PtrT ctx = CodeContext::fromString(source);
+        Parser parser{*ctx};
+        if (parser.parse() != 0 || ctx->root() == nullptr) {
+            nfailed++;
+            std::fprintf(stderr, "cannot parse `%s`\n", source.c_str());
+            return nullptr;
+        }
+        return ctx;
+    }
+
+    /** 全局常量 name 的初始值在 fold_tree() 以后应该已经记成整数 expected */
+    void expect_folded(CodeContext &ctx, char const *name, int64_t expected)
+    {
+        Variable *var = ctx.root()->scope_self()->get_constant(std::string_view{name});
+        Expression *init = var == nullptr ? nullptr : var->get_init_expr();
+        if (init == nullptr || init->get_fold_state() != Expression::FoldState::CONSTANT) {
+            nfailed++;
+            std::fprintf(stderr, "`%s` was not folded\n", name);
+            return;
+        }
+        Value *value = init->get_folded_value().get();
+        if (value->node_type() != NodeType::INT_VALUE ||
+            static_cast<IntValue*>(value)->get_value() != expected) {
+            nfailed++;
+            std::fprintf(stderr, "`%s` folded to the wrong value\n", name);
+        }
+    }
+} // namespace
+
+int main()
+{
+    /* 每个常量引用前一个三次: 不记忆化要算 3^60 次, 记忆化以后是线性的 */
+    {
+        std::ostringstream os;
+        os << "const int c0 = 1;\n";
+        for (int i = 1; i < 60; i++)
+            os << "const int c" << i << " = c" << i - 1 << " + c" << i - 1 << " - c" << i - 1 << ";\n";
+        if (CodeContext::PtrT ctx = parse(os.str())) {
+            ExprChecker{}.fold_tree(ctx->root());
+            expect_folded(*ctx, "c59", 1);
+        }
+    }
+    /* 一元运算生成新值, 不能改掉被共享的操作数 */
+    if (CodeContext::PtrT ctx = parse("const int a = 2 * 3 + 1; const int b = -a; const int c = a;")) {
+        ExprChecker{}.fold_tree(ctx->root());
+        expect_folded(*ctx, "a", 7);
+        expect_folded(*ctx, "b", -7);
+        expect_folded(*ctx, "c", 7);
+    }
+    /* 函数参数在语法树里也标成常量, 但没有初始值, 不能拿去求值 */
+    if (CodeContext::PtrT ctx = parse("const int k = 2 + 2; int f(int a) { return a + k; }")) {
+        ExprChecker{}.fold_tree(ctx->root());
+        expect_folded(*ctx, "k", 4);
+    }
+
+    if (nfailed == 0)
+        std::puts("ast-fold-tree: all passed");
+    return nfailed;
+}
@@ -0,0 +1,202 @@
+/** @file ast-sparse-init-list.cpp
+ * @brief 初始化列表一趟展开(SparseInitList)、稀疏数组常量(ArrayExpr::CreateSparse)
+ *        和全局量初始值(IRGen::make_global_init)的回归测试.
+ *
+ * 返回 0 表示全部通过, 否则是失败的检查个数. */
+#include "mygl-ir/ir-constant.hxx"
+#include "mygl-ir/ir-module.hxx"
+#include "myglc-lang/ast-code-context.hxx"
+#include "myglc-lang/ast-exception.hxx"
+#include "myglc-lang/ast-parser.hxx"
+#include "myglc-lang/ast-scope.hxx"
+#include "myglc-lang/codegen/irgen-global-init.hxx"
+#include "myglc-lang/util/expr-indexer.hxx"
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+using namespace MYGL;
+using namespace MTB;
+using Utility::SparseInitList;
+
+namespace {
+    int nfailed = 0;
+
+    void expect(char const *what, bool cond)
+    {
+        if (cond)
+            return;
+        nfailed++;
+        std::fprintf(stderr, "failed: %s\n", what);
+    }
+
+    Ast::Variable *variable_of(Ast::CodeContext &ctx, char const *name)
+    {
+        return ctx.root()->scope_self()->get_variable(std::string_view{name});
+    }
+    Ast::InitList *init_list_of(Ast::CodeContext &ctx, char const *name)
+    {
+        Ast::Variable *var = variable_of(ctx, name);
+        return var == nullptr ? nullptr : dynamic_cast<Ast::InitList*>(var->get_init_expr());
+    }
+
+    bool is_int(IR::Value *value, int64_t expected)
+    {
+        return value != nullptr && value->get_type_id() == IR::ValueTID::INT_CONST &&
+               static_cast<IR::IntConst*>(value)->get_value().get_signed_value() == expected;
+    }
+    bool is_zero(IR::Value *value)
+    {
+        return value != nullptr && static_cast<IR::Constant*>(value)->is_zero();
+    }
+
+    /** 展开结果里偏移为 offset 的元素是整数 expected */
+    bool int_at(SparseInitList const &flat, size_t offset, int64_t expected)
+    {
+        Ast::Expression *expr = flat.at(offset);
+        return expr != nullptr && expr->node_type() == Ast::NodeType::INT_VALUE &&
+               static_cast<Ast::IntValue*>(expr)->get_value() == expected;
+    }
+} // namespace
+
+int main()
+{
+    /* 子列表对齐到子数组开头, 写出来的 0 和没写的元素都不记录 */
+    Ast::CodeContext::PtrT ctx = Ast::CodeContext::fromString(
+        "int a[3][2] = {{1, 0}, {}, 3, 4};\n"
+        "int b[2] = {5, 6, 7};\n");
+    Ast::Parser parser{*ctx};
+    if (parser.parse() != 0 || ctx->root() == nullptr) {
+        std::fputs("cannot parse the source\n", stderr);
+        return 1;
+    }
+    if (Ast::InitList *list = init_list_of(*ctx, "a")) {
+        SparseInitList::PtrT flat = SparseInitList::Get(list, {3, 2});
+        expect("total counts every element", flat->total == 6);
+        expect("only the non-zero elements are kept", flat->elements.size() == 3);
+        expect("a[0][0] is 1", int_at(*flat, 0, 1));
+        expect("a[0][1] is an implicit zero", flat->at(1) == nullptr);
+        expect("a[2][0] is 3", int_at(*flat, 4, 3));
+        expect("a[2][1] is 4", int_at(*flat, 5, 4));
+        size_t offset = 0;
+        expect("offset_of() is row-major",
+               flat->offset_of({2, 1}, offset) && offset == 5);
+        expect("offset_of() rejects an out-of-range index", !flat->offset_of({3, 0}, offset));
+        expect("the flattened list is cached on the node",
+               SparseInitList::Get(list, {3, 2}) == flat);
+    } else {
+        expect("`a` has an initializer list", false);
+    }
+    if (Ast::InitList *list = init_list_of(*ctx, "b")) {
+        bool thrown = false;
+        try {
+            (void)SparseInitList::Get(list, {2});
+        } catch (std::exception &) {
+            thrown = true;
+        }
+        expect("a list longer than the array is rejected", thrown);
+    } else {
+        expect("`b` has an initializer list", false);
+    }
+
+    /* 稀疏数组常量: 没列出来的元素是 0, 要求下标严格升序 */
+    {
+        owned<IR::Module> module = IR::Module::Create("sparse", 8);
+        IRBase::TypeContext &tctx = module->type_ctx();
+        IRBase::IntType *i32 = tctx.getIntType(32);
+        IR::ArrayType *aty = tctx.getArrayType(i32, 4);
+
+        owned<IR::ArrayExpr> array = IR::ArrayExpr::CreateSparse(
+            aty, {{1, IR::IntConst::Create(i32, 7)}, {3, IR::IntConst::Create(i32, 9)}});
+        expect("a sparse array is not zero", !array->is_zero());
+        IR::ArrayExpr::ValueArrayT const &elems = array->element_list();
+        auto int_elem = [&elems](size_t i) {
+            return static_cast<IR::IntConst*>(elems[i].get())->get_value().get_signed_value();
+        };
+        expect("the expanded array has every element", elems.size() == 4);
+        expect("listed elements keep their values", elems.size() == 4 &&
+               int_elem(1) == 7 && int_elem(3) == 9);
+        expect("unlisted elements are zero", elems.size() == 4 &&
+               static_cast<IR::Constant*>(elems[0].get())->is_zero() &&
+               static_cast<IR::Constant*>(elems[2].get())->is_zero());
+
+        bool thrown = false;
+        try {
+            (void)IR::ArrayExpr::CreateSparse(
+                aty, {{2, IR::IntConst::Create(i32, 1)}, {2, IR::IntConst::Create(i32, 1)}});
+        } catch (MTB::Exception &) {
+            thrown = true;
+        }
+        expect("repeated indices are rejected", thrown);
+        expect("an empty sparse array is zero",
+               IR::ArrayExpr::CreateSparse(aty, {})->is_zero());
+    }
+
+    /* 全局量的初始值: 标量折叠成常量, 数组只为非零元素生成常量, 空的子数组保持全零 */
+    {
+        Ast::CodeContext::PtrT gctx = Ast::CodeContext::fromString(
+            "int s = 2 + 3;\n"
+            "int u;\n"
+            "int m[3][2] = {{1, 0}, {}, 3, 4};\n"
+            "int big[1000][1000] = {{7}};\n"
+            "int w[2] = 1;\n");
+        Ast::Parser gparser{*gctx};
+        if (gparser.parse() != 0 || gctx->root() == nullptr) {
+            std::fputs("cannot parse the global source\n", stderr);
+            return nfailed + 1;
+        }
+        owned<IR::Module> module = IR::Module::Create("global-init", 8);
+        IRBase::TypeContext &tctx = module->type_ctx();
+        IRBase::IntType *i32 = tctx.getIntType(32);
+        GenUtil::ExprChecker checker;
+        auto init_of = [&](char const *name, IR::Type *type) -> owned<IR::Constant> {
+            Ast::Variable *var = variable_of(*gctx, name);
+            return var == nullptr ? nullptr : IRGen::make_global_init(checker, var, type);
+        };
+
+        owned<IR::Constant> s = init_of("s", i32), u = init_of("u", i32);
+        expect("global init: a scalar initializer is folded", is_int(s, 5));
+        expect("global init: no initializer gives zero", is_zero(u));
+
+        IR::ArrayType *row = tctx.getArrayType(i32, 2);
+        owned<IR::Constant> m = init_of("m", tctx.getArrayType(row, 3));
+        auto *marr = dynamic_cast<IR::ArrayExpr*>(m.get());
+        expect("global init: an array list gives an array constant",
+               marr != nullptr && marr->element_list().size() == 3);
+        if (marr != nullptr && marr->element_list().size() == 3) {
+            auto elem = [marr](size_t i, size_t j) -> IR::Value* {
+                auto sub = dynamic_cast<IR::ArrayExpr*>(marr->element_list()[i].get());
+                return sub == nullptr || sub->element_list().size() <= j ?
+                       nullptr : sub->element_list()[j].get();
+            };
+            expect("global init: m[0] is {1, 0}", is_int(elem(0, 0), 1) && is_zero(elem(0, 1)));
+            expect("global init: the empty row m[1] is zero",
+                   is_zero(marr->element_list()[1].get()));
+            expect("global init: m[2] is {3, 4}", is_int(elem(2, 0), 3) && is_int(elem(2, 1), 4));
+        }
+
+        IR::ArrayType *big_row = tctx.getArrayType(i32, 1000);
+        owned<IR::Constant> big = init_of("big", tctx.getArrayType(big_row, 1000));
+        auto *bigarr = dynamic_cast<IR::ArrayExpr*>(big.get());
+        bool big_ok = bigarr != nullptr && bigarr->element_list().size() == 1000;
+        if (big_ok) {
+            auto first = dynamic_cast<IR::ArrayExpr*>(bigarr->element_list()[0].get());
+            big_ok = first != nullptr && is_int(first->element_list()[0].get(), 7);
+            for (size_t i = 1; big_ok && i < 1000; i++)
+                big_ok = is_zero(bigarr->element_list()[i].get());
+        }
+        expect("global init: only the first row of a large array is filled", big_ok);
+
+        bool thrown = false;
+        try {
+            (void)init_of("w", row);
+        } catch (Ast::NullException &) {
+            thrown = true;
+        }
+        expect("global init: a single value cannot initialize an array", thrown);
+    }
+
+    if (nfailed == 0)
+        std::puts("sparse-init-list: all passed");
+    return nfailed;
+}
@@ -0,0 +1,117 @@
+/** @file ast-streaming-sink.cpp
+ * @brief 流式语法分析(CodeContext::TopLevelSink)的回归测试: 接收者拿到的每个函数都
+ *        带着函数体, 下一个函数交给接收者之前上一个函数体已经释放, 竞技场里常驻的
+ *        结点只随签名增长, 不随函数体增长.
+ *
+ * 返回 0 表示全部通过, 否则是失败的检查个数. */
+#include "myglc-lang/ast-code-context.hxx"
+#include "myglc-lang/ast-parser.hxx"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace MYGL::Ast;
+
+namespace {
+    int nfailed = 0;
+
+    void expect(char const *what, bool cond)
+    {
+        if (cond)
+            return;
+        nfailed++;
+        std::fprintf(stderr, "failed: %s\n", what);
+    }
+
+    constexpr int NFUNCTIONS = 30;
+
+    /** 每个函数体有 20 组语句, 几百个结点; 签名只有几个结点 */
+    std::string make_source()
+    {
+        std::ostringstream os;
+        os << "int g[10];\n";
+        for (int f = 0; f < NFUNCTIONS; f++) {
+            os << "int f" << f << "(int a) {\n"
+                  "  int x = a;\n";
+            for (int s = 0; s < 20; s++)
+                os << "  if (x > " << s << ") { x = x - g[" << s % 10 << "] * 2; }\n";
+            os << "  return x;\n"
+                  "}\n";
+        }
+        return os.str();
+    }
+
+    /** 记下接收者每一步看到的竞技场状态 */
+    struct RecordingSink: CodeContext::TopLevelSink {
+        NodeArena            *arena = nullptr;
+        std::vector<Function*> functions;
+        std::vector<size_t>    resident;   // 每个函数交给接收者时竞技场里常驻的结点数
+        std::vector<size_t>    body_nodes; // 每个函数体的结点数
+        size_t ndeclarations = 0;
+        bool   body_present  = true;  // 交给接收者时函数体都还在
+        bool   released_in_time = true; // 上一个函数体在下一个函数到来之前已经释放
+
+        void on_declaration(Declaration *) override { ndeclarations++; }
+        void on_function(Function *func) override
+        {
+            body_present &= func->get_func_body() != nullptr;
+            if (!functions.empty())
+                released_in_time &= functions.back()->is_body_released();
+            functions.push_back(func);
+            resident.push_back(arena->get_nnodes());
+        }
+        void on_release(Function *, std::vector<Node*> const &nodes) override {
+            body_nodes.push_back(nodes.size());
+        }
+    }; // struct RecordingSink
+} // namespace
+
+int main()
+{
+    std::string source = make_source();
+
+    /* 一次性分析作为对照: 所有函数体都常驻 */
+    size_t batch_nodes = 0;
+    {
+        CodeContext::PtrT ctx = CodeContext::fromString(source);
+        Parser parser{*ctx};
+        expect("batch: parses", parser.parse() == 0 && ctx->root() != nullptr);
+        batch_nodes = ctx->get_node_arena().get_nnodes();
+    }
+
+    CodeContext::PtrT ctx = CodeContext::fromString(source);
+    RecordingSink sink;
+    sink.arena = &ctx->get_node_arena();
+    ctx->set_sink(&sink);
+    Parser parser{*ctx};
+    expect("streaming: parses", parser.parse() == 0);
+
+    expect("every function reaches the sink", sink.functions.size() == NFUNCTIONS);
+    expect("the global declaration reaches the sink", sink.ndeclarations == 1);
+    expect("each function arrives with its body", sink.body_present);
+    expect("each body is released before the next function arrives", sink.released_in_time);
+    expect("the last body is released too",
+           !sink.functions.empty() && sink.functions.back()->is_body_released());
+    expect("every body is handed to on_release", sink.body_nodes.size() == NFUNCTIONS);
+
+    /* 常驻结点只多出签名: 每个函数的增量远小于一个函数体 */
+    size_t min_body = SIZE_MAX, body_total = 0;
+    for (size_t n: sink.body_nodes) {
+        min_body = std::min(min_body, n);
+        body_total += n;
+    }
+    bool bounded = sink.resident.size() == NFUNCTIONS;
+    for (size_t i = 1; bounded && i < sink.resident.size(); i++)
+        bounded = sink.resident[i] - sink.resident[i - 1] < min_body / 10;
+    expect("resident nodes grow by a signature, not a body, per function", bounded);
+    size_t resident = ctx->get_node_arena().get_nnodes();
+    expect("the resident tree is the batch tree without the bodies",
+           resident + body_total == batch_nodes);
+
+    if (nfailed == 0)
+        std::puts("streaming-sink: all passed");
+    return nfailed;
+}
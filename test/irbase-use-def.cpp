@@ -0,0 +1,95 @@
+/** @file irbase-use-def.cpp
+ * @brief Use 与使用者链表的回归测试. 使用者在没有先解除 use 关系的情况下析构时,
+ *        它的 Use 要自己从 usee 的使用者链表上摘下来, 链表里不能留下悬垂的结点.
+ *
+ * 返回 0 表示全部通过, 否则是失败的检查个数. */
+#include "mygl-ir/ir-basicblock.hxx"
+#include "mygl-ir/ir-constant-function.hxx"
+#include "mygl-ir/ir-constant.hxx"
+#include "mygl-ir/ir-instruction.hxx"
+#include "mygl-ir/ir-module.hxx"
+#include <cstdio>
+#include <vector>
+
+using namespace MYGL::IR;
+using namespace MYGL::IRBase;
+using namespace MTB;
+
+namespace {
+    int nfailed = 0;
+
+    /** 从头走一遍使用者链表, 顺便检查每个结点都还挂在这个值上 */
+    size_t walk_uses(Value *value)
+    {
+        size_t n = 0;
+        for (Use *use = value->get_list_as_usee().front();
+             use != nullptr; use = use->get_next_usee()) {
+            if (!use->is_linked_as_usee() || use->get_usee() != value) {
+                nfailed++;
+                std::fprintf(stderr, "use #%zu of %%%s is not linked to it\n",
+                             n, value->get_name_or_id().c_str());
+            }
+            n++;
+        }
+        return n;
+    }
+
+    void expect_uses(char const *what, Value *value, size_t expected)
+    {
+        size_t got = walk_uses(value);
+        if (got == expected)
+            return;
+        nfailed++;
+        std::fprintf(stderr, "%s: %zu uses, expected %zu\n", what, got, expected);
+    }
+
+    owned<Function> make_function(Module *module, char const *name)
+    {
+        TypeContext &ctx = module->type_ctx();
+        IntType *i32 = ctx.getIntType(32);
+        auto fty = ctx.getFunctionType(i32, TypeContext::FTypeListT{i32});
+        return Function::Create(ctx.getPointerType(fty), name, module, false);
+    }
+} // namespace
+
+int main()
+{
+    owned<Module> module = Module::Create("use-def", 8);
+    IntType *i32 = module->type_ctx().getIntType(32);
+
+    /* 三条游离的指令使用同一个参数, 析构中间那条: 参数的链表要跳过它 */
+    {
+        owned<Function> fn = make_function(module, "detached_users");
+        Value *a = fn->argumentAt(0);
+        owned<IntConst> one = IntConst::Create(i32, 1);
+        std::vector<owned<BinarySSA>> users;
+        for (int i = 0; i < 3; i++)
+            users.push_back(BinarySSA::Create(Instruction::OpCode::ADD, a, one, true));
+        expect_uses("before", a, 3);
+        users[1].reset();
+        expect_uses("after destroying the middle user", a, 2);
+        users[0].reset();
+        users[2].reset();
+        expect_uses("after destroying every user", a, 0);
+    }
+    /* 函数析构时, 函数体对函数外的常量的使用要跟着消失 */
+    {
+        owned<IntConst> seven = IntConst::Create(i32, 7);
+        {
+            owned<Function> fn = make_function(module, "constant_user");
+            owned<Value> last = fn->argumentAt(0);
+            for (int i = 0; i < 4; i++) {
+                owned<BinarySSA> inst = BinarySSA::Create(
+                    Instruction::OpCode::MUL, last, seven, true);
+                fn->get_entry()->append(inst);
+                last = inst;
+            }
+            expect_uses("constant inside the function", seven, 4);
+        }
+        expect_uses("constant after the function is gone", seven, 0);
+    }
+
+    if (nfailed == 0)
+        std::puts("use-def: all passed");
+    return nfailed;
+}
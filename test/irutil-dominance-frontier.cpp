@@ -0,0 +1,117 @@
+/** @file irutil-dominance-frontier.cpp
+ * @brief DominatorTree 支配边界的回归测试. 重点是有回边指向入口块的情形:
+ *        入口不严格支配它自己, 所以入口在回边源头到入口这一路上每个块的支配边界里.
+ *
+ * 返回 0 表示全部通过, 否则是失败的检查个数. */
+#include "mygl-ir/ir-basicblock.hxx"
+#include "mygl-ir/ir-constant-function.hxx"
+#include "mygl-ir/ir-constant.hxx"
+#include "mygl-ir/ir-instruction.hxx"
+#include "mygl-ir/ir-module.hxx"
+#include "mygl-ir/utils/irutil-dominance.hxx"
+#include <algorithm>
+#include <cstdio>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+using namespace MYGL::IR;
+using namespace MTB;
+using MYGL::IRUtil::DominatorTree;
+
+namespace {
+    int nfailed = 0;
+
+    struct CFG {
+        owned<Function>          fn;
+        std::vector<BasicBlock*> blocks;
+
+        CFG(Module *module, char const *name, size_t nblocks)
+        {
+            TypeContext &ctx = module->type_ctx();
+            auto fty = ctx.getFunctionType(ctx.getIntType(32), TypeContext::FTypeListT{});
+            fn = Function::Create(ctx.getPointerType(fty), name, module, false);
+            (void)module->setFunction(name, fn);
+            blocks.push_back(fn->get_entry());
+            for (size_t i = 1; i < nblocks; i++) {
+                owned<BasicBlock> block = BasicBlock::Create(fn);
+                fn->body().append(block);
+                blocks.push_back(block.get());
+            }
+        }
+
+        void jump(size_t from, size_t to) {
+            blocks[from]->set_terminator(JumpSSA::Create(blocks[from], blocks[to]));
+        }
+        void branch(size_t from, size_t if_true, size_t if_false) {
+            blocks[from]->set_terminator(BranchSSA::Create(
+                IntConst::BooleanTrue(), blocks[if_true], blocks[if_false]));
+        }
+    }; // struct CFG
+
+    void expect_frontier(CFG const &cfg, DominatorTree const &tree,
+                         size_t block, std::initializer_list<size_t> expected)
+    {
+        std::vector<BasicBlock*> want;
+        for (size_t i: expected)
+            want.push_back(cfg.blocks[i]);
+        DominatorTree::BlockSpanT got = tree.get_frontier(cfg.blocks[block]);
+        std::vector<BasicBlock*> got_sorted(got.begin(), got.end());
+        std::sort(want.begin(), want.end(), [&tree](BasicBlock *a, BasicBlock *b) {
+            return tree.indexOf(a) < tree.indexOf(b);
+        });
+        if (got_sorted == want)
+            return;
+        nfailed++;
+        std::fprintf(stderr, "%s: DF(b%zu) has %zu blocks, expected %zu\n",
+                     std::string(cfg.fn->get_name()).c_str(), block,
+                     got_sorted.size(), want.size());
+    }
+} // namespace
+
+int main()
+{
+    owned<Module> module = Module::Create("dominance-frontier", 8);
+
+    /* b0 -> b1 -> b0: 最小的入口回边 */
+    {
+        CFG cfg(module.get(), "self_loop_entry", 2);
+        cfg.jump(0, 1);
+        cfg.jump(1, 0);
+        DominatorTree::PtrT tree = DominatorTree::Build(cfg.fn);
+        expect_frontier(cfg, *tree, 0, {0});
+        expect_frontier(cfg, *tree, 1, {0});
+    }
+    /* b0 -> {b1, b2} -> b3 -> {b4, b0}: 菱形的汇合点再跳回入口 */
+    {
+        CFG cfg(module.get(), "diamond_back_to_entry", 5);
+        cfg.branch(0, 1, 2);
+        cfg.jump(1, 3);
+        cfg.jump(2, 3);
+        cfg.branch(3, 4, 0);
+        cfg.jump(4, 4);
+        DominatorTree::PtrT tree = DominatorTree::Build(cfg.fn);
+        expect_frontier(cfg, *tree, 0, {0});
+        expect_frontier(cfg, *tree, 1, {3});
+        expect_frontier(cfg, *tree, 2, {3});
+        expect_frontier(cfg, *tree, 3, {0});
+        expect_frontier(cfg, *tree, 4, {4});
+    }
+    /* 入口没有回边时不在任何块的支配边界里 */
+    {
+        CFG cfg(module.get(), "no_entry_back_edge", 4);
+        cfg.branch(0, 1, 2);
+        cfg.jump(1, 3);
+        cfg.jump(2, 3);
+        cfg.jump(3, 1);
+        DominatorTree::PtrT tree = DominatorTree::Build(cfg.fn);
+        expect_frontier(cfg, *tree, 0, {});
+        expect_frontier(cfg, *tree, 1, {3});
+        expect_frontier(cfg, *tree, 2, {3});
+        expect_frontier(cfg, *tree, 3, {1});
+    }
+
+    if (nfailed == 0)
+        std::puts("dominance frontier: all passed");
+    return nfailed;
+}
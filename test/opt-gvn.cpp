@@ -0,0 +1,172 @@
+/** @file opt-gvn.cpp
+ * @brief GVNPass 的回归测试: 交换律运算和镜像比较的两种写法是同一个值, 被支配的块里
+ *        重复的 getelementptr 换成支配块里的那条, 兄弟块之间互不支配, 不能合并.
+ *
+ * 返回 0 表示全部通过, 否则是失败的检查个数. */
+#include "mygl-ir/ir-basicblock.hxx"
+#include "mygl-ir/ir-constant-function.hxx"
+#include "mygl-ir/ir-constant.hxx"
+#include "mygl-ir/ir-instruction.hxx"
+#include "mygl-ir/ir-module.hxx"
+#include "optimizers/GVNPass.hxx"
+#include <cstdio>
+#include <vector>
+
+using namespace MYGL::IR;
+using namespace MTB;
+using OpCode = Instruction::OpCode;
+using MYGL::Optimizers::GVNPass;
+
+namespace {
+    int nfailed = 0;
+
+    void expect(char const *what, bool cond)
+    {
+        if (cond)
+            return;
+        nfailed++;
+        std::fprintf(stderr, "failed: %s\n", what);
+    }
+
+    /** i32 fn(i32 a), 带 nblocks 个基本块, blocks[0] 是入口 */
+    struct CFG {
+        owned<Function>          fn;
+        std::vector<BasicBlock*> blocks;
+        IntType                 *i32;
+
+        CFG(Module *module, char const *name, size_t nblocks)
+        {
+            TypeContext &ctx = module->type_ctx();
+            i32 = ctx.getIntType(32);
+            auto fty = ctx.getFunctionType(i32, TypeContext::FTypeListT{i32});
+            fn = Function::Create(ctx.getPointerType(fty), name, module, false);
+            (void)module->setFunction(name, fn);
+            blocks.push_back(fn->get_entry());
+            for (size_t i = 1; i < nblocks; i++) {
+                owned<BasicBlock> block = BasicBlock::Create(fn);
+                fn->body().append(block);
+                blocks.push_back(block.get());
+            }
+        }
+
+        Value *arg() { return fn->argumentAt(0); }
+        owned<IntConst> iconst(int64_t value) const { return IntConst::Create(i32, value); }
+
+        template<typename InstT>
+        InstT *add(size_t block, owned<InstT> inst) {
+            blocks[block]->append(inst);
+            return inst.get();
+        }
+        BinarySSA *binary(size_t block, OpCode opcode, owned<Value> lhs, owned<Value> rhs) {
+            return add(block, BinarySSA::Create(opcode, std::move(lhs), std::move(rhs), true));
+        }
+        CompareSSA *icmp(size_t block, CompareResult cond, owned<Value> lhs, owned<Value> rhs) {
+            return add(block, CompareSSA::CreateICmp(cond, true, std::move(lhs), std::move(rhs)));
+        }
+        void branch(size_t from, Value *cond, size_t if_true, size_t if_false) {
+            blocks[from]->set_terminator(
+                BranchSSA::Create(cond, blocks[if_true], blocks[if_false]));
+        }
+        void ret(size_t from, owned<Value> value) {
+            blocks[from]->set_terminator(ReturnSSA::Create(fn, value));
+        }
+
+        /** inst 还在 block 块里 */
+        bool contains(size_t block, Instruction *inst) const {
+            for (Instruction *i: blocks[block]->instruction_list()) {
+                if (i == inst)
+                    return true;
+            }
+            return false;
+        }
+        Value *returned(size_t block) const {
+            return static_cast<ReturnSSA*>(blocks[block]->get_terminator())->get_result();
+        }
+    }; // struct CFG
+} // namespace
+
+int main()
+{
+    owned<Module> module = Module::Create("gvn", 8);
+    GVNPass pass;
+
+    /* a + 5 和 5 + a 是同一个值; a - 5 和 5 - a 不是 */
+    {
+        CFG cfg(module, "commuted", 1);
+        BinarySSA *add0 = cfg.binary(0, OpCode::ADD, cfg.arg(), cfg.iconst(5));
+        BinarySSA *add1 = cfg.binary(0, OpCode::ADD, cfg.iconst(5), cfg.arg());
+        BinarySSA *sub0 = cfg.binary(0, OpCode::SUB, cfg.arg(), cfg.iconst(5));
+        BinarySSA *sub1 = cfg.binary(0, OpCode::SUB, cfg.iconst(5), cfg.arg());
+        BinarySSA *mul  = cfg.binary(0, OpCode::MUL, add0, add1);
+        BinarySSA *diff = cfg.binary(0, OpCode::SUB, sub0, sub1);
+        cfg.ret(0, cfg.binary(0, OpCode::XOR, mul, diff));
+        expect("commuted: changed", pass.runOnFunction(cfg.fn));
+        expect("commuted: the second add is removed", !cfg.contains(0, add1));
+        expect("commuted: its users use the first add",
+               mul->get_lhs() == add0 && mul->get_rhs() == add0);
+        expect("commuted: subtractions in both orders stay",
+               cfg.contains(0, sub0) && cfg.contains(0, sub1) &&
+               diff->get_lhs() == sub0 && diff->get_rhs() == sub1);
+        expect("commuted: a second run changes nothing", !pass.runOnFunction(cfg.fn));
+    }
+    /* a < 10 和 10 > a 是同一个比较; 10 < a 不是 */
+    {
+        CFG cfg(module, "mirrored", 3);
+        CompareSSA *lt = cfg.icmp(0, CompareResult::LT, cfg.arg(), cfg.iconst(10));
+        CompareSSA *gt = cfg.icmp(0, CompareResult::GT, cfg.iconst(10), cfg.arg());
+        CompareSSA *le = cfg.icmp(0, CompareResult::LE, cfg.arg(), cfg.iconst(10));
+        CompareSSA *ge = cfg.icmp(0, CompareResult::GE, cfg.iconst(10), cfg.arg());
+        CompareSSA *rev = cfg.icmp(0, CompareResult::LT, cfg.iconst(10), cfg.arg());
+        BinarySSA *both   = cfg.binary(0, OpCode::AND, lt, gt);
+        BinarySSA *both_e = cfg.binary(0, OpCode::AND, le, ge);
+        BinarySSA *all    = cfg.binary(0, OpCode::OR, cfg.binary(0, OpCode::OR, both, both_e), rev);
+        cfg.branch(0, all, 1, 2);
+        cfg.ret(1, cfg.iconst(1));
+        cfg.ret(2, cfg.iconst(0));
+        expect("mirrored: changed", pass.runOnFunction(cfg.fn));
+        expect("mirrored: 10 > a is replaced by a < 10",
+               !cfg.contains(0, gt) && both->get_lhs() == lt && both->get_rhs() == lt);
+        expect("mirrored: 10 >= a is replaced by a <= 10",
+               !cfg.contains(0, ge) && both_e->get_lhs() == le && both_e->get_rhs() == le);
+        expect("mirrored: 10 < a is a different compare", cfg.contains(0, rev));
+        expect("mirrored: a < 10 and a <= 10 stay apart", cfg.contains(0, le));
+    }
+    /* 入口块的 getelementptr 支配两个分支, 分支里同样的地址直接用它 */
+    {
+        CFG cfg(module, "gep_dominated", 3);
+        TypeContext &ctx = module->type_ctx();
+        AllocaSSA *array = cfg.add(0, AllocaSSA::CreateAutoAligned(ctx.getArrayType(cfg.i32, 4)));
+        GetElemPtrSSA *addr = cfg.add(0, GetElemPtrSSA::CreateFromPointer(
+            array, {cfg.iconst(0), cfg.arg()}));
+        cfg.add(0, StoreSSA::Create(cfg.iconst(1), addr));
+        cfg.branch(0, cfg.icmp(0, CompareResult::LT, cfg.arg(), cfg.iconst(2)), 1, 2);
+        GetElemPtrSSA *again = cfg.add(1, GetElemPtrSSA::CreateFromPointer(
+            array, {cfg.iconst(0), cfg.arg()}));
+        LoadSSA *load = cfg.add(1, own<LoadSSA>(again));
+        cfg.ret(1, load);
+        GetElemPtrSSA *other = cfg.add(2, GetElemPtrSSA::CreateFromPointer(
+            array, {cfg.iconst(0), cfg.iconst(3)}));
+        cfg.ret(2, cfg.add(2, own<LoadSSA>(other)));
+        expect("gep: changed", pass.runOnFunction(cfg.fn));
+        expect("gep: the dominated duplicate is removed", !cfg.contains(1, again));
+        expect("gep: the load reads through the dominating gep", load->get_operand() == addr);
+        expect("gep: a different index stays", cfg.contains(2, other));
+    }
+    /* 兄弟块互不支配: 各自的 a * 7 都要留着 */
+    {
+        CFG cfg(module, "siblings", 3);
+        cfg.branch(0, cfg.icmp(0, CompareResult::LT, cfg.arg(), cfg.iconst(2)), 1, 2);
+        BinarySSA *left  = cfg.binary(1, OpCode::MUL, cfg.arg(), cfg.iconst(7));
+        cfg.ret(1, left);
+        BinarySSA *right = cfg.binary(2, OpCode::MUL, cfg.arg(), cfg.iconst(7));
+        cfg.ret(2, right);
+        expect("siblings: nothing to remove", !pass.runOnFunction(cfg.fn));
+        expect("siblings: both multiplications stay",
+               cfg.contains(1, left) && cfg.contains(2, right) &&
+               cfg.returned(1) == left && cfg.returned(2) == right);
+    }
+
+    if (nfailed == 0)
+        std::puts("gvn: all passed");
+    return nfailed;
+}
@@ -0,0 +1,250 @@
+/** @file opt-mem2reg.cpp
+ * @brief Mem2RegPass 的回归测试: 单条 store、单个基本块、菱形、循环、回边指向入口块
+ *        几种情形各自提升干净, 不可提升的 alloca 原样保留并且报告"没有改动".
+ *
+ * 返回 0 表示全部通过, 否则是失败的检查个数. */
+#include "mygl-ir/ir-basicblock.hxx"
+#include "mygl-ir/ir-constant-function.hxx"
+#include "mygl-ir/ir-constant.hxx"
+#include "mygl-ir/ir-instruction.hxx"
+#include "mygl-ir/ir-module.hxx"
+#include "optimizers/Mem2RegPass.hxx"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace MYGL::IR;
+using namespace MTB;
+using OpCode = Instruction::OpCode;
+using MYGL::Optimizers::Mem2RegPass;
+
+namespace {
+    int nfailed = 0;
+
+    void expect(char const *what, bool cond)
+    {
+        if (cond)
+            return;
+        nfailed++;
+        std::fprintf(stderr, "failed: %s\n", what);
+    }
+
+    /** i32 fn(i32 a), 带 nblocks 个基本块, blocks[0] 是入口 */
+    struct CFG {
+        owned<Function>          fn;
+        std::vector<BasicBlock*> blocks;
+        IntType                 *i32;
+
+        CFG(Module *module, char const *name, size_t nblocks)
+        {
+            TypeContext &ctx = module->type_ctx();
+            i32 = ctx.getIntType(32);
+            auto fty = ctx.getFunctionType(i32, TypeContext::FTypeListT{i32});
+            fn = Function::Create(ctx.getPointerType(fty), name, module, false);
+            (void)module->setFunction(name, fn);
+            blocks.push_back(fn->get_entry());
+            for (size_t i = 1; i < nblocks; i++) {
+                owned<BasicBlock> block = BasicBlock::Create(fn);
+                fn->body().append(block);
+                blocks.push_back(block.get());
+            }
+        }
+
+        Value *arg() { return fn->argumentAt(0); }
+        owned<IntConst> iconst(int64_t value) const { return IntConst::Create(i32, value); }
+
+        template<typename InstT>
+        InstT *add(size_t block, owned<InstT> inst) {
+            blocks[block]->append(inst);
+            return inst.get();
+        }
+        AllocaSSA *alloca() {
+            return add(0, AllocaSSA::CreateAutoAligned(i32));
+        }
+        LoadSSA *load(size_t block, AllocaSSA *ptr) {
+            return add(block, own<LoadSSA>(ptr));
+        }
+        void store(size_t block, Value *value, AllocaSSA *ptr) {
+            add(block, StoreSSA::Create(value, ptr));
+        }
+
+        void jump(size_t from, size_t to) {
+            blocks[from]->set_terminator(JumpSSA::Create(blocks[from], blocks[to]));
+        }
+        /** 条件是 a < 10, 放在 from 块的末尾 */
+        void branch(size_t from, size_t if_true, size_t if_false) {
+            CompareSSA *cond = add(from, CompareSSA::CreateICmp(
+                CompareResult::LT, true, arg(), iconst(10)));
+            blocks[from]->set_terminator(BranchSSA::Create(cond, blocks[if_true], blocks[if_false]));
+        }
+        void ret(size_t from, Value *value) {
+            blocks[from]->set_terminator(ReturnSSA::Create(fn, value));
+        }
+
+        size_t count(ValueTID tid) {
+            size_t n = 0;
+            for (BasicBlock *block: fn->body()) {
+                for (Instruction *inst: block->instruction_list())
+                    n += inst->get_type_id() == tid;
+            }
+            return n;
+        }
+        /** 函数里的内存读写都没了 */
+        bool promoted() {
+            return count(ValueTID::ALLOCA_SSA) == 0 && count(ValueTID::LOAD_SSA) == 0 &&
+                   count(ValueTID::STORE_SSA) == 0;
+        }
+        PhiSSA *phi_in(size_t block) const {
+            for (Instruction *inst: blocks[block]->instruction_list()) {
+                if (inst->get_type_id() == ValueTID::PHI_SSA)
+                    return static_cast<PhiSSA*>(inst);
+            }
+            return nullptr;
+        }
+        Value *returned(size_t block) const {
+            return static_cast<ReturnSSA*>(blocks[block]->get_terminator())->get_result();
+        }
+    }; // struct CFG
+
+    bool is_int(Value *value, int64_t expected) {
+        return value != nullptr && value->get_type_id() == ValueTID::INT_CONST &&
+               static_cast<IntConst*>(value)->get_value().get_signed_value() == expected;
+    }
+    bool is_undef(Value *value) {
+        return value != nullptr && value->get_type_id() == ValueTID::UNDEFINED;
+    }
+} // namespace
+
+int main()
+{
+    owned<Module> module = Module::Create("mem2reg", 8);
+    Mem2RegPass pass;
+
+    /* 唯一的 store 在入口, 支配两个分支里的 load */
+    {
+        CFG cfg(module, "single_store", 3);
+        AllocaSSA *x = cfg.alloca();
+        cfg.store(0, cfg.arg(), x);
+        cfg.branch(0, 1, 2);
+        cfg.ret(1, cfg.load(1, x));
+        cfg.ret(2, cfg.load(2, x));
+        expect("single store: changed", pass.runOnFunction(cfg.fn));
+        expect("single store: promoted", cfg.promoted());
+        expect("single store: loads read the stored value",
+               cfg.returned(1) == cfg.arg() && cfg.returned(2) == cfg.arg());
+        expect("single store: no phi", cfg.count(ValueTID::PHI_SSA) == 0);
+        expect("single store: a second run changes nothing", !pass.runOnFunction(cfg.fn));
+    }
+    /* 同一个块里先读后写再读: 第一次读是 undef, 之后读最近一次写的值 */
+    {
+        CFG cfg(module, "single_block", 1);
+        AllocaSSA *x = cfg.alloca();
+        LoadSSA *before = cfg.load(0, x);
+        cfg.store(0, cfg.iconst(1).get(), x);
+        cfg.store(0, cfg.iconst(2).get(), x);
+        LoadSSA *after = cfg.load(0, x);
+        BinarySSA *sum = cfg.add(0, BinarySSA::Create(OpCode::ADD, before, after, true));
+        cfg.ret(0, sum);
+        expect("single block: changed", pass.runOnFunction(cfg.fn));
+        expect("single block: promoted", cfg.promoted());
+        expect("single block: a load before every store reads undef", is_undef(sum->get_lhs()));
+        expect("single block: a load reads the closest store", is_int(sum->get_rhs(), 2));
+    }
+    /* 菱形: 两边各写一次, 汇合点放一个两入口的 phi */
+    {
+        CFG cfg(module, "diamond", 4);
+        AllocaSSA *x = cfg.alloca();
+        cfg.branch(0, 1, 2);
+        cfg.store(1, cfg.iconst(1).get(), x);
+        cfg.jump(1, 3);
+        cfg.store(2, cfg.iconst(2).get(), x);
+        cfg.jump(2, 3);
+        cfg.ret(3, cfg.load(3, x));
+        expect("diamond: changed", pass.runOnFunction(cfg.fn));
+        expect("diamond: promoted", cfg.promoted());
+        PhiSSA *phi = cfg.phi_in(3);
+        expect("diamond: the join block has a phi", phi != nullptr && cfg.returned(3) == phi);
+        expect("diamond: the phi merges both stores",
+               phi != nullptr && phi->get_operands().size() == 2 &&
+               is_int(phi->getValueFrom(cfg.blocks[1]), 1) &&
+               is_int(phi->getValueFrom(cfg.blocks[2]), 2));
+        expect("diamond: only one phi", cfg.count(ValueTID::PHI_SSA) == 1);
+    }
+    /* 循环: i = 0; while (i < a) i = i + 1; 循环头放 phi, 出口读到的就是它 */
+    {
+        CFG cfg(module, "loop", 4);
+        AllocaSSA *i = cfg.alloca();
+        cfg.store(0, cfg.iconst(0).get(), i);
+        cfg.jump(0, 1);
+        LoadSSA *head = cfg.load(1, i);
+        CompareSSA *cond = cfg.add(1, CompareSSA::CreateICmp(
+            CompareResult::LT, true, head, cfg.arg()));
+        cfg.blocks[1]->set_terminator(BranchSSA::Create(cond, cfg.blocks[2], cfg.blocks[3]));
+        BinarySSA *next = cfg.add(2, BinarySSA::Create(
+            OpCode::ADD, cfg.load(2, i), cfg.iconst(1), true));
+        cfg.store(2, next, i);
+        cfg.jump(2, 1);
+        cfg.ret(3, cfg.load(3, i));
+        expect("loop: changed", pass.runOnFunction(cfg.fn));
+        expect("loop: promoted", cfg.promoted());
+        PhiSSA *phi = cfg.phi_in(1);
+        expect("loop: the header phi takes 0 from the entry and i + 1 from the body",
+               phi != nullptr && is_int(phi->getValueFrom(cfg.blocks[0]), 0) &&
+               phi->getValueFrom(cfg.blocks[2]) == next);
+        expect("loop: the increment and the exit read the phi",
+               phi != nullptr && next->get_lhs() == phi && cfg.returned(3) == phi);
+        expect("loop: only one phi", cfg.count(ValueTID::PHI_SSA) == 1);
+    }
+    /* 回边指向入口: 入口处先读后写, 读到的是 undef, 入口不放 phi */
+    {
+        CFG cfg(module, "entry_back_edge", 2);
+        AllocaSSA *x = cfg.alloca();
+        LoadSSA *first = cfg.load(0, x);
+        BinarySSA *use = cfg.add(0, BinarySSA::Create(OpCode::ADD, first, cfg.arg(), true));
+        cfg.store(0, use, x);
+        cfg.branch(0, 0, 1);
+        cfg.ret(1, cfg.load(1, x));
+        expect("entry back edge: changed", pass.runOnFunction(cfg.fn));
+        expect("entry back edge: promoted", cfg.promoted());
+        expect("entry back edge: no phi", cfg.count(ValueTID::PHI_SSA) == 0);
+        expect("entry back edge: the first read is undef", is_undef(use->get_lhs()));
+        expect("entry back edge: the exit reads the stored value", cfg.returned(1) == use);
+    }
+    /* slot 存着 x 的地址: 第一轮只能提升 slot, 把 slot 的读换掉以后 x 才可提升 */
+    {
+        CFG cfg(module, "chained", 1);
+        AllocaSSA *x    = cfg.alloca();
+        AllocaSSA *slot = cfg.add(0, AllocaSSA::CreateAutoAligned(x->get_value_type()));
+        cfg.store(0, x, slot);
+        cfg.store(0, cfg.arg(), x);
+        expect("chained: x is not promotable at first", !Mem2RegPass::isPromotable(x));
+        LoadSSA *ptr = cfg.load(0, slot);
+        cfg.ret(0, cfg.add(0, own<LoadSSA>(ptr)));
+        expect("chained: changed", pass.runOnFunction(cfg.fn));
+        expect("chained: both allocas are promoted", cfg.promoted());
+        expect("chained: the function returns its argument", cfg.returned(0) == cfg.arg());
+    }
+    /* 地址传给了别的函数: 不可提升, 原样保留并且报告没有改动 */
+    {
+        TypeContext &ctx = module->type_ctx();
+        CFG cfg(module, "escaped", 1);
+        auto sink_ty = ctx.getFunctionType(
+            cfg.i32, TypeContext::FTypeListT{ctx.getPointerType(cfg.i32)});
+        owned<Function> sink = Function::Create(ctx.getPointerType(sink_ty), "sink", module, true);
+        (void)module->setFunction("sink", sink);
+
+        AllocaSSA *x = cfg.alloca();
+        cfg.store(0, cfg.arg(), x);
+        cfg.add(0, own<CallSSA>(sink, CallSSA::ValueArrayT{x}));
+        cfg.ret(0, cfg.load(0, x));
+        expect("escaped: not promotable", !Mem2RegPass::isPromotable(x));
+        expect("escaped: no change", !pass.runOnFunction(cfg.fn));
+        expect("escaped: the alloca and its accesses stay",
+               cfg.count(ValueTID::ALLOCA_SSA) == 1 && cfg.count(ValueTID::LOAD_SSA) == 1 &&
+               cfg.count(ValueTID::STORE_SSA) == 1);
+    }
+
+    if (nfailed == 0)
+        std::puts("mem2reg: all passed");
+    return nfailed;
+}
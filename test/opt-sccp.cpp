@@ -0,0 +1,289 @@
+/** @file opt-sccp.cpp
+ * @brief SCCPPass 的回归测试: 常量条件的 br 和 switch 折叠成 jump, phi 只合并
+ *        可执行边上的入口, 删掉的不可达块不能在 phi 里留下入口, 结果未定义的运算
+ *        (除以零、INT_MIN / -1、移位越界) 不折叠. 多个线程同时在共享的 true/false
+ *        常量上折叠分支时, 常量的使用链表不能被改乱.
+ *
+ * 返回 0 表示全部通过, 否则是失败的检查个数. */
+#include "mygl-ir/ir-basicblock.hxx"
+#include "mygl-ir/ir-constant-function.hxx"
+#include "mygl-ir/ir-constant.hxx"
+#include "mygl-ir/ir-instruction.hxx"
+#include "mygl-ir/ir-module.hxx"
+#include "optimizers/FunctionPassManager.hxx"
+#include "optimizers/SCCPPass.hxx"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace MYGL::IR;
+using namespace MTB;
+using OpCode = Instruction::OpCode;
+using MYGL::Optimizers::FunctionPassManager;
+using MYGL::Optimizers::SCCPPass;
+
+namespace {
+    int nfailed = 0;
+
+    void expect(char const *what, bool cond)
+    {
+        if (cond)
+            return;
+        nfailed++;
+        std::fprintf(stderr, "failed: %s\n", what);
+    }
+
+    /** i32 fn(i32 a), 带 nblocks 个基本块, blocks[0] 是入口 */
+    struct CFG {
+        owned<Function>          fn;
+        std::vector<BasicBlock*> blocks;
+        IntType                 *i32;
+
+        CFG(Module *module, char const *name, size_t nblocks)
+        {
+            TypeContext &ctx = module->type_ctx();
+            i32 = ctx.getIntType(32);
+            auto fty = ctx.getFunctionType(i32, TypeContext::FTypeListT{i32});
+            fn = Function::Create(ctx.getPointerType(fty), name, module, false);
+            (void)module->setFunction(name, fn);
+            blocks.push_back(fn->get_entry());
+            for (size_t i = 1; i < nblocks; i++) {
+                owned<BasicBlock> block = BasicBlock::Create(fn);
+                fn->body().append(block);
+                blocks.push_back(block.get());
+            }
+        }
+
+        Value *arg() { return fn->argumentAt(0); }
+        owned<IntConst> iconst(int64_t value) const { return IntConst::Create(i32, value); }
+
+        template<typename InstT>
+        InstT *add(size_t block, owned<InstT> inst) {
+            blocks[block]->append(inst);
+            return inst.get();
+        }
+        void jump(size_t from, size_t to) {
+            blocks[from]->set_terminator(JumpSSA::Create(blocks[from], blocks[to]));
+        }
+        void branch(size_t from, Value *cond, size_t if_true, size_t if_false) {
+            blocks[from]->set_terminator(
+                BranchSSA::Create(cond, blocks[if_true], blocks[if_false]));
+        }
+        void ret(size_t from, owned<Value> value) {
+            blocks[from]->set_terminator(ReturnSSA::Create(fn, value));
+        }
+
+        /** 第 block 块还在函数里 */
+        bool has_block(size_t block) {
+            for (BasicBlock *i: fn->body()) {
+                if (i == blocks[block])
+                    return true;
+            }
+            return false;
+        }
+        /** from 块以 jump 结尾, 跳到 to 块 */
+        bool jumps_to(size_t from, size_t to) const {
+            Instruction *terminator = blocks[from]->get_terminator()->get_instance();
+            return terminator->get_type_id() == ValueTID::JUMP_SSA &&
+                   static_cast<JumpSSA*>(terminator)->get_target() == blocks[to];
+        }
+        Value *returned(size_t block) const {
+            return static_cast<ReturnSSA*>(blocks[block]->get_terminator())->get_result();
+        }
+    }; // struct CFG
+
+    size_t count_uses(Value *value)
+    {
+        size_t n = 0;
+        for (Use *use = value->get_list_as_usee().front();
+             use != nullptr; use = use->get_next_usee())
+            n++;
+        return n;
+    }
+
+    bool is_int(Value *value, int64_t expected) {
+        return value != nullptr && value->get_type_id() == ValueTID::INT_CONST &&
+               static_cast<IntConst*>(value)->get_value().get_signed_value() == expected;
+    }
+} // namespace
+
+int main()
+{
+    owned<Module> module = Module::Create("sccp", 8);
+    SCCPPass pass;
+
+    /* if (1 < 2) return 1; else return 2; */
+    {
+        CFG cfg(module, "constant_branch", 3);
+        CompareSSA *cond = cfg.add(0, CompareSSA::CreateICmp(
+            CompareResult::LT, true, cfg.iconst(1), cfg.iconst(2)));
+        cfg.branch(0, cond, 1, 2);
+        cfg.ret(1, cfg.iconst(1));
+        cfg.ret(2, cfg.iconst(2));
+        expect("constant branch: changed", pass.runOnFunction(cfg.fn));
+        expect("constant branch: br becomes a jump to the taken side", cfg.jumps_to(0, 1));
+        expect("constant branch: the other side is deleted", !cfg.has_block(2));
+        expect("constant branch: a second run changes nothing", !pass.runOnFunction(cfg.fn));
+    }
+    /* phi 只看可执行边: 不可执行的那一边送来的是参数, 也不影响结果是常量 7 */
+    {
+        CFG cfg(module, "feasible_phi", 4);
+        CompareSSA *cond = cfg.add(0, CompareSSA::CreateICmp(
+            CompareResult::GT, true, cfg.iconst(3), cfg.iconst(4)));
+        cfg.branch(0, cond, 1, 2);
+        cfg.jump(1, 3);
+        cfg.jump(2, 3);
+        owned<PhiSSA> phi = own<PhiSSA>(cfg.blocks[3], cfg.i32);
+        cfg.blocks[3]->prepend(phi);
+        phi->setValueFrom(cfg.blocks[1], cfg.arg());
+        phi->setValueFrom(cfg.blocks[2], cfg.iconst(7));
+        cfg.ret(3, phi);
+        expect("feasible phi: changed", pass.runOnFunction(cfg.fn));
+        expect("feasible phi: the phi folds to the feasible incoming",
+               is_int(cfg.returned(3), 7));
+        expect("feasible phi: the infeasible side is deleted", !cfg.has_block(1));
+    }
+    /* 两条边都可执行, 送来的值不同: phi 不是常量, 保留两个入口 */
+    {
+        CFG cfg(module, "overdefined_phi", 4);
+        CompareSSA *cond = cfg.add(0, CompareSSA::CreateICmp(
+            CompareResult::LT, true, cfg.arg(), cfg.iconst(10)));
+        cfg.branch(0, cond, 1, 2);
+        cfg.jump(1, 3);
+        cfg.jump(2, 3);
+        owned<PhiSSA> phi = own<PhiSSA>(cfg.blocks[3], cfg.i32);
+        cfg.blocks[3]->prepend(phi);
+        phi->setValueFrom(cfg.blocks[1], cfg.iconst(1));
+        phi->setValueFrom(cfg.blocks[2], cfg.iconst(2));
+        cfg.ret(3, phi);
+        expect("overdefined phi: nothing to fold", !pass.runOnFunction(cfg.fn));
+        expect("overdefined phi: the phi stays with both incomings",
+               cfg.returned(3) == phi.get() && phi->get_operands().size() == 2);
+    }
+    /* switch 的条件只能是 i1: switch (1 + 1 == 2) { case 0: ...; case 1: ...; default: ... }
+     * i1 的 true 按有符号读是 -1, case 写的是 1, 也要能匹配上 */
+    {
+        CFG cfg(module, "constant_switch", 4);
+        BinarySSA *sum = cfg.add(0, BinarySSA::Create(
+            OpCode::ADD, cfg.iconst(1), cfg.iconst(1), true));
+        CompareSSA *key = cfg.add(0, CompareSSA::CreateICmp(
+            CompareResult::EQ, true, sum, cfg.iconst(2)));
+        owned<SwitchSSA> sw = SwitchSSA::Create(key, cfg.blocks[3]);
+        sw->setCase(0, cfg.blocks[1]);
+        sw->setCase(1, cfg.blocks[2]);
+        cfg.blocks[0]->set_terminator(sw);
+        cfg.ret(1, cfg.iconst(10));
+        cfg.ret(2, cfg.iconst(20));
+        cfg.ret(3, cfg.iconst(0));
+        expect("constant switch: changed", pass.runOnFunction(cfg.fn));
+        expect("constant switch: switch becomes a jump to the matching case",
+               cfg.jumps_to(0, 2));
+        expect("constant switch: the other cases are deleted",
+               !cfg.has_block(1) && !cfg.has_block(3));
+    }
+    /* 不可达块删掉以后, 汇合块的 phi 里不能留下来自它的入口 */
+    {
+        CFG cfg(module, "unreachable_incoming", 4);
+        cfg.branch(0, IntConst::BooleanTrue(), 1, 2);
+        cfg.jump(1, 3);
+        BinarySSA *dead = cfg.add(2, BinarySSA::Create(
+            OpCode::MUL, cfg.arg(), cfg.iconst(3), true));
+        cfg.jump(2, 3);
+        owned<PhiSSA> phi = own<PhiSSA>(cfg.blocks[3], cfg.i32);
+        cfg.blocks[3]->prepend(phi);
+        phi->setValueFrom(cfg.blocks[1], cfg.arg());
+        phi->setValueFrom(cfg.blocks[2], dead);
+        cfg.ret(3, phi);
+        expect("unreachable incoming: changed", pass.runOnFunction(cfg.fn));
+        expect("unreachable incoming: the dead block is deleted", !cfg.has_block(2));
+        expect("unreachable incoming: only the live incoming is left",
+               phi->get_operands().size() == 1 &&
+               phi->get_operands().contains(cfg.blocks[1]) &&
+               phi->getValueFrom(cfg.blocks[1]) == cfg.arg());
+        size_t ncomes_from = cfg.blocks[3]->get_comes_from().size();
+        expect("unreachable incoming: the join has one predecessor", ncomes_from == 1);
+    }
+    /* 结果未定义的运算原样保留, 同一个函数里正常的运算照样折叠 */
+    {
+        struct Case {
+            char const *what;
+            OpCode      opcode;
+            int64_t     lhs, rhs;
+        } const cases[] = {
+            { "sdiv by zero",        OpCode::SDIV, 1,         0  },
+            { "srem by zero",        OpCode::SREM, 1,         0  },
+            { "udiv by zero",        OpCode::UDIV, 1,         0  },
+            { "INT_MIN / -1",        OpCode::SDIV, INT32_MIN, -1 },
+            { "INT_MIN % -1",        OpCode::SREM, INT32_MIN, -1 },
+            { "shl by the width",    OpCode::SHL,  1,         32 },
+            { "lshr by the width",   OpCode::LSHR, 1,         32 },
+            { "ashr past the width", OpCode::ASHR, -1,        40 },
+        };
+        CFG cfg(module, "undefined_results", 1);
+        std::vector<BinarySSA*> kept;
+        owned<Value> sum = cfg.add(0, BinarySSA::Create(
+            OpCode::SDIV, cfg.iconst(-6), cfg.iconst(3), true));
+        for (Case const &c: cases) {
+            BinarySSA *inst = cfg.add(0, BinarySSA::Create(
+                c.opcode, cfg.iconst(c.lhs), cfg.iconst(c.rhs), true));
+            kept.push_back(inst);
+            sum = cfg.add(0, BinarySSA::Create(OpCode::ADD, sum, inst, true));
+        }
+        cfg.ret(0, sum);
+        pass.runOnFunction(cfg.fn);
+        for (size_t i = 0; i < kept.size(); i++) {
+            bool found = false;
+            for (Instruction *inst: cfg.blocks[0]->instruction_list())
+                found |= inst == kept[i];
+            if (!found) {
+                nfailed++;
+                std::fprintf(stderr, "failed: %s was folded\n", cases[i].what);
+            }
+        }
+        /* 第一个加法的左边是 -6 / 3, 它能折叠 */
+        BinarySSA *first_add = nullptr;
+        for (Instruction *inst: cfg.blocks[0]->instruction_list()) {
+            if (inst->get_type_id() == ValueTID::BINARY_SSA &&
+                static_cast<BinarySSA*>(inst)->get_opcode() == OpCode::ADD) {
+                first_add = static_cast<BinarySSA*>(inst);
+                break;
+            }
+        }
+        expect("-6 / 3 folds to -2", first_add != nullptr && is_int(first_add->get_lhs(), -2));
+    }
+
+    /* 多线程: 每个函数都直接在共享的 true/false 上分支. SCCP 换下旧的 br 时, 它在
+     * 常量使用链表上的 Use 要在锁里摘掉, 否则几个线程会同时改同一个链表 */
+    {
+        constexpr size_t NFUNCTIONS = 512;
+        owned<Module> pmodule = Module::Create("sccp-parallel", 8);
+        Value *const_true  = IntConst::BooleanTrue();
+        Value *const_false = IntConst::BooleanFalse();
+        size_t ntrue  = count_uses(const_true);
+        size_t nfalse = count_uses(const_false);
+
+        std::vector<CFG> cfgs;
+        cfgs.reserve(NFUNCTIONS);
+        for (size_t i = 0; i < NFUNCTIONS; i++) {
+            CFG &cfg = cfgs.emplace_back(pmodule, ("branch" + std::to_string(i)).c_str(), 3);
+            cfg.branch(0, i % 2 == 0 ? const_true : const_false, 1, 2);
+            cfg.ret(1, cfg.iconst(1));
+            cfg.ret(2, cfg.iconst(2));
+        }
+        FunctionPassManager manager{4};
+        manager.addPass(own<SCCPPass>());
+        expect("parallel: every function is folded", manager.run(pmodule) == NFUNCTIONS);
+        bool all_jump = true;
+        for (size_t i = 0; i < NFUNCTIONS; i++)
+            all_jump &= cfgs[i].jumps_to(0, i % 2 == 0 ? 1 : 2);
+        expect("parallel: every branch becomes a jump to the taken side", all_jump);
+        expect("parallel: the old branches are unlinked from true and false",
+               count_uses(const_true) == ntrue && count_uses(const_false) == nfalse);
+    }
+
+    if (nfailed == 0)
+        std::puts("sccp: all passed");
+    return nfailed;
+}